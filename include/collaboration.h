@@ -0,0 +1,68 @@
+#ifndef COLLABORATION_H
+#define COLLABORATION_H
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "text_editor.h"
+#include "sequence_crdt.h"
+#include "collaboration_relay.h"
+
+// keeps a document in a collaboration session, the edits of its views are sent to the relay
+// as operations of a SequenceCrdt and the operations of the other editors are applied to it
+// as edits no view made, every view moves over them like over the edits of another pane
+//
+// the operations of one poll go out as one batch, typing and deleting character by character
+// is sent as one operation per run
+class Collaboration
+{
+public:
+
+    Collaboration() = default;
+
+    Collaboration(const Collaboration&) = delete;
+    Collaboration& operator= (const Collaboration&) = delete;
+
+    // connects to the relay of the session name, the document of view is the one that is shared,
+    // the text of the session replaces it unless this is the first editor of the session
+    [[nodiscard]] bool m_join(const std::wstring_view name, const TextEditor& view);
+
+    void m_leave();
+
+    [[nodiscard]] bool m_isJoined() const noexcept { return m_socket.m_isValid(); }
+
+    [[nodiscard]] const std::wstring& m_getName() const noexcept { return m_name; }
+
+    // sends the local edits and applies what the relay sent, leaves when the relay is gone
+    void m_poll();
+
+private:
+
+    LocalSocket m_socket;
+
+    std::wstring m_name;
+
+    // keeps the shared document when the editor shows another one
+    TextEditor m_view;
+
+    // made once the history arrived, local edits before it are replaced by the text of the session
+    std::optional<SequenceCrdt> m_crdt;
+
+    CollaborationRelay::WelcomeMessage m_welcome = {};
+
+    std::vector<SequenceCrdt::Operation> m_unsent;
+
+    // turns the changes the views recorded into operations
+    void m_takeChanges();
+
+    [[nodiscard]] bool m_handleMessage(const LocalSocket::Message& message);
+
+    [[nodiscard]] bool m_startSession(const std::vector<char>& history);
+
+    [[nodiscard]] bool m_applyBatch(const std::vector<char>& batch);
+};
+
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef COLLABORATION_RELAY_H
+#define COLLABORATION_RELAY_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "local_socket.h"
+
+// passes the operations of the editors of a collaboration session to each other,
+//
+//   e --relay <name>
+//   e <file> --collab=<name>
+//
+// the relay does not read the operations, it numbers the editors, forwards every batch to the others
+// in the order the batches arrive and keeps them all for editors that join later. an editor only sends
+// operations on characters it has, so forwarding in one order keeps every batch after the ones it needs
+class CollaborationRelay
+{
+public:
+
+    using ClientId = std::uint32_t;
+
+    // entry point of the relay mode, returns the process exit code
+    [[nodiscard]] static int s_main(const int argc, const wchar_t* argv[]);
+
+    // socket file of the session, empty if name has characters a file name can not have,
+    // only letters, digits, '-' and '_' are taken
+    [[nodiscard]] static std::string s_getPath(const std::wstring_view name);
+
+    CollaborationRelay() = default;
+
+    CollaborationRelay(const CollaborationRelay&) = delete;
+    CollaborationRelay& operator= (const CollaborationRelay&) = delete;
+
+    [[nodiscard]] bool m_listen(const std::string& path) noexcept;
+
+    // relays until the process is ended
+    void m_run();
+
+public:
+
+    enum MessageType : std::uint32_t
+    {
+        Message_Welcome, // relay, WelcomeMessage, sent once right after the editor connects
+        Message_History, // relay, the operations of every batch so far, sent right after the welcome
+        Message_Batch    // editor, operations written by SequenceCrdt::s_write, forwarded to the other editors
+    };
+
+    struct WelcomeMessage
+    {
+        ClientId m_client;
+
+        // the text of the first editor of the session is its starting text, the others take the history
+        std::uint32_t m_first;
+    };
+
+private:
+
+    struct Client
+    {
+        LocalSocket m_socket;
+
+        bool m_closed = false;
+    };
+
+    // the relay has no idle work, the wait only bounds how long a closed editor stays in the list
+    static constexpr long s_waitTimeout = 250;
+
+    LocalSocket m_listener;
+
+    std::vector<std::unique_ptr<Client>> m_clients;
+
+    // batches one after another, s_read reads them as one sequence
+    std::vector<char> m_history;
+
+    ClientId m_nextClient = 1;
+
+    void m_acceptClients();
+
+    void m_relay(const Client& sender, const std::vector<char>& batch);
+};
+
+
+#endif
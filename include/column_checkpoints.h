@@ -0,0 +1,87 @@
+#ifndef COLUMN_CHECKPOINTS_H
+#define COLUMN_CHECKPOINTS_H
+
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+#include "unicode_properties.h"
+
+
+// screen column and wrap position at every s_interval characters of recently used long lines,
+// so a column of a line with millions of characters is found without walking the line from its start
+//
+// checkpoints are only computed as far as they were asked for, an edit drops the ones after it
+class ColumnCheckpoints
+{
+public:
+
+    using SizeType = std::wstring_view::size_type;
+
+    static constexpr SizeType s_interval = 1 << 12;
+
+    static constexpr SizeType s_cachedLines = 8;
+
+    // position before the character at m_index
+    struct State
+    {
+        SizeType m_index  = 0;
+        SizeType m_column = 0;
+
+        // row and column inside the row when the line wraps at the width
+        SizeType m_row       = 0;
+        SizeType m_rowColumn = 0;
+    };
+
+    // checkpoints of a different width or tab size are dropped
+    void m_setLayout(const SizeType width, const SizeType tabSize) noexcept;
+
+    [[nodiscard]] static SizeType s_getCharWidth(const wchar_t c, const SizeType tabSize) noexcept { return c == L'\t' ? tabSize : UnicodeProperties::s_getWidth(c); }
+
+    // moves state over the character at state.m_index
+    void m_advance(State& state, const wchar_t c) const noexcept;
+
+    // [lineStart, lineEnd) is a line of text, index is inside it or lineEnd
+
+    [[nodiscard]] State m_getStateAt(const std::wstring_view text, const SizeType lineStart, const SizeType lineEnd, const SizeType index);
+
+    // the last checkpoint at or before column, scanning on from it finds the exact index
+    [[nodiscard]] State m_getStateBeforeColumn(const std::wstring_view text, const SizeType lineStart, const SizeType lineEnd, const SizeType column);
+
+    // the last checkpoint on a row before row
+    [[nodiscard]] State m_getStateBeforeRow(const std::wstring_view text, const SizeType lineStart, const SizeType lineEnd, const SizeType row);
+
+    // both are called with the edits in the order they were made, hasNewLine tells if the inserted text has one
+    void m_onInsert(const SizeType index, const SizeType size, const bool hasNewLine) noexcept;
+    void m_onErase (const SizeType start, const SizeType end) noexcept;
+
+    void m_clear() noexcept { m_lines.clear(); }
+
+private:
+
+    struct Line
+    {
+        SizeType m_start   = 0;
+        SizeType m_lastUse = 0;
+
+        // m_states[i] is at m_start + i * s_interval, indices are relative to m_start
+        std::vector<State> m_states;
+    };
+
+    std::vector<Line> m_lines;
+
+    SizeType m_useCounter = 0;
+
+    SizeType m_width   = 0;
+    SizeType m_tabSize = 0;
+
+    // returns the cached line or starts one, evicting the least recently used one
+    [[nodiscard]] Line& m_getLine(const SizeType lineStart);
+
+    // adds checkpoints while stop returns false for the last one and the line has more
+    template<typename Function>
+    void m_extend(Line& line, const std::wstring_view text, const SizeType lineEnd, Function&& stop);
+};
+
+
+#endif
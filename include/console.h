@@ -13,8 +13,11 @@
 
 #include <windows.h>
 #include <cstddef>
+#include <algorithm>
 #include <string>
+#include <string_view>
 #include <vector>
+#include <cwchar>
 #include <optional>
 #include <chrono>
 
@@ -68,6 +71,33 @@ public:
 
 	void m_run() noexcept;
 
+	// only the cells, no console is created or changed, a client of the editor server
+	// sends the input and draws the cells in its own console
+	[[nodiscard]] bool m_constructHeadless(const int width, const int height) noexcept;
+
+	[[nodiscard]] constexpr bool m_isRunning() const noexcept { return m_runing; }
+
+	// input read from a console somewhere else, more tells that the events continue in the next call
+	void m_handleInputEvents(const INPUT_RECORD* events, const std::size_t count, const bool more) noexcept
+	{
+		m_dispatchInputEvents(events, count);
+
+		if (!more) m_flushKeyEvents();
+	}
+
+	void m_resizeConsole(const COORD newSize) noexcept;
+
+	void m_handleIdle() { m_childHandleIdle(); }
+
+	[[nodiscard]] const std::vector<wchar_t>& m_getChars     () const noexcept { return m_chars;      }
+	[[nodiscard]] const std::vector<WORD>   & m_getAttributes() const noexcept { return m_attributes; }
+
+	// last values set, a headless console only keeps them
+	[[nodiscard]] constexpr COORD m_getCursorPos    () const noexcept { return m_cursorPos;     }
+	[[nodiscard]] constexpr bool  m_isCursorVisible () const noexcept { return m_cursorVisible; }
+
+	[[nodiscard]] std::wstring_view m_getConsoleTitle() const noexcept { return m_title; }
+
 public:
 
 	static constexpr WORD s_ctrlKeyFlag = RIGHT_CTRL_PRESSED | LEFT_CTRL_PRESSED;
@@ -109,7 +139,10 @@ public:
 
 
 	static bool s_setUserClipboard(const std::wstring_view str) noexcept;
-    [[nodiscard]] static std::optional<std::wstring> s_getUserClipboard() noexcept;
+
+	// calls function with a view of the clipboard text while it is locked, the text is not copied
+	template<typename Function>
+	static bool s_useUserClipboard(Function&& function) noexcept;
 
 public:
 
@@ -134,8 +167,8 @@ public:
 	{
 		if (index < m_screenBufferSize())
 		{
-			m_screenBuffer[index].Attributes       = color;
-			m_screenBuffer[index].Char.UnicodeChar = c;
+			m_attributes[index] = color;
+			m_chars     [index] = c;
 		}
 	}
 
@@ -147,8 +180,8 @@ public:
 		{
 			const std::size_t index = m_getIndex(x, y);
 
-			m_screenBuffer[index].Attributes       = color;
-			m_screenBuffer[index].Char.UnicodeChar = c;
+			m_attributes[index] = color;
+			m_chars     [index] = c;
 		}
 	}
 
@@ -156,7 +189,7 @@ public:
 	{
 		if (index < m_screenBufferSize())
 		{
-			return m_screenBuffer[index].Attributes;
+			return m_attributes[index];
 		}
 		
 		return 0;
@@ -166,10 +199,55 @@ public:
 	{
 		if (index < m_screenBufferSize())
 		{
-			m_screenBuffer[index].Attributes = color;
+			m_attributes[index] = color;
 		}
 	}
 
+	// span writes, count cells starting at index, the span is clipped to the buffer once
+
+	void m_fillCells(const std::size_t index, const std::size_t count, const wchar_t c, const WORD color) noexcept
+	{
+		const auto size = m_clipSpan(index, count);
+
+		if (size == 0) return;
+
+		std::fill_n(m_chars     .begin() + index, size, c);
+		std::fill_n(m_attributes.begin() + index, size, color);
+	}
+
+	void m_copyChars(const std::size_t index, const wchar_t* const chars, const std::size_t count) noexcept
+	{
+		const auto size = m_clipSpan(index, count);
+
+		if (size > 0) std::copy_n(chars, size, m_chars.begin() + index);
+	}
+
+	void m_copyColors(const std::size_t index, const WORD* const colors, const std::size_t count) noexcept
+	{
+		const auto size = m_clipSpan(index, count);
+
+		if (size > 0) std::copy_n(colors, size, m_attributes.begin() + index);
+	}
+
+	void m_fillColor(const std::size_t index, const std::size_t count, const WORD color) noexcept
+	{
+		const auto size = m_clipSpan(index, count);
+
+		if (size > 0) std::fill_n(m_attributes.begin() + index, size, color);
+	}
+
+	// ors color into the attributes, for highlights drawn over colored text
+	void m_addColor(const std::size_t index, const std::size_t count, const WORD color) noexcept
+	{
+		const auto size = m_clipSpan(index, count);
+
+		if (size == 0) return;
+
+		const auto first = m_attributes.begin() + index;
+
+		std::transform(first, first + size, first, [color] (const WORD value) { return static_cast<WORD>(value | color); });
+	}
+
 	constexpr void m_setRect(const std::size_t startX, const std::size_t startY,
 		const std::size_t width, const std::size_t height,
 		const wchar_t c, const WORD color = s_foregroundWhite) noexcept
@@ -214,12 +292,9 @@ public:
 		m_setRect(startX, startY, width, height, L' ', color);
 	}
 
-    constexpr void m_clearConsole() noexcept
+    void m_clearConsole() noexcept
 	{
-		for (std::size_t i = 0; i < m_screenBufferSize(); ++i)
-		{
-			m_setGrid(i, L' ');
-		}
+		m_fillCells(0, m_screenBufferSize(), L' ', s_foregroundWhite);
 	}
 	
 	void m_renderConsole() noexcept;
@@ -254,6 +329,10 @@ protected:
     virtual void m_childHandleKeyEvents  (const KEY_EVENT_RECORD&  ) {}
     virtual void m_childHandleMouseEvents(const MOUSE_EVENT_RECORD&) {}
 	virtual void m_childHandleResizeEvent(const COORD, const COORD ) {}
+	virtual void m_childHandlePasteEvent (std::wstring             ) {}
+
+	// called once per event loop iteration, for work that does not wait on input
+	virtual void m_childHandleIdle() {}
 
 protected:
 
@@ -264,11 +343,17 @@ public:
 
 	void m_setCursorPos(const COORD pos) const noexcept
 	{
-		SetConsoleCursorPosition(m_handleOut, pos);
+		m_cursorPos = pos;
+
+		if (m_handleOut) SetConsoleCursorPosition(m_handleOut, pos);
 	}
 
 	auto m_setCursorInfo(const bool visible, const DWORD size = 1) const noexcept
 	{
+		m_cursorVisible = visible;
+
+		if (!m_handleOut) return TRUE;
+
 		CONSOLE_CURSOR_INFO cursorInfo;
         cursorInfo.dwSize = size;
         cursorInfo.bVisible = visible;
@@ -293,12 +378,19 @@ public:
 	{
 		if (!str.empty())
 		{
-			SetConsoleTitleW(str.data());
+			m_title = str;
+
+			if (m_handleOut) SetConsoleTitleW(m_title.c_str());
 		}
 	}
 
 private:
 
+	// characters and attributes of the cells are separate arrays so spans of either are plain fills and copies,
+	// they are interleaved into m_screenBuffer only when the frame is written
+	std::vector<wchar_t> m_chars;
+	std::vector<WORD>    m_attributes;
+
 	std::vector<CHAR_INFO> m_screenBuffer;
 
 	int m_width  = 0;
@@ -309,7 +401,13 @@ private:
 	HANDLE m_handleOut = nullptr;
 	HANDLE m_handleIn  = nullptr;
 	
-	DWORD m_oldInputHandleMode;
+	DWORD m_oldInputHandleMode  = 0;
+	DWORD m_oldOutputHandleMode = 0;
+
+	mutable COORD m_cursorPos = {};
+	mutable bool m_cursorVisible = false;
+
+	mutable std::wstring m_title;
 
     bool m_runing = true;
 
@@ -369,13 +467,94 @@ private:
 		return { 0, 0, static_cast<short>(m_width - 1), static_cast<short>(m_height - 1) };
 	}
 
+	// cells of the span that are inside the buffer
+	[[nodiscard]] std::size_t m_clipSpan(const std::size_t index, const std::size_t count) const noexcept
+	{
+		const auto size = m_screenBufferSize();
+
+		return index < size ? std::min(count, size - index) : 0;
+	}
+
+private:
+
+	// pasted text arrives as one key event per character, it is collected
+	// and delivered with a single m_childHandlePasteEvent call instead
+	enum class PasteState
+	{
+		None,
+		Burst,     // more characters in the input queue than anyone can type
+		Bracketed  // terminal marked the text with bracketed paste sequences
+	};
+
+	PasteState m_pasteState = PasteState::None;
+
+	std::wstring m_pasteBuffer;
+
+	// events held back until it is known whether they start a paste
+	std::vector<KEY_EVENT_RECORD> m_pendingKeyEvents;
+	std::wstring m_pendingText;
+
+	static constexpr std::size_t s_pasteBurstSize = 32;
+
+	static constexpr std::wstring_view s_bracketedPasteStart = L"\x1b[200~";
+	static constexpr std::wstring_view s_bracketedPasteEnd   = L"\x1b[201~";
+
+	[[nodiscard]] static constexpr bool s_isTextKeyEvent(const KEY_EVENT_RECORD& event) noexcept
+	{
+		if ((event.dwControlKeyState & (s_ctrlKeyFlag | s_altKeyFlag)) != 0) return false;
+
+		// key up events and shift state changes are carried along
+		if (!event.bKeyDown || event.wVirtualKeyCode == VK_SHIFT) return true;
+
+		const auto c = event.uChar.UnicodeChar;
+
+		return c == L'\r' || c == L'\n' || c == L'\t' || c >= L' ';
+	}
+
+	void m_decodeKeyEvent(const KEY_EVENT_RECORD& event) noexcept;
+
+	// replays held back events or finishes a burst paste
+	void m_flushKeyEvents() noexcept;
+
+	void m_endPaste() noexcept;
+
+	void m_setBracketedPaste(const bool enable) const noexcept;
+
 private:
 
 	void m_handleEvents() noexcept;
 
-	void m_resizeConsole(const COORD newSize) noexcept;
+	void m_dispatchInputEvents(const INPUT_RECORD* events, const std::size_t count) noexcept;
+
 	void m_createScreenBuffer(const int width, const int height) noexcept;
 };
 
+template<typename Function>
+bool Console::s_useUserClipboard(Function&& function) noexcept
+{
+	if (!OpenClipboard(nullptr)) return false;
+
+	bool result = false;
+
+	if (const auto clipboardHandle = GetClipboardData(CF_UNICODETEXT))
+	{
+		if (const auto data = static_cast<const wchar_t*>(GlobalLock(clipboardHandle)))
+		{
+			// size of the memory block is the limit, the terminating null is not trusted
+			const auto maxSize = GlobalSize(clipboardHandle) / sizeof(wchar_t);
+
+			function(std::wstring_view{ data, wcsnlen(data, maxSize) });
+
+			GlobalUnlock(clipboardHandle);
+
+			result = true;
+		}
+	}
 
-#endif
\ No newline at end of file
+	CloseClipboard();
+
+	return result;
+}
+
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef CONSOLE_CLIENT_H
+#define CONSOLE_CLIENT_H
+
+#include <optional>
+
+#include "editor_server.h"
+
+// console of an editor run by the editor server, input events go to the server as they are read
+// and the cells it sends back are drawn, the same arguments as the editor without the server
+class ConsoleClient : public Console
+{
+public:
+
+    // runs the editor in the server if one is listening and neither --local nor --collab is given, returns the exit code,
+    // nothing when the editor has to run in this process
+    [[nodiscard]] static std::optional<int> s_attach(const int argc, const wchar_t* argv[]);
+
+private:
+
+    LocalSocket m_socket;
+
+    [[nodiscard]] bool m_constructClient(const int argc, const wchar_t* argv[]) noexcept;
+
+    // until the server closes the connection, the editor exited or the server stopped
+    void m_runClient();
+
+    void m_forwardInput();
+
+    // returns true if the cells changed
+    bool m_handleMessage(const LocalSocket::Message& message);
+
+    void m_childHandleResizeEvent(const COORD, const COORD) final override;
+};
+
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef CONSOLE_FILE_VIEWER_H
+#define CONSOLE_FILE_VIEWER_H
+
+#include "text_editor.h"
+#include "paged_file.h"
+
+// read only pager for files of any size, memory use does not depend on the file size
+class ConsoleFileViewer : public Console
+{
+public:
+
+    using SizeType = PagedFile::SizeType;
+
+    // e --view <file> [width height [fontW fontH]]
+    [[nodiscard]] bool m_constructViewer(const int argc, const wchar_t* argv[]) noexcept;
+
+private:
+
+    PagedFile m_file;
+
+    std::wstring m_fileName;
+
+    // byte offset of the first visible line
+    SizeType m_topLine = 0;
+
+    // first visible column
+    SizeType m_column = 0;
+
+    std::wstring m_message;
+
+    static constexpr SizeType s_tabSize = 4;
+
+    static constexpr WORD s_statusColor = s_foregroundWhite | BACKGROUND_RED | BACKGROUND_BLUE;
+
+    [[nodiscard]] SizeType m_getViewHeight() const noexcept;
+
+    void m_scrollDown(SizeType lineCount);
+    void m_scrollUp  (SizeType lineCount);
+
+    void m_scrollToEnd();
+
+    void m_draw();
+
+    void m_drawStatus(const SizeType y);
+
+private:
+
+    enum class Prompt
+    {
+        None,
+        GoTo,
+        Find
+    };
+
+    Prompt m_prompt = Prompt::None;
+
+    TextEditor m_promptEditor;
+
+    void m_openPrompt(const Prompt prompt);
+
+    // "<line>" or "<percent>%"
+    bool m_goTo(std::wstring_view str);
+
+private:
+
+    TextSearch m_search;
+
+    // next byte offset to search from while a search is running
+    std::optional<SizeType> m_searchPosition;
+
+    // bytes searched per idle call, the viewer stays responsive on huge files
+    static constexpr SizeType s_searchChunkSize = 1 << 20;
+    static constexpr SizeType s_searchChunksPerIdle = 8;
+
+    void m_startSearch(const SizeType start);
+
+    // searches the next chunks, moves the view to a match
+    void m_continueSearch();
+
+private:
+
+    std::chrono::steady_clock::time_point m_lastIdleDraw;
+
+    // status stops being redrawn once it showed the complete index
+    bool m_drewCompleteIndex = false;
+
+    void m_childHandleKeyEvents  (const KEY_EVENT_RECORD&  ) final override;
+    void m_childHandleMouseEvents(const MOUSE_EVENT_RECORD&) final override;
+	void m_childHandleResizeEvent(const COORD, const COORD ) final override;
+	void m_childHandleIdle       (                         ) final override;
+};
+
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef CONSOLE_HEX_EDITOR_H
+#define CONSOLE_HEX_EDITOR_H
+
+#include "text_editor.h"
+#include "mapped_file.h"
+
+// hex and ascii view of a mapped file, bytes are overwritten in place and the size never changes
+class ConsoleHexEditor : public Console
+{
+public:
+
+    using SizeType = MappedFile::SizeType;
+
+    // e --hex <file> [width height [fontW fontH]]
+    [[nodiscard]] bool m_constructHexEditor(const int argc, const wchar_t* argv[]) noexcept;
+
+private:
+
+    MappedFile m_file;
+
+    std::wstring m_fileName;
+
+    static constexpr SizeType s_bytesPerRow = 16;
+
+    // first visible row
+    SizeType m_topRow = 0;
+
+    SizeType m_cursor = 0;
+
+    // the high nibble is typed first
+    bool m_lowNibble = false;
+
+    // typing goes to the ascii column instead of the hex column
+    bool m_asciiPane = false;
+
+    // hex digits of the offset column
+    std::size_t m_offsetDigits = 8;
+
+    std::vector<std::uint8_t> m_rowBytes;
+
+    std::wstring m_message;
+
+    // the first Esc with unsaved changes only warns
+    bool m_warnedUnsaved = false;
+
+    static constexpr WORD s_statusColor   = s_foregroundWhite | BACKGROUND_RED | BACKGROUND_BLUE;
+    static constexpr WORD s_offsetColor   = FOREGROUND_GREEN | FOREGROUND_BLUE;
+    static constexpr WORD s_modifiedColor = FOREGROUND_RED | FOREGROUND_INTENSITY;
+    static constexpr WORD s_matchColor    = BACKGROUND_RED | BACKGROUND_GREEN;
+    static constexpr WORD s_cursorColor   = s_backgroundWhite;
+
+    [[nodiscard]] SizeType m_getViewHeight() const noexcept;
+
+    [[nodiscard]] std::size_t m_getHexColumn  (const SizeType column) const noexcept;
+    [[nodiscard]] std::size_t m_getAsciiColumn(const SizeType column) const noexcept;
+
+    // moves the cursor and scrolls it into view
+    void m_moveCursor(const SizeType offset) noexcept;
+
+    void m_typeChar(const wchar_t c);
+
+    void m_draw();
+
+    void m_drawStatus(const SizeType y);
+
+private:
+
+    enum class Prompt
+    {
+        None,
+        GoTo,
+        Find
+    };
+
+    Prompt m_prompt = Prompt::None;
+
+    TextEditor m_promptEditor;
+
+    std::wstring m_findInput;
+
+    void m_openPrompt(const Prompt prompt);
+
+    // "0x<hex>", "<decimal>" or "<percent>%"
+    bool m_goTo(std::wstring_view str);
+
+private:
+
+    std::vector<std::uint8_t> m_pattern;
+
+    // "<hex bytes>" like "4D 5A 90" or "\"<text>\"" searched as utf-8
+    bool m_parsePattern(std::wstring_view str);
+
+    // the last match stays highlighted
+    SizeType m_matchStart = 0;
+    SizeType m_matchSize  = 0;
+
+    // next byte offset to search from while a search is running
+    std::optional<SizeType> m_searchPosition;
+
+    std::vector<std::uint8_t> m_searchBytes;
+
+    // bytes searched per idle call, the view stays responsive on huge files
+    static constexpr SizeType s_searchChunkSize = 1 << 20;
+    static constexpr SizeType s_searchChunksPerIdle = 8;
+
+    void m_startSearch(const SizeType start);
+
+    // searches the next chunks, moves the cursor to a match
+    void m_continueSearch();
+
+private:
+
+    void m_childHandleKeyEvents  (const KEY_EVENT_RECORD&  ) final override;
+    void m_childHandleMouseEvents(const MOUSE_EVENT_RECORD&) final override;
+	void m_childHandleResizeEvent(const COORD, const COORD ) final override;
+	void m_childHandleIdle       (                         ) final override;
+};
+
+
+#endif
@@ -2,19 +2,41 @@
 #define CONSOLE_TEXT_EDITOR_H
 
 #include <array>
+#include <vector>
+#include <functional>
+#include <memory>
+#include <optional>
 
 #include "text_editor.h"
+#include "document_list.h"
+#include "occur_list.h"
+#include "process_filter.h"
+#include "file_follower.h"
+#include "collaboration.h"
 
 
 class ConsoleTextEditor : public Console
 {
 public:
 
+    ConsoleTextEditor() = default;
+
+    // a save that is still running is finished first
+    ~ConsoleTextEditor();
+
+    ConsoleTextEditor(const ConsoleTextEditor&) = delete;
+    ConsoleTextEditor& operator= (const ConsoleTextEditor&) = delete;
+
     [[nodiscard]] bool m_constructEditor(const int argc, const wchar_t* argv[]) noexcept;
 
+    // headless editor of a client of the editor server, view is the server's view of the document at path
+    // and the main editor becomes another view of it, an untitled document is shown without one
+    [[nodiscard]] bool m_constructSession(const int width, const int height, 
+        const std::wstring_view path, const TextEditor* view) noexcept;
+
 private:
 
-    static constexpr std::size_t s_editorCount = 5;
+    static constexpr std::size_t s_editorCount = 6;
 
     enum EditorType : std::size_t 
     {
@@ -22,7 +44,8 @@ private:
         Editor_Save,
         Editor_Open,
         Editor_Find,
-        Editor_Replace
+        Editor_Replace,
+        Editor_Command
     };
 
     std::array<TextEditor, s_editorCount> m_editors;
@@ -33,8 +56,174 @@ private:
 
     void m_updateEditors() noexcept;
 
+    // version of the main document when it was drawn, clients of the server sharing it edit it too
+    std::size_t m_drawnVersion = 0;
+
     void m_updateEditor(const EditorType editorT, const std::wstring_view header) noexcept;
 
+    // find and replace editors grow with their content
+    void m_syncSearchEditorHeights() noexcept;
+
+private:
+
+    // the main editor split into panes, every pane is a view of the same document
+    // with its own cursors and scroll position
+
+    enum class SplitMode
+    {
+        Horizontal, // panes stacked from top to bottom
+        Vertical    // panes side by side
+    };
+
+    static constexpr std::size_t s_maxPanes = 4;
+
+    SplitMode m_splitMode = SplitMode::Horizontal;
+
+    // unfocused panes in screen order, the focused one is m_editors[Editor_Main] and sits at m_focusedPane
+    std::vector<TextEditor> m_panes;
+    std::size_t m_focusedPane = 0;
+
+    // rows left for the panes above the occur list and the find / replace editors
+    std::size_t m_paneAreaHeight = 0;
+
+    [[nodiscard]] TextEditor& m_getPane(const std::size_t pane) noexcept
+    {
+        if (pane == m_focusedPane) return m_editors[Editor_Main];
+
+        return m_panes[pane < m_focusedPane ? pane : pane - 1];
+    }
+
+    // alt+h / alt+v split the focused pane, alt+n focuses the next one, alt+q closes it
+    bool m_handlePaneEvents(const KEY_EVENT_RECORD& event);
+
+    void m_splitPane(const SplitMode mode);
+
+    void m_focusPane(const std::size_t pane);
+
+    void m_closePane();
+
+    // divides the rows above height or the screen width between the panes, one separator between two panes
+    void m_layoutPanes(const std::size_t height) noexcept;
+
+    void m_drawPaneSeparators() noexcept;
+
+private:
+
+    TextSearch::Options m_searchOptions;
+
+    [[nodiscard]] TextSearch m_getSearch() const { return { m_editors[Editor_Find].m_buffer(), m_searchOptions }; }
+
+    bool m_handleSearchOptionEvents(const KEY_EVENT_RECORD& event) noexcept;
+
+private:
+
+    OccurList m_occurList;
+
+    bool m_showOccur    = false;
+    bool m_occurFocused = false;
+
+    void m_handleOccurEvents(const KEY_EVENT_RECORD& event) noexcept;
+
+    void m_layoutOccurList() noexcept;
+
+    void m_closeOccurList() noexcept;
+
+    void m_jumpToOccurrence() noexcept;
+
+private:
+
+    bool m_commandFailed = false;
+
+    // runs the line command typed into the command editor on the main editor
+    bool m_runCommand() noexcept;
+
+private:
+
+    ProcessFilter m_filter;
+
+    // range of the main editor that is replaced with the output of m_filter, in the text at m_filterVersion
+    std::pair<std::size_t, std::size_t> m_filterRange;
+    std::size_t m_filterVersion = 0;
+
+    std::chrono::steady_clock::time_point m_lastProgressDraw;
+
+    // pipes the selection or the whole file through command, the editor only takes escape until it finishes
+    bool m_startFilter(const std::wstring_view command);
+
+    void m_finishFilter();
+
+    [[nodiscard]] std::wstring m_getFilterProgress() const;
+
+private:
+
+    // path of the file in the main editor
+    std::wstring m_filePath;
+
+    // every open document, ctrl+page down / page up show the next / previous one and ctrl+w closes it
+    DocumentList m_documents;
+
+    // points every pane at the document the main editor shows now
+    void m_onDocumentShown();
+
+    void m_showDocument(const std::size_t entry);
+
+    void m_closeDocument();
+
+    // file name with its place in the document list
+    void m_updateTitle();
+
+    FileFollower m_follower;
+
+    // ctrl+t, the main editor grows with what is appended to the file after the size it was read or saved at
+    void m_toggleFollow();
+
+    void m_pollFollower();
+
+    // --collab=<name>, the document opened first is edited together with the other editors of the session
+    Collaboration m_collaboration;
+
+private:
+
+    // long operation on the worker pool, the editor keeps drawing and editing while it runs and escape cancels it
+    struct BackgroundTask
+    {
+        std::shared_ptr<WorkerPool::Job> m_job;
+
+        // shown in the title with the progress
+        std::wstring m_description;
+
+        // applies the result on this thread once the job finished, cancelled or not
+        std::function<void(const bool cancelled)> m_finish;
+
+        // a save is waited for when the editor closes, any other task is cancelled
+        bool m_finishOnExit = false;
+    };
+
+    // texts and files smaller than this are handled right away, a task would only add a frame of delay
+    static constexpr std::size_t s_backgroundSize = 1 << 20;
+
+    // save, open or replace all, one at a time, the shown document does not change while it runs
+    std::optional<BackgroundTask> m_task;
+
+    // match count of the find editor, started again when the search or the text changes
+    std::optional<BackgroundTask> m_countTask;
+    TextSearch m_countedSearch;
+
+    std::chrono::steady_clock::time_point m_lastTaskDraw;
+
+    void m_saveFile(const std::wstring_view path);
+
+    // shows the document if it is open already
+    void m_openFile(const std::wstring_view path);
+
+    void m_replaceAll();
+
+    // counts the matches of search in the background unless its count is running already
+    void m_startMatchCount(const TextSearch& search);
+
+    // finishes the tasks that are done, returns true if the screen has to be drawn again
+    bool m_pollTasks();
+
 private:
 
     static constexpr WORD s_openSaveEditorColor = s_foregroundWhite | BACKGROUND_RED | BACKGROUND_BLUE;
@@ -44,6 +233,8 @@ private:
     void m_childHandleKeyEvents  (const KEY_EVENT_RECORD&  ) final override;
     void m_childHandleMouseEvents(const MOUSE_EVENT_RECORD&) final override;
 	void m_childHandleResizeEvent(const COORD, const COORD ) final override;
+	void m_childHandlePasteEvent (std::wstring             ) final override;
+	void m_childHandleIdle       (                         ) final override;
 };
 
 
@@ -0,0 +1,204 @@
+#ifndef DOCUMENT_H
+#define DOCUMENT_H
+
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+#include <deque>
+#include <optional>
+
+#include "text_search.h"
+#include "trigram_index.h"
+#include "line_index.h"
+#include "syntax_highlighter.h"
+#include "text_snapshot.h"
+
+
+// text, line index, edit log and undo history of one buffer, shared by every TextEditor that shows it
+//
+// views only keep positions into the text, they move them over the edits other views made
+// by reading the edit log, the same way the wrap layout and the highlighter catch up
+class Document
+{
+public:
+
+    using SizeType = std::wstring::size_type;
+
+    // text followed by one space the cursor can stand on after the last character
+    std::wstring m_text = std::wstring(1, L' ');
+
+    [[nodiscard]] std::wstring_view m_getText() const noexcept { return { m_text.c_str(), m_text.size() - 1 }; }
+
+    // version the text was read or written at, the document has unsaved changes at any other one
+    SizeType m_savedVersion = 0;
+
+    [[nodiscard]] bool m_isModified() const noexcept { return m_savedVersion != m_getVersion(); }
+
+    // bytes the file had when it was read or written at m_savedVersion, following the file continues after them
+    SizeType m_fileSize = 0;
+
+public:
+
+    // bytes taken by the text, the line index and the undo history
+    [[nodiscard]] SizeType m_getMemoryUsage() const noexcept;
+
+    // gives the unused capacity of the text and the line index back
+    void m_compact();
+
+    [[nodiscard]] bool m_isLoaded() const noexcept { return m_loaded; }
+
+    // frees the text and the indices until m_readRaw or m_onReset fills them again,
+    // the version, the undo history and the line states stay
+    void m_unload() noexcept;
+
+    // the text as it is in memory, utf-16 without a byte order mark
+    [[nodiscard]] bool m_writeRaw(const std::wstring& path) const noexcept;
+
+    // reads back what m_writeRaw wrote, the version does not change so views stay where they were
+    [[nodiscard]] bool m_readRaw(const std::wstring& path);
+
+public:
+
+    struct BufferEdit
+    {
+        SizeType m_index;
+        SizeType m_removed;
+        SizeType m_inserted;
+
+        // line of m_index before the edit and newline counts of the removed / inserted text
+        SizeType m_line;
+        SizeType m_removedLines;
+        SizeType m_insertedLines;
+    };
+
+    // increases with every edit
+    [[nodiscard]] SizeType m_getVersion() const noexcept { return m_editLogStart + m_editLog.size(); }
+
+    // returns nothing if the edits are not known anymore, the buffer is reloaded or the log is trimmed
+    [[nodiscard]] std::optional<std::vector<BufferEdit>> m_getEditsSince(const SizeType version) const;
+
+    // keep the line index, edit log and trigram index in sync, called before the text changes
+    // ( the line index and the log only need the inserted text, the trigram index must stop first )
+    void m_onInsert(const SizeType index, const std::wstring_view str);
+    void m_onErase (const SizeType start, const SizeType end) noexcept;
+
+    // called after the whole text is replaced
+    void m_onReset() noexcept;
+
+    // the text at the current version for a reader on another thread, the first snapshot copies the text
+    // into one piece and while any snapshot is held the document keeps the copy in step with its edits,
+    // so the next ones cost nothing, the copy is dropped at the first edit after the last one is gone
+    [[nodiscard]] TextSnapshot m_takeSnapshot();
+
+    // between these m_onInsert and m_onErase leave the snapshot copy alone, the replacements, given in the
+    // text before the first of them, are applied to it at the end in one rebuild
+    void m_beginReplacements() noexcept { m_replacing = true; }
+    void m_endReplacements(const std::vector<TextSnapshot::Replacement>& replacements);
+
+    // moves the ranges [start, start + size) found in the text at version over the edits made since,
+    // ranges an edit touched are dropped, returns false if the edits are not known anymore
+    [[nodiscard]] bool m_rebase(const SizeType version, std::vector<SizeType>& starts, const SizeType size) const;
+
+    // an edit no view made, like one of another editor, every view moves over it as over the edits of
+    // another view and the undo steps are moved over it too
+    void m_applyEdit(const SizeType index, const SizeType removed, const std::wstring_view inserted);
+
+    // edit with its text, m_removed is npos when the whole text was replaced by m_inserted
+    struct Change
+    {
+        SizeType m_index;
+        SizeType m_removed;
+
+        std::wstring m_inserted;
+    };
+
+    // edits of the views in the order they were made, recorded only for someone that mirrors the text,
+    // edits made through m_applyEdit are not recorded
+    bool m_recordChanges = false;
+    std::vector<Change> m_changes;
+
+    LineIndex m_lineIndex;
+
+    // dropped on every edit, it only helps while the text is unchanged
+    TrigramIndex m_trigramIndex;
+
+private:
+
+    std::deque<BufferEdit> m_editLog;
+    SizeType m_editLogStart = 0;
+
+    bool m_loaded = true;
+
+    // text size while it is unloaded
+    SizeType m_unloadedSize = 0;
+
+    // made by the first snapshot, dropped when no other snapshot is left or the text is replaced or unloaded
+    std::optional<TextSnapshot> m_snapshot;
+
+    bool m_replacing = false;
+
+    // drops the snapshot copy nobody reads anymore, true if it is still kept
+    [[nodiscard]] bool m_keepSnapshot() noexcept;
+
+    void m_logEdit(const BufferEdit& edit) noexcept;
+
+    // undo steps made before an edit of m_applyEdit, the ones it overlaps and everything before them are dropped
+    void m_moveRecordsOver(SizeType index, const SizeType removed, const SizeType inserted);
+
+public:
+
+    struct InsertionRecord
+    {
+        SizeType m_index;
+        SizeType m_size;
+    };
+
+    struct DeletionRecord
+    {
+        SizeType m_index;
+        std::wstring m_data;
+    };
+
+    // edits of all cursors, undone together
+    struct BatchRecord
+    {
+        struct Edit
+        {
+            // position and size of the inserted text after the batch
+            SizeType m_index;
+            SizeType m_size;
+
+            std::wstring m_removed;
+        };
+
+        std::vector<Edit> m_edits;
+    };
+
+    // undo steps of every view, the last one is undone first whichever view made it
+    std::deque<std::variant<InsertionRecord, DeletionRecord, BatchRecord>> m_records;
+
+public:
+
+    // matches of the last counted search per block of characters
+    struct MatchCount
+    {
+        std::wstring m_pattern;
+        TextSearch::Options m_options;
+
+        SizeType m_version  = std::wstring::npos;
+        SizeType m_textSize = 0;
+        SizeType m_total    = 0;
+
+        std::vector<SizeType> m_blockCounts;
+    };
+
+    MatchCount m_matchCount;
+
+    // line states do not depend on the view, the first view that draws after an edit moves them
+    SyntaxHighlighter m_highlighter;
+    SizeType m_highlightVersion = std::wstring::npos;
+};
+
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef DOCUMENT_LIST_H
+#define DOCUMENT_LIST_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <cstddef>
+
+#include "text_editor.h"
+
+
+// documents open in the editor, the shown one is in the editor passed to the calls
+// and every other one keeps its view ( cursor, selection, scroll position ) here
+//
+// while the loaded documents take more than the budget, the ones shown least recently are unloaded:
+// unmodified files are read from disk again when they are shown, modified text is compacted first
+// and then spilled to a temp file that is read back as it is
+class DocumentList
+{
+public:
+
+    using SizeType = std::size_t;
+
+    static constexpr SizeType s_defaultBudget = SizeType(512) << 20;
+
+    DocumentList() = default;
+    ~DocumentList();
+
+    DocumentList(const DocumentList&) = delete;
+    DocumentList& operator= (const DocumentList&) = delete;
+
+    // bytes the loaded documents may take, the shown one is never unloaded
+    SizeType m_budget = s_defaultBudget;
+
+    // the document shown in editor becomes the only entry, path is empty for an untitled one
+    void m_reset(const std::wstring_view path);
+
+    [[nodiscard]] SizeType m_getCount () const noexcept { return m_entries.size(); }
+    [[nodiscard]] SizeType m_getActive() const noexcept { return m_active; }
+
+    [[nodiscard]] std::wstring_view m_getPath(const SizeType entry) const noexcept { return m_entries[entry].m_path; }
+
+    [[nodiscard]] std::optional<SizeType> m_find(const std::wstring_view path) const;
+
+    // reads path into a new entry and shows it, nothing changes if it can not be read
+    [[nodiscard]] bool m_open(const std::wstring_view path, TextEditor& editor);
+
+    // shows view, the file at path read by the caller, as a new entry
+    [[nodiscard]] bool m_add(const std::wstring_view path, TextEditor view, TextEditor& editor);
+
+    // the shown document keeps its view here and entry is loaded into editor,
+    // returns false if its text can not be read back
+    [[nodiscard]] bool m_show(const SizeType entry, TextEditor& editor);
+
+    // closes the shown document and shows the one before it, an empty untitled one replaces the last one
+    void m_closeActive(TextEditor& editor);
+
+    // the shown document is saved under a new name
+    void m_setActivePath(const std::wstring_view path) { m_entries[m_active].m_path = path; }
+
+private:
+
+    enum class State
+    {
+        Loaded,
+        Dropped, // read from m_path again
+        Spilled  // read from m_spillPath again
+    };
+
+    struct Entry
+    {
+        std::wstring m_path;
+
+        // moved into the editor while the entry is shown
+        TextEditor m_view;
+
+        State m_state = State::Loaded;
+
+        std::wstring m_spillPath;
+
+        // version of the text in the spill file, it is written again only after an edit
+        SizeType m_spillVersion = std::wstring::npos;
+
+        SizeType m_lastShown = 0;
+    };
+
+    std::vector<Entry> m_entries;
+
+    SizeType m_active = 0;
+
+    SizeType m_showCounter = 0;
+
+    [[nodiscard]] bool m_load(Entry& entry);
+
+    [[nodiscard]] bool m_unload(Entry& entry);
+
+    // unloads the documents shown least recently until the loaded ones fit in the budget
+    void m_applyBudget(const TextEditor& editor);
+
+    void m_removeSpillFile(Entry& entry) noexcept;
+
+    // a new empty file in the temp directory, empty if it can not be created
+    [[nodiscard]] static std::wstring s_createSpillFile();
+};
+
+
+#endif
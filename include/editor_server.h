@@ -0,0 +1,156 @@
+#ifndef EDITOR_SERVER_H
+#define EDITOR_SERVER_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "console_text_editor.h"
+#include "local_socket.h"
+
+// keeps documents loaded between runs of the editor,
+//
+//   e --server [--memory=<MB>]
+//
+// an editor started while the server runs attaches to it through a unix domain socket, the server runs
+// a headless ConsoleTextEditor for it and sends the cells that changed, the client only forwards its input
+//
+// a client that opens a file the server has loaded gets another view of the same document, the text
+// and the line index are not read again. one thread handles every client, so the edits of clients sharing
+// a document are applied one after another and each view moves over the edits of the others
+class EditorServer
+{
+public:
+
+    using SizeType = std::size_t;
+
+    static constexpr const char* s_socketName = "e-server";
+
+    // entry point of the server mode, returns the process exit code
+    [[nodiscard]] static int s_main(const int argc, const wchar_t* argv[]);
+
+    EditorServer() = default;
+
+    EditorServer(const EditorServer&) = delete;
+    EditorServer& operator= (const EditorServer&) = delete;
+
+    // bytes the documents no client shows may take, modified ones are kept until a client saves them
+    SizeType m_budget = DocumentList::s_defaultBudget;
+
+    [[nodiscard]] bool m_listen(const std::string& path) noexcept;
+
+    // serves clients until the process is ended
+    void m_run();
+
+public:
+
+    // client and server run on the same machine, the structs are sent as they are
+
+    enum MessageType : std::uint32_t
+    {
+        Message_Hello,  // client, HelloMessage and the absolute path of the file, empty for an untitled document
+        Message_Input,  // client, InputMessage and the INPUT_RECORDs read from its console
+        Message_Resize, // client, ResizeMessage
+        Message_Frame,  // server, FrameMessage and its runs
+        Message_Title   // server, the console title
+    };
+
+    struct HelloMessage
+    {
+        COORD m_size;
+    };
+
+    struct InputMessage
+    {
+        // more events were waiting in the client's console, a paste may continue in the next message
+        std::uint32_t m_more;
+    };
+
+    struct ResizeMessage
+    {
+        COORD m_size;
+    };
+
+    struct FrameMessage
+    {
+        // a frame of another size is one the client has not resized to yet
+        COORD m_size;
+
+        COORD m_cursorPos;
+        std::uint32_t m_cursorVisible;
+
+        std::uint32_t m_runCount;
+    };
+
+    // followed by m_size characters and then m_size attributes
+    struct FrameRun
+    {
+        std::uint32_t m_index;
+        std::uint32_t m_size;
+    };
+
+private:
+
+    // cells the client shows, the next frame only carries the ones that differ
+    struct Session
+    {
+        LocalSocket m_socket;
+
+        // made when the hello message arrives
+        std::unique_ptr<ConsoleTextEditor> m_editor;
+
+        std::vector<wchar_t> m_sentChars;
+        std::vector<WORD>    m_sentAttributes;
+
+        COORD m_sentSize      = {};
+        COORD m_sentCursorPos = {};
+        bool  m_sentCursorVisible = false;
+
+        std::wstring m_sentTitle;
+
+        bool m_closed = false;
+    };
+
+    // view of a loaded document that no client moves, clients get copies of it
+    struct CachedDocument
+    {
+        std::wstring m_path;
+
+        TextEditor m_view;
+
+        SizeType m_lastAttached = 0;
+    };
+
+    // unchanged cells between two changed ones that are sent along instead of starting another run
+    static constexpr SizeType s_runGap = 8;
+
+    // idle work of the editors, like highlighting in the background, runs between the waits
+    static constexpr long s_waitTimeout = 15;
+
+    LocalSocket m_listener;
+
+    std::vector<std::unique_ptr<Session>> m_sessions;
+
+    std::vector<CachedDocument> m_documents;
+
+    SizeType m_attachCounter = 0;
+
+    void m_acceptClients();
+
+    [[nodiscard]] bool m_handleMessage(Session& session, const LocalSocket::Message& message);
+
+    [[nodiscard]] bool m_attach(Session& session, const HelloMessage& hello, const std::wstring_view path);
+
+    // the loaded view of path, reads the file if no client had it open, nullptr if it can not be read
+    [[nodiscard]] const TextEditor* m_loadDocument(const std::wstring_view path);
+
+    [[nodiscard]] bool m_sendFrame(Session& session) const;
+
+    // drops the unmodified documents no client shows, attached least recently first, until the rest fit
+    void m_applyBudget();
+};
+
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef FILE_FOLLOWER_H
+#define FILE_FOLLOWER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+#include "console.h"
+
+// reads what another process appends to a file, like tail -f
+class FileFollower
+{
+public:
+
+    using SizeType = std::uint64_t;
+
+    // bytes read per m_poll call, a fast growing file is caught up over several calls
+    static constexpr SizeType s_readSize = 1 << 22;
+
+    enum class Result
+    {
+        None,
+        Appended,
+
+        // the file got shorter, it was truncated or replaced
+        Truncated,
+        Failed
+    };
+
+    FileFollower() = default;
+    ~FileFollower();
+
+    FileFollower(const FileFollower&) = delete;
+    FileFollower& operator= (const FileFollower&) = delete;
+
+    // m_poll returns what the file holds after its first offset bytes,
+    // the file is reported as truncated if it is shorter than that
+    [[nodiscard]] bool m_start(const std::wstring_view filePath, const SizeType offset = 0);
+
+    void m_stop() noexcept;
+
+    [[nodiscard]] bool m_isFollowing() const noexcept { return m_file != INVALID_HANDLE_VALUE; }
+
+    // bytes of the file the text returned so far was decoded from
+    [[nodiscard]] SizeType m_getOffset() const noexcept { return m_offset - m_pending.size(); }
+
+    // decodes new utf-8 bytes into text, cheap when nothing changed
+    [[nodiscard]] Result m_poll(std::wstring& text);
+
+private:
+
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+
+    // signaled when a file in the directory changes
+    HANDLE m_notification = INVALID_HANDLE_VALUE;
+
+    SizeType m_offset = 0;
+
+    // size seen by the last check, reads continue without a notification until they reach it
+    SizeType m_knownSize = 0;
+
+    // an incomplete utf-8 sequence at the end of the last read
+    std::vector<char> m_pending;
+    std::vector<char> m_bytes;
+
+    // writers that keep the file open do not always trigger the notification
+    std::chrono::steady_clock::time_point m_lastSizeCheck;
+
+    static constexpr auto s_sizeCheckInterval = std::chrono::milliseconds(250);
+
+    [[nodiscard]] bool m_hasChanged() noexcept;
+};
+
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef LINE_INDEX_H
+#define LINE_INDEX_H
+
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+
+// sorted positions of every newline character of a text
+//
+// positions after the last edit point are stored without the pending shift of that edit ( m_gapDelta ),
+// so repeated edits around the same place only touch the entries between the old and new edit points
+class LineIndex
+{
+public:
+
+    using SizeType = std::wstring_view::size_type;
+
+    void m_build(const std::wstring_view text);
+
+    [[nodiscard]] SizeType m_getLineCount() const noexcept { return m_newLines.size() + 1; }
+    [[nodiscard]] SizeType m_getTextSize () const noexcept { return m_textSize; }
+
+    [[nodiscard]] SizeType m_getMemoryUsage() const noexcept { return m_newLines.capacity() * sizeof(SizeType); }
+
+    void m_shrinkToFit() { m_newLines.shrink_to_fit(); }
+
+    // index of the first character of line
+    [[nodiscard]] SizeType m_getLineStart(const SizeType line) const noexcept;
+
+    // index of the newline character that ends line or text size for the last line
+    [[nodiscard]] SizeType m_getLineEnd(const SizeType line) const noexcept;
+
+    // line that contains index
+    [[nodiscard]] SizeType m_getLineOf(const SizeType index) const noexcept;
+
+    // both must be called before the text changes, they return the inserted / erased newline count
+    SizeType m_onInsert(const SizeType index, const std::wstring_view str);
+    SizeType m_onErase (const SizeType start, const SizeType end) noexcept;
+
+private:
+
+    std::vector<SizeType> m_newLines;
+
+    SizeType m_gapIndex = 0;
+    SizeType m_gapDelta = 0; // wraps around for negative shifts
+
+    SizeType m_textSize = 0;
+
+    [[nodiscard]] SizeType m_getNewLine(const SizeType i) const noexcept
+    {
+        return i < m_gapIndex ? m_newLines[i] : m_newLines[i] + m_gapDelta;
+    }
+
+    void m_moveGap(const SizeType gapIndex) noexcept;
+};
+
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef LINE_INDEX_CACHE_H
+#define LINE_INDEX_CACHE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+#include "console.h"
+
+// newline counts per block of a file saved in the user's cache directory, so opening the same
+// file again does not have to read all of it before line numbers work
+class LineIndexCache
+{
+public:
+
+    using SizeType = std::uint64_t;
+
+    // bumped whenever the file layout changes, older files are ignored
+    static constexpr std::uint32_t s_version = 1;
+
+    // what has to match for the counts to belong to the file
+    struct Key
+    {
+        // full path, lower case
+        std::wstring m_path;
+
+        SizeType m_fileSize    = 0;
+        SizeType m_writeTime   = 0;
+        SizeType m_blockSize   = 0;
+
+        // hash of a few samples spread over the file, catches changes that keep size and time
+        SizeType m_contentHash = 0;
+    };
+
+    [[nodiscard]] static SizeType s_hash(const char* data, const std::size_t size, const SizeType seed = 14695981039346656037ull) noexcept;
+
+    [[nodiscard]] static std::wstring s_getFullPath(const std::wstring_view filePath);
+
+    // maps the cache file and copies the counts if everything in its header matches the key
+    [[nodiscard]] static bool s_load(const Key& key, std::vector<SizeType>& lineCounts);
+
+    // writes a temporary file and renames it over the old one, readers never see half a file
+    [[nodiscard]] static bool s_save(const Key& key, const std::vector<SizeType>& lineCounts);
+
+private:
+
+    // %LOCALAPPDATA%\e\line-index\<hash of the path>.idx, empty if there is no such directory
+    [[nodiscard]] static std::wstring s_getCachePath(const Key& key, const bool createDirectory);
+};
+
+
+#endif
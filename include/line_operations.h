@@ -0,0 +1,51 @@
+#ifndef LINE_OPERATIONS_H
+#define LINE_OPERATIONS_H
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <optional>
+
+#include "text_search.h"
+
+// whole line commands, lines are views into the text and are never copied
+class LineOperations
+{
+public:
+
+    enum class Type
+    {
+        Sort,
+        SortNumeric,
+        Unique,
+        Keep,
+        Drop,
+        Reverse
+    };
+
+    struct Command
+    {
+        Type m_type;
+        std::wstring_view m_argument;
+    };
+
+    // "sort", "sort -n", "unique", "keep <text>", "drop <text>" or "reverse"
+    [[nodiscard]] static std::optional<Command> s_parseCommand(std::wstring_view str) noexcept;
+
+    // search is only used by Keep and Drop, sorts are stable
+    static void s_apply(const Type type, std::vector<std::wstring_view>& lines, const TextSearch& search);
+
+    [[nodiscard]] static std::wstring s_joinLines(const std::vector<std::wstring_view>& lines);
+
+private:
+
+    // leading number of the line, lines without one sort first
+    [[nodiscard]] static double s_getNumericKey(const std::wstring_view line) noexcept;
+
+    static void s_sortNumeric(std::vector<std::wstring_view>& lines);
+    static void s_removeDuplicates(std::vector<std::wstring_view>& lines);
+    static void s_filter(std::vector<std::wstring_view>& lines, const TextSearch& search, const bool keepMatches);
+};
+
+
+#endif
@@ -0,0 +1,112 @@
+#ifndef LOCAL_SOCKET_H
+#define LOCAL_SOCKET_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <optional>
+
+
+// unix domain stream socket of the editor server and its clients, messages are a type and a size
+// followed by the data
+//
+// connected sockets never block, one thread serves many of them: m_send queues what the other side does not
+// take at once and m_flush sends more of it whenever s_wait says the socket can take it
+//
+// winsock2.h has to come before windows.h, so only local_socket.cpp includes it and the handle is kept as an integer
+class LocalSocket
+{
+public:
+
+    using Handle = std::uintptr_t;
+
+    static constexpr Handle s_invalidHandle = ~Handle(0);
+
+    // a message that claims to be bigger is taken as a broken connection
+    static constexpr std::size_t s_maxMessageSize = std::size_t(1) << 30;
+
+    // m_send fails while more than this is queued, the other side stopped reading
+    static constexpr std::size_t s_maxBacklog = std::size_t(64) << 20;
+
+    struct Message
+    {
+        std::uint32_t m_type;
+
+        std::vector<char> m_data;
+    };
+
+    LocalSocket() = default;
+    ~LocalSocket();
+
+    LocalSocket(const LocalSocket&) = delete;
+    LocalSocket& operator= (const LocalSocket&) = delete;
+
+    LocalSocket(LocalSocket&& other) noexcept;
+    LocalSocket& operator= (LocalSocket&& other) noexcept;
+
+    // winsock has to be started once before any socket is made
+    [[nodiscard]] static bool s_startup() noexcept;
+
+    // socket file called name in the temp directory
+    [[nodiscard]] static std::string s_getPath(const std::string& name);
+
+    // invalid when no server listens at path
+    [[nodiscard]] static LocalSocket s_connect(const std::string& path) noexcept;
+
+    // a socket file left by a server that did not exit is replaced, invalid when a server is already listening
+    [[nodiscard]] static LocalSocket s_listen(const std::string& path) noexcept;
+
+    // blocks until one of sockets has something to read, one with a backlog can send again or timeout milliseconds pass
+    static void s_wait(const std::vector<const LocalSocket*>& sockets, const long timeout) noexcept;
+
+    [[nodiscard]] bool m_isValid() const noexcept { return m_handle != s_invalidHandle; }
+
+    void m_close() noexcept;
+
+    // a waiting connection of a listening socket, invalid if there is none
+    [[nodiscard]] LocalSocket m_accept() const noexcept;
+
+    // sends what the socket takes now and queues the rest, false if the connection is broken or the backlog is too big
+    [[nodiscard]] bool m_send(const std::uint32_t type, const void* data, const std::size_t size);
+
+    // sends more of the backlog, false if the connection is broken
+    [[nodiscard]] bool m_flush() noexcept;
+
+    [[nodiscard]] std::size_t m_getBacklog() const noexcept { return m_outgoing.size() - m_sendOffset; }
+
+    // reads what has arrived without waiting, returns false once the other side has closed
+    [[nodiscard]] bool m_receive();
+
+    // next complete message of what m_receive read, a message bigger than s_maxMessageSize closes the socket
+    [[nodiscard]] std::optional<Message> m_takeMessage();
+
+private:
+
+    explicit LocalSocket(const Handle handle) noexcept : m_handle(handle) {}
+
+    Handle m_handle = s_invalidHandle;
+
+    std::vector<char> m_received;
+
+    // messages before it are taken already
+    std::size_t m_readOffset = 0;
+
+    // queued messages, the bytes before m_sendOffset are sent already
+    std::vector<char> m_outgoing;
+    std::size_t m_sendOffset = 0;
+
+    struct Header
+    {
+        std::uint32_t m_type;
+        std::uint32_t m_size;
+    };
+
+    [[nodiscard]] bool m_isReadable(const long timeout) const noexcept;
+
+    // false if the mode could not be set, the socket is closed then
+    [[nodiscard]] bool m_setNonBlocking() noexcept;
+};
+
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+#include "console.h"
+
+// bytes of a file mapped read only, overwritten bytes are kept in copies of their pages
+// until m_save writes back just those pages
+class MappedFile
+{
+public:
+
+    using SizeType = std::uint64_t;
+
+    static constexpr SizeType s_pageSize = 1 << 12;
+
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator= (const MappedFile&) = delete;
+
+    [[nodiscard]] bool m_open(const std::wstring_view filePath);
+
+    void m_close() noexcept;
+
+    [[nodiscard]] SizeType m_getSize() const noexcept { return m_size; }
+
+    // offset has to be less than the size
+    [[nodiscard]] std::uint8_t m_getByte(const SizeType offset) const noexcept;
+
+    void m_setByte(const SizeType offset, const std::uint8_t value);
+
+    // true when the byte differs from the one on disk
+    [[nodiscard]] bool m_isChanged(const SizeType offset) const noexcept;
+
+    // copies [offset, offset + size) with the changes applied, size is clamped to the end
+    void m_read(const SizeType offset, const SizeType size, std::vector<std::uint8_t>& bytes) const;
+
+    [[nodiscard]] bool m_isModified() const noexcept { return !m_dirtyPages.empty(); }
+
+    // writes the changed pages in place
+    [[nodiscard]] bool m_save();
+
+private:
+
+    std::wstring m_filePath;
+
+    HANDLE m_file    = INVALID_HANDLE_VALUE;
+    HANDLE m_mapping = nullptr;
+
+    const std::uint8_t* m_data = nullptr;
+
+    SizeType m_size = 0;
+
+    std::unordered_map<SizeType, std::vector<std::uint8_t>> m_dirtyPages;
+};
+
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef OCCUR_LIST_H
+#define OCCUR_LIST_H
+
+#include "text_editor.h"
+
+// list of every line of an editor that contains the search term,
+// only line numbers are stored and only the visible rows are drawn
+class OccurList
+{
+public:
+
+    using SizeType = TextEditor::SizeType;
+
+    void m_initList(const SizeType width, const SizeType height,
+        const SizeType startX = 0, const SizeType startY = 0) noexcept;
+
+    // incremental when only edits happened since the last update
+    void m_update(const TextEditor& editor, const TextSearch& search);
+
+    void m_updateConsole(Console& console, const TextEditor& editor, const TextSearch& search) noexcept;
+
+    void m_handleEvents(const KEY_EVENT_RECORD& event) noexcept;
+
+    // selects the row at console position y
+    void m_selectRowAt(const SizeType y) noexcept;
+
+    [[nodiscard]] std::optional<SizeType> m_getSelectedLine() const noexcept;
+
+    [[nodiscard]] SizeType m_getLineCount() const noexcept { return m_lines.size(); }
+
+    [[nodiscard]] constexpr bool m_isInsidePoint(const SizeType x, const SizeType y) const noexcept
+    {
+        return x >= m_drawStartX && y >= m_drawStartY && x < m_drawStartX + m_width && y < m_drawStartY + m_height;
+    }
+
+public:
+
+    SizeType m_drawStartX = 0;
+    SizeType m_drawStartY = 0;
+
+    SizeType m_width  = 0;
+    SizeType m_height = 0;
+
+    COORD m_cursorPos = {};
+
+private:
+
+    // sorted line numbers of the matches, like LineIndex the entries from m_gapIndex on are stored
+    // without the line shift of the edits after them ( m_gapDelta ), an edit only moves the gap
+    std::vector<SizeType> m_lines;
+
+    SizeType m_gapIndex = 0;
+    SizeType m_gapDelta = 0; // wraps around for negative shifts
+
+    SizeType m_selectedRow = 0;
+    SizeType m_startRow    = 0;
+
+    std::wstring m_pattern;
+    TextSearch::Options m_options;
+
+    SizeType m_version = std::wstring::npos;
+
+    static constexpr WORD s_listColor     = Console::s_foregroundWhite | BACKGROUND_BLUE;
+    static constexpr WORD s_selectedColor = BACKGROUND_RED | BACKGROUND_GREEN | BACKGROUND_BLUE;
+    static constexpr WORD s_matchColor    = BACKGROUND_RED | BACKGROUND_GREEN;
+
+private:
+
+    [[nodiscard]] SizeType m_getLine(const SizeType i) const noexcept
+    {
+        return i < m_gapIndex ? m_lines[i] : m_lines[i] + m_gapDelta;
+    }
+
+    // index of the first entry that is not below line / above line
+    [[nodiscard]] SizeType m_lowerBound(const SizeType line) const noexcept;
+    [[nodiscard]] SizeType m_upperBound(const SizeType line) const noexcept;
+
+    void m_moveGap(const SizeType gapIndex) noexcept;
+
+    // replaces the entries [first, last) by lines
+    void m_replaceLines(const SizeType first, const SizeType last, const std::vector<SizeType>& lines);
+
+    void m_applyEdits(const TextEditor& editor, const TextSearch& search, const std::vector<TextEditor::BufferEdit>& edits);
+
+    // appends matching lines in [firstLine, lastLine] to result
+    static void s_scanLines(const TextEditor& editor, const TextSearch& search,
+        const SizeType firstLine, const SizeType lastLine, std::vector<SizeType>& result);
+
+    constexpr void m_keepSelectionVisible() noexcept
+    {
+        if (m_selectedRow < m_startRow) m_startRow = m_selectedRow;
+        else if (m_height > 0 && m_selectedRow >= m_startRow + m_height) m_startRow = m_selectedRow - m_height + 1;
+    }
+};
+
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef PAGED_FILE_H
+#define PAGED_FILE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+
+#include "console.h"
+#include "line_index_cache.h"
+
+// read only view of a file of any size, only a few recently used pages are kept in memory
+// and a background thread counts newlines per block to build a sparse line index
+class PagedFile
+{
+public:
+
+    using SizeType = std::uint64_t;
+
+    static constexpr SizeType s_pageSize    = 1 << 16;
+    static constexpr SizeType s_cachedPages = 32;
+
+    // one line index entry per block
+    static constexpr SizeType s_indexBlockSize = 1 << 20;
+
+    // longer lines are split, scanning for a line start never reads more than this
+    static constexpr SizeType s_maxLineSize = 1 << 20;
+
+    // smaller files are indexed faster than a cache file could be found and checked
+    static constexpr SizeType s_minCachedSize = 1 << 25;
+
+    // samples hashed for the cache key
+    static constexpr SizeType s_cacheSampleCount = 16;
+    static constexpr SizeType s_cacheSampleSize  = 1 << 12;
+
+    PagedFile() = default;
+    ~PagedFile();
+
+    PagedFile(const PagedFile&) = delete;
+    PagedFile& operator= (const PagedFile&) = delete;
+
+    [[nodiscard]] bool m_open(const std::wstring_view filePath);
+
+    void m_close() noexcept;
+
+    [[nodiscard]] SizeType m_getSize() const noexcept { return m_size; }
+
+    // start of the line that contains offset
+    [[nodiscard]] SizeType m_getLineStart(const SizeType offset);
+
+    // start of the line after the one that contains offset, file size for the last line
+    [[nodiscard]] SizeType m_getNextLineStart(const SizeType offset);
+
+    // decodes the utf-8 bytes of [start, end) into str, newlines are not included
+    void m_readText(const SizeType start, const SizeType end, std::wstring& str);
+
+public:
+
+    [[nodiscard]] bool m_isIndexComplete() const noexcept { return m_indexedBlocks.load(std::memory_order_acquire) == m_lineCounts.size(); }
+
+    // indexed part of the file between 0 and 1
+    [[nodiscard]] double m_getIndexProgress() const noexcept;
+
+    // line count of the whole file once the index is complete
+    [[nodiscard]] std::optional<SizeType> m_getLineCount() const noexcept;
+
+    // 0-based line number of the line that starts at offset, nothing if the index has not reached it
+    [[nodiscard]] std::optional<SizeType> m_getLineNumber(const SizeType offset);
+
+    // start of a 0-based line, estimated from the average line length so far when the index has not
+    // reached it, second is false for estimates
+    [[nodiscard]] std::pair<SizeType, bool> m_findLine(const SizeType line);
+
+private:
+
+    struct Page
+    {
+        SizeType m_index = 0;
+        SizeType m_lastUse = 0;
+
+        std::vector<char> m_data;
+    };
+
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+
+    std::wstring m_filePath;
+
+    SizeType m_size = 0;
+
+    std::vector<Page> m_pages;
+    SizeType m_useCounter = 0;
+
+    // returns the cached page or reads it, evicting the least recently used one
+    [[nodiscard]] const Page& m_getPage(const SizeType pageIndex);
+
+    // newline count before the end of every block, written by the index thread only
+    std::vector<SizeType> m_lineCounts;
+
+    std::atomic<SizeType> m_indexedBlocks { 0 };
+    std::atomic<bool> m_cancelIndex { false };
+
+    std::thread m_indexThread;
+
+    void m_buildIndex() noexcept;
+
+    LineIndexCache::Key m_cacheKey;
+
+    // false for small files and when the key could not be read
+    bool m_useCache = false;
+
+    [[nodiscard]] bool m_makeCacheKey();
+
+    [[nodiscard]] static bool s_readAt(const HANDLE file, const SizeType offset, char* data, const DWORD size) noexcept;
+};
+
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef PROCESS_FILTER_H
+#define PROCESS_FILTER_H
+
+#include <string>
+#include <string_view>
+#include <optional>
+#include <thread>
+#include <atomic>
+
+#include "console.h"
+#include "text_snapshot.h"
+
+// runs a shell command with text streamed to its standard input and collects its standard output,
+// writing and reading happen at the same time so the command never waits on a full pipe
+class ProcessFilter
+{
+public:
+
+    using SizeType = std::wstring_view::size_type;
+
+    // characters converted and written at once, input is never copied as a whole
+    static constexpr SizeType s_chunkSize = 1 << 16;
+
+    ProcessFilter() = default;
+    ~ProcessFilter();
+
+    ProcessFilter(const ProcessFilter&) = delete;
+    ProcessFilter& operator= (const ProcessFilter&) = delete;
+
+    // the characters [first, last) of input are written, text is exchanged as utf-8
+    [[nodiscard]] bool m_start(const std::wstring_view command, TextSnapshot input, const SizeType first, const SizeType last);
+
+    // kills the command and everything it started, m_finish returns nothing afterwards
+    void m_cancel() noexcept;
+
+    // waits for the command, returns its output if it exited with zero
+    [[nodiscard]] std::optional<std::wstring> m_finish();
+
+    [[nodiscard]] bool m_isRunning  () const noexcept { return m_process != nullptr; }
+    [[nodiscard]] bool m_isFinished () const noexcept { return m_outputDone.load(std::memory_order_acquire); }
+    [[nodiscard]] bool m_isCancelled() const noexcept { return m_cancelled.load(std::memory_order_relaxed); }
+
+    [[nodiscard]] SizeType m_getInputSize   () const noexcept { return m_inputSize; }
+    [[nodiscard]] SizeType m_getWrittenSize () const noexcept { return m_written.load(std::memory_order_relaxed); }
+    [[nodiscard]] SizeType m_getOutputBytes () const noexcept { return m_read.load(std::memory_order_relaxed); }
+
+private:
+
+    HANDLE m_process     = nullptr;
+    HANDLE m_job         = nullptr;
+    HANDLE m_inputWrite  = nullptr;
+    HANDLE m_outputRead  = nullptr;
+
+    std::thread m_writer;
+    std::thread m_reader;
+
+    std::atomic<SizeType> m_written { 0 };
+    std::atomic<SizeType> m_read    { 0 };
+
+    std::atomic<bool> m_cancelled  { false };
+    std::atomic<bool> m_outputDone { false };
+
+    SizeType m_inputSize = 0;
+
+    std::wstring m_output;
+
+    void m_writeInput(const TextSnapshot input, const SizeType first) noexcept;
+    void m_readOutput() noexcept;
+
+    void m_closeHandles() noexcept;
+};
+
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef SCRIPT_RUNNER_H
+#define SCRIPT_RUNNER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+
+#include "text_editor.h"
+
+// runs an edit script on files without a console, one TextEditor per file,
+//
+//   e --script <script file> [--jobs <count>] <files...>
+//
+// every file is opened before the script runs, one command per line, arguments
+// are the rest of the line with \n, \t and \\ escapes, lines starting with # are comments
+//
+//   open <path>           reads another file into the editor
+//   save [path]           writes the opened file or path
+//   find <text>           selects the next match after the cursor
+//   replace <text>        replaces the selection
+//   replace-all <text>    replaces every match of the last find
+//   select all
+//   select lines <first> [last]
+//   delete                deletes the selection
+//   ignore-case on|off
+//   whole-word on|off
+//   sort, sort -n, unique, keep <text>, drop <text>, reverse
+class ScriptRunner
+{
+public:
+
+    using SizeType = TextEditor::SizeType;
+
+    // entry point of the headless mode, returns the process exit code
+    [[nodiscard]] static int s_main(const int argc, const wchar_t* argv[]);
+
+    [[nodiscard]] bool m_load(const std::wstring_view scriptPath);
+
+    // runs the script on every file with threadCount files at once, returns the number of failed files
+    [[nodiscard]] SizeType m_run(const std::vector<std::wstring_view>& files, const unsigned threadCount) const;
+
+private:
+
+    enum class Type
+    {
+        Open,
+        Save,
+        Find,
+        Replace,
+        ReplaceAll,
+        SelectAll,
+        SelectLines,
+        Delete,
+        IgnoreCase,
+        WholeWord,
+        LineOperation
+    };
+
+    struct Command
+    {
+        Type m_type;
+        std::wstring m_argument;
+
+        LineOperations::Type m_lineOperation = LineOperations::Type::Sort;
+
+        // 1-based lines of SelectLines
+        SizeType m_firstLine = 0;
+        SizeType m_lastLine  = 0;
+
+        // line in the script for error messages
+        SizeType m_scriptLine = 0;
+    };
+
+    std::vector<Command> m_commands;
+
+    // false when any command fails, error describes the failing one
+    [[nodiscard]] bool m_runFile(const std::wstring_view path, std::wstring& error) const;
+
+    [[nodiscard]] static std::optional<Command> s_parseLine(const std::wstring_view line);
+
+    [[nodiscard]] static std::wstring s_unescape(const std::wstring_view str);
+
+    [[nodiscard]] static std::optional<bool> s_parseSwitch(const std::wstring_view str) noexcept;
+};
+
+
+#endif
@@ -0,0 +1,183 @@
+#ifndef SEQUENCE_CRDT_H
+#define SEQUENCE_CRDT_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+#include <list>
+#include <map>
+#include <optional>
+#include <utility>
+
+
+// replicated text of a collaboration session, an RGA sequence: every character has an id that never
+// changes, an insertion names the character it goes after and removed characters stay as tombstones,
+// so operations of different editors can be applied in any order that keeps each one after the ones it saw
+//
+// characters typed one after another get consecutive ids and are kept as one run, an item holds a run
+// and the items are kept in blocks, a document costs memory per run and not per character
+class SequenceCrdt
+{
+public:
+
+    using SizeType = std::size_t;
+    using ClientId = std::uint32_t;
+    using Clock    = std::uint64_t;
+
+    // lamport clock of the editor that typed the character, ties are broken by the editor
+    struct Id
+    {
+        Clock    m_clock  = 0;
+        ClientId m_client = 0;
+
+        [[nodiscard]] bool m_isNull() const noexcept { return m_clock == 0; }
+
+        [[nodiscard]] Id m_plus(const SizeType offset) const noexcept { return { m_clock + offset, m_client }; }
+
+        [[nodiscard]] bool operator== (const Id& other) const noexcept { return m_clock == other.m_clock && m_client == other.m_client; }
+        [[nodiscard]] bool operator!= (const Id& other) const noexcept { return !(*this == other); }
+
+        [[nodiscard]] bool operator< (const Id& other) const noexcept
+        {
+            return m_clock != other.m_clock ? m_clock < other.m_clock : m_client < other.m_client;
+        }
+    };
+
+    // m_text gets the ids m_id, m_id + 1, ... and goes after m_origin, a null origin is the start of the text
+    struct Insertion
+    {
+        Id m_id;
+        Id m_origin;
+
+        std::wstring m_text;
+    };
+
+    // the characters with the ids m_id ... m_id + m_size - 1
+    struct Removal
+    {
+        Id m_id;
+        SizeType m_size;
+    };
+
+    using Operation = std::variant<Insertion, Removal>;
+
+    // what an operation did to the visible text, m_inserted points into the operation
+    struct Edit
+    {
+        SizeType m_index;
+        SizeType m_removed;
+
+        std::wstring_view m_inserted;
+    };
+
+    explicit SequenceCrdt(const ClientId client) noexcept : m_client(client) {}
+
+    [[nodiscard]] SizeType m_getSize() const noexcept { return m_size; }
+
+    [[nodiscard]] std::wstring m_getText() const;
+
+public:
+
+    // local edits, return the operations the other editors have to apply
+
+    [[nodiscard]] Insertion m_insert(const SizeType index, const std::wstring_view text);
+
+    [[nodiscard]] std::vector<Removal> m_erase(const SizeType start, const SizeType end);
+
+    // an operation of another editor, edits get what changed in the visible text in the order it has to
+    // be applied, false if the characters it names are unknown
+    [[nodiscard]] bool m_apply(const Operation& operation, std::vector<Edit>& edits);
+
+public:
+
+    // the editors run on the same machine, ids and text are written as they are in memory
+
+    static void s_write(const Operation& operation, std::vector<char>& data);
+
+    // nothing if data is not a sequence of written operations
+    [[nodiscard]] static std::optional<std::vector<Operation>> s_read(const std::vector<char>& data);
+
+    // adds operation to the ones not sent yet, text typed or deleted character by character
+    // continues the last operation instead of adding one per character
+    static void s_append(std::vector<Operation>& operations, Operation operation);
+
+private:
+
+    static constexpr SizeType s_blockSize = 64;
+
+    // a run of characters of one editor with consecutive ids, the text is freed once they are removed
+    struct Item
+    {
+        Id m_id;
+        SizeType m_size;
+
+        bool m_removed = false;
+
+        std::wstring m_text;
+
+        [[nodiscard]] bool m_contains(const Id& id) const noexcept
+        {
+            return id.m_client == m_id.m_client && id.m_clock >= m_id.m_clock && id.m_clock < m_id.m_clock + m_size;
+        }
+    };
+
+    // visible characters are counted per block, an index is found by skipping whole blocks
+    struct Block
+    {
+        std::vector<Item> m_items;
+
+        SizeType m_visible = 0;
+    };
+
+    using BlockIterator = std::list<Block>::iterator;
+
+    struct Position
+    {
+        BlockIterator m_block;
+        SizeType m_item;
+    };
+
+    ClientId m_client;
+
+    // highest clock seen, the next local character gets a higher one
+    Clock m_clock = 0;
+
+    // never empty, an empty text is one empty block
+    std::list<Block> m_blocks = std::list<Block>(1);
+
+    // block of every item by the id of its first character
+    std::map<std::pair<ClientId, Clock>, BlockIterator> m_locations;
+
+    SizeType m_size = 0;
+
+    // item holding id, nothing if it is unknown
+    [[nodiscard]] std::optional<Position> m_find(const Id& id);
+
+    // item holding visible character index and the offset of the character in it
+    [[nodiscard]] std::pair<Position, SizeType> m_findCharacter(SizeType index);
+
+    // visible characters before the item
+    [[nodiscard]] SizeType m_getIndex(const Position& position) const noexcept;
+
+    // position of the item after position, the end of the last block at the end of the text
+    [[nodiscard]] Position m_next(Position position) noexcept;
+
+    // makes the characters of the item from offset on an item of their own, returns its position
+    Position m_split(Position position, const SizeType offset);
+
+    // keeps the blocks at most twice s_blockSize items, position is moved along with its item
+    void m_balance(Position& position);
+
+    // adds the removed item at position to its removed neighbors with continuing ids
+    void m_mergeTombstones(const Position& position);
+
+    [[nodiscard]] bool m_integrate(const Insertion& insertion, std::vector<Edit>& edits);
+
+    [[nodiscard]] bool m_integrate(Removal removal, std::vector<Edit>& edits);
+};
+
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef SYNTAX_HIGHLIGHTER_H
+#define SYNTAX_HIGHLIGHTER_H
+
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+#include "line_index.h"
+
+
+// table driven highlighting of c / c++, json, log and diff files
+//
+// the lexer state at the start of every line is cached, an edit only lexes again from the edited line
+// until the state matches the one cached before the edit, lines far from the viewport are left for the background
+class SyntaxHighlighter
+{
+public:
+
+    using SizeType = LineIndex::SizeType;
+
+    enum class Kind : std::uint8_t
+    {
+        Text,
+        Keyword,
+        Type,
+        Number,
+        String,
+        Comment,
+        Preprocessor,
+        Key,
+        Error,
+        Warning,
+        Info,
+        Debug,
+        Added,
+        Removed,
+        Section
+    };
+
+    enum class State : std::uint8_t
+    {
+        Normal,
+        BlockComment
+    };
+
+    // the tables are in the source file
+    struct Language;
+
+    // lines longer than this are drawn as text and keep the state of the line before them
+    static constexpr SizeType s_maxLineLength = 1 << 14;
+
+    // picks the language from the file extension, nothing is highlighted if none matches
+    void m_setLanguageFor(const std::wstring_view filePath);
+
+    [[nodiscard]] bool m_isEnabled() const noexcept { return m_language != nullptr; }
+
+    // every state is unknown again
+    void m_reset(const SizeType lineCount);
+
+    // old lines [line, line + removedLines] became [line, line + insertedLines], called in edit order
+    void m_spliceLines(const SizeType line, const SizeType removedLines, const SizeType insertedLines);
+
+    [[nodiscard]] bool m_isComplete() const noexcept { return m_validLines >= m_states.size(); }
+
+    // lexes until the states up to line are exact or about maxSize characters are lexed,
+    // returns the first and the last line whose state changed, npos and 0 if none did
+    std::pair<SizeType, SizeType> m_lex(const std::wstring_view text, const LineIndex& lineIndex, const SizeType line, const SizeType maxSize);
+
+    // kinds of the characters of line lexed from its cached start state, empty for plain text and long lines
+    void m_highlightLine(const std::wstring_view text, const LineIndex& lineIndex, const SizeType line, std::vector<Kind>& kinds) const;
+
+private:
+
+    const Language* m_language = nullptr;
+
+    // state at the start of every line, the ones after m_validLines may be outdated
+    std::vector<State> m_states;
+
+    SizeType m_validLines = 0;
+
+    // states of [m_checkLine, m_trustedEnd) were exact before an edit above them,
+    // they are exact again once the lexer reaches one of them with the same state
+    SizeType m_checkLine  = 0;
+    SizeType m_trustedEnd = 0;
+
+    // kinds gets one entry for every character of line if it is not null
+    [[nodiscard]] State m_lexLine(const std::wstring_view line, const State state, Kind* kinds) const noexcept;
+};
+
+
+#endif
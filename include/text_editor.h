@@ -2,12 +2,20 @@
 #define TEXT_EDITOR_H
 
 #include <type_traits>
-#include <variant>
-#include <deque>
+#include <memory>
 
 #include "console.h"
 #include "utility.h"
-
+#include "text_search.h"
+#include "document.h"
+#include "wrap_layout.h"
+#include "column_checkpoints.h"
+#include "line_operations.h"
+#include "unicode_properties.h"
+#include "worker_pool.h"
+
+// one view of a document, copies of an editor are more views of the same document
+// with their own cursors, selections and scroll position
 class TextEditor
 {
 public:
@@ -21,12 +29,12 @@ public:
     bool m_handleEvents(const Console& console, const KEY_EVENT_RECORD  & event);
     void m_handleEvents(const Console& console, const MOUSE_EVENT_RECORD& event);
 
-    void m_updateConsole(Console& console, const std::wstring_view searchStr = {}) noexcept;
+    void m_updateConsole(Console& console, const TextSearch& search = {}) noexcept;
 
     void m_syncHeightWithRows(const SizeType consoleHeight) noexcept;
     
 
-    [[nodiscard]] std::wstring_view m_buffer() const noexcept { return { m_inputBuffer.c_str(), m_inputBuffer.size() - 1 }; }
+    [[nodiscard]] std::wstring_view m_buffer() const noexcept { return m_document->m_getText(); }
 
     [[nodiscard]] constexpr bool m_isInsidePoint(const SizeType x, const SizeType y) const noexcept
     {   
@@ -41,18 +49,112 @@ public:
 
         const auto[min, max] = utils::GetMinMax(m_currentIndex, m_selectionStartIndex);
 
-        return { { m_inputBuffer.c_str() + min, max - min + 1 } }; 
+        return { { m_document->m_text.c_str() + min, m_getClusterEnd(max) - min } }; 
     }
 
-    bool m_selectNextString    (const std::wstring_view str) noexcept;
-    bool m_selectPreviousString(const std::wstring_view str) noexcept;
+    bool m_selectNextString    (const TextSearch& search) noexcept;
+    bool m_selectPreviousString(const TextSearch& search) noexcept;
 
     void m_setInputBuffer      (const std::wstring_view str) noexcept;
 
-    bool m_readFile            (const std::wstring_view filePath) noexcept;
+    // a job reading on a worker gets the progress in bytes of the file and may cancel the read,
+    // a cancelled read leaves the text read so far and returns false
+    bool m_readFile            (const std::wstring_view filePath, WorkerPool::Job* job = nullptr) noexcept;
     bool m_writeFile           (const std::wstring_view filePath) const noexcept;
 
-    [[nodiscard]] std::pair<SizeType, SizeType> m_getMatchResults(const std::wstring_view str) const noexcept;
+    // writes the text of snapshot the way m_writeFile writes the document, the file is written
+    // next to path and replaces it only once it is complete
+    [[nodiscard]] static bool s_writeSnapshot(const std::wstring_view filePath, const TextSnapshot& snapshot, WorkerPool::Job& job) noexcept;
+
+    // size in bytes, 0 if the file can not be found
+    [[nodiscard]] static SizeType s_getFileSize(const std::wstring_view filePath) noexcept;
+
+    // counts are kept per block and only the new text is counted again while text is appended
+    [[nodiscard]] std::pair<SizeType, SizeType> m_getMatchResults(const TextSearch& search) noexcept;
+
+    // true if m_getMatchResults would count the whole text again, a big text is counted by s_countMatches instead
+    [[nodiscard]] bool m_needsMatchRecount(const TextSearch& search) const;
+
+    // takes a count of s_countMatches, the edits made since its version are counted by m_getMatchResults
+    void m_setMatchCount(Document::MatchCount count) noexcept { m_document->m_matchCount = std::move(count); }
+
+    // counts the matches of a snapshot on the workers
+    [[nodiscard]] static Document::MatchCount s_countMatches(const TextSnapshot& snapshot, const TextSearch& search, WorkerPool::Job& job);
+
+    // the matches m_replaceMatchsWith replaces, found in a snapshot on the workers
+    [[nodiscard]] static std::vector<SizeType> s_findMatches(const TextSnapshot& snapshot, const TextSearch& search, WorkerPool::Job& job);
+
+    enum class IndexMode
+    {
+        None,
+        Memory,
+        Persistent
+    };
+
+    // trigram index built after m_readFile, persistent mode keeps it next to the file
+    IndexMode m_indexMode = IndexMode::None;
+
+    [[nodiscard]] bool m_isIndexReady() const noexcept { return m_document->m_trigramIndex.m_isReady(); }
+
+    [[nodiscard]] const LineIndex& m_getLineIndex() const noexcept { return m_document->m_lineIndex; }
+
+    [[nodiscard]] const Document& m_getDocument() const noexcept { return *m_document; }
+    [[nodiscard]]       Document& m_getDocument()       noexcept { return *m_document; }
+
+    // another TextEditor shows the same document, a pane or a client of the editor server
+    [[nodiscard]] bool m_isDocumentShared() const noexcept { return m_document.use_count() > 1; }
+
+    [[nodiscard]] constexpr SizeType m_getCursorIndex() const noexcept { return m_currentIndex; }
+
+    // moves the cursor to index and scrolls to it
+    void m_goToIndex(const SizeType index) noexcept;
+
+    // long lines continue on the next rows instead of scrolling horizontally
+    void m_setWrap(const bool wrap) noexcept;
+
+    [[nodiscard]] constexpr bool m_isWrapped() const noexcept { return m_wrap; }
+
+    // highlights the syntax of the language the extension of filePath belongs to
+    void m_setLanguageFor(const std::wstring_view filePath);
+
+    // lexes the lines the drawing left behind a bit at a time, returns true if drawn lines changed color
+    bool m_highlightInBackground();
+
+    // works on the selected lines or the whole buffer, one undo step
+    void m_applyLineOperation(const LineOperations::Type type, const TextSearch& search = {});
+
+    // selection as [first, second) or the whole buffer when nothing is selected
+    [[nodiscard]] std::pair<SizeType, SizeType> m_getSelectionRange() const noexcept;
+
+    // selects [start, end), nothing is selected when the range is empty
+    void m_selectRange(const SizeType start, const SizeType end) noexcept;
+
+    // text that changed outside of the editor, like a growing log file, it is not an undo step
+    // the cursor stays at the end if it was there
+    void m_appendText(std::wstring str);
+
+    // replaces [start, end) with the insertable characters of str, one undo step
+    void m_replaceRange(const SizeType start, const SizeType end, std::wstring str);
+
+    // selects every match with its own cursor, returns false if there is none
+    bool m_addCursorsAtMatches(const TextSearch& search);
+
+    // uses the trigram index if it is ready to skip blocks that can not contain a match
+    [[nodiscard]] SizeType m_findNext    (const TextSearch& search, const SizeType start   ) const;
+    [[nodiscard]] SizeType m_findPrevious(const TextSearch& search, const SizeType maxStart) const;
+
+    // starts of the matches that do not overlap, the candidate ranges are taken once for all of them
+    [[nodiscard]] std::vector<SizeType> m_findAll(const TextSearch& search) const;
+
+public:
+
+    using BufferEdit = Document::BufferEdit;
+
+    // increases with every edit of any view
+    [[nodiscard]] SizeType m_getVersion() const noexcept { return m_document->m_getVersion(); }
+
+    // returns nothing if the edits are not known anymore, the buffer is reloaded or the log is trimmed
+    [[nodiscard]] std::optional<std::vector<BufferEdit>> m_getEditsSince(const SizeType version) const { return m_document->m_getEditsSince(version); }
 
 public:
 
@@ -66,8 +168,8 @@ public:
 
 private:
 
-    constexpr void m_handleSelection(const SizeType start) noexcept;
-    constexpr void m_handleSelection(const SizeType start, const SizeType end) noexcept;
+    void m_handleSelection(const SizeType start) noexcept;
+    void m_handleSelection(const SizeType start, const SizeType end) noexcept;
 
     WORD m_textColor = 0;
     bool m_shiftPressed = false;
@@ -84,24 +186,50 @@ private:
 
 private:
 
-    std::wstring m_inputBuffer;
+    // shared with the copies of this editor
+    std::shared_ptr<Document> m_document = std::make_shared<Document>();
+
+    // edits up to this version are applied to the cursors and the scroll position,
+    // the ones this view makes are applied by the edit itself
+    SizeType m_viewVersion = 0;
+
+    // moves the positions of this view over the edits other views made since the last call,
+    // called first by the public functions that move them and by the drawing
+    void m_syncView() noexcept;
 
     SizeType m_currentIndex = 0;
     SizeType m_startRow = 0;
 
-    SizeType m_rowCount = 1;
-    
     bool m_selectionInProgress = false;
     SizeType m_selectionStartIndex = 0;
 
     static constexpr SizeType s_tabSize = 4;
+
+    // keep the document in sync, called before the buffer changes
+    void m_onBufferInsert(const SizeType index, const std::wstring_view str);
+    void m_onBufferErase (const SizeType start, const SizeType end) noexcept;
+
+    // called after the whole buffer is replaced
+    void m_onBufferReset() noexcept;
+
+    // matches are counted per block of s_matchBlockSize characters
+    static constexpr SizeType s_matchBlockSize = 1 << 16;
+
+    void m_updateMatchCount(const TextSearch& search) noexcept;
+
+    // nothing if the count of search is current, true if only the end that was appended to is counted again
+    [[nodiscard]] std::optional<bool> m_getMatchCountUpdate(const TextSearch& search) const;
     
 private:
 
-    void m_handleInsertionEvents (const KEY_EVENT_RECORD& event);
-    void m_handleControlKeyEvents(const KEY_EVENT_RECORD& event);
-    void m_handleCursorEvents    (const KEY_EVENT_RECORD& event);
-    void m_handleCursorMoveEvents(const KEY_EVENT_RECORD& event);
+    void m_handleInsertionEvents  (const KEY_EVENT_RECORD& event);
+    void m_handleControlKeyEvents (const KEY_EVENT_RECORD& event);
+    void m_handleCursorEvents     (const KEY_EVENT_RECORD& event);
+    void m_handleCursorMoveEvents (const KEY_EVENT_RECORD& event);
+    bool m_handleMultiCursorEvents(const KEY_EVENT_RECORD& event);
+    bool m_handleBlockSelectionEvents(const KEY_EVENT_RECORD& event);
+
+    void m_moveCursor(const KEY_EVENT_RECORD& event);
 
     void m_moveCursorOneWordLeft () noexcept;
     void m_moveCursorOneWordRight() noexcept;  
@@ -114,39 +242,139 @@ private:
     void m_deleteStartingFrom(const SizeType start, SizeType end) noexcept; 
 
     void m_insertChar(const wchar_t c) noexcept;
-    void m_insertUnsafeString(std::wstring str);
     void m_insertString(const std::wstring_view str, const SizeType insertIndex);
 
-    constexpr void m_scrollOneUp  () noexcept { if (m_startRow > 0) --m_startRow; }
-    constexpr void m_scrollOneDown() noexcept { if (m_startRow + m_height < m_rowCount) ++m_startRow; }
+    void m_pasteClipboard();
+
+    void m_scrollOneUp  () noexcept;
+    void m_scrollOneDown() noexcept;
 
 public:
 
     void m_insertString(const std::wstring_view str);
-    void m_replaceMatchsWith(const std::wstring_view keyStr, const std::wstring_view replaceStr) noexcept;
+    void m_insertUnsafeString(std::wstring str);
+    void m_replaceMatchsWith(const TextSearch& search, const std::wstring_view replaceStr) noexcept;
+
+    // replaces the matches of size characters s_findMatches found and Document::m_rebase moved over the edits since, one undo step
+    void m_replaceMatchesAt(const std::vector<SizeType>& starts, const SizeType size, const std::wstring_view replaceStr) noexcept;
 
 private:
-    
-    struct InsertionRecord
+
+    using InsertionRecord = Document::InsertionRecord;
+    using DeletionRecord  = Document::DeletionRecord;
+    using BatchRecord     = Document::BatchRecord;
+
+    void m_writeInsertionRecord(const SizeType index, const SizeType size, const bool createNew = true) noexcept;
+    void m_writeDeletionRecord (const SizeType index, std::wstring&& str , const bool createNew = true) noexcept;
+
+    void m_resizeRecordsIfNeeded() noexcept;
+
+private:
+
+    struct Cursor
     {
         SizeType m_index;
-        SizeType m_size;
+        SizeType m_selectionStart;
+        bool m_selected;
     };
 
-    struct DeletionRecord
+    // cursors besides m_currentIndex, sorted by m_index
+    std::vector<Cursor> m_extraCursors;
+
+    static constexpr WORD s_extraCursorColor = Console::s_backgroundWhite | BACKGROUND_INTENSITY;
+
+    // makes cursor the primary one by exchanging it with m_currentIndex and the selection
+    void m_swapCursor(Cursor& cursor) noexcept
     {
-        SizeType m_index;
-        std::wstring m_data;
+        std::swap(m_currentIndex, cursor.m_index);
+        std::swap(m_selectionStartIndex, cursor.m_selectionStart);
+        std::swap(m_selectionInProgress, cursor.m_selected);
+    }
+
+    void m_sortCursors();
+
+    // primary cursor is placed at positions[primary], the rest become extra cursors
+    void m_setCursors(const std::vector<SizeType>& positions, const SizeType primary);
+
+    void m_addCursorsToSelectedLines();
+
+    struct Replacement
+    {
+        SizeType m_start;
+        SizeType m_end;
+        std::wstring_view m_text;
+    };
+
+    // replaces sorted, non overlapping ranges with one pass over the buffer,
+    // returns where each replacement starts afterwards
+    std::vector<SizeType> m_applyReplacements(const std::vector<Replacement>& replacements, BatchRecord* record);
+
+    enum class CursorEdit
+    {
+        Insert,
+        DeleteBackward,
+        DeleteForward
     };
 
+    // the same edit at every cursor as one batch and one undo step
+    void m_editAtCursors(const CursorEdit edit, const std::wstring_view str = {});
+
+    void m_undoBatch(const BatchRecord& record);
+
+    // drops the extra cursors and the block selection
+    void m_resetCursors() noexcept
+    {
+        m_extraCursors.clear();
+        m_blockSelection.reset();
+    }
+
 private:
 
-    std::deque<std::variant<InsertionRecord, DeletionRecord>> m_records;
+    // rectangular selection, columns are screen columns with tabs expanded to s_tabSize
+    struct BlockSelection
+    {
+        SizeType m_anchorLine;
+        SizeType m_anchorColumn;
 
-    void m_writeInsertionRecord(const SizeType index, const SizeType size, const bool createNew = true) noexcept;
-    void m_writeDeletionRecord (const SizeType index, std::wstring&& str , const bool createNew = true) noexcept;
+        SizeType m_line;
+        SizeType m_column;
 
-    void m_resizeRecordsIfNeeded() noexcept;
+        [[nodiscard]] constexpr SizeType m_firstLine  () const noexcept { return std::min(m_anchorLine, m_line); }
+        [[nodiscard]] constexpr SizeType m_lastLine   () const noexcept { return std::max(m_anchorLine, m_line); }
+        [[nodiscard]] constexpr SizeType m_leftColumn () const noexcept { return std::min(m_anchorColumn, m_column); }
+        [[nodiscard]] constexpr SizeType m_rightColumn() const noexcept { return std::max(m_anchorColumn, m_column); }
+    };
+
+    std::optional<BlockSelection> m_blockSelection;
+
+    [[nodiscard]] static SizeType s_getCharWidth(const wchar_t c) noexcept { return c == L'\t' ? s_tabSize : UnicodeProperties::s_getWidth(c); }
+
+    // end of the grapheme cluster containing index, selections include the whole cluster at their larger end
+    [[nodiscard]] SizeType m_getClusterEnd(const SizeType index) const noexcept
+    {
+        const auto text = m_buffer();
+
+        return std::max(index + 1, UnicodeProperties::s_getNextGraphemeBreak(text, UnicodeProperties::s_getPreviousGraphemeBreak(text, index + 1)));
+    }
+
+    [[nodiscard]] static SizeType s_getTextWidth(const std::wstring_view str) noexcept;
+
+    [[nodiscard]] SizeType m_getColumnOf(const SizeType index) const noexcept;
+
+    // first index of line at or after column ( line end if the line is shorter ) and the column of that index
+    [[nodiscard]] std::pair<SizeType, SizeType> m_getIndexAtColumn(const SizeType line, const SizeType column) const noexcept;
+
+    // moves the block corner and the cursor to line / column
+    void m_setBlockCorner(const SizeType line, const SizeType column) noexcept;
+
+    void m_moveBlockCorner(const KEY_EVENT_RECORD& event) noexcept;
+
+    [[nodiscard]] std::wstring m_getBlockText() const;
+
+    // rowTexts has one entry for every row or one entry for all rows
+    void m_editBlock(const CursorEdit edit, const std::vector<std::wstring_view>& rowTexts = {});
+
+    void m_pasteIntoBlock(const std::wstring_view str);
 
 private:
 
@@ -154,16 +382,102 @@ private:
 
 private:
 
-    constexpr void m_updateStartRow() noexcept;
+    void m_updateStartRow() noexcept;
+
+    // returns top left pixels index value ( according to m_buffer() )
+    [[nodiscard]] SizeType m_getConsoleStartIndex() const noexcept;
+
+    [[nodiscard]] SizeType m_getConsoleColumnStartIndex(const SizeType consoleStartIndex) const noexcept;
+
+    [[nodiscard]] SizeType m_getRowCountUntil(const SizeType index) const noexcept;
+
+private:
+
+    bool m_wrap = false;
+
+    // first drawn row of the line m_startRow in wrap mode
+    SizeType m_startSubRow = 0;
+
+    WrapLayout m_wrapLayout;
+    SizeType m_wrapVersion = 0;
+
+    // columns and wrapped rows inside long lines, filled by the const lookups below
+    mutable ColumnCheckpoints m_columnCheckpoints;
+    mutable SizeType m_checkpointVersion = 0;
+
+    // moves the checkpoints over the edits of every view before a lookup
+    void m_syncColumnCheckpoints() const;
+
+    // measures the lines edited since the last call, everything after a reload or a resize
+    void m_updateWrapLayout();
+
+    [[nodiscard]] SizeType m_getStartVisualRow() const noexcept;
+
+    void m_setStartVisualRow(const SizeType row) noexcept;
+
+    // row inside its line and column inside that row of index, wrapped like m_updateConsole draws it
+    [[nodiscard]] std::pair<SizeType, SizeType> m_getRowColumnOf(const SizeType index) const noexcept;
+
+    // index drawn at column of the given row of line, the last index of the row if it is shorter
+    [[nodiscard]] SizeType m_getIndexAtRowColumn(const SizeType line, const SizeType row, const SizeType column) const noexcept;
+
+    void m_moveCursorOneRowDown() noexcept;
+    void m_moveCursorOneRowUp  () noexcept;
+
+private:
+
+    // characters lexed before drawing and in one background step
+    static constexpr SizeType s_drawLexSize       = 1 << 18;
+    static constexpr SizeType s_backgroundLexSize = 1 << 20;
+
+    // lines from this one on were not drawn
+    SizeType m_highlightEndLine = 0;
+
+    // kinds of the line that is being drawn
+    std::vector<SyntaxHighlighter::Kind> m_lineKinds;
+
+    // moves the line states of the document over the edits since the last call
+    void m_updateHighlighter();
+
+    [[nodiscard]] WORD m_getKindColor(const SyntaxHighlighter::Kind kind) const noexcept;
+
+private:
+
+    // the text is laid out into the cells first, then every color is an interval of text indices
+    // written over the cells that show it as one span per row
+
+    struct DrawnRow
+    {
+        SizeType m_line = 0;
+
+        // column of the line at the first cell of the row
+        SizeType m_firstColumn = 0;
+
+        // cells from the first one that show a character
+        SizeType m_cellCount = 0;
+    };
+
+    std::vector<DrawnRow> m_drawnRows;
+
+    // text index shown by every cell of the view row by row, a character may take several cells
+    std::vector<SizeType> m_cellIndices;
 
-    // returns top left pixels index value ( according to m_inputBuffer )
-    [[nodiscard]] constexpr SizeType m_getConsoleStartIndex() const noexcept;
+    // console indices of wide characters, they get the leading and trailing byte flags after the colors
+    std::vector<SizeType> m_wideCells;
 
-    [[nodiscard]] constexpr SizeType m_getConsoleColumnStartIndex(const SizeType consoleStartIndex) const noexcept;
+    // writes the characters and fills m_drawnRows and m_cellIndices, sets the cursor position
+    void m_layoutRows(Console& console, const SizeType consoleStartIndex, const SizeType columnStartVal) noexcept;
 
-    [[nodiscard]] constexpr SizeType m_getRowCountUntil(const SizeType index) const noexcept;
+    // calls function with the console index and the size of the cell span of row that shows [start, end)
+    template<typename Function>
+    void m_forRowCells(const Console& console, const SizeType row, const SizeType start, const SizeType end, Function&& function) const;
 
+    template<typename Function>
+    void m_forCells(const Console& console, const SizeType start, const SizeType end, Function&& function) const;
 
+    void m_drawSyntaxColors (Console& console) noexcept;
+    void m_drawSelections   (Console& console) const noexcept;
+    void m_drawSearchMatches(Console& console, const TextSearch& search) const noexcept;
 };
 
 
@@ -0,0 +1,87 @@
+#ifndef TEXT_SEARCH_H
+#define TEXT_SEARCH_H
+
+#include <string>
+#include <string_view>
+
+
+class TextSearch
+{
+public:
+
+    using SizeType = std::wstring_view::size_type;
+
+    static constexpr SizeType s_npos = std::wstring_view::npos;
+
+    struct Options
+    {
+        bool m_ignoreCase = false;
+        bool m_wholeWord  = false;
+    };
+
+    TextSearch() = default;
+    TextSearch(const std::wstring_view pattern, const Options options);
+
+    [[nodiscard]] bool m_empty() const noexcept { return m_pattern.empty(); }
+
+    [[nodiscard]] SizeType m_size() const noexcept { return m_pattern.size(); }
+
+    [[nodiscard]] constexpr const Options& m_getOptions() const noexcept { return m_options; }
+
+    [[nodiscard]] const std::wstring& m_getPattern() const noexcept { return m_pattern; }
+
+    // returns start index of the first match that starts at or after start and ends at or before end
+    [[nodiscard]] SizeType m_findNext(const std::wstring_view text, 
+        const SizeType start = 0, const SizeType end = s_npos) const;
+
+    // returns start index of the last match that starts between minStart and maxStart
+    [[nodiscard]] SizeType m_findPrevious(const std::wstring_view text, 
+        const SizeType maxStart, const SizeType minStart = 0) const;
+
+    [[nodiscard]] bool m_isMatchAt(const std::wstring_view text, const SizeType index) const noexcept;
+
+    // walks the matches of one text from front to back, a case insensitive search folds a chunk of the text
+    // once and keeps it while the starts stay inside it, the text must not change while the cursor is used
+    class Cursor
+    {
+    public:
+
+        Cursor(const TextSearch& search, const std::wstring_view text, const SizeType end = s_npos);
+
+        // same as TextSearch::m_findNext with the text and end of the cursor
+        [[nodiscard]] SizeType m_findNext(const SizeType start);
+
+    private:
+
+        const TextSearch& m_search;
+
+        std::wstring_view m_text;
+        SizeType m_end;
+
+        // folded characters of the text from m_chunkStart on
+        std::wstring m_folded;
+        SizeType m_chunkStart = 0;
+    };
+
+public:
+
+    // word characters are the ones cursor word movement stops at
+    [[nodiscard]] static bool s_isWordChar(const wchar_t c) noexcept;
+
+    // unicode simple case folding ( C + S mappings of the BMP )
+    [[nodiscard]] static wchar_t s_foldCase(const wchar_t c) noexcept;
+
+    static void s_foldCase(const wchar_t* src, wchar_t* dst, const SizeType size) noexcept;
+
+private:
+
+    std::wstring m_pattern;
+    Options m_options;
+
+    [[nodiscard]] bool m_isWholeWordAt(const std::wstring_view text, const SizeType index) const noexcept;
+
+    [[nodiscard]] SizeType m_findPreviousFolded(const std::wstring_view text, SizeType end, const SizeType minStart) const;
+};
+
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef TEXT_SNAPSHOT_H
+#define TEXT_SNAPSHOT_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+// text of a document at one version, a worker reads it while the document is edited on
+//
+// the text is a persistent piece tree, a balanced tree whose leaves view pieces of buffers that never
+// change: an edit makes new nodes on the paths to the pieces it touches and shares the rest of the tree
+// with the copies taken before it, so a copy costs a pointer and an edit a few nodes per level,
+// splitting a piece only makes two views of its buffer
+class TextSnapshot
+{
+public:
+
+    using SizeType = std::size_t;
+
+    // characters [m_start, m_end) of the text replaced by m_text
+    struct Replacement
+    {
+        SizeType m_start;
+        SizeType m_end;
+
+        std::wstring_view m_text;
+    };
+
+    TextSnapshot() = default;
+    explicit TextSnapshot(const std::wstring_view text);
+
+    [[nodiscard]] SizeType m_getSize() const noexcept { return m_root ? m_root->m_size : 0; }
+
+    // version of the document's edit log the snapshot was taken at
+    [[nodiscard]] SizeType m_getVersion() const noexcept { return m_version; }
+
+    // appends the characters [first, last) to out
+    void m_copy(const SizeType first, const SizeType last, std::wstring& out) const;
+
+    [[nodiscard]] std::wstring m_getText() const;
+
+    // change this copy only, the ones taken before keep their text
+    void m_insert(const SizeType index, const std::wstring_view str);
+    void m_erase (const SizeType first, const SizeType last);
+
+    // replacements are sorted and do not overlap, the tree is built again once from the pieces between them
+    void m_replace(const std::vector<Replacement>& replacements);
+
+private:
+
+    friend class Document;
+
+    // pieces this short are copied into one when they meet, typing does not leave a piece per character
+    static constexpr SizeType s_smallPiece = 256;
+
+    struct Node;
+    using NodePtr = std::shared_ptr<const Node>;
+
+    struct Node
+    {
+        SizeType m_size   = 0;
+        SizeType m_height = 1;
+
+        // both are null for a leaf
+        NodePtr m_left;
+        NodePtr m_right;
+
+        // a leaf views m_size characters of m_buffer from m_offset on
+        std::shared_ptr<const std::wstring> m_buffer;
+        SizeType m_offset = 0;
+
+        [[nodiscard]] bool m_isLeaf() const noexcept { return !m_left; }
+
+        [[nodiscard]] std::wstring_view m_getPiece() const noexcept { return std::wstring_view(*m_buffer).substr(m_offset, m_size); }
+    };
+
+    NodePtr m_root;
+
+    SizeType m_version = 0;
+
+    // shared by the copies the document hands out, it stops keeping its own once no other one is left
+    std::shared_ptr<const void> m_lease;
+
+    [[nodiscard]] static NodePtr s_makeLeaf(const std::wstring_view text);
+    [[nodiscard]] static NodePtr s_makeLeaf(const std::shared_ptr<const std::wstring>& buffer, const SizeType offset, const SizeType size);
+    [[nodiscard]] static NodePtr s_makeNode(NodePtr left, NodePtr right);
+
+    // node of left and right, rotated once when one side is two levels higher
+    [[nodiscard]] static NodePtr s_balance(NodePtr left, NodePtr right);
+
+    // the text of left followed by the text of right, either may be null
+    [[nodiscard]] static NodePtr s_join(const NodePtr& left, const NodePtr& right);
+
+    // the characters before index and the ones from index on
+    [[nodiscard]] static std::pair<NodePtr, NodePtr> s_split(const NodePtr& node, const SizeType index);
+
+    // appends leaves viewing the characters [first, last) of node
+    static void s_collect(const NodePtr& node, SizeType first, SizeType last, std::vector<NodePtr>& leaves);
+
+    // balanced tree of the leaves [first, last)
+    [[nodiscard]] static NodePtr s_build(const std::vector<NodePtr>& leaves, const SizeType first, const SizeType last);
+
+    static void s_copy(const Node* node, SizeType first, SizeType last, std::wstring& out);
+};
+
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef TRIGRAM_INDEX_H
+#define TRIGRAM_INDEX_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+
+#include "text_search.h"
+
+// posting lists of case folded trigrams for every block of a big static text,
+// searches only verify the blocks that contain every trigram of the pattern
+class TrigramIndex
+{
+public:
+
+    using SizeType = std::wstring_view::size_type;
+
+    // characters covered by one posting list entry
+    static constexpr SizeType s_blockSize = 1 << 20;
+
+    static constexpr std::uint32_t s_bucketBits  = 20;
+    static constexpr std::uint32_t s_bucketCount = 1u << s_bucketBits;
+
+    TrigramIndex() = default;
+    ~TrigramIndex();
+
+    TrigramIndex(const TrigramIndex&) = delete;
+    TrigramIndex& operator= (const TrigramIndex&) = delete;
+
+    // starts indexing text on a background thread, text must not change until m_clear is called
+    // if persistPath is not empty the index is loaded from it when valid or saved to it once built
+    void m_build(const std::wstring_view text, std::wstring persistPath = {});
+
+    // cancels a running build and drops the index
+    void m_clear() noexcept;
+
+    [[nodiscard]] bool m_isReady() const noexcept { return m_ready.load(std::memory_order_acquire); }
+
+    // returns sorted ranges [first, second) of the indexed text,
+    // every match of search lies completely inside one of them
+    [[nodiscard]] std::vector<std::pair<SizeType, SizeType>> m_getCandidateRanges(const TextSearch& search) const;
+
+private:
+
+    std::thread m_thread;
+
+    std::atomic<bool> m_cancel { false };
+    std::atomic<bool> m_ready  { false };
+
+    SizeType m_textSize   = 0;
+    SizeType m_blockCount = 0;
+
+    // posting lists of every bucket are stored back to back as delta encoded varints
+    std::vector<std::uint64_t> m_offsets;
+    std::vector<std::uint8_t > m_postings;
+
+    void m_buildIndex(const std::wstring_view text) noexcept;
+
+    [[nodiscard]] bool m_loadIndex(const std::wstring_view text, const std::wstring& path) noexcept;
+    [[nodiscard]] bool m_saveIndex(const std::wstring_view text, const std::wstring& path) const noexcept;
+};
+
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef UNICODE_PROPERTIES_H
+#define UNICODE_PROPERTIES_H
+
+#include <string_view>
+#include <utility>
+#include <cstdint>
+
+
+// display width, grapheme cluster break and word class of code points,
+// looked up in two level tables generated at compile time from the ranges in the source file
+class UnicodeProperties
+{
+public:
+
+    using SizeType = std::wstring_view::size_type;
+
+    enum class GraphemeBreak : std::uint8_t
+    {
+        Other,
+        CR,
+        LF,
+        Control,
+        Extend,
+        ZWJ,
+        RegionalIndicator,
+        Prepend,
+        SpacingMark,
+        L,
+        V,
+        T,
+        LV,
+        LVT,
+        ExtendedPictographic
+    };
+
+    // cursor word movement stops where the class changes, Other is never part of a word
+    enum class WordBreak : std::uint8_t
+    {
+        Other,
+        AlphaNumeric,
+        Ideographic,
+        Hiragana,
+        Katakana
+    };
+
+    // console cells taken by a utf-16 unit, 0 for combining marks, 2 for wide and fullwidth characters,
+    // each half of a surrogate pair takes one cell like it does in the console buffer
+    [[nodiscard]] static SizeType s_getWidth(const wchar_t c) noexcept;
+
+    [[nodiscard]] static GraphemeBreak s_getGraphemeBreak(const char32_t c) noexcept;
+
+    [[nodiscard]] static WordBreak s_getWordBreak(const char32_t c) noexcept;
+
+    // code point starting at index and the number of units it takes, unpaired surrogates are returned as they are
+    [[nodiscard]] static std::pair<char32_t, SizeType> s_decode(const std::wstring_view text, const SizeType index) noexcept;
+
+    // start of the grapheme cluster after the one at index, text.size() for the last one
+    [[nodiscard]] static SizeType s_getNextGraphemeBreak(const std::wstring_view text, const SizeType index) noexcept;
+
+    // start of the grapheme cluster containing the unit before index
+    [[nodiscard]] static SizeType s_getPreviousGraphemeBreak(const std::wstring_view text, const SizeType index) noexcept;
+
+    [[nodiscard]] static bool s_isGraphemeBreak(const std::wstring_view text, const SizeType index) noexcept;
+};
+
+
+#endif
@@ -3,6 +3,7 @@
 
 #include <utility>
 #include <string_view>
+#include <cstddef>
 
 namespace utils
 {
@@ -39,6 +40,29 @@ namespace utils
 
         return {};
     }
+
+    // size of the prefix of utf-8 bytes that does not end inside a sequence
+    [[nodiscard]] constexpr std::size_t GetCompleteUtf8Size(const char* data, const std::size_t size) noexcept
+    {
+        // the last lead byte tells how long its sequence has to be
+        for (std::size_t i = size; i > 0 && size - i < 4; --i)
+        {
+            const auto byte = static_cast<unsigned char>(data[i - 1]);
+
+            if ((byte & 0xC0) == 0x80) continue;
+
+            std::size_t length = 1;
+
+            if      (byte >= 0xF0) length = 4;
+            else if (byte >= 0xE0) length = 3;
+            else if (byte >= 0xC0) length = 2;
+
+            return size - (i - 1) >= length ? size : i - 1;
+        }
+
+        // invalid bytes are left to the decoder
+        return size;
+    }
 }
 
 
@@ -0,0 +1,111 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <cstddef>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <thread>
+#include <vector>
+
+
+// threads shared by the long operations of the editor, every thread takes the tasks of its own queue
+// newest first and steals the oldest tasks of the other queues once its own is empty
+class WorkerPool
+{
+public:
+
+    using SizeType = std::size_t;
+
+    // progress and cancellation of one operation, shared by its tasks and the thread that waits for it
+    class Job
+    {
+    public:
+
+        // tasks stop at their next check, the job still finishes
+        void m_cancel() noexcept { m_cancelled.store(true, std::memory_order_relaxed); }
+
+        [[nodiscard]] bool m_isCancelled() const noexcept { return m_cancelled.load(std::memory_order_relaxed); }
+
+        // what the task wrote is visible to the thread that sees the job finished
+        [[nodiscard]] bool m_isFinished() const noexcept { return m_finished.load(std::memory_order_acquire); }
+
+        // the task threw, what it wrote is incomplete
+        [[nodiscard]] bool m_isFailed() const noexcept { return m_failed.load(std::memory_order_relaxed); }
+
+        // units of work of the whole job and the ones done, in any unit the task likes
+        void m_setTotal(const SizeType total) noexcept { m_total.store(total, std::memory_order_relaxed); }
+        void m_addDone (const SizeType done ) noexcept { m_done.fetch_add(done, std::memory_order_relaxed); }
+
+        [[nodiscard]] SizeType m_getPercent() const noexcept;
+
+    private:
+
+        friend class WorkerPool;
+
+        std::atomic<bool> m_cancelled { false };
+        std::atomic<bool> m_finished  { false };
+        std::atomic<bool> m_failed    { false };
+
+        std::atomic<SizeType> m_total { 0 };
+        std::atomic<SizeType> m_done  { 0 };
+    };
+
+    // the pool of the editor, one thread per core, started on the first use
+    [[nodiscard]] static WorkerPool& s_get();
+
+    explicit WorkerPool(const unsigned threadCount);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator= (const WorkerPool&) = delete;
+
+    // runs task on a worker, the job finishes when it returns and fails if it throws
+    [[nodiscard]] std::shared_ptr<Job> m_run(std::function<void(Job&)> task);
+
+    // calls body(first, last) for the chunks of [0, count), the chunks run on every worker and on the
+    // calling thread, which returns once all of them are done, chunks that start after the job is
+    // cancelled are skipped, the first exception of a chunk is thrown again once all of them are done
+    // and the chunks that did not start yet are skipped too
+    void m_parallelFor(const Job& job, const SizeType count, const SizeType chunkSize,
+        const std::function<void(SizeType, SizeType)>& body);
+
+private:
+
+    using Task = std::function<void()>;
+
+    struct Queue
+    {
+        std::mutex m_mutex;
+        std::deque<Task> m_tasks;
+    };
+
+    // one queue per worker, tasks pushed by other threads are spread over them
+    std::vector<std::unique_ptr<Queue>> m_queues;
+
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+
+    // tasks in the queues, the workers sleep while it is zero
+    std::atomic<SizeType> m_queued { 0 };
+
+    std::atomic<SizeType> m_nextQueue { 0 };
+
+    bool m_stopping = false;
+
+    void m_push(Task task);
+
+    // runs one task of queue home or of another queue, returns false if every queue was empty
+    bool m_runOne(const SizeType home);
+
+    void m_work(const SizeType index);
+};
+
+
+#endif
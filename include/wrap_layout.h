@@ -0,0 +1,74 @@
+#ifndef WRAP_LAYOUT_H
+#define WRAP_LAYOUT_H
+
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+#include "line_index.h"
+#include "unicode_properties.h"
+
+
+// screen rows of every line of a text wrapped at a fixed width, with prefix sums over the lines
+// so visual rows and lines convert in O(log n)
+//
+// edits only measure the lines they touched again, the prefix sums are rebuilt when the line count changes
+class WrapLayout
+{
+public:
+
+    using SizeType = LineIndex::SizeType;
+
+    // measures every line
+    void m_build(const std::wstring_view text, const LineIndex& lineIndex, const SizeType width, const SizeType tabSize);
+
+    void m_clear() noexcept;
+
+    [[nodiscard]] SizeType m_getWidth() const noexcept { return m_width; }
+
+    // old lines [line, line + removedLines] became [line, line + insertedLines], called in edit order
+    void m_spliceLines(const SizeType line, const SizeType removedLines, const SizeType insertedLines);
+
+    // measures the lines given to m_spliceLines, the text has to be the one after all of them
+    void m_measureChangedLines(const std::wstring_view text, const LineIndex& lineIndex);
+
+    [[nodiscard]] SizeType m_getRowCount() const noexcept { return m_getFirstRow(m_rows.size()); }
+
+    [[nodiscard]] SizeType m_getRowsOf(const SizeType line) const noexcept { return line < m_rows.size() ? m_rows[line] : 1; }
+
+    // visual row of the first row of line
+    [[nodiscard]] SizeType m_getFirstRow(const SizeType line) const noexcept;
+
+    // line that contains the visual row and the row inside that line
+    [[nodiscard]] std::pair<SizeType, SizeType> m_getLineAt(const SizeType row) const noexcept;
+
+    [[nodiscard]] static SizeType s_getCharWidth(const wchar_t c, const SizeType tabSize) noexcept { return c == L'\t' ? tabSize : UnicodeProperties::s_getWidth(c); }
+
+    // a character that does not fit on the row starts the next one, so does the line end,
+    // a line has at least one row
+    [[nodiscard]] static SizeType s_countRows(const std::wstring_view line, const SizeType width, const SizeType tabSize) noexcept;
+
+private:
+
+    std::vector<SizeType> m_rows;
+
+    // fenwick tree over m_rows, m_tree[i] holds the sum of the lines (i - lowbit(i), i]
+    std::vector<SizeType> m_tree;
+
+    SizeType m_width   = 0;
+    SizeType m_tabSize = 0;
+
+    // inclusive line ranges to measure again, in line numbers after the splices so far
+    std::vector<std::pair<SizeType, SizeType>> m_changedLines;
+
+    // the line count changed, m_tree is built again after measuring
+    bool m_treeOutdated = false;
+
+    void m_buildTree();
+
+    void m_addToTree(SizeType line, const SizeType delta) noexcept;
+};
+
+
+#endif
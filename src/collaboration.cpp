@@ -0,0 +1,179 @@
+#include "../include/collaboration.h"
+
+#include <cstring>
+
+[[nodiscard]] bool Collaboration::m_join(const std::wstring_view name, const TextEditor& view)
+{
+	const auto path = CollaborationRelay::s_getPath(name);
+
+	if (path.empty() || !LocalSocket::s_startup()) return false;
+
+	m_socket = LocalSocket::s_connect(path);
+
+	if (!m_socket.m_isValid()) return false;
+
+	m_name = name;
+	m_view = view;
+
+	auto& document = m_view.m_getDocument();
+
+	document.m_changes.clear();
+	document.m_recordChanges = true;
+
+	return true;
+}
+
+void Collaboration::m_leave()
+{
+	m_socket.m_close();
+
+	auto& document = m_view.m_getDocument();
+
+	document.m_recordChanges = false;
+	document.m_changes.clear();
+
+	// the document is freed with the last view of the editor
+	m_view = TextEditor();
+
+	m_crdt.reset();
+	m_unsent.clear();
+}
+
+void Collaboration::m_poll()
+{
+	if (!m_isJoined()) return;
+
+	// the views edited the text the relay's operations were made on, the crdt has to catch up first
+	m_takeChanges();
+
+	// the batches the relay did not take yet go first, a relay that takes nothing for too long fails m_send below
+	const bool open = m_socket.m_flush() && m_socket.m_receive();
+
+	while (const auto message = m_socket.m_takeMessage())
+	{
+		if (!m_handleMessage(message.value()))
+		{
+			m_leave();
+			return;
+		}
+	}
+
+	if (!m_unsent.empty())
+	{
+		std::vector<char> batch;
+
+		for (const auto& operation : m_unsent) SequenceCrdt::s_write(operation, batch);
+
+		m_unsent.clear();
+
+		if (!m_socket.m_send(CollaborationRelay::Message_Batch, batch.data(), batch.size()))
+		{
+			m_leave();
+			return;
+		}
+	}
+
+	if (!open) m_leave();
+}
+
+void Collaboration::m_takeChanges()
+{
+	auto& changes = m_view.m_getDocument().m_changes;
+
+	if (m_crdt.has_value())
+	{
+		for (const auto& change : changes)
+		{
+			const bool reset = change.m_removed == std::wstring::npos;
+
+			const auto start = reset ? 0 : change.m_index;
+			const auto end   = reset ? m_crdt->m_getSize() : change.m_index + change.m_removed;
+
+			if (end > start)
+			{
+				for (const auto& removal : m_crdt->m_erase(start, end)) SequenceCrdt::s_append(m_unsent, removal);
+			}
+
+			if (!change.m_inserted.empty()) SequenceCrdt::s_append(m_unsent, m_crdt->m_insert(start, change.m_inserted));
+		}
+	}
+
+	changes.clear();
+}
+
+[[nodiscard]] bool Collaboration::m_handleMessage(const LocalSocket::Message& message)
+{
+	const auto& data = message.m_data;
+
+	switch (message.m_type)
+	{
+	case CollaborationRelay::Message_Welcome:
+
+		if (data.size() < sizeof(m_welcome)) return false;
+
+		std::memcpy(&m_welcome, data.data(), sizeof(m_welcome));
+		return true;
+	case CollaborationRelay::Message_History:
+
+		return !m_crdt.has_value() && m_welcome.m_client != 0 && m_startSession(data);
+	case CollaborationRelay::Message_Batch:
+
+		return m_crdt.has_value() && m_applyBatch(data);
+	default:
+		return false;
+	}
+}
+
+[[nodiscard]] bool Collaboration::m_startSession(const std::vector<char>& history)
+{
+	const auto operations = SequenceCrdt::s_read(history);
+
+	if (!operations.has_value()) return false;
+
+	m_crdt.emplace(m_welcome.m_client);
+
+	std::vector<SequenceCrdt::Edit> edits;
+
+	for (const auto& operation : operations.value())
+	{
+		if (!m_crdt->m_apply(operation, edits)) return false;
+	}
+
+	auto& document = m_view.m_getDocument();
+
+	const auto text = document.m_getText();
+
+	if (m_welcome.m_first != 0)
+	{
+		if (!text.empty()) SequenceCrdt::s_append(m_unsent, m_crdt->m_insert(0, text));
+	}
+	else
+	{
+		document.m_applyEdit(0, text.size(), m_crdt->m_getText());
+	}
+
+	return true;
+}
+
+[[nodiscard]] bool Collaboration::m_applyBatch(const std::vector<char>& batch)
+{
+	const auto operations = SequenceCrdt::s_read(batch);
+
+	if (!operations.has_value()) return false;
+
+	auto& document = m_view.m_getDocument();
+
+	std::vector<SequenceCrdt::Edit> edits;
+
+	for (const auto& operation : operations.value())
+	{
+		edits.clear();
+
+		// the relay forwards batches in the order it got them, an editor only names characters it had
+		if (!m_crdt->m_apply(operation, edits)) return false;
+
+		for (const auto& edit : edits) document.m_applyEdit(edit.m_index, edit.m_removed, edit.m_inserted);
+	}
+
+	return true;
+}
@@ -0,0 +1,127 @@
+#include "../include/collaboration_relay.h"
+
+#include <algorithm>
+#include <cstdio>
+
+[[nodiscard]] int CollaborationRelay::s_main(const int argc, const wchar_t* argv[])
+{
+	const auto path = argc > 2 ? s_getPath(argv[2]) : std::string();
+
+	if (path.empty())
+	{
+		std::fwprintf(stderr, L"usage: e --relay <name>, the name has only letters, digits, '-' and '_'\n");
+		return 1;
+	}
+
+	CollaborationRelay relay;
+
+	if (!LocalSocket::s_startup() || !relay.m_listen(path))
+	{
+		std::fwprintf(stderr, L"could not listen on %hs, the session may be relayed already\n", path.c_str());
+		return 1;
+	}
+
+	std::fwprintf(stdout, L"relaying %ls on %hs\n", argv[2], path.c_str());
+
+	relay.m_run();
+
+	return 0;
+}
+
+[[nodiscard]] std::string CollaborationRelay::s_getPath(const std::wstring_view name)
+{
+	if (name.empty()) return {};
+
+	std::string file = "e-relay-";
+
+	for (const auto c : name)
+	{
+		const bool allowed = (c >= L'a' && c <= L'z') || (c >= L'A' && c <= L'Z') || (c >= L'0' && c <= L'9') || c == L'-' || c == L'_';
+
+		if (!allowed) return {};
+
+		file.push_back(static_cast<char>(c));
+	}
+
+	return LocalSocket::s_getPath(file);
+}
+
+[[nodiscard]] bool CollaborationRelay::m_listen(const std::string& path) noexcept
+{
+	m_listener = LocalSocket::s_listen(path);
+
+	return m_listener.m_isValid();
+}
+
+void CollaborationRelay::m_run()
+{
+	std::vector<const LocalSocket*> sockets;
+
+	while (true)
+	{
+		sockets.assign(1, &m_listener);
+
+		for (const auto& client : m_clients) sockets.push_back(&client->m_socket);
+
+		LocalSocket::s_wait(sockets, s_waitTimeout);
+
+		m_acceptClients();
+
+		for (auto& client : m_clients)
+		{
+			// an editor that reads slowly gets its batches later, the others do not wait for it
+			const bool open = client->m_socket.m_flush() && client->m_socket.m_receive();
+
+			while (const auto message = client->m_socket.m_takeMessage())
+			{
+				if (message->m_type != Message_Batch)
+				{
+					client->m_closed = true;
+					break;
+				}
+
+				m_relay(*client, message->m_data);
+			}
+
+			if (!open) client->m_closed = true;
+		}
+
+		m_clients.erase(std::remove_if(m_clients.begin(), m_clients.end(), [] (const auto& client) { return client->m_closed; }), m_clients.end());
+	}
+}
+
+void CollaborationRelay::m_acceptClients()
+{
+	while (true)
+	{
+		auto socket = m_listener.m_accept();
+
+		if (!socket.m_isValid()) return;
+
+		auto client = std::make_unique<Client>();
+
+		client->m_socket = std::move(socket);
+
+		const WelcomeMessage welcome = { m_nextClient, m_nextClient == 1 ? 1u : 0u };
+
+		++m_nextClient;
+
+		if (!client->m_socket.m_send(Message_Welcome, &welcome, sizeof(welcome)) ||
+			!client->m_socket.m_send(Message_History, m_history.data(), m_history.size())) continue;
+
+		m_clients.push_back(std::move(client));
+	}
+}
+
+void CollaborationRelay::m_relay(const Client& sender, const std::vector<char>& batch)
+{
+	m_history.insert(m_history.end(), batch.cbegin(), batch.cend());
+
+	for (auto& client : m_clients)
+	{
+		if (client.get() == &sender || client->m_closed) continue;
+
+		// fails once the editor is more than LocalSocket::s_maxBacklog behind, it can join again and take the history
+		if (!client->m_socket.m_send(Message_Batch, batch.data(), batch.size())) client->m_closed = true;
+	}
+}
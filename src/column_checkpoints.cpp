@@ -0,0 +1,173 @@
+#include "../include/column_checkpoints.h"
+
+#include <algorithm>
+
+void ColumnCheckpoints::m_setLayout(const SizeType width, const SizeType tabSize) noexcept
+{
+	if (width == m_width && tabSize == m_tabSize) return;
+
+	m_width   = width;
+	m_tabSize = tabSize;
+
+	m_lines.clear();
+}
+
+void ColumnCheckpoints::m_advance(State& state, const wchar_t c) const noexcept
+{
+	const auto charWidth = s_getCharWidth(c, m_tabSize);
+
+	if (state.m_rowColumn > 0 && state.m_rowColumn + charWidth > m_width)
+	{
+		++state.m_row;
+		state.m_rowColumn = 0;
+	}
+
+	state.m_rowColumn += charWidth;
+	state.m_column    += charWidth;
+
+	++state.m_index;
+}
+
+[[nodiscard]] ColumnCheckpoints::State ColumnCheckpoints::m_getStateAt(const std::wstring_view text,
+	const SizeType lineStart, const SizeType lineEnd, const SizeType index)
+{
+	State state;
+
+	state.m_index = lineStart;
+
+	if (lineEnd - lineStart >= s_interval)
+	{
+		auto& line = m_getLine(lineStart);
+
+		const auto checkpoint = (index - lineStart) / s_interval;
+
+		m_extend(line, text, lineEnd, [checkpoint] (const State& last) { return last.m_index >= checkpoint * s_interval; });
+
+		state = line.m_states[std::min(checkpoint, line.m_states.size() - 1)];
+		state.m_index += lineStart;
+	}
+
+	while (state.m_index < index) m_advance(state, text[state.m_index]);
+
+	return state;
+}
+
+[[nodiscard]] ColumnCheckpoints::State ColumnCheckpoints::m_getStateBeforeColumn(const std::wstring_view text,
+	const SizeType lineStart, const SizeType lineEnd, const SizeType column)
+{
+	if (lineEnd - lineStart < s_interval) return { lineStart, 0, 0, 0 };
+
+	auto& line = m_getLine(lineStart);
+
+	m_extend(line, text, lineEnd, [column] (const State& last) { return last.m_column > column; });
+
+	const auto it = std::upper_bound(line.m_states.cbegin() + 1, line.m_states.cend(), column,
+		[] (const SizeType value, const State& state) { return value < state.m_column; });
+
+	auto state = *(it - 1);
+	state.m_index += lineStart;
+
+	return state;
+}
+
+[[nodiscard]] ColumnCheckpoints::State ColumnCheckpoints::m_getStateBeforeRow(const std::wstring_view text,
+	const SizeType lineStart, const SizeType lineEnd, const SizeType row)
+{
+	if (lineEnd - lineStart < s_interval) return { lineStart, 0, 0, 0 };
+
+	auto& line = m_getLine(lineStart);
+
+	m_extend(line, text, lineEnd, [row] (const State& last) { return last.m_row >= row; });
+
+	const auto it = std::lower_bound(line.m_states.cbegin() + 1, line.m_states.cend(), row,
+		[] (const State& state, const SizeType value) { return state.m_row < value; });
+
+	auto state = *(it - 1);
+	state.m_index += lineStart;
+
+	return state;
+}
+
+void ColumnCheckpoints::m_onInsert(const SizeType index, const SizeType size, const bool hasNewLine) noexcept
+{
+	for (auto& line : m_lines)
+	{
+		if (index < line.m_start)
+		{
+			line.m_start += size;
+		}
+		else if (index == line.m_start && hasNewLine)
+		{
+			// the line starts somewhere else now
+			line.m_states.clear();
+		}
+		else
+		{
+			// checkpoints up to index only depend on the text before it
+			line.m_states.resize(std::min(line.m_states.size(), (index - line.m_start) / s_interval + 1));
+		}
+	}
+
+	m_lines.erase(std::remove_if(m_lines.begin(), m_lines.end(), [] (const Line& line) { return line.m_states.empty(); }), m_lines.end());
+}
+
+void ColumnCheckpoints::m_onErase(const SizeType start, const SizeType end) noexcept
+{
+	for (auto& line : m_lines)
+	{
+		if (end < line.m_start)
+		{
+			line.m_start -= end - start;
+		}
+		else if (start < line.m_start)
+		{
+			// the newline before the line is removed
+			line.m_states.clear();
+		}
+		else
+		{
+			line.m_states.resize(std::min(line.m_states.size(), (start - line.m_start) / s_interval + 1));
+		}
+	}
+
+	m_lines.erase(std::remove_if(m_lines.begin(), m_lines.end(), [] (const Line& line) { return line.m_states.empty(); }), m_lines.end());
+}
+
+[[nodiscard]] ColumnCheckpoints::Line& ColumnCheckpoints::m_getLine(const SizeType lineStart)
+{
+	++m_useCounter;
+
+	for (auto& line : m_lines)
+	{
+		if (line.m_start == lineStart)
+		{
+			line.m_lastUse = m_useCounter;
+			return line;
+		}
+	}
+
+	if (m_lines.size() < s_cachedLines) m_lines.emplace_back();
+
+	auto& line = *std::min_element(m_lines.begin(), m_lines.end(), [] (const Line& lhs, const Line& rhs) { return lhs.m_lastUse < rhs.m_lastUse; });
+
+	line.m_start   = lineStart;
+	line.m_lastUse = m_useCounter;
+
+	// the line start itself is always the first checkpoint
+	line.m_states.assign(1, State{});
+
+	return line;
+}
+
+template<typename Function>
+void ColumnCheckpoints::m_extend(Line& line, const std::wstring_view text, const SizeType lineEnd, Function&& stop)
+{
+	while (!stop(line.m_states.back()) && line.m_start + line.m_states.back().m_index + s_interval <= lineEnd)
+	{
+		auto state = line.m_states.back();
+
+		for (SizeType i = 0; i < s_interval; ++i) m_advance(state, text[line.m_start + state.m_index]);
+
+		line.m_states.push_back(state);
+	}
+}
@@ -4,12 +4,205 @@
 #include <sstream>
 #include <cwchar>
 #include <chrono>
+#include <algorithm>
 
 #define CONSOLE_ASSERT(x, ...)\
     if (!(x)) { Console::s_reportLastError(#x, __FILE__, __LINE__, __VA_ARGS__); return false; }
 
+namespace
+{
+    // with virtual terminal input the keys come as characters and escape sequences without
+    // a virtual key code, the ones the editor handles are turned back into key events
+    enum class KeySequence
+    {
+        Partial,
+        Complete,
+        Unknown
+    };
+
+    [[nodiscard]] bool IsVirtualTerminalInput(const std::vector<KEY_EVENT_RECORD>& events) noexcept
+    {
+        return std::all_of(events.begin(), events.end(), [](const auto& event) { return event.wVirtualKeyCode == 0; });
+    }
+
+    [[nodiscard]] constexpr WORD VirtualKeyOf(const wchar_t c) noexcept
+    {
+        if (c >= L'a' && c <= L'z') return static_cast<WORD>(c - L'a' + L'A');
+
+        if ((c >= L'A' && c <= L'Z') || (c >= L'0' && c <= L'9')) return static_cast<WORD>(c);
+
+        return 0;
+    }
+
+    // xterm sends the modifiers as 1 + shift 1 + alt 2 + ctrl 4
+    [[nodiscard]] constexpr DWORD ControlKeyStateOf(const unsigned modifier) noexcept
+    {
+        const unsigned bits = modifier > 0 ? modifier - 1 : 0;
+
+        DWORD state = 0;
+
+        if (bits & 1u) state |= SHIFT_PRESSED;
+        if (bits & 2u) state |= LEFT_ALT_PRESSED;
+        if (bits & 4u) state |= LEFT_CTRL_PRESSED;
+
+        return state;
+    }
+
+    [[nodiscard]] KEY_EVENT_RECORD DecodeKeyCharacter(KEY_EVENT_RECORD event) noexcept
+    {
+        if (event.wVirtualKeyCode != 0 || !event.bKeyDown) return event;
+
+        const wchar_t c = event.uChar.UnicodeChar;
+
+        switch (c)
+        {
+        case L'\x1b': event.wVirtualKeyCode = VK_ESCAPE; break;
+        case L'\r'  : event.wVirtualKeyCode = VK_RETURN; break;
+        case L'\t'  : event.wVirtualKeyCode = VK_TAB;    break;
+        case L'\x7f': event.wVirtualKeyCode = VK_BACK;   break;
+
+        // ctrl + backspace
+        case L'\b':
+            event.wVirtualKeyCode = VK_BACK;
+            event.dwControlKeyState |= LEFT_CTRL_PRESSED;
+            break;
+        default:
+            // control characters are ctrl and a letter
+            if (c >= L'\x01' && c <= L'\x1a')
+            {
+                event.wVirtualKeyCode = static_cast<WORD>(VirtualKeyCode::A + (c - L'\x01'));
+                event.dwControlKeyState |= LEFT_CTRL_PRESSED;
+            }
+            else
+            {
+                event.wVirtualKeyCode = VirtualKeyOf(c);
+
+                if (c >= L'A' && c <= L'Z') event.dwControlKeyState |= SHIFT_PRESSED;
+            }
+            break;
+        }
+
+        return event;
+    }
+
+    [[nodiscard]] WORD VirtualKeyOfTilde(const unsigned code) noexcept
+    {
+        switch (code)
+        {
+        case 1: case 7: return VK_HOME;
+        case 2:         return VK_INSERT;
+        case 3:         return VK_DELETE;
+        case 4: case 8: return VK_END;
+        case 5:         return VK_PRIOR;
+        case 6:         return VK_NEXT;
+        case 11:        return VK_F1;
+        case 12:        return VK_F2;
+        case 13:        return VK_F3;
+        case 14:        return VK_F4;
+        case 15:        return VK_F5;
+        case 17:        return VK_F6;
+        case 18:        return VK_F7;
+        case 19:        return VK_F8;
+        case 20:        return VK_F9;
+        case 21:        return VK_F10;
+        case 23:        return VK_F11;
+        case 24:        return VK_F12;
+        default:        return 0;
+        }
+    }
+
+    [[nodiscard]] WORD VirtualKeyOfFinal(const wchar_t c) noexcept
+    {
+        switch (c)
+        {
+        case L'A': return VK_UP;
+        case L'B': return VK_DOWN;
+        case L'C': return VK_RIGHT;
+        case L'D': return VK_LEFT;
+        case L'H': return VK_HOME;
+        case L'F': return VK_END;
+        case L'P': return VK_F1;
+        case L'Q': return VK_F2;
+        case L'R': return VK_F3;
+        case L'S': return VK_F4;
+        case L'Z': return VK_TAB;
+        default:   return 0;
+        }
+    }
+
+    // text has to start with escape, partial while more characters can still make it a known key
+    [[nodiscard]] KeySequence DecodeKeySequence(const std::wstring_view text, KEY_EVENT_RECORD& key) noexcept
+    {
+        constexpr std::size_t maxSequenceSize = 16;
+
+        if (text.empty() || text.front() != L'\x1b') return KeySequence::Unknown;
+
+        if (text.size() == 1) return KeySequence::Partial;
+
+        key = {};
+        key.bKeyDown = TRUE;
+        key.wRepeatCount = 1;
+
+        if (text[1] != L'[' && text[1] != L'O')
+        {
+            if (text.size() > 2) return KeySequence::Unknown;
+
+            // alt and a character
+            key.uChar.UnicodeChar = text[1];
+            key = DecodeKeyCharacter(key);
+            key.dwControlKeyState |= LEFT_ALT_PRESSED;
+
+            return KeySequence::Complete;
+        }
+
+        std::size_t end = 2;
+
+        while (end < text.size() && ((text[end] >= L'0' && text[end] <= L'9') || text[end] == L';')) ++end;
+
+        if (end == text.size()) return text.size() < maxSequenceSize ? KeySequence::Partial : KeySequence::Unknown;
+
+        if (end + 1 != text.size()) return KeySequence::Unknown;
+
+        // the key code or 1 and then the modifiers
+        unsigned parameters[2] = { 0, 1 };
+        std::size_t index = 0;
+
+        for (const auto c : text.substr(2, end - 2))
+        {
+            if (c != L';')
+            {
+                parameters[index] = parameters[index] * 10 + static_cast<unsigned>(c - L'0');
+                continue;
+            }
+
+            if (++index == std::size(parameters)) return KeySequence::Unknown;
+
+            parameters[index] = 0;
+        }
+
+        const wchar_t final = text[end];
+
+        key.wVirtualKeyCode = final == L'~' ? VirtualKeyOfTilde(parameters[0]) : VirtualKeyOfFinal(final);
+
+        if (key.wVirtualKeyCode == 0) return KeySequence::Unknown;
+
+        key.dwControlKeyState = ControlKeyStateOf(parameters[1]);
+
+        // back tab
+        if (final == L'Z') key.dwControlKeyState |= SHIFT_PRESSED;
+
+        return KeySequence::Complete;
+    }
+} // namespace
+
 Console::~Console() 
 {
+    // a headless console changed nothing
+    if (!m_handleOut) return;
+
+    m_setBracketedPaste(false);
+
+    SetConsoleMode(m_handleOut, m_oldOutputHandleMode);
     CloseHandle(m_handleOut);
 
     SetConsoleActiveScreenBuffer(GetStdHandle(STD_OUTPUT_HANDLE));
@@ -50,6 +243,7 @@ Console::~Console()
 
     CONSOLE_ASSERT( GetConsoleMode              ( m_handleIn , &m_oldInputHandleMode    ) );
     CONSOLE_ASSERT( SetConsoleMode              ( m_handleIn , consoleMode              ) );
+    CONSOLE_ASSERT( GetConsoleMode              ( m_handleOut, &m_oldOutputHandleMode   ) );
     CONSOLE_ASSERT( SetConsoleWindowInfo        ( m_handleOut, true, &consoleWindow     ) );
     CONSOLE_ASSERT( SetConsoleScreenBufferSize  ( m_handleOut, m_consoleSizeCoord()     ) );
     CONSOLE_ASSERT( SetConsoleActiveScreenBuffer( m_handleOut                           ) );
@@ -63,10 +257,19 @@ Console::~Console()
     csbi.dwMaximumWindowSize.X, L", ", csbi.dwMaximumWindowSize.Y, L"}");
 
     CONSOLE_ASSERT(m_setCursorInfo(visibleCursor));
+
+    m_setBracketedPaste(true);
     
     return true;
 }
 
+[[nodiscard]] bool Console::m_constructHeadless(const int width, const int height) noexcept
+{
+    m_createScreenBuffer(width, height);
+
+    return true;
+}
+
 void Console::m_run() noexcept
 {
     while (m_runing)
@@ -132,8 +335,18 @@ void Console::s_reportLastError(const char* funcName, const char* fileName,
 
 void Console::m_renderConsole() noexcept
 {
+    // the cells of a headless console are read by whoever draws them
+    if (!m_handleOut) return;
+
     auto rect = m_consoleRect();
 
+    // one pass over the two arrays, the console api takes interleaved cells
+    for (std::size_t i = 0; i < m_screenBuffer.size(); ++i)
+    {
+        m_screenBuffer[i].Char.UnicodeChar = m_chars[i];
+        m_screenBuffer[i].Attributes       = m_attributes[i];
+    }
+
     WriteConsoleOutputW(m_handleOut, m_screenBuffer.data(), m_consoleSizeCoord(), { 0, 0 }, &rect);
 }
 
@@ -145,41 +358,56 @@ void Console::m_handleEvents() noexcept
 
     if (eventCount > 0)
     {
-        INPUT_RECORD inputBuffer[32];
+        // pasted text arrives as thousands of events, read them in big batches
+        INPUT_RECORD inputBuffer[512];
 
-        ReadConsoleInputW(m_handleIn, inputBuffer, 32, &eventCount);
+        ReadConsoleInputW(m_handleIn, inputBuffer, 512, &eventCount);
 
-        for (std::size_t i = 0; i < eventCount; ++i)
-        {
-            const auto& event = inputBuffer[i];
+        m_dispatchInputEvents(inputBuffer, eventCount);
 
-            switch(event.EventType)
-            {
-            case KEY_EVENT:
-                
-                m_childHandleKeyEvents(event.Event.KeyEvent);
-                break;
-            case MOUSE_EVENT:
-            {
-                const auto& mouseEvent = event.Event.MouseEvent;
+        // a paste or an escape sequence may continue in the next batch
+        GetNumberOfConsoleInputEvents(m_handleIn, &eventCount);
 
-                m_leftMouseButton.m_handleEvent (mouseEvent);
-                m_rightMouseButton.m_handleEvent(mouseEvent);
-
-                m_childHandleMouseEvents(mouseEvent);
-                
-                break;
-            }
-            default:
-                break;
-            }
-        }
+        if (eventCount == 0) m_flushKeyEvents();
     }
 
     CONSOLE_SCREEN_BUFFER_INFO csbi = {};
     GetConsoleScreenBufferInfo(m_handleOut, &csbi);
 
     m_resizeConsole( { static_cast<short>(csbi.srWindow.Right + 1), static_cast<short>(csbi.srWindow.Bottom + 1) } );
+
+    m_childHandleIdle();
+}
+
+void Console::m_dispatchInputEvents(const INPUT_RECORD* events, const std::size_t count) noexcept
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const auto& event = events[i];
+
+        switch(event.EventType)
+        {
+        case KEY_EVENT:
+            
+            m_decodeKeyEvent(event.Event.KeyEvent);
+            break;
+        case MOUSE_EVENT:
+        {
+            m_flushKeyEvents();
+
+            const auto& mouseEvent = event.Event.MouseEvent;
+
+            m_leftMouseButton.m_handleEvent (mouseEvent);
+            m_rightMouseButton.m_handleEvent(mouseEvent);
+
+            m_childHandleMouseEvents(mouseEvent);
+            
+            break;
+        }
+        default:
+            break;
+        }
+    }
 }
 
 void Console::m_resizeConsole(const COORD newSize) noexcept
@@ -189,7 +417,7 @@ void Console::m_resizeConsole(const COORD newSize) noexcept
 		const auto oldCoord = m_consoleSizeCoord();
         
         m_createScreenBuffer(newSize.X, newSize.Y);
-		SetConsoleScreenBufferSize(m_handleOut, newSize);
+		if (m_handleOut) SetConsoleScreenBufferSize(m_handleOut, newSize);
         m_childHandleResizeEvent(oldCoord, newSize);
     }
 }
@@ -200,51 +428,202 @@ void Console::m_createScreenBuffer(const int width, const int height) noexcept
     m_width  = width;   
     m_height = height;
 
+    m_chars       .resize(m_screenBufferSize());
+    m_attributes  .resize(m_screenBufferSize());
     m_screenBuffer.resize(m_screenBufferSize());
 }
 
-bool Console::s_setUserClipboard(const std::wstring_view str) noexcept
+void Console::m_decodeKeyEvent(const KEY_EVENT_RECORD& event) noexcept
 {
-	if (!OpenClipboard(nullptr)) return false;
+    const wchar_t c = event.bKeyDown ? event.uChar.UnicodeChar : L'\0';
 
-	const auto size = (str.size() + 1) * sizeof(wchar_t);
+    switch (m_pasteState)
+    {
+    case PasteState::Bracketed:
 
-	const auto stringHandle = GlobalAlloc(GMEM_MOVEABLE, size);
+        if (c) m_pasteBuffer.push_back(c);
 
-	if (!stringHandle) return false;
+        if (m_pasteBuffer.size() >= s_bracketedPasteEnd.size() && 
+            std::wstring_view(m_pasteBuffer).substr(m_pasteBuffer.size() - s_bracketedPasteEnd.size()) == s_bracketedPasteEnd)
+        {
+            m_pasteBuffer.resize(m_pasteBuffer.size() - s_bracketedPasteEnd.size());
+            m_endPaste();
+        }
 
-	const auto lockedStr = GlobalLock(stringHandle);
+        return;
+    case PasteState::Burst:
 
-	if (!lockedStr) return false;
+        if (s_isTextKeyEvent(event))
+        {
+            if (c) m_pasteBuffer.push_back(c);
+            return;
+        }
 
-	std::memcpy(lockedStr, str.data(), size);
+        m_endPaste();
+        break;
+    case PasteState::None:
+        break;
+    }
 
-	GlobalUnlock(stringHandle);
+    // escape may start a bracketed paste sequence
+    if (c == L'\x1b') m_flushKeyEvents();
 
-	if (!SetClipboardData(CF_UNICODETEXT, stringHandle)) return false;
+    m_pendingKeyEvents.push_back(event);
 
-	CloseClipboard();
+    if (c) m_pendingText.push_back(c);
+
+    if (!m_pendingText.empty() && m_pendingText.front() == L'\x1b')
+    {
+        if (m_pendingText == s_bracketedPasteStart)
+        {
+            m_pendingKeyEvents.clear();
+            m_pendingText.clear();
+            m_pasteBuffer.clear();
+
+            m_pasteState = PasteState::Bracketed;
+            return;
+        }
+
+        // wait for the rest of the sequence
+        if (s_bracketedPasteStart.substr(0, m_pendingText.size()) == m_pendingText) return;
+
+        KEY_EVENT_RECORD key;
+
+        if (IsVirtualTerminalInput(m_pendingKeyEvents) && DecodeKeySequence(m_pendingText, key) == KeySequence::Partial) return;
+    }
+    else if (s_isTextKeyEvent(event))
+    {
+        if (m_pendingText.size() < s_pasteBurstSize) return;
+
+        // more characters at once than anyone can type
+        m_pasteBuffer = std::move(m_pendingText);
+
+        m_pendingKeyEvents.clear();
+        m_pendingText.clear();
+
+        m_pasteState = PasteState::Burst;
+        return;
+    }
+
+    m_flushKeyEvents();
+}
+
+void Console::m_flushKeyEvents() noexcept
+{
+    if (m_pasteState == PasteState::Burst) m_endPaste();
 
-	return true;
+    KEY_EVENT_RECORD key;
+
+    // a whole escape sequence from a virtual terminal is a single key
+    if (m_pendingText.size() > 1 && IsVirtualTerminalInput(m_pendingKeyEvents) && 
+        DecodeKeySequence(m_pendingText, key) == KeySequence::Complete)
+    {
+        // the editor follows shift through its own key events
+        KEY_EVENT_RECORD shift = {};
+        shift.bKeyDown = TRUE;
+        shift.wRepeatCount = 1;
+        shift.wVirtualKeyCode = VK_SHIFT;
+        shift.dwControlKeyState = key.dwControlKeyState;
+
+        const bool shiftPressed = (key.dwControlKeyState & SHIFT_PRESSED) != 0;
+
+        if (shiftPressed) m_childHandleKeyEvents(shift);
+
+        m_childHandleKeyEvents(key);
+
+        key.bKeyDown = FALSE;
+        m_childHandleKeyEvents(key);
+
+        if (shiftPressed)
+        {
+            shift.bKeyDown = FALSE;
+            shift.dwControlKeyState &= ~static_cast<DWORD>(SHIFT_PRESSED);
+            m_childHandleKeyEvents(shift);
+        }
+    }
+    else for (const auto& event : m_pendingKeyEvents)
+    {
+        m_childHandleKeyEvents(DecodeKeyCharacter(event));
+    }
+
+    m_pendingKeyEvents.clear();
+    m_pendingText.clear();
 }
 
-[[nodiscard]] std::optional<std::wstring> Console::s_getUserClipboard() noexcept
-{	
-	if (!OpenClipboard(nullptr)) return {};
+void Console::m_endPaste() noexcept
+{
+    m_pasteState = PasteState::None;
 
-	const auto clipboardHandle = GetClipboardData(CF_UNICODETEXT);
-	
-	if (!clipboardHandle) return {};
-	
-	const auto data = static_cast<wchar_t*>(GlobalLock(clipboardHandle));
-	
-	if (!data) return {};
+    // terminals send enter as \r, clipboard text uses \r\n
+    std::size_t size = 0;
 
-	std::optional<std::wstring> result = { data };
+    for (std::size_t i = 0; i < m_pasteBuffer.size(); ++i)
+    {
+        if (m_pasteBuffer[i] == L'\r')
+        {
+            m_pasteBuffer[size++] = L'\n';
 
-	GlobalUnlock(clipboardHandle);
+            if (i + 1 < m_pasteBuffer.size() && m_pasteBuffer[i + 1] == L'\n') ++i;
+        }
+        else m_pasteBuffer[size++] = m_pasteBuffer[i];
+    }
+
+    m_pasteBuffer.resize(size);
+
+    if (!m_pasteBuffer.empty()) m_childHandlePasteEvent(std::move(m_pasteBuffer));
+
+    m_pasteBuffer.clear();
+}
+
+void Console::m_setBracketedPaste(const bool enable) const noexcept
+{
+    // ENABLE_VIRTUAL_TERMINAL_PROCESSING, consoles without it do not understand the sequence
+    constexpr DWORD virtualTerminalProcessing = 0x0004;
+
+    // ENABLE_VIRTUAL_TERMINAL_INPUT, without it the console drops the paste markers from the input,
+    // the keys then come as sequences too and are decoded in m_decodeKeyEvent
+    constexpr DWORD virtualTerminalInput = 0x0200;
+
+    DWORD outputMode = 0;
+    DWORD inputMode  = 0;
+
+    if (!GetConsoleMode(m_handleOut, &outputMode) || !SetConsoleMode(m_handleOut, outputMode | virtualTerminalProcessing)) return;
+
+    if (!GetConsoleMode(m_handleIn, &inputMode)) return;
+
+    if (!SetConsoleMode(m_handleIn, enable ? (inputMode | virtualTerminalInput) : (inputMode & ~virtualTerminalInput))) return;
+
+    const std::wstring_view sequence = enable ? L"\x1b[?2004h" : L"\x1b[?2004l";
+
+    WriteConsoleW(m_handleOut, sequence.data(), static_cast<DWORD>(sequence.size()), nullptr, nullptr);
+}
+
+bool Console::s_setUserClipboard(const std::wstring_view str) noexcept
+{
+	if (!OpenClipboard(nullptr)) return false;
+
+	EmptyClipboard();
+
+	bool result = false;
+
+	// the text is written straight into the clipboard memory
+	if (const auto stringHandle = GlobalAlloc(GMEM_MOVEABLE, (str.size() + 1) * sizeof(wchar_t)))
+	{
+		if (const auto lockedStr = static_cast<wchar_t*>(GlobalLock(stringHandle)))
+		{
+			std::memcpy(lockedStr, str.data(), str.size() * sizeof(wchar_t));
+			lockedStr[str.size()] = L'\0';
+
+			GlobalUnlock(stringHandle);
+
+			result = SetClipboardData(CF_UNICODETEXT, stringHandle) != nullptr;
+		}
+
+		// clipboard owns the memory only after SetClipboardData succeeds
+		if (!result) GlobalFree(stringHandle);
+	}
 
 	CloseClipboard();
 
 	return result;
-}
\ No newline at end of file
+}
@@ -0,0 +1,212 @@
+#include "../include/console_client.h"
+
+#include <cstring>
+#include <vector>
+
+[[nodiscard]] std::optional<int> ConsoleClient::s_attach(const int argc, const wchar_t* argv[])
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::wstring_view arg = argv[i];
+
+		// a collaboration is kept by the editor that joined it
+		if (arg == L"--local" || arg.substr(0, 9) == L"--collab=") return {};
+	}
+
+	if (!LocalSocket::s_startup()) return {};
+
+	auto socket = LocalSocket::s_connect(LocalSocket::s_getPath(EditorServer::s_socketName));
+
+	if (!socket.m_isValid()) return {};
+
+	ConsoleClient client;
+
+	client.m_socket = std::move(socket);
+
+	if (!client.m_constructClient(argc, argv)) return -1;
+
+	client.m_runClient();
+
+	return 0;
+}
+
+[[nodiscard]] bool ConsoleClient::m_constructClient(const int argc, const wchar_t* argv[]) noexcept
+{
+	int width  = 80;
+	int height = 40;
+
+	short fontW = 8;
+	short fontH = 16;
+
+	std::vector<std::wstring_view> args;
+
+	for (int i = 0; i < argc; ++i)
+	{
+		const std::wstring_view arg = argv[i];
+
+		if (arg.substr(0, 2) != L"--") args.push_back(arg);
+	}
+
+	if (args.size() > 3)
+	{
+		width  = _wtoi(args[2].data());
+		height = _wtoi(args[3].data());
+
+		if (args.size() > 5)
+		{
+			fontW = static_cast<short>(_wtoi(args[4].data()));
+			fontH = static_cast<short>(_wtoi(args[5].data()));
+		}
+	}
+
+	if (!m_construct(width, height, fontW, fontH, true, s_defalutConsoleMode)) return false;
+
+	// the server runs in another directory
+	std::wstring path;
+
+	if (args.size() > 1)
+	{
+		path.resize(MAX_PATH + 1);
+
+		const auto length = GetFullPathNameW(args[1].data(), static_cast<DWORD>(path.size()), path.data(), nullptr);
+
+		if (length == 0 || length > path.size()) return false;
+
+		path.resize(length);
+	}
+
+	const EditorServer::HelloMessage hello = { { static_cast<short>(m_screenWidth()), static_cast<short>(m_screenHeight()) } };
+
+	std::vector<char> data(sizeof(hello) + path.size() * sizeof(wchar_t));
+
+	std::memcpy(data.data(), &hello, sizeof(hello));
+	std::memcpy(data.data() + sizeof(hello), path.data(), path.size() * sizeof(wchar_t));
+
+	return m_socket.m_send(EditorServer::Message_Hello, data.data(), data.size());
+}
+
+void ConsoleClient::m_runClient()
+{
+	// console input can not be waited on together with the socket, it is read between short waits
+	constexpr long waitTimeout = 5;
+
+	while (true)
+	{
+		m_forwardInput();
+
+		const bool open = m_socket.m_flush() && m_socket.m_receive();
+
+		bool changed = false;
+
+		while (const auto message = m_socket.m_takeMessage())
+		{
+			changed = m_handleMessage(message.value()) || changed;
+		}
+
+		if (changed) m_renderConsole();
+
+		if (!open) return;
+
+		LocalSocket::s_wait({ &m_socket }, waitTimeout);
+	}
+}
+
+void ConsoleClient::m_forwardInput()
+{
+	DWORD eventCount = 0;
+
+	GetNumberOfConsoleInputEvents(m_getConsoleHandleIn(), &eventCount);
+
+	if (eventCount > 0)
+	{
+		INPUT_RECORD inputBuffer[512];
+
+		ReadConsoleInputW(m_getConsoleHandleIn(), inputBuffer, 512, &eventCount);
+
+		// alt gr arrives as ctrl + alt, the server can not ask the keyboard of this console about it
+		if (GetKeyState(VK_RMENU) & 0x8000)
+		{
+			for (DWORD i = 0; i < eventCount; ++i)
+			{
+				if (inputBuffer[i].EventType == KEY_EVENT) inputBuffer[i].Event.KeyEvent.dwControlKeyState &= ~s_ctrlKeyFlag;
+			}
+		}
+
+		DWORD pendingCount = 0;
+
+		GetNumberOfConsoleInputEvents(m_getConsoleHandleIn(), &pendingCount);
+
+		const EditorServer::InputMessage input = { pendingCount > 0 ? 1u : 0u };
+
+		std::vector<char> data(sizeof(input) + eventCount * sizeof(INPUT_RECORD));
+
+		std::memcpy(data.data(), &input, sizeof(input));
+		std::memcpy(data.data() + sizeof(input), inputBuffer, eventCount * sizeof(INPUT_RECORD));
+
+		if (!m_socket.m_send(EditorServer::Message_Input, data.data(), data.size())) m_socket.m_close();
+	}
+
+	CONSOLE_SCREEN_BUFFER_INFO csbi = {};
+	GetConsoleScreenBufferInfo(m_getConsoleHandleOut(), &csbi);
+
+	m_resizeConsole( { static_cast<short>(csbi.srWindow.Right + 1), static_cast<short>(csbi.srWindow.Bottom + 1) } );
+}
+
+bool ConsoleClient::m_handleMessage(const LocalSocket::Message& message)
+{
+	const auto& data = message.m_data;
+
+	switch (message.m_type)
+	{
+	case EditorServer::Message_Frame:
+	{
+		if (data.size() < sizeof(EditorServer::FrameMessage)) return false;
+
+		EditorServer::FrameMessage frame;
+		std::memcpy(&frame, data.data(), sizeof(frame));
+
+		// the server draws the new size after the resize message arrives
+		if (frame.m_size.X != m_screenWidth() || frame.m_size.Y != m_screenHeight()) return false;
+
+		std::size_t offset = sizeof(frame);
+
+		for (std::uint32_t i = 0; i < frame.m_runCount; ++i)
+		{
+			EditorServer::FrameRun run;
+
+			if (data.size() - offset < sizeof(run)) return true;
+
+			std::memcpy(&run, data.data() + offset, sizeof(run));
+			offset += sizeof(run);
+
+			const auto cellsSize = static_cast<std::size_t>(run.m_size) * (sizeof(wchar_t) + sizeof(WORD));
+
+			if (data.size() - offset < cellsSize) return true;
+
+			// runs are a multiple of four bytes, the cells are aligned for their types
+			m_copyChars (run.m_index, reinterpret_cast<const wchar_t*>(data.data() + offset), run.m_size);
+			m_copyColors(run.m_index, reinterpret_cast<const WORD*>   (data.data() + offset + run.m_size * sizeof(wchar_t)), run.m_size);
+
+			offset += cellsSize;
+		}
+
+		m_setCursorPos(frame.m_cursorPos);
+		m_setCursorInfo(frame.m_cursorVisible != 0);
+
+		return true;
+	}
+	case EditorServer::Message_Title:
+
+		m_setConsoleTitle({ reinterpret_cast<const wchar_t*>(data.data()), data.size() / sizeof(wchar_t) });
+		return false;
+	default:
+		return false;
+	}
+}
+
+void ConsoleClient::m_childHandleResizeEvent(const COORD, const COORD newSize)
+{
+	const EditorServer::ResizeMessage resize = { newSize };
+
+	if (!m_socket.m_send(EditorServer::Message_Resize, &resize, sizeof(resize))) m_socket.m_close();
+}
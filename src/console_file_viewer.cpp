@@ -0,0 +1,438 @@
+#include "../include/console_file_viewer.h"
+
+#include <sstream>
+#include <algorithm>
+
+[[nodiscard]] bool ConsoleFileViewer::m_constructViewer(const int argc, const wchar_t* argv[]) noexcept
+{
+	// argv[1] is "--view"
+	if (argc < 3) return false;
+
+	int width  = 80;
+	int height = 40;
+
+	short fontW = 8;
+	short fontH = 16;
+
+	if (argc > 4)
+	{
+		width  = _wtoi(argv[3]);
+		height = _wtoi(argv[4]);
+
+		if (argc > 6)
+		{
+			fontW = static_cast<short>(_wtoi(argv[5]));
+			fontH = static_cast<short>(_wtoi(argv[6]));
+		}
+	}
+
+	const std::wstring_view filePath = argv[2];
+
+	if (!m_file.m_open(filePath)) return false;
+
+	if (!m_construct(width, height, fontW, fontH, false, s_defalutConsoleMode)) return false;
+
+	m_fileName = utils::GetFileName(filePath);
+
+	if (m_fileName.empty()) m_fileName = filePath;
+
+	m_setConsoleTitle(m_fileName);
+
+	m_draw();
+
+	return true;
+}
+
+[[nodiscard]] ConsoleFileViewer::SizeType ConsoleFileViewer::m_getViewHeight() const noexcept
+{
+	// status line and the prompt below it
+	const int reserved = m_prompt == Prompt::None ? 1 : 2;
+
+	return static_cast<SizeType>(std::max(0, m_screenHeight() - reserved));
+}
+
+void ConsoleFileViewer::m_scrollDown(SizeType lineCount)
+{
+	for (; lineCount > 0; --lineCount)
+	{
+		const auto next = m_file.m_getNextLineStart(m_topLine);
+
+		if (next >= m_file.m_getSize()) break;
+
+		m_topLine = next;
+	}
+}
+
+void ConsoleFileViewer::m_scrollUp(SizeType lineCount)
+{
+	for (; lineCount > 0 && m_topLine > 0; --lineCount)
+	{
+		m_topLine = m_file.m_getLineStart(m_topLine - 1);
+	}
+}
+
+void ConsoleFileViewer::m_scrollToEnd()
+{
+	m_topLine = m_file.m_getLineStart(m_file.m_getSize());
+
+	m_scrollUp(std::max<SizeType>(1, m_getViewHeight()) - 1);
+}
+
+void ConsoleFileViewer::m_draw()
+{
+	m_clearConsole();
+
+	const auto width = static_cast<SizeType>(m_screenWidth());
+	const auto viewHeight = m_getViewHeight();
+
+	std::wstring text;
+	std::vector<SizeType> columns;
+
+	auto offset = m_topLine;
+
+	for (SizeType y = 0; y < viewHeight && offset < m_file.m_getSize(); ++y)
+	{
+		const auto next = m_file.m_getNextLineStart(offset);
+
+		// only the visible part of the line is decoded, a character takes at most 4 bytes
+		m_file.m_readText(offset, std::min(next, offset + (m_column + width) * 4), text);
+
+		columns.clear();
+
+		SizeType column = 0;
+
+		for (const auto c : text)
+		{
+			columns.push_back(column);
+
+			const auto charWidth = c == L'\t' ? s_tabSize : 1;
+
+			for (SizeType i = 0; i < charWidth; ++i, ++column)
+			{
+				if (column >= m_column && column - m_column < width)
+				{
+					m_setGrid(static_cast<std::size_t>(column - m_column), static_cast<std::size_t>(y), c == L'\t' ? L' ' : c);
+				}
+			}
+		}
+
+		columns.push_back(column);
+
+		TextSearch::Cursor cursor(m_search, text);
+
+		for (auto i = cursor.m_findNext(0); i != TextSearch::s_npos; i = cursor.m_findNext(i + 1))
+		{
+			for (auto t = columns[i]; t < columns[i + m_search.m_size()]; ++t)
+			{
+				if (t >= m_column && t - m_column < width)
+				{
+					m_setColorAt(m_getIndex(static_cast<std::size_t>(t - m_column), static_cast<std::size_t>(y)), BACKGROUND_RED | BACKGROUND_GREEN);
+				}
+			}
+		}
+
+		offset = next;
+	}
+
+	m_drawStatus(viewHeight);
+
+	if (m_prompt != Prompt::None)
+	{
+		m_promptEditor.m_updateConsole(*this);
+		m_setCursorPos(m_promptEditor.m_cursorPos);
+	}
+
+	m_renderConsole();
+}
+
+void ConsoleFileViewer::m_drawStatus(const SizeType y)
+{
+	std::wstringstream ss;
+
+	switch (m_prompt)
+	{
+	case Prompt::GoTo:
+		ss << L"Go to line or percent (123 or 50%):";
+		break;
+	case Prompt::Find:
+		ss << L"Find:";
+		break;
+	case Prompt::None:
+	{
+		const auto size = m_file.m_getSize();
+
+		ss << m_fileName << L"  line ";
+
+		if (const auto line = m_file.m_getLineNumber(m_topLine)) ss << line.value() + 1;
+		else ss << L"?";
+
+		ss << L" of ";
+
+		if (const auto count = m_file.m_getLineCount()) ss << count.value();
+		else ss << L"?";
+
+		ss << L"  " << (size > 0 ? m_topLine * 100 / size : 100) << L"%";
+
+		if (!m_file.m_isIndexComplete()) ss << L"  indexing " << static_cast<int>(m_file.m_getIndexProgress() * 100) << L"%";
+
+		if (m_searchPosition.has_value())
+		{
+			ss << L"  searching " << (size > 0 ? m_searchPosition.value() * 100 / size : 100) << L"%  Esc: cancel";
+		}
+		else if (!m_message.empty())
+		{
+			ss << L"  " << m_message;
+		}
+		else
+		{
+			ss << L"  Ctrl+G: go to  Ctrl+F: find  F3: next  Esc: quit";
+		}
+
+		break;
+	}
+	}
+
+	m_drawRect(0, static_cast<std::size_t>(y), static_cast<std::size_t>(m_screenWidth()), 1, s_statusColor);
+	m_drawString(0, static_cast<std::size_t>(y), ss.str(), s_statusColor, false);
+}
+
+void ConsoleFileViewer::m_openPrompt(const Prompt prompt)
+{
+	m_prompt = prompt;
+	m_message.clear();
+
+	m_promptEditor.m_initEditor(m_screenWidth(), 1, s_statusColor, 0, m_screenHeight() - 1);
+	m_promptEditor.m_setInputBuffer(prompt == Prompt::Find ? std::wstring_view(m_search.m_getPattern()) : std::wstring_view());
+
+	m_setCursorInfo(true);
+}
+
+bool ConsoleFileViewer::m_goTo(std::wstring_view str)
+{
+	while (!str.empty() && str.front() == L' ') str.remove_prefix(1);
+	while (!str.empty() && str.back()  == L' ') str.remove_suffix(1);
+
+	const bool percent = !str.empty() && str.back() == L'%';
+
+	if (percent) str.remove_suffix(1);
+
+	if (str.empty() || str.size() > 18 || !std::all_of(str.cbegin(), str.cend(), [] (const wchar_t c) { return c >= L'0' && c <= L'9'; })) return false;
+
+	const auto value = static_cast<SizeType>(_wtoi64(std::wstring(str).c_str()));
+
+	if (percent)
+	{
+		// works before the line index knows anything
+		const auto size = m_file.m_getSize();
+
+		m_topLine = m_file.m_getLineStart(std::min<SizeType>(value, 100) * (size / 100) + std::min<SizeType>(value, 100) * (size % 100) / 100);
+		return true;
+	}
+
+	const auto [offset, exact] = m_file.m_findLine(value > 0 ? value - 1 : 0);
+
+	m_topLine = offset;
+
+	if (!exact) m_message = L"line is estimated until indexing reaches it";
+
+	return true;
+}
+
+void ConsoleFileViewer::m_startSearch(const SizeType start)
+{
+	if (m_search.m_empty()) return;
+
+	m_message.clear();
+	m_searchPosition = start;
+}
+
+void ConsoleFileViewer::m_continueSearch()
+{
+	const auto size = m_file.m_getSize();
+
+	std::wstring text;
+
+	for (SizeType chunk = 0; chunk < s_searchChunksPerIdle && m_searchPosition.has_value(); ++chunk)
+	{
+		const auto start = m_searchPosition.value();
+
+		if (start >= size)
+		{
+			m_searchPosition.reset();
+			m_message = L"not found";
+			return;
+		}
+
+		// chunks end at line ends, matches do not span lines
+		const auto end = m_file.m_getNextLineStart(std::min(size, start + s_searchChunkSize) - 1);
+
+		m_file.m_readText(start, end, text);
+
+		const auto index = m_search.m_findNext(text);
+
+		if (index != TextSearch::s_npos)
+		{
+			auto lineStart = start;
+
+			// the newlines before the match tell which line it is on
+			for (auto lines = std::count(text.cbegin(), text.cbegin() + static_cast<std::ptrdiff_t>(index), L'\n'); lines > 0; --lines)
+			{
+				lineStart = m_file.m_getNextLineStart(lineStart);
+			}
+
+			m_topLine = lineStart;
+			m_searchPosition.reset();
+			return;
+		}
+
+		m_searchPosition = end;
+	}
+}
+
+void ConsoleFileViewer::m_childHandleKeyEvents(const KEY_EVENT_RECORD& event)
+{
+	if (!event.bKeyDown) return;
+
+	if (m_prompt != Prompt::None)
+	{
+		switch (event.wVirtualKeyCode)
+		{
+		case VK_ESCAPE:
+			m_prompt = Prompt::None;
+			break;
+		case VK_RETURN:
+
+			if (m_prompt == Prompt::Find)
+			{
+				m_search = { m_promptEditor.m_buffer(), {} };
+				m_startSearch(m_topLine);
+			}
+			else if (!m_goTo(m_promptEditor.m_buffer()))
+			{
+				m_message = L"use a line number or a percentage";
+			}
+
+			m_prompt = Prompt::None;
+			break;
+		default:
+			m_promptEditor.m_handleEvents(*this, event);
+			break;
+		}
+
+		if (m_prompt == Prompt::None) m_setCursorInfo(false);
+
+		m_draw();
+		return;
+	}
+
+	if (m_searchPosition.has_value() && event.wVirtualKeyCode == VK_ESCAPE)
+	{
+		m_searchPosition.reset();
+		m_message = L"search cancelled";
+
+		m_draw();
+		return;
+	}
+
+	if (s_isCtrlKeyPressed(event))
+	{
+		switch (event.wVirtualKeyCode)
+		{
+		case VirtualKeyCode::G:
+			m_openPrompt(Prompt::GoTo);
+			break;
+		case VirtualKeyCode::F:
+			m_openPrompt(Prompt::Find);
+			break;
+		default:
+			break;
+		}
+
+		m_draw();
+		return;
+	}
+
+	const auto pageSize = std::max<SizeType>(1, m_getViewHeight());
+
+	switch (event.wVirtualKeyCode)
+	{
+	case VK_ESCAPE:
+	case VirtualKeyCode::Q:
+		m_closeConsole();
+		return;
+	case VK_UP:
+		m_scrollUp(1);
+		break;
+	case VK_DOWN:
+		m_scrollDown(1);
+		break;
+	case VK_PRIOR:
+		m_scrollUp(pageSize);
+		break;
+	case VK_NEXT:
+		m_scrollDown(pageSize);
+		break;
+	case VK_HOME:
+		m_topLine = 0;
+		break;
+	case VK_END:
+		m_scrollToEnd();
+		break;
+	case VK_LEFT:
+		m_column -= std::min<SizeType>(m_column, s_tabSize);
+		break;
+	case VK_RIGHT:
+		m_column += s_tabSize;
+		break;
+	case VK_F3:
+		m_startSearch(m_file.m_getNextLineStart(m_topLine));
+		break;
+	default:
+		return;
+	}
+
+	m_message.clear();
+
+	m_draw();
+}
+
+void ConsoleFileViewer::m_childHandleMouseEvents(const MOUSE_EVENT_RECORD& event)
+{
+	if (event.dwEventFlags != MOUSE_WHEELED) return;
+
+	const short wheelRotation = HIWORD(event.dwButtonState);
+
+	if (wheelRotation < 0) m_scrollDown(3);
+	else m_scrollUp(3);
+
+	m_draw();
+}
+
+void ConsoleFileViewer::m_childHandleResizeEvent(const COORD, const COORD)
+{
+	if (m_prompt != Prompt::None) m_promptEditor.m_initEditor(m_screenWidth(), 1, s_statusColor, 0, m_screenHeight() - 1);
+
+	m_draw();
+}
+
+void ConsoleFileViewer::m_childHandleIdle()
+{
+	if (m_searchPosition.has_value())
+	{
+		m_continueSearch();
+		m_draw();
+		return;
+	}
+
+	// the status shows how far the line index got
+	if (m_drewCompleteIndex) return;
+
+	const auto now = std::chrono::steady_clock::now();
+
+	if (now - m_lastIdleDraw < std::chrono::milliseconds(250)) return;
+
+	m_lastIdleDraw = now;
+	m_drewCompleteIndex = m_file.m_isIndexComplete();
+
+	m_draw();
+}
@@ -0,0 +1,558 @@
+#include "../include/console_hex_editor.h"
+
+#include <sstream>
+#include <algorithm>
+#include <functional>
+
+namespace
+{
+	constexpr wchar_t s_hexDigits[] = L"0123456789ABCDEF";
+
+	[[nodiscard]] constexpr int GetHexValue(const wchar_t c) noexcept
+	{
+		if (c >= L'0' && c <= L'9') return c - L'0';
+		if (c >= L'a' && c <= L'f') return c - L'a' + 10;
+		if (c >= L'A' && c <= L'F') return c - L'A' + 10;
+
+		return -1;
+	}
+
+	[[nodiscard]] constexpr bool IsPrintable(const std::uint8_t byte) noexcept
+	{
+		return byte >= 0x20 && byte < 0x7F;
+	}
+
+	[[nodiscard]] std::wstring_view Trim(std::wstring_view str) noexcept
+	{
+		while (!str.empty() && str.front() == L' ') str.remove_prefix(1);
+		while (!str.empty() && str.back()  == L' ') str.remove_suffix(1);
+
+		return str;
+	}
+
+	[[nodiscard]] std::wstring ToHex(std::uint64_t value, std::size_t digits)
+	{
+		std::wstring str(digits, L'0');
+
+		for (; digits > 0; --digits, value >>= 4) str[digits - 1] = s_hexDigits[value & 0xF];
+
+		return str;
+	}
+} // namespace
+
+[[nodiscard]] bool ConsoleHexEditor::m_constructHexEditor(const int argc, const wchar_t* argv[]) noexcept
+{
+	// argv[1] is "--hex"
+	if (argc < 3) return false;
+
+	int width  = 80;
+	int height = 40;
+
+	short fontW = 8;
+	short fontH = 16;
+
+	if (argc > 4)
+	{
+		width  = _wtoi(argv[3]);
+		height = _wtoi(argv[4]);
+
+		if (argc > 6)
+		{
+			fontW = static_cast<short>(_wtoi(argv[5]));
+			fontH = static_cast<short>(_wtoi(argv[6]));
+		}
+	}
+
+	const std::wstring_view filePath = argv[2];
+
+	if (!m_file.m_open(filePath)) return false;
+
+	if (!m_construct(width, height, fontW, fontH, true, s_defalutConsoleMode)) return false;
+
+	// wide enough for the last offset
+	for (auto size = m_file.m_getSize() > 0 ? m_file.m_getSize() - 1 : 0; (size >> (m_offsetDigits * 4)) != 0;) ++m_offsetDigits;
+
+	m_fileName = utils::GetFileName(filePath);
+
+	if (m_fileName.empty()) m_fileName = filePath;
+
+	m_setConsoleTitle(m_fileName);
+
+	m_draw();
+
+	return true;
+}
+
+[[nodiscard]] ConsoleHexEditor::SizeType ConsoleHexEditor::m_getViewHeight() const noexcept
+{
+	// status line and the prompt below it
+	const int reserved = m_prompt == Prompt::None ? 1 : 2;
+
+	return static_cast<SizeType>(std::max(1, m_screenHeight() - reserved));
+}
+
+[[nodiscard]] std::size_t ConsoleHexEditor::m_getHexColumn(const SizeType column) const noexcept
+{
+	// "offset  xx xx xx xx xx xx xx xx  xx xx ..." with a wider gap in the middle
+	return m_offsetDigits + 2 + static_cast<std::size_t>(column) * 3 + (column >= s_bytesPerRow / 2 ? 1 : 0);
+}
+
+[[nodiscard]] std::size_t ConsoleHexEditor::m_getAsciiColumn(const SizeType column) const noexcept
+{
+	return m_getHexColumn(s_bytesPerRow) + 1 + static_cast<std::size_t>(column);
+}
+
+void ConsoleHexEditor::m_moveCursor(const SizeType offset) noexcept
+{
+	const auto size = m_file.m_getSize();
+
+	m_cursor = size > 0 ? std::min(offset, size - 1) : 0;
+	m_lowNibble = false;
+
+	const auto row = m_cursor / s_bytesPerRow;
+	const auto viewHeight = m_getViewHeight();
+
+	if (row < m_topRow) m_topRow = row;
+	else if (row >= m_topRow + viewHeight) m_topRow = row - viewHeight + 1;
+}
+
+void ConsoleHexEditor::m_typeChar(const wchar_t c)
+{
+	if (m_file.m_getSize() == 0) return;
+
+	if (m_asciiPane)
+	{
+		if (c < 0x20 || c >= 0x7F) return;
+
+		m_file.m_setByte(m_cursor, static_cast<std::uint8_t>(c));
+		m_moveCursor(m_cursor + 1);
+		return;
+	}
+
+	const auto value = GetHexValue(c);
+
+	if (value < 0) return;
+
+	const auto byte = m_file.m_getByte(m_cursor);
+
+	if (!m_lowNibble)
+	{
+		m_file.m_setByte(m_cursor, static_cast<std::uint8_t>((byte & 0x0F) | (value << 4)));
+		m_lowNibble = true;
+		return;
+	}
+
+	m_file.m_setByte(m_cursor, static_cast<std::uint8_t>((byte & 0xF0) | value));
+
+	if (m_cursor + 1 < m_file.m_getSize()) m_moveCursor(m_cursor + 1);
+	else m_lowNibble = false;
+}
+
+void ConsoleHexEditor::m_draw()
+{
+	m_clearConsole();
+
+	const auto size = m_file.m_getSize();
+	const auto viewHeight = m_getViewHeight();
+
+	for (SizeType y = 0; y < viewHeight; ++y)
+	{
+		const auto rowStart = (m_topRow + y) * s_bytesPerRow;
+
+		if (rowStart >= size) break;
+
+		// only the visible rows are touched, the rest of the mapping is never paged in
+		m_file.m_read(rowStart, s_bytesPerRow, m_rowBytes);
+
+		const auto screenY = static_cast<std::size_t>(y);
+
+		m_drawString(0, screenY, ToHex(rowStart, m_offsetDigits), s_offsetColor, false);
+
+		for (SizeType column = 0; column < m_rowBytes.size(); ++column)
+		{
+			const auto offset = rowStart + column;
+			const auto byte = m_rowBytes[static_cast<std::size_t>(column)];
+
+			WORD color = m_file.m_isChanged(offset) ? s_modifiedColor : s_foregroundWhite;
+
+			if (offset >= m_matchStart && offset - m_matchStart < m_matchSize) color |= s_matchColor;
+
+			if (offset == m_cursor) color = s_cursorColor;
+
+			const auto hexX = m_getHexColumn(column);
+
+			m_setGrid(hexX,     screenY, s_hexDigits[byte >> 4 ], color);
+			m_setGrid(hexX + 1, screenY, s_hexDigits[byte & 0xF], color);
+
+			m_setGrid(m_getAsciiColumn(column), screenY, IsPrintable(byte) ? static_cast<wchar_t>(byte) : L'.', color);
+		}
+	}
+
+	m_drawStatus(viewHeight);
+
+	if (m_prompt != Prompt::None)
+	{
+		m_promptEditor.m_updateConsole(*this);
+		m_setCursorPos(m_promptEditor.m_cursorPos);
+	}
+	else
+	{
+		const auto row = m_cursor / s_bytesPerRow;
+
+		// the mouse wheel can scroll the cursor out of view
+		const bool visible = row >= m_topRow && row - m_topRow < viewHeight;
+
+		m_setCursorInfo(visible);
+
+		if (visible)
+		{
+			const auto column = m_cursor % s_bytesPerRow;
+			const auto x = m_asciiPane ? m_getAsciiColumn(column) : m_getHexColumn(column) + (m_lowNibble ? 1 : 0);
+
+			m_setCursorPos({ static_cast<short>(x), static_cast<short>(row - m_topRow) });
+		}
+	}
+
+	m_renderConsole();
+}
+
+void ConsoleHexEditor::m_drawStatus(const SizeType y)
+{
+	std::wstringstream ss;
+
+	switch (m_prompt)
+	{
+	case Prompt::GoTo:
+		ss << L"Go to offset (0x1F00, 7936 or 50%):";
+		break;
+	case Prompt::Find:
+		ss << L"Find bytes (4D 5A 90) or \"text\":";
+		break;
+	case Prompt::None:
+	{
+		const auto size = m_file.m_getSize();
+
+		ss << m_fileName << (m_file.m_isModified() ? L"*" : L"") << L"  0x" << ToHex(m_cursor, m_offsetDigits);
+		ss << L" of 0x" << ToHex(size, m_offsetDigits) << L"  " << (size > 0 ? m_cursor * 100 / size : 100) << L"%";
+
+		if (m_searchPosition.has_value())
+		{
+			ss << L"  searching " << (size > 0 ? m_searchPosition.value() * 100 / size : 100) << L"%  Esc: cancel";
+		}
+		else if (!m_message.empty())
+		{
+			ss << L"  " << m_message;
+		}
+		else
+		{
+			ss << L"  Tab: hex/ascii  Ctrl+G: go to  Ctrl+F: find  F3: next  Ctrl+S: save  Esc: quit";
+		}
+
+		break;
+	}
+	}
+
+	m_drawRect(0, static_cast<std::size_t>(y), static_cast<std::size_t>(m_screenWidth()), 1, s_statusColor);
+	m_drawString(0, static_cast<std::size_t>(y), ss.str(), s_statusColor, false);
+}
+
+void ConsoleHexEditor::m_openPrompt(const Prompt prompt)
+{
+	m_prompt = prompt;
+	m_message.clear();
+
+	m_promptEditor.m_initEditor(m_screenWidth(), 1, s_statusColor, 0, m_screenHeight() - 1);
+	m_promptEditor.m_setInputBuffer(prompt == Prompt::Find ? std::wstring_view(m_findInput) : std::wstring_view());
+}
+
+bool ConsoleHexEditor::m_goTo(std::wstring_view str)
+{
+	str = Trim(str);
+
+	const bool percent = !str.empty() && str.back() == L'%';
+	const bool hex = str.size() > 2 && str[0] == L'0' && (str[1] == L'x' || str[1] == L'X');
+
+	if (percent) str.remove_suffix(1);
+	if (hex)     str.remove_prefix(2);
+
+	const auto isDigit = [hex] (const wchar_t c) { return hex ? GetHexValue(c) >= 0 : c >= L'0' && c <= L'9'; };
+
+	if (str.empty() || str.size() > (hex ? 15 : 18) || !std::all_of(str.cbegin(), str.cend(), isDigit)) return false;
+
+	const auto value = static_cast<SizeType>(std::wcstoull(std::wstring(str).c_str(), nullptr, hex ? 16 : 10));
+
+	if (percent)
+	{
+		const auto size = m_file.m_getSize();
+		const auto part = std::min<SizeType>(value, 100);
+
+		m_moveCursor(part * (size / 100) + part * (size % 100) / 100);
+		return true;
+	}
+
+	m_moveCursor(value);
+
+	return true;
+}
+
+bool ConsoleHexEditor::m_parsePattern(std::wstring_view str)
+{
+	str = Trim(str);
+
+	m_pattern.clear();
+
+	if (str.size() > 2 && str.front() == L'"' && str.back() == L'"')
+	{
+		str.remove_prefix(1);
+		str.remove_suffix(1);
+
+		const auto byteCount = WideCharToMultiByte(CP_UTF8, 0, str.data(), static_cast<int>(str.size()), nullptr, 0, nullptr, nullptr);
+
+		if (byteCount <= 0) return false;
+
+		m_pattern.resize(static_cast<std::size_t>(byteCount));
+
+		WideCharToMultiByte(CP_UTF8, 0, str.data(), static_cast<int>(str.size()),
+			reinterpret_cast<char*>(m_pattern.data()), byteCount, nullptr, nullptr);
+
+		return true;
+	}
+
+	int high = -1;
+
+	for (const auto c : str)
+	{
+		if (c == L' ') continue;
+
+		const auto value = GetHexValue(c);
+
+		if (value < 0) return false;
+
+		if (high < 0)
+		{
+			high = value;
+			continue;
+		}
+
+		m_pattern.push_back(static_cast<std::uint8_t>((high << 4) | value));
+		high = -1;
+	}
+
+	// an odd number of digits is a mistake rather than a half byte
+	return high < 0 && !m_pattern.empty();
+}
+
+void ConsoleHexEditor::m_startSearch(const SizeType start)
+{
+	if (m_pattern.empty()) return;
+
+	m_message.clear();
+	m_searchPosition = start;
+}
+
+void ConsoleHexEditor::m_continueSearch()
+{
+	const auto size = m_file.m_getSize();
+	const auto patternSize = static_cast<SizeType>(m_pattern.size());
+
+	const std::boyer_moore_horspool_searcher searcher(m_pattern.cbegin(), m_pattern.cend());
+
+	for (SizeType chunk = 0; chunk < s_searchChunksPerIdle && m_searchPosition.has_value(); ++chunk)
+	{
+		const auto start = m_searchPosition.value();
+
+		if (start >= size || size - start < patternSize)
+		{
+			m_searchPosition.reset();
+			m_message = L"not found";
+			return;
+		}
+
+		// chunks overlap by one byte less than the pattern so no match is split
+		m_file.m_read(start, s_searchChunkSize + patternSize - 1, m_searchBytes);
+
+		const auto it = std::search(m_searchBytes.cbegin(), m_searchBytes.cend(), searcher);
+
+		if (it != m_searchBytes.cend())
+		{
+			m_matchStart = start + static_cast<SizeType>(it - m_searchBytes.cbegin());
+			m_matchSize  = patternSize;
+
+			m_moveCursor(m_matchStart);
+			m_searchPosition.reset();
+			return;
+		}
+
+		m_searchPosition = start + s_searchChunkSize;
+	}
+}
+
+void ConsoleHexEditor::m_childHandleKeyEvents(const KEY_EVENT_RECORD& event)
+{
+	if (!event.bKeyDown) return;
+
+	if (m_prompt != Prompt::None)
+	{
+		switch (event.wVirtualKeyCode)
+		{
+		case VK_ESCAPE:
+			m_prompt = Prompt::None;
+			break;
+		case VK_RETURN:
+
+			if (m_prompt == Prompt::Find)
+			{
+				m_findInput = m_promptEditor.m_buffer();
+
+				if (m_parsePattern(m_findInput)) m_startSearch(m_cursor);
+				else m_message = L"use hex bytes or quoted text";
+			}
+			else if (!m_goTo(m_promptEditor.m_buffer()))
+			{
+				m_message = L"use 0x<hex>, a decimal offset or a percentage";
+			}
+
+			m_prompt = Prompt::None;
+			break;
+		default:
+			m_promptEditor.m_handleEvents(*this, event);
+			break;
+		}
+
+		m_draw();
+		return;
+	}
+
+	if (m_searchPosition.has_value() && event.wVirtualKeyCode == VK_ESCAPE)
+	{
+		m_searchPosition.reset();
+		m_message = L"search cancelled";
+
+		m_draw();
+		return;
+	}
+
+	const auto size = m_file.m_getSize();
+
+	if (s_isCtrlKeyPressed(event))
+	{
+		switch (event.wVirtualKeyCode)
+		{
+		case VirtualKeyCode::G:
+			m_openPrompt(Prompt::GoTo);
+			break;
+		case VirtualKeyCode::F:
+			m_openPrompt(Prompt::Find);
+			break;
+		case VirtualKeyCode::S:
+			m_message = m_file.m_save() ? L"saved" : L"could not save the file";
+			m_warnedUnsaved = false;
+			break;
+		case VK_HOME:
+			m_moveCursor(0);
+			break;
+		case VK_END:
+			m_moveCursor(size);
+			break;
+		default:
+			break;
+		}
+
+		m_draw();
+		return;
+	}
+
+	const auto pageBytes = m_getViewHeight() * s_bytesPerRow;
+
+	switch (event.wVirtualKeyCode)
+	{
+	case VK_ESCAPE:
+
+		if (m_file.m_isModified() && !m_warnedUnsaved)
+		{
+			m_message = L"unsaved changes, Ctrl+S: save  Esc: quit without saving";
+			m_warnedUnsaved = true;
+			break;
+		}
+
+		m_closeConsole();
+		return;
+	case VK_TAB:
+		m_asciiPane = !m_asciiPane;
+		m_lowNibble = false;
+		break;
+	case VK_LEFT:
+		m_moveCursor(m_cursor - std::min<SizeType>(m_cursor, 1));
+		break;
+	case VK_RIGHT:
+		m_moveCursor(m_cursor + 1);
+		break;
+	case VK_UP:
+		m_moveCursor(m_cursor >= s_bytesPerRow ? m_cursor - s_bytesPerRow : m_cursor);
+		break;
+	case VK_DOWN:
+		if (size - m_cursor > s_bytesPerRow) m_moveCursor(m_cursor + s_bytesPerRow);
+		break;
+	case VK_PRIOR:
+		m_topRow -= std::min(m_topRow, pageBytes / s_bytesPerRow);
+		m_moveCursor(m_cursor - std::min(m_cursor, pageBytes));
+		break;
+	case VK_NEXT:
+		m_topRow = std::min(m_topRow + pageBytes / s_bytesPerRow, size / s_bytesPerRow);
+		m_moveCursor(m_cursor + pageBytes);
+		break;
+	case VK_HOME:
+		m_moveCursor(m_cursor - m_cursor % s_bytesPerRow);
+		break;
+	case VK_END:
+		m_moveCursor(m_cursor - m_cursor % s_bytesPerRow + s_bytesPerRow - 1);
+		break;
+	case VK_F3:
+		m_startSearch(m_cursor + 1);
+		break;
+	default:
+
+		if (!event.uChar.UnicodeChar) return;
+
+		m_typeChar(event.uChar.UnicodeChar);
+		break;
+	}
+
+	if (event.wVirtualKeyCode != VK_ESCAPE)
+	{
+		m_message.clear();
+		m_warnedUnsaved = false;
+	}
+
+	m_draw();
+}
+
+void ConsoleHexEditor::m_childHandleMouseEvents(const MOUSE_EVENT_RECORD& event)
+{
+	if (event.dwEventFlags != MOUSE_WHEELED) return;
+
+	const short wheelRotation = HIWORD(event.dwButtonState);
+
+	// the cursor stays where it is, it may scroll out of view
+	if (wheelRotation < 0) m_topRow = std::min(m_topRow + 3, m_file.m_getSize() / s_bytesPerRow);
+	else m_topRow -= std::min<SizeType>(m_topRow, 3);
+
+	m_draw();
+}
+
+void ConsoleHexEditor::m_childHandleResizeEvent(const COORD, const COORD)
+{
+	if (m_prompt != Prompt::None) m_promptEditor.m_initEditor(m_screenWidth(), 1, s_statusColor, 0, m_screenHeight() - 1);
+
+	m_moveCursor(m_cursor);
+
+	m_draw();
+}
+
+void ConsoleHexEditor::m_childHandleIdle()
+{
+	if (!m_searchPosition.has_value()) return;
+
+	m_continueSearch();
+	m_draw();
+}
@@ -1,5 +1,6 @@
 #include "../include/console_text_editor.h"
 
+#include <algorithm>
 #include <sstream>
 
 
@@ -12,16 +13,31 @@
 	short fontW = 8;
 	short fontH = 16;
 
+	// options start with "--", everything else is positional
+	std::vector<std::wstring_view> args;
 
-	if (argc > 3)
+	std::wstring_view sessionName;
+
+	for (int i = 0; i < argc; ++i)
+	{
+		const std::wstring_view arg = argv[i];
+
+		if 		(arg == L"--index"        ) m_editors[Editor_Main].m_indexMode = TextEditor::IndexMode::Memory;
+		else if (arg == L"--persist-index") m_editors[Editor_Main].m_indexMode = TextEditor::IndexMode::Persistent;
+		else if (arg.substr(0, 9) == L"--memory=") m_documents.m_budget = static_cast<std::size_t>(_wtoi(arg.data() + 9)) << 20;
+		else if (arg.substr(0, 9) == L"--collab=") sessionName = arg.substr(9);
+		else if (arg.substr(0, 2) != L"--") args.push_back(arg);
+	}
+
+	if (args.size() > 3)
 	{
-		width  = _wtoi(argv[2]);
-		height = _wtoi(argv[3]);
+		width  = _wtoi(args[2].data());
+		height = _wtoi(args[3].data());
 	
-		if (argc > 5)
+		if (args.size() > 5)
 		{
-			fontW = static_cast<short>(_wtoi(argv[4]));
-			fontH = static_cast<short>(_wtoi(argv[5]));
+			fontW = static_cast<short>(_wtoi(args[4].data()));
+			fontH = static_cast<short>(_wtoi(args[5].data()));
 		}
 	}
 	
@@ -29,26 +45,114 @@
 
 	m_initEditors();
 	
-	if (argc > 1)
+	if (args.size() > 1 && m_editors[Editor_Main].m_readFile(args[1]))
 	{
-		const std::wstring_view str = argv[1];
+		m_filePath = args[1];
+		m_editors[Editor_Main].m_setLanguageFor(m_filePath);
 
-		if (m_editors[Editor_Main].m_readFile(str))
-		{
-			m_updateEditors();
-			m_setConsoleTitle(utils::GetFileName(str));
-		}	
+		m_updateEditors();
 	}
-	else
+
+	m_documents.m_reset(m_filePath);
+
+	m_updateTitle();
+
+	// the editor runs on its own when the session can not be joined
+	if (!sessionName.empty() && !m_collaboration.m_join(sessionName, m_editors[Editor_Main]))
 	{
-		m_setConsoleTitle(L"Untitled");
+		m_setConsoleTitle(L"No relay runs for " + std::wstring(sessionName) + L", start it with e --relay " + std::wstring(sessionName));
 	}
 
 	return true;
 }
 
+[[nodiscard]] bool ConsoleTextEditor::m_constructSession(const int width, const int height, 
+	const std::wstring_view path, const TextEditor* view) noexcept
+{
+	if (!m_constructHeadless(width, height)) return false;
+
+	if (view != nullptr)
+	{
+		// a copy shares the document, the text and the line index are not read again
+		m_editors[Editor_Main] = *view;
+		m_filePath = path;
+	}
+
+	m_initEditors();
+
+	m_documents.m_reset(m_filePath);
+
+	m_updateTitle();
+	m_updateEditors();
+	m_setCursorPos(m_editors[Editor_Main].m_cursorPos);
+
+	return true;
+}
+
+ConsoleTextEditor::~ConsoleTextEditor()
+{
+	if (m_countTask.has_value()) m_countTask->m_job->m_cancel();
+
+	if (!m_task.has_value()) return;
+
+	if (!m_task->m_finishOnExit) m_task->m_job->m_cancel();
+
+	// the pool is stopped at exit, a file half written there would be lost
+	while (!m_task->m_job->m_isFinished()) Sleep(1);
+}
+
 void ConsoleTextEditor::m_childHandleKeyEvents(const KEY_EVENT_RECORD& event) 
 {
+	if (m_filter.m_isRunning())
+	{
+		// the filter reads the main buffer until it finishes
+		if (event.bKeyDown && event.wVirtualKeyCode == VK_ESCAPE) m_filter.m_cancel();
+		return;
+	}
+
+	// the text is edited on while a task runs, escape is taken by it
+	if (m_task.has_value() && event.bKeyDown && event.wVirtualKeyCode == VK_ESCAPE)
+	{
+		m_task->m_job->m_cancel();
+		return;
+	}
+
+	if (m_occurFocused)
+	{
+		m_handleOccurEvents(event);
+
+		m_updateEditors();
+		m_setCursorPos(m_occurFocused ? m_occurList.m_cursorPos : m_editors[m_currentEditor].m_cursorPos);
+		return;
+	}
+
+	if (m_handleSearchOptionEvents(event))
+	{
+		m_updateEditors();
+		m_setCursorPos(m_editors[m_currentEditor].m_cursorPos);
+		return;
+	}
+
+	// toggle soft wrap of the main editor
+	if (event.bKeyDown && m_currentEditor == Editor_Main && s_isAltKeyPressed(event) && !s_isCtrlKeyPressed(event)
+		&& event.wVirtualKeyCode == VirtualKeyCode::Z)
+	{
+		auto& editor = m_editors[Editor_Main];
+
+		editor.m_setWrap(!editor.m_isWrapped());
+
+		m_updateEditors();
+		m_setCursorPos(editor.m_cursorPos);
+		return;
+	}
+
+	if (event.bKeyDown && m_currentEditor == Editor_Main && m_handlePaneEvents(event))
+	{
+		m_updateEditors();
+		m_setCursorPos(m_editors[Editor_Main].m_cursorPos);
+		return;
+	}
+
 	// handle editor change events
 	if (event.bKeyDown)
 	{
@@ -60,14 +164,52 @@ void ConsoleTextEditor::m_childHandleKeyEvents(const KEY_EVENT_RECORD& event)
 			{
 			case VirtualKeyCode::S:
 				// save file event
-				if (m_currentEditor == Editor_Main) m_currentEditor = Editor_Save;
+				if (m_currentEditor == Editor_Main && !m_task.has_value()) m_currentEditor = Editor_Save;
 
 				break;
 			case VirtualKeyCode::O:
 				// open file event
-				if (m_currentEditor == Editor_Main) m_currentEditor = Editor_Open;
+				if (m_currentEditor == Editor_Main && !m_task.has_value()) m_currentEditor = Editor_Open;
 				
 				break;
+			case VirtualKeyCode::P:
+				// line command event
+				if (m_currentEditor == Editor_Main)
+				{
+					m_commandFailed = false;
+					m_currentEditor = Editor_Command;
+				}
+
+				break;
+			case VirtualKeyCode::T:
+				// follow file event
+				if (m_currentEditor == Editor_Main) m_toggleFollow();
+
+				break;
+			case VK_NEXT:
+			case VK_PRIOR:
+			{
+				// next / previous document event
+				if (m_currentEditor != Editor_Main || m_task.has_value()) break;
+
+				const auto count = m_documents.m_getCount();
+				const auto step  = event.wVirtualKeyCode == VK_NEXT ? 1 : count - 1;
+
+				m_showDocument((m_documents.m_getActive() + step) % count);
+
+				m_updateEditors();
+				m_setCursorPos(m_editors[Editor_Main].m_cursorPos);
+				return;
+			}
+			case VirtualKeyCode::W:
+				// close document event
+				if (m_currentEditor != Editor_Main || m_task.has_value()) break;
+
+				m_closeDocument();
+
+				m_updateEditors();
+				m_setCursorPos(m_editors[Editor_Main].m_cursorPos);
+				return;
 			case VirtualKeyCode::F:
 			{
 				// find event
@@ -95,17 +237,17 @@ void ConsoleTextEditor::m_childHandleKeyEvents(const KEY_EVENT_RECORD& event)
 
 				if (m_currentEditor == Editor_Replace && s_isAltKeyPressed(event))
 				{
-					m_editors[Editor_Main].m_replaceMatchsWith(m_editors[Editor_Find].m_buffer(), m_editors[Editor_Replace].m_buffer());
+					m_replaceAll();
 				}
 				else if (m_currentEditor == Editor_Find || m_currentEditor == Editor_Replace)
 				{
 					if (s_isShiftKeyPressed(event))
 					{
-						m_editors[Editor_Main].m_selectPreviousString(m_editors[Editor_Find].m_buffer());
+						m_editors[Editor_Main].m_selectPreviousString(m_getSearch());
 					}
 					else
 					{
-						m_editors[Editor_Main].m_selectNextString(m_editors[Editor_Find].m_buffer());
+						m_editors[Editor_Main].m_selectNextString(m_getSearch());
 					}
 
 					if (m_currentEditor == Editor_Replace && m_editors[Editor_Main].m_isStringSelected())
@@ -129,7 +271,7 @@ void ConsoleTextEditor::m_childHandleKeyEvents(const KEY_EVENT_RECORD& event)
 			if (m_currentEditor != Editor_Main)
 			{
 				m_currentEditor = Editor_Main;
-				m_editors[Editor_Main].m_height = m_screenHeight();
+				m_layoutPanes(m_screenHeight());
 				return;
 			}
 
@@ -140,26 +282,23 @@ void ConsoleTextEditor::m_childHandleKeyEvents(const KEY_EVENT_RECORD& event)
 			{
 			case Editor_Save:
 				// save file
-				if (m_editors[Editor_Main].m_writeFile(m_editors[m_currentEditor].m_buffer()))
-				{
-					m_currentEditor = Editor_Main;
-				}
+				m_saveFile(m_editors[m_currentEditor].m_buffer());
 
 				return;
 			case Editor_Open:
-			{
 				// open file
+				m_openFile(m_editors[m_currentEditor].m_buffer());
 
-				const auto str = m_editors[m_currentEditor].m_buffer();
+				return;
+			case Editor_Command:
+				
+				m_commandFailed = !m_runCommand();
 
-				if (m_editors[Editor_Main].m_readFile(str))
-				{
-					m_setConsoleTitle(utils::GetFileName(str));
-					m_currentEditor = Editor_Main;
-				}
+				if (!m_commandFailed && !m_filter.m_isRunning()) m_currentEditor = Editor_Main;
 
+				m_updateEditors();
+				m_setCursorPos(m_editors[m_currentEditor].m_cursorPos);
 				return;
-			}
 			default:
 				break;
 			}
@@ -172,21 +311,267 @@ void ConsoleTextEditor::m_childHandleKeyEvents(const KEY_EVENT_RECORD& event)
 
 	if (!m_editors[m_currentEditor].m_handleEvents(*this, event)) m_closeConsole();
 
+	m_syncSearchEditorHeights();
+
+	m_updateEditors();
+
+	m_setCursorPos(m_editors[m_currentEditor].m_cursorPos);
+}
+
+void ConsoleTextEditor::m_childHandlePasteEvent(std::wstring str)
+{
+	// occur list has no text input
+	if (m_occurFocused || m_filter.m_isRunning()) return;
+
+	m_editors[m_currentEditor].m_insertUnsafeString(std::move(str));
+
+	m_syncSearchEditorHeights();
+
+	m_updateEditors();
+
+	m_setCursorPos(m_editors[m_currentEditor].m_cursorPos);
+}
+
+void ConsoleTextEditor::m_syncSearchEditorHeights() noexcept
+{
 	if (m_currentEditor == Editor_Find || m_currentEditor == Editor_Replace)
 	{
 		m_editors[Editor_Find   ].m_syncHeightWithRows(m_screenHeight());
 		m_editors[Editor_Replace].m_syncHeightWithRows(m_editors[Editor_Find].m_drawStartY - 1);
 
-		m_editors[Editor_Main].m_height = m_editors[Editor_Replace].m_drawStartY - 1;
+		m_layoutPanes(m_editors[Editor_Replace].m_drawStartY - 1);
 	}
+}
 
-	m_updateEditors();
+bool ConsoleTextEditor::m_handlePaneEvents(const KEY_EVENT_RECORD& event)
+{
+	if (s_isCtrlKeyPressed(event) || !s_isAltKeyPressed(event)) return false;
 
-	m_setCursorPos(m_editors[m_currentEditor].m_cursorPos);
+	switch (event.wVirtualKeyCode)
+	{
+	case VirtualKeyCode::H:
+		m_splitPane(SplitMode::Horizontal);
+		return true;
+	case VirtualKeyCode::V:
+		m_splitPane(SplitMode::Vertical);
+		return true;
+	case VirtualKeyCode::N:
+		if (!m_panes.empty()) m_focusPane((m_focusedPane + 1) % (m_panes.size() + 1));
+		return true;
+	case VirtualKeyCode::Q:
+		m_closePane();
+		return true;
+	default:
+		break;
+	}
+
+	return false;
+}
+
+void ConsoleTextEditor::m_splitPane(const SplitMode mode)
+{
+	const auto paneCount = m_panes.size() + 1;
+
+	if (paneCount >= s_maxPanes) return;
+
+	// every pane keeps at least two rows or columns besides the separators
+	const auto space = mode == SplitMode::Vertical ? m_screenWidth() : m_paneAreaHeight;
+
+	if (space < paneCount * 3 + 2) return;
+
+	// the new pane is a copy of the focused one above or left of it, the focus stays on the original
+	m_panes.insert(m_panes.begin() + static_cast<std::ptrdiff_t>(m_focusedPane), m_editors[Editor_Main]);
+	++m_focusedPane;
+
+	m_splitMode = mode;
+
+	m_layoutPanes(m_paneAreaHeight);
+}
+
+void ConsoleTextEditor::m_focusPane(const std::size_t pane)
+{
+	if (pane == m_focusedPane) return;
+
+	// the panes stay in screen order, the focused one moves into the main editor slot
+	m_panes.insert(m_panes.begin() + static_cast<std::ptrdiff_t>(m_focusedPane), std::move(m_editors[Editor_Main]));
+
+	m_editors[Editor_Main] = std::move(m_panes[pane]);
+	m_panes.erase(m_panes.begin() + static_cast<std::ptrdiff_t>(pane));
+
+	m_focusedPane = pane;
+}
+
+void ConsoleTextEditor::m_closePane()
+{
+	if (m_panes.empty()) return;
+
+	// the pane before the closed one takes the focus, the first one for the first pane
+	const auto next = m_focusedPane > 0 ? m_focusedPane - 1 : 0;
+
+	m_editors[Editor_Main] = std::move(m_panes[next]);
+	m_panes.erase(m_panes.begin() + static_cast<std::ptrdiff_t>(next));
+
+	m_focusedPane = next;
+
+	m_layoutPanes(m_paneAreaHeight);
+}
+
+void ConsoleTextEditor::m_layoutPanes(const std::size_t height) noexcept
+{
+	m_paneAreaHeight = height;
+
+	const auto paneCount = m_panes.size() + 1;
+	const bool vertical = m_splitMode == SplitMode::Vertical;
+
+	const auto space = (vertical ? m_screenWidth() : height) - std::min(paneCount - 1, vertical ? m_screenWidth() : height);
+
+	std::size_t start = 0;
+
+	for (std::size_t pane = 0; pane < paneCount; ++pane)
+	{
+		// the first panes take the rows or columns that do not divide evenly
+		const auto size = std::max<std::size_t>(1, space / paneCount + (pane < space % paneCount ? 1 : 0));
+
+		if (vertical)
+		{
+			m_getPane(pane).m_initEditor(size, height, s_foregroundWhite, start, 0);
+		}
+		else
+		{
+			m_getPane(pane).m_initEditor(m_screenWidth(), size, s_foregroundWhite, 0, start);
+		}
+
+		start += size + 1;
+	}
+}
+
+void ConsoleTextEditor::m_drawPaneSeparators() noexcept
+{
+	// the last pane has no separator after it
+	for (std::size_t pane = 0; pane < m_panes.size(); ++pane)
+	{
+		const auto& editor = m_getPane(pane);
+
+		if (m_splitMode == SplitMode::Vertical)
+		{
+			for (std::size_t y = 0; y < m_paneAreaHeight; ++y)
+			{
+				m_fillCells(m_getIndex(editor.m_drawStartX + editor.m_width, y), 1, L'\x2502', s_openSaveEditorColor);
+			}
+		}
+		else
+		{
+			m_fillCells(m_getIndex(0, editor.m_drawStartY + editor.m_height), m_screenWidth(), L'\x2500', s_openSaveEditorColor);
+		}
+	}
+}
+
+bool ConsoleTextEditor::m_handleSearchOptionEvents(const KEY_EVENT_RECORD& event) noexcept
+{
+	if (!event.bKeyDown || s_isCtrlKeyPressed(event) || !s_isAltKeyPressed(event)) return false;
+	
+	if (m_currentEditor != Editor_Find && m_currentEditor != Editor_Replace) return false;
+
+	switch (event.wVirtualKeyCode)
+	{
+	case VirtualKeyCode::C:
+		// toggle case insensitive search
+		m_searchOptions.m_ignoreCase = !m_searchOptions.m_ignoreCase;
+		return true;
+	case VirtualKeyCode::W:
+		// toggle whole word search
+		m_searchOptions.m_wholeWord = !m_searchOptions.m_wholeWord;
+		return true;
+	case VirtualKeyCode::A:
+		// a cursor on every match, editing continues in the main editor
+		if (m_editors[Editor_Main].m_addCursorsAtMatches(m_getSearch()))
+		{
+			m_currentEditor = Editor_Main;
+			m_layoutPanes(m_screenHeight());
+		}
+
+		return true;
+	case VirtualKeyCode::O:
+		// show every matching line
+		m_showOccur    = true;
+		m_occurFocused = true;
+		return true;
+	default:
+		break;
+	}
+
+	return false;
+}
+
+void ConsoleTextEditor::m_handleOccurEvents(const KEY_EVENT_RECORD& event) noexcept
+{
+	if (!event.bKeyDown) return;
+
+	switch (event.wVirtualKeyCode)
+	{
+	case VK_ESCAPE:
+		m_closeOccurList();
+		break;
+	case VK_RETURN:
+		m_jumpToOccurrence();
+		break;
+	default:
+		m_occurList.m_handleEvents(event);
+		break;
+	}
+}
+
+void ConsoleTextEditor::m_layoutOccurList() noexcept
+{
+	const bool findOpen = m_currentEditor == Editor_Find || m_currentEditor == Editor_Replace;
+
+	// list sits between the main editor and the find / replace editors
+	const std::size_t bottom = findOpen ? m_editors[Editor_Replace].m_drawStartY - 1 : m_screenHeight();
+	const auto height = std::max<std::size_t>(1, bottom / 3);
+
+	m_occurList.m_initList(m_screenWidth(), height, 0, bottom - height);
+
+	m_layoutPanes(bottom - height - 1);
+}
+
+void ConsoleTextEditor::m_closeOccurList() noexcept
+{
+	m_showOccur    = false;
+	m_occurFocused = false;
+
+	const bool findOpen = m_currentEditor == Editor_Find || m_currentEditor == Editor_Replace;
+
+	m_layoutPanes(findOpen ? m_editors[Editor_Replace].m_drawStartY - 1 : m_screenHeight());
+}
+
+void ConsoleTextEditor::m_jumpToOccurrence() noexcept
+{
+	const auto line = m_occurList.m_getSelectedLine();
+
+	if (!line.has_value()) return;
+
+	m_editors[Editor_Main].m_goToIndex(m_editors[Editor_Main].m_getLineIndex().m_getLineStart(line.value()));
+
+	m_occurFocused = false;
+	m_currentEditor = Editor_Main;
 }
 
 void ConsoleTextEditor::m_childHandleMouseEvents(const MOUSE_EVENT_RECORD& event) 
 {
+	if (m_filter.m_isRunning()) return;
+
+	if (m_showOccur && s_isLeftButtonPressed(event) 
+		&& m_occurList.m_isInsidePoint(event.dwMousePosition.X, event.dwMousePosition.Y))
+	{
+		// jump to the clicked line
+		m_occurList.m_selectRowAt(event.dwMousePosition.Y);
+		m_jumpToOccurrence();
+
+		m_updateEditors();
+		m_setCursorPos(m_editors[m_currentEditor].m_cursorPos);
+		return;
+	}
+
 	if (s_isLeftButtonPressed(event))
 	{
 		auto isInsidePoint = [&] (const EditorType type)
@@ -197,9 +582,21 @@ void ConsoleTextEditor::m_childHandleMouseEvents(const MOUSE_EVENT_RECORD& event
 		switch (m_currentEditor)
 		{
 		case Editor_Main:
+
+			// a click in another pane focuses it
+			for (std::size_t pane = 0; pane <= m_panes.size(); ++pane)
+			{
+				if (pane != m_focusedPane && m_getPane(pane).m_isInsidePoint(event.dwMousePosition.X, event.dwMousePosition.Y))
+				{
+					m_focusPane(pane);
+					break;
+				}
+			}
+
 			break;
 		case Editor_Save:
 		case Editor_Open:
+		case Editor_Command:
 			if (!isInsidePoint(m_currentEditor))
 			{
 				m_currentEditor = Editor_Main;
@@ -245,11 +642,12 @@ void ConsoleTextEditor::m_childHandleResizeEvent(const COORD, const COORD)
 
 void ConsoleTextEditor::m_initEditors() noexcept
 {
-	m_editors[Editor_Main   ].m_initEditor(m_screenWidth(), m_screenHeight());
+	m_layoutPanes(m_screenHeight());
 	m_editors[Editor_Save   ].m_initEditor(m_screenWidth(), 2, s_openSaveEditorColor, 0, m_screenHeight() - 2);
 	m_editors[Editor_Open   ].m_initEditor(m_screenWidth(), 2, s_openSaveEditorColor, 0, m_screenHeight() - 2);
 	m_editors[Editor_Find   ].m_initEditor(m_screenWidth(), 4, s_openSaveEditorColor, 0, m_screenHeight() - 4);
 	m_editors[Editor_Replace].m_initEditor(m_screenWidth(), 8, s_openSaveEditorColor, 0, m_screenHeight() - 8);
+	m_editors[Editor_Command].m_initEditor(m_screenWidth(), 2, s_openSaveEditorColor, 0, m_screenHeight() - 2);
 
 }
 
@@ -265,7 +663,28 @@ void ConsoleTextEditor::m_updateEditors() noexcept
 {	
 	m_clearConsole();
 
-	m_editors[Editor_Main].m_updateConsole(*this, m_editors[Editor_Find].m_buffer());
+	const auto search = m_getSearch();
+
+	if (m_showOccur) m_layoutOccurList();
+
+	for (auto& pane : m_panes) pane.m_updateConsole(*this, search);
+
+	m_editors[Editor_Main].m_updateConsole(*this, search);
+
+	m_drawPaneSeparators();
+
+	if (m_showOccur)
+	{
+		m_occurList.m_update(m_editors[Editor_Main], search);
+
+		std::wstringstream ss;
+
+		ss << L"Occur: " << m_occurList.m_getLineCount() << L" lines  Enter: go to line  Esc: close";
+
+		m_drawString(m_occurList.m_drawStartX, m_occurList.m_drawStartY - 1, ss.str(), s_openSaveEditorColor, false);
+
+		m_occurList.m_updateConsole(*this, m_editors[Editor_Main], search);
+	}
 
 	switch (m_currentEditor)
 	{
@@ -274,9 +693,26 @@ void ConsoleTextEditor::m_updateEditors() noexcept
 	{
 		std::wstringstream ss;
 
-		const auto [index, count] = m_editors[Editor_Main].m_getMatchResults(m_editors[Editor_Find].m_buffer());			
-		
-		ss << L"Find in editor: (" << index << L" of " << count << L")";
+		auto& editor = m_editors[Editor_Main];
+
+		if (editor.m_buffer().size() >= s_backgroundSize && editor.m_needsMatchRecount(search))
+		{
+			m_startMatchCount(search);
+
+			ss << L"Find in editor: (counting " << m_countTask->m_job->m_getPercent() << L"%)";
+		}
+		else
+		{
+			const auto [index, count] = editor.m_getMatchResults(search);
+
+			ss << L"Find in editor: (" << index << L" of " << count << L")";
+		}
+
+		ss
+		<< L"  Alt+C ignore case: " << (m_searchOptions.m_ignoreCase ? L"on" : L"off")
+		<< L"  Alt+W whole word: "  << (m_searchOptions.m_wholeWord  ? L"on" : L"off");
+
+		if (m_editors[Editor_Main].m_isIndexReady()) ss << L"  (indexed)";
 
 		m_updateEditor(Editor_Find   , ss.str());
 		m_updateEditor(Editor_Replace, L"Replace in file");
@@ -289,12 +725,513 @@ void ConsoleTextEditor::m_updateEditors() noexcept
 	case Editor_Open:
 		m_updateEditor(m_currentEditor, L"Open a File:");
 		break;
+	case Editor_Command:
+	{
+		const auto command = m_editors[Editor_Command].m_buffer();
+
+		if (m_filter.m_isRunning())
+		{
+			m_updateEditor(m_currentEditor, m_getFilterProgress());
+		}
+		else if (m_commandFailed)
+		{
+			m_updateEditor(m_currentEditor, !command.empty() && command.front() == L'!'
+				? L"Command could not be started or exited with an error" 
+				: L"Unknown command, use: sort, sort -n, unique, keep <text>, drop <text>, reverse, !<shell command>");
+		}
+		else
+		{
+			m_updateEditor(m_currentEditor, L"Line command (selected lines or whole file):");
+		}
+
+		break;
+	}
 	case Editor_Main:
 		break;
 	}
+
+	m_drawnVersion = m_editors[Editor_Main].m_getVersion();
 	
 	m_renderConsole();	
 }
 
+bool ConsoleTextEditor::m_runCommand() noexcept
+{
+	const auto str = m_editors[Editor_Command].m_buffer();
+
+	if (!str.empty() && str.front() == L'!') return m_startFilter(str.substr(1));
+
+	const auto command = LineOperations::s_parseCommand(m_editors[Editor_Command].m_buffer());
+
+	if (!command.has_value()) return false;
+
+	// keep and drop match like the find editor does
+	m_editors[Editor_Main].m_applyLineOperation(command->m_type, { command->m_argument, m_searchOptions });
+
+	return true;
+}
+
+bool ConsoleTextEditor::m_startFilter(const std::wstring_view command)
+{
+	auto& editor = m_editors[Editor_Main];
+
+	m_filterRange = editor.m_getSelectionRange();
+
+	// other clients of the server and the collaboration can edit the document while the filter reads it,
+	// the snapshot keeps the text of this version without copying the range
+	auto input = editor.m_getDocument().m_takeSnapshot();
+
+	m_filterVersion = input.m_getVersion();
+
+	m_lastProgressDraw = {};
+
+	return m_filter.m_start(command, std::move(input), m_filterRange.first, m_filterRange.second);
+}
+
+void ConsoleTextEditor::m_finishFilter()
+{
+	const bool cancelled = m_filter.m_isCancelled();
+
+	auto output = m_filter.m_finish();
+
+	auto& editor = m_editors[Editor_Main];
+
+	if (output.has_value())
+	{
+		const auto size = m_filterRange.second - m_filterRange.first;
+
+		// the range moves over the edits made while the filter ran, the output of a range they changed is dropped
+		std::vector<std::size_t> starts = { m_filterRange.first };
+
+		if (editor.m_getDocument().m_rebase(m_filterVersion, starts, size) && !starts.empty())
+		{
+			editor.m_replaceRange(starts.front(), starts.front() + size, std::move(output.value()));
+		}
+		else
+		{
+			m_setConsoleTitle(L"The text changed while it was filtered, the output was dropped");
+		}
+	}
+
+	// a failed command stays in the command editor with its error
+	m_commandFailed = !output.has_value() && !cancelled;
+
+	if (!m_commandFailed) m_currentEditor = Editor_Main;
+}
+
+[[nodiscard]] std::wstring ConsoleTextEditor::m_getFilterProgress() const
+{
+	const auto inputSize = std::max<std::size_t>(1, m_filter.m_getInputSize());
+
+	std::wstringstream ss;
+
+	ss << L"Filtering: " << m_filter.m_getWrittenSize() * 100 / inputSize << L"% written, "
+	<< m_filter.m_getOutputBytes() / 1024 << L" KB read  Esc: cancel";
 
+	return ss.str();
+}
+
+void ConsoleTextEditor::m_childHandleIdle()
+{
+	if (m_follower.m_isFollowing()) m_pollFollower();
+
+	if (m_collaboration.m_isJoined())
+	{
+		m_collaboration.m_poll();
+
+		// the relay stopped
+		if (!m_collaboration.m_isJoined()) m_updateTitle();
+	}
+
+	// the panes share the line states, each one tells if its own rows changed
+	bool highlighted = m_editors[Editor_Main].m_highlightInBackground();
+
+	for (auto& pane : m_panes) highlighted = pane.m_highlightInBackground() || highlighted;
+
+	if (m_pollTasks())
+	{
+		m_updateEditors();
+		m_setCursorPos(m_editors[m_currentEditor].m_cursorPos);
+	}
+
+	// another client of the server or another editor of the collaboration edited the document
+	if (highlighted || m_editors[Editor_Main].m_getVersion() != m_drawnVersion)
+	{
+		m_updateEditors();
+		m_setCursorPos(m_editors[m_currentEditor].m_cursorPos);
+	}
+
+	if (!m_filter.m_isRunning()) return;
+
+	if (m_filter.m_isFinished())
+	{
+		m_finishFilter();
+	}
+	else
+	{
+		const auto now = std::chrono::steady_clock::now();
 
+		// progress is redrawn a few times per second
+		if (now - m_lastProgressDraw < std::chrono::milliseconds(100)) return;
+
+		m_lastProgressDraw = now;
+	}
+
+	m_updateEditors();
+	m_setCursorPos(m_editors[m_currentEditor].m_cursorPos);
+}
+
+void ConsoleTextEditor::m_saveFile(const std::wstring_view path)
+{
+	auto& editor = m_editors[Editor_Main];
+
+	if (editor.m_buffer().size() < s_backgroundSize)
+	{
+		if (!editor.m_writeFile(path)) return;
+
+		m_filePath = path;
+		m_documents.m_setActivePath(m_filePath);
+
+		m_updateTitle();
+		m_currentEditor = Editor_Main;
+
+		return;
+	}
+
+	// the snapshot is written while the document is edited further, it stays modified then
+	const auto snapshot = editor.m_getDocument().m_takeSnapshot();
+	const auto version  = snapshot.m_getVersion();
+	const auto written  = std::make_shared<bool>(false);
+	const auto fileSize = std::make_shared<TextEditor::SizeType>(0);
+
+	auto started = WorkerPool::s_get().m_run([path = std::wstring(path), snapshot, written, fileSize] (WorkerPool::Job& job)
+	{
+		*written = TextEditor::s_writeSnapshot(path, snapshot, job);
+
+		if (*written) *fileSize = TextEditor::s_getFileSize(path);
+	});
+
+	auto finish = [this, path = std::wstring(path), version, written, fileSize] (const bool cancelled)
+	{
+		if (!*written)
+		{
+			m_setConsoleTitle(std::wstring(utils::GetFileName(path)) + (cancelled ? L" was not saved" : L" could not be saved"));
+			return;
+		}
+
+		m_editors[Editor_Main].m_getDocument().m_savedVersion = version;
+		m_editors[Editor_Main].m_getDocument().m_fileSize     = *fileSize;
+
+		m_filePath = path;
+		m_documents.m_setActivePath(m_filePath);
+
+		m_updateTitle();
+	};
+
+	m_task = BackgroundTask{ std::move(started), L"saving", std::move(finish), true };
+
+	m_updateTitle();
+	m_currentEditor = Editor_Main;
+}
+
+void ConsoleTextEditor::m_openFile(const std::wstring_view path)
+{
+	auto& editor = m_editors[Editor_Main];
+
+	// an open file is shown again instead of being read twice
+	const auto entry = m_documents.m_find(path);
+
+	WIN32_FILE_ATTRIBUTE_DATA attributes;
+
+	const bool small = !GetFileAttributesExW(std::wstring(path).c_str(), GetFileExInfoStandard, &attributes)
+		|| ((static_cast<std::size_t>(attributes.nFileSizeHigh) << 32) | attributes.nFileSizeLow) < s_backgroundSize;
+
+	if (entry.has_value() || small)
+	{
+		if (entry.has_value() ? m_documents.m_show(entry.value(), editor) : m_documents.m_open(path, editor))
+		{
+			m_onDocumentShown();
+			m_currentEditor = Editor_Main;
+		}
+
+		return;
+	}
+
+	// the shown document is edited on while the file is read into a view of its own
+	const auto view = std::make_shared<TextEditor>();
+	const auto read = std::make_shared<bool>(false);
+
+	view->m_indexMode = editor.m_indexMode;
+
+	auto started = WorkerPool::s_get().m_run([path = std::wstring(path), view, read] (WorkerPool::Job& job)
+	{
+		*read = view->m_readFile(path, &job);
+	});
+
+	auto finish = [this, path = std::wstring(path), view, read] (const bool cancelled)
+	{
+		if (!*read)
+		{
+			m_setConsoleTitle(std::wstring(utils::GetFileName(path)) + (cancelled ? L" was not opened" : L" could not be read"));
+			return;
+		}
+
+		if (m_documents.m_add(path, std::move(*view), m_editors[Editor_Main])) m_onDocumentShown();
+	};
+
+	m_task = BackgroundTask{ std::move(started), L"opening " + std::wstring(utils::GetFileName(path)), std::move(finish) };
+
+	m_updateTitle();
+	m_currentEditor = Editor_Main;
+}
+
+void ConsoleTextEditor::m_replaceAll()
+{
+	auto& editor = m_editors[Editor_Main];
+
+	const auto search = m_getSearch();
+
+	// the index finds the matches of a big text without reading all of it
+	if (editor.m_buffer().size() < s_backgroundSize || editor.m_isIndexReady() || search.m_empty())
+	{
+		editor.m_replaceMatchsWith(search, m_editors[Editor_Replace].m_buffer());
+		return;
+	}
+
+	// one task at a time, a save or an open may still run
+	if (m_task.has_value()) return;
+
+	// the matches are found in a snapshot while the text is edited on and moved over those edits at the end
+	const auto snapshot = editor.m_getDocument().m_takeSnapshot();
+	const auto version  = snapshot.m_getVersion();
+	const auto matches  = std::make_shared<std::vector<std::size_t>>();
+
+	auto started = WorkerPool::s_get().m_run([snapshot, search, matches] (WorkerPool::Job& job)
+	{
+		*matches = TextEditor::s_findMatches(snapshot, search, job);
+	});
+
+	auto finish = [this, version, matches, search, replacement = std::wstring(m_editors[Editor_Replace].m_buffer())] (const bool cancelled)
+	{
+		if (cancelled) return;
+
+		auto& main = m_editors[Editor_Main];
+
+		if (!main.m_getDocument().m_rebase(version, *matches, search.m_size()))
+		{
+			m_setConsoleTitle(L"the text changed too much while searching, nothing was replaced");
+			return;
+		}
+
+		// an edit next to a match may have joined it to a word
+		const auto text = main.m_buffer();
+
+		matches->erase(std::remove_if(matches->begin(), matches->end(), [&] (const std::size_t start) { return !search.m_isMatchAt(text, start); }), matches->end());
+
+		main.m_replaceMatchesAt(*matches, search.m_size(), replacement);
+	};
+
+	m_task = BackgroundTask{ std::move(started), L"replacing", std::move(finish) };
+
+	m_updateTitle();
+}
+
+void ConsoleTextEditor::m_startMatchCount(const TextSearch& search)
+{
+	const auto& options = search.m_getOptions();
+
+	if (m_countTask.has_value() && !m_countTask->m_job->m_isCancelled()
+		&& m_countedSearch.m_getPattern() == search.m_getPattern()
+		&& m_countedSearch.m_getOptions().m_ignoreCase == options.m_ignoreCase
+		&& m_countedSearch.m_getOptions().m_wholeWord  == options.m_wholeWord) return;
+
+	// the count of the search typed before is of no use, it finishes on its own
+	if (m_countTask.has_value()) m_countTask->m_job->m_cancel();
+
+	const auto count = std::make_shared<Document::MatchCount>();
+
+	// edits made while it counts are counted again by m_getMatchResults or start the next count
+	auto started = WorkerPool::s_get().m_run([snapshot = m_editors[Editor_Main].m_getDocument().m_takeSnapshot(), search, count] (WorkerPool::Job& job)
+	{
+		*count = TextEditor::s_countMatches(snapshot, search, job);
+	});
+
+	auto finish = [this, count] (const bool cancelled)
+	{
+		if (!cancelled) m_editors[Editor_Main].m_setMatchCount(std::move(*count));
+	};
+
+	m_countedSearch = search;
+	m_countTask = BackgroundTask{ std::move(started), L"counting", std::move(finish) };
+}
+
+bool ConsoleTextEditor::m_pollTasks()
+{
+	bool changed = false;
+
+	for (auto* slot : { &m_task, &m_countTask })
+	{
+		if (!slot->has_value() || !slot->value().m_job->m_isFinished()) continue;
+
+		// the slot is free again before the result is applied, a failed task sets the title after it
+		auto task = std::move(slot->value());
+		slot->reset();
+
+		if (slot == &m_task) m_updateTitle();
+
+		// what a failed task left behind is incomplete, nothing of it is applied
+		if (task.m_job->m_isFailed())
+		{
+			if (slot == &m_task) m_setConsoleTitle(task.m_description + L" failed");
+		}
+		else
+		{
+			task.m_finish(task.m_job->m_isCancelled());
+		}
+
+		changed = true;
+	}
+
+	if (!m_task.has_value() && !m_countTask.has_value()) return changed;
+
+	const auto now = std::chrono::steady_clock::now();
+
+	// progress is redrawn a few times per second
+	if (now - m_lastTaskDraw < std::chrono::milliseconds(100)) return changed;
+
+	m_lastTaskDraw = now;
+
+	if (m_task.has_value()) m_updateTitle();
+
+	return true;
+}
+
+void ConsoleTextEditor::m_onDocumentShown()
+{
+	// the other panes start at the place the document was left
+	for (auto& pane : m_panes) pane = m_editors[Editor_Main];
+
+	m_layoutPanes(m_paneAreaHeight);
+
+	// the follower, the occur list and the match count belong to the document shown before
+	m_follower.m_stop();
+
+	if (m_countTask.has_value()) m_countTask->m_job->m_cancel();
+
+	if (m_showOccur) m_closeOccurList();
+
+	m_filePath = m_documents.m_getPath(m_documents.m_getActive());
+
+	m_updateTitle();
+}
+
+void ConsoleTextEditor::m_showDocument(const std::size_t entry)
+{
+	if (entry == m_documents.m_getActive()) return;
+
+	if (m_documents.m_show(entry, m_editors[Editor_Main]))
+	{
+		m_onDocumentShown();
+	}
+	else
+	{
+		m_setConsoleTitle(std::wstring(utils::GetFileName(m_documents.m_getPath(entry))) + L" could not be read again");
+	}
+}
+
+void ConsoleTextEditor::m_closeDocument()
+{
+	if (m_editors[Editor_Main].m_getDocument().m_isModified())
+	{
+		m_setConsoleTitle(std::wstring(m_filePath.empty() ? L"Untitled" : utils::GetFileName(m_filePath)) + L" has unsaved changes, Ctrl+S: save");
+		return;
+	}
+
+	m_documents.m_closeActive(m_editors[Editor_Main]);
+
+	m_onDocumentShown();
+}
+
+void ConsoleTextEditor::m_updateTitle()
+{
+	std::wstringstream ss;
+
+	if (m_filePath.empty()) ss << L"Untitled";
+	else ss << utils::GetFileName(m_filePath);
+
+	if (m_documents.m_getCount() > 1) ss << L" (" << m_documents.m_getActive() + 1 << L" of " << m_documents.m_getCount() << L")";
+
+	if (m_collaboration.m_isJoined()) ss << L" [shared in " << m_collaboration.m_getName() << L"]";
+
+	if (m_task.has_value()) ss << L"  " << m_task->m_description << L" " << m_task->m_job->m_getPercent() << L"%  Esc: cancel";
+
+	m_setConsoleTitle(ss.str());
+}
+
+void ConsoleTextEditor::m_toggleFollow()
+{
+	if (m_follower.m_isFollowing())
+	{
+		m_follower.m_stop();
+		m_updateTitle();
+		return;
+	}
+
+	if (m_filePath.empty()) return;
+
+	const auto& document = m_editors[Editor_Main].m_getDocument();
+
+	// the buffer is only known to match the file up to its size when it has no changes of its own
+	if (document.m_isModified())
+	{
+		m_setConsoleTitle(std::wstring(utils::GetFileName(m_filePath)) + L" has unsaved changes, save before following");
+		return;
+	}
+
+	if (!m_follower.m_start(m_filePath, document.m_fileSize)) return;
+
+	m_setConsoleTitle(std::wstring(utils::GetFileName(m_filePath)) + L" (following, Ctrl+T: stop)");
+}
+
+void ConsoleTextEditor::m_pollFollower()
+{
+	// the filter reads the buffer, appends wait until it finishes
+	if (m_filter.m_isRunning()) return;
+
+	std::wstring text;
+
+	switch (m_follower.m_poll(text))
+	{
+	case FileFollower::Result::None:
+		return;
+	case FileFollower::Result::Appended:
+	{
+		auto& document = m_editors[Editor_Main].m_getDocument();
+
+		const bool saved = !document.m_isModified();
+
+		m_editors[Editor_Main].m_appendText(std::move(text));
+
+		// the buffer still is the file, following can stop and start again from here
+		if (saved)
+		{
+			document.m_savedVersion = document.m_getVersion();
+			document.m_fileSize     = m_follower.m_getOffset();
+		}
+
+		break;
+	}
+	case FileFollower::Result::Truncated:
+		// the text read so far stays, what the file holds now is unknown
+		m_follower.m_stop();
+		m_setConsoleTitle(std::wstring(utils::GetFileName(m_filePath)) + L" got shorter, following stopped, reopen it to follow again");
+		break;
+	case FileFollower::Result::Failed:
+		m_follower.m_stop();
+		m_updateTitle();
+		break;
+	}
+
+	m_updateEditors();
+	m_setCursorPos(m_editors[m_currentEditor].m_cursorPos);
+}
@@ -0,0 +1,274 @@
+#include "../include/document.h"
+#include "../include/console.h" // _wfopen_s
+#include "../include/utility.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <utility>
+
+[[nodiscard]] std::optional<std::vector<Document::BufferEdit>> Document::m_getEditsSince(const SizeType version) const
+{
+	if (version < m_editLogStart || version > m_getVersion()) return {};
+
+	return std::vector<BufferEdit>(m_editLog.cbegin() + static_cast<std::ptrdiff_t>(version - m_editLogStart), m_editLog.cend());
+}
+
+void Document::m_onInsert(const SizeType index, const std::wstring_view str)
+{
+	m_trigramIndex.m_clear();
+
+	const auto line = m_lineIndex.m_getLineOf(index);
+	const auto insertedLines = m_lineIndex.m_onInsert(index, str);
+
+	m_logEdit({ index, 0, str.size(), line, 0, insertedLines });
+
+	if (!m_replacing && m_keepSnapshot()) m_snapshot->m_insert(index, str);
+
+	if (m_recordChanges) m_changes.push_back({ index, 0, std::wstring(str) });
+}
+
+void Document::m_onErase(const SizeType start, const SizeType end) noexcept
+{
+	m_trigramIndex.m_clear();
+
+	const auto line = m_lineIndex.m_getLineOf(start);
+	const auto removedLines = m_lineIndex.m_onErase(start, end);
+
+	m_logEdit({ start, end - start, 0, line, removedLines, 0 });
+
+	if (!m_replacing && m_keepSnapshot()) m_snapshot->m_erase(start, end);
+
+	if (m_recordChanges) m_changes.push_back({ start, end - start, {} });
+}
+
+void Document::m_onReset() noexcept
+{
+	m_loaded = true;
+
+	m_trigramIndex.m_clear();
+
+	m_lineIndex.m_build(m_getText());
+
+	// readers holding an older version have to start over
+	m_editLogStart = m_getVersion() + 1;
+	m_editLog.clear();
+
+	// copied again by the next snapshot, a reset often comes without one
+	m_snapshot.reset();
+
+	if (m_recordChanges) m_changes.push_back({ 0, std::wstring::npos, std::wstring(m_getText()) });
+}
+
+[[nodiscard]] TextSnapshot Document::m_takeSnapshot()
+{
+	if (!m_snapshot.has_value())
+	{
+		m_snapshot.emplace(m_getText());
+		m_snapshot->m_lease = std::make_shared<const char>();
+	}
+
+	auto snapshot = m_snapshot.value();
+
+	snapshot.m_version = m_getVersion();
+
+	return snapshot;
+}
+
+void Document::m_endReplacements(const std::vector<TextSnapshot::Replacement>& replacements)
+{
+	m_replacing = false;
+
+	if (m_keepSnapshot()) m_snapshot->m_replace(replacements);
+}
+
+[[nodiscard]] bool Document::m_keepSnapshot() noexcept
+{
+	// only this thread copies the lease, a reader letting go of it on another thread can only lower the count
+	if (m_snapshot.has_value() && m_snapshot->m_lease.use_count() == 1) m_snapshot.reset();
+
+	return m_snapshot.has_value();
+}
+
+[[nodiscard]] bool Document::m_rebase(const SizeType version, std::vector<SizeType>& starts, const SizeType size) const
+{
+	const auto edits = m_getEditsSince(version);
+
+	if (!edits.has_value()) return false;
+
+	for (const auto& edit : edits.value())
+	{
+		// the starts are sorted, ranges that end before the edit stay and the ones that start after it move,
+		// an insertion right at a start is before the range
+		const auto first = std::lower_bound(starts.begin(), starts.end(), edit.m_index + 1 - std::min(edit.m_index + 1, size));
+		const auto last  = std::lower_bound(first, starts.end(), edit.m_index + edit.m_removed);
+
+		for (auto it = last; it != starts.end(); ++it) *it = *it - edit.m_removed + edit.m_inserted;
+
+		starts.erase(first, last);
+	}
+
+	return true;
+}
+
+void Document::m_applyEdit(const SizeType index, const SizeType removed, const std::wstring_view inserted)
+{
+	const bool recordChanges = std::exchange(m_recordChanges, false);
+
+	if (removed > 0)
+	{
+		m_onErase(index, index + removed);
+		m_text.erase(index, removed);
+	}
+
+	if (!inserted.empty())
+	{
+		m_onInsert(index, inserted);
+		m_text.insert(index, inserted);
+	}
+
+	m_recordChanges = recordChanges;
+
+	m_moveRecordsOver(index, removed, inserted.size());
+}
+
+void Document::m_moveRecordsOver(SizeType index, const SizeType removed, const SizeType inserted)
+{
+	// newest step first, each one sees the text as it was right after it, so the edit
+	// is moved back over every step it passes
+	for (auto it = m_records.rbegin(); it != m_records.rend(); ++it)
+	{
+		const bool overlaps = std::visit(utils::MakeVisitor
+		{
+			[&] (InsertionRecord& record)
+			{
+				if (index + removed <= record.m_index)
+				{
+					record.m_index = record.m_index - removed + inserted;
+					return false;
+				}
+
+				if (index < record.m_index + record.m_size) return true;
+
+				index -= record.m_size;
+				return false;
+			},
+			[&] (DeletionRecord& record)
+			{
+				if (index + removed <= record.m_index)
+				{
+					record.m_index = record.m_index - removed + inserted;
+					return false;
+				}
+
+				if (index < record.m_index) return true;
+
+				index += record.m_data.size();
+				return false;
+			},
+			[&] (BatchRecord&)
+			{
+				// the edits of a batch are not moved one by one
+				return true;
+			}
+		}, *it);
+
+		if (overlaps)
+		{
+			m_records.erase(m_records.begin(), it.base());
+			return;
+		}
+	}
+}
+
+void Document::m_logEdit(const BufferEdit& edit) noexcept
+{
+	constexpr SizeType maxLimit = 1024;
+
+	m_editLog.push_back(edit);
+
+	if (m_editLog.size() > maxLimit)
+	{
+		m_editLog.pop_front();
+		++m_editLogStart;
+	}
+}
+
+[[nodiscard]] Document::SizeType Document::m_getMemoryUsage() const noexcept
+{
+	auto usage = m_text.capacity() * sizeof(wchar_t) + m_lineIndex.m_getMemoryUsage();
+
+	// pieces a worker still reads after an edit are not counted, they go with its snapshot
+	if (m_snapshot.has_value()) usage += m_snapshot->m_getSize() * sizeof(wchar_t);
+
+	for (const auto& record : m_records)
+	{
+		if (const auto deletion = std::get_if<DeletionRecord>(&record))
+		{
+			usage += deletion->m_data.capacity() * sizeof(wchar_t);
+		}
+		else if (const auto batch = std::get_if<BatchRecord>(&record))
+		{
+			for (const auto& edit : batch->m_edits) usage += sizeof(edit) + edit.m_removed.capacity() * sizeof(wchar_t);
+		}
+	}
+
+	return usage;
+}
+
+void Document::m_compact()
+{
+	m_text.shrink_to_fit();
+	m_lineIndex.m_shrinkToFit();
+
+	m_records.shrink_to_fit();
+}
+
+void Document::m_unload() noexcept
+{
+	if (!m_loaded) return;
+
+	m_unloadedSize = m_text.size() - 1;
+
+	m_trigramIndex.m_clear();
+
+	// swapping with new objects gives the memory back, clear keeps the capacity
+	std::wstring(1, L' ').swap(m_text);
+	m_lineIndex = {};
+	m_matchCount = {};
+	m_snapshot.reset();
+
+	m_loaded = false;
+}
+
+[[nodiscard]] bool Document::m_writeRaw(const std::wstring& path) const noexcept
+{
+	std::FILE* file = nullptr;
+	if (_wfopen_s(&file, path.c_str(), L"wb") || !file) return false;
+
+	const auto text = m_getText();
+
+	const bool written = std::fwrite(text.data(), sizeof(wchar_t), text.size(), file) == text.size();
+
+	return std::fclose(file) == 0 && written;
+}
+
+[[nodiscard]] bool Document::m_readRaw(const std::wstring& path)
+{
+	std::FILE* file = nullptr;
+	if (_wfopen_s(&file, path.c_str(), L"rb") || !file) return false;
+
+	std::wstring text(m_unloadedSize + 1, L' ');
+
+	const bool read = std::fread(text.data(), sizeof(wchar_t), m_unloadedSize, file) == m_unloadedSize;
+
+	std::fclose(file);
+
+	if (!read) return false;
+
+	m_text = std::move(text);
+	m_lineIndex.m_build(m_getText());
+
+	m_loaded = true;
+
+	return true;
+}
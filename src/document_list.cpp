@@ -0,0 +1,246 @@
+#include "../include/document_list.h"
+#include "../include/line_index_cache.h"
+
+#include <algorithm>
+#include <cwchar>
+
+DocumentList::~DocumentList()
+{
+	for (auto& entry : m_entries) m_removeSpillFile(entry);
+}
+
+void DocumentList::m_reset(const std::wstring_view path)
+{
+	for (auto& entry : m_entries) m_removeSpillFile(entry);
+
+	m_entries.clear();
+	m_entries.emplace_back();
+
+	m_entries.back().m_path = path;
+	m_entries.back().m_lastShown = ++m_showCounter;
+
+	m_active = 0;
+}
+
+[[nodiscard]] std::optional<DocumentList::SizeType> DocumentList::m_find(const std::wstring_view path) const
+{
+	// windows paths do not tell case apart and the same file can be named relative or absolute
+	const auto fullPath = LineIndexCache::s_getFullPath(path);
+
+	for (SizeType i = 0; i < m_entries.size(); ++i)
+	{
+		if (!m_entries[i].m_path.empty() && LineIndexCache::s_getFullPath(m_entries[i].m_path) == fullPath) return i;
+	}
+
+	return {};
+}
+
+[[nodiscard]] bool DocumentList::m_open(const std::wstring_view path, TextEditor& editor)
+{
+	TextEditor view;
+
+	view.m_indexMode = editor.m_indexMode;
+
+	if (!view.m_readFile(path)) return false;
+
+	return m_add(path, std::move(view), editor);
+}
+
+[[nodiscard]] bool DocumentList::m_add(const std::wstring_view path, TextEditor view, TextEditor& editor)
+{
+	Entry entry;
+
+	entry.m_path = path;
+	entry.m_view = std::move(view);
+
+	entry.m_view.m_setLanguageFor(path);
+
+	m_entries.push_back(std::move(entry));
+
+	return m_show(m_entries.size() - 1, editor);
+}
+
+[[nodiscard]] bool DocumentList::m_show(const SizeType entry, TextEditor& editor)
+{
+	if (entry == m_active) return true;
+
+	auto& target = m_entries[entry];
+
+	if (!m_load(target)) return false;
+
+	m_entries[m_active].m_view = std::move(editor);
+	editor = std::move(target.m_view);
+
+	m_active = entry;
+	target.m_lastShown = ++m_showCounter;
+
+	m_applyBudget(editor);
+
+	return true;
+}
+
+void DocumentList::m_closeActive(TextEditor& editor)
+{
+	const auto indexMode = editor.m_indexMode;
+
+	m_removeSpillFile(m_entries[m_active]);
+
+	if (m_entries.size() > 1)
+	{
+		m_entries.erase(m_entries.begin() + static_cast<std::ptrdiff_t>(m_active));
+
+		m_active = m_active > 0 ? m_active - 1 : 0;
+
+		auto& target = m_entries[m_active];
+
+		target.m_lastShown = ++m_showCounter;
+
+		if (m_load(target))
+		{
+			editor = std::move(target.m_view);
+			return;
+		}
+	}
+
+	// the last document or one that can not be read back becomes an empty untitled one
+	m_removeSpillFile(m_entries[m_active]);
+
+	m_entries[m_active] = Entry{};
+	m_entries[m_active].m_lastShown = m_showCounter;
+
+	editor = TextEditor();
+	editor.m_indexMode = indexMode;
+}
+
+[[nodiscard]] bool DocumentList::m_load(Entry& entry)
+{
+	switch (entry.m_state)
+	{
+	case State::Loaded:
+		return true;
+	case State::Dropped:
+	{
+		const auto cursor = entry.m_view.m_getCursorIndex();
+
+		if (!entry.m_view.m_readFile(entry.m_path)) return false;
+
+		entry.m_view.m_goToIndex(cursor);
+		break;
+	}
+	case State::Spilled:
+
+		if (!entry.m_view.m_getDocument().m_readRaw(entry.m_spillPath)) return false;
+
+		break;
+	}
+
+	entry.m_state = State::Loaded;
+
+	return true;
+}
+
+[[nodiscard]] bool DocumentList::m_unload(Entry& entry)
+{
+	auto& document = entry.m_view.m_getDocument();
+
+	if (!entry.m_path.empty() && !document.m_isModified())
+	{
+		// the text comes back as a new version, the undo history would not match it if the file changed
+		document.m_records.clear();
+		document.m_unload();
+
+		entry.m_state = State::Dropped;
+		return true;
+	}
+
+	if (entry.m_spillVersion != document.m_getVersion())
+	{
+		if (entry.m_spillPath.empty()) entry.m_spillPath = s_createSpillFile();
+
+		if (entry.m_spillPath.empty() || !document.m_writeRaw(entry.m_spillPath)) return false;
+
+		entry.m_spillVersion = document.m_getVersion();
+	}
+
+	document.m_unload();
+
+	entry.m_state = State::Spilled;
+	return true;
+}
+
+void DocumentList::m_applyBudget(const TextEditor& editor)
+{
+	auto total = editor.m_getDocument().m_getMemoryUsage();
+
+	std::vector<SizeType> loaded;
+
+	for (SizeType i = 0; i < m_entries.size(); ++i)
+	{
+		if (i == m_active || m_entries[i].m_state != State::Loaded) continue;
+
+		// someone else still shows it, its text can not go away under them
+		if (m_entries[i].m_view.m_isDocumentShared()) continue;
+
+		total += m_entries[i].m_view.m_getDocument().m_getMemoryUsage();
+		loaded.push_back(i);
+	}
+
+	if (total <= m_budget) return;
+
+	// compacting the modified documents may be enough, reading them back later is not
+	for (const auto i : loaded)
+	{
+		auto& document = m_entries[i].m_view.m_getDocument();
+
+		if (!document.m_isModified()) continue;
+
+		const auto usage = document.m_getMemoryUsage();
+
+		document.m_compact();
+
+		total -= usage - std::min(usage, document.m_getMemoryUsage());
+	}
+
+	std::sort(loaded.begin(), loaded.end(), [&] (const SizeType lhs, const SizeType rhs)
+	{
+		return m_entries[lhs].m_lastShown < m_entries[rhs].m_lastShown;
+	});
+
+	for (const auto i : loaded)
+	{
+		if (total <= m_budget) break;
+
+		const auto usage = m_entries[i].m_view.m_getDocument().m_getMemoryUsage();
+
+		if (m_unload(m_entries[i])) total -= std::min(total, usage);
+	}
+}
+
+void DocumentList::m_removeSpillFile(Entry& entry) noexcept
+{
+	if (entry.m_spillPath.empty()) return;
+
+	DeleteFileW(entry.m_spillPath.c_str());
+
+	entry.m_spillPath.clear();
+	entry.m_spillVersion = std::wstring::npos;
+}
+
+[[nodiscard]] std::wstring DocumentList::s_createSpillFile()
+{
+	std::wstring directory(MAX_PATH + 1, L'\0');
+
+	const auto length = GetTempPathW(static_cast<DWORD>(directory.size()), directory.data());
+
+	if (length == 0 || length > directory.size()) return {};
+
+	directory.resize(length);
+
+	std::wstring path(MAX_PATH + 1, L'\0');
+
+	if (GetTempFileNameW(directory.c_str(), L"edt", 0, path.data()) == 0) return {};
+
+	path.resize(std::wcslen(path.c_str()));
+
+	return path;
+}
@@ -0,0 +1,336 @@
+#include "../include/editor_server.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <cwchar>
+
+namespace
+{
+
+	template<typename Type>
+	void Append(std::vector<char>& data, const Type* values, const std::size_t count)
+	{
+		const auto bytes = reinterpret_cast<const char*>(values);
+
+		data.insert(data.end(), bytes, bytes + count * sizeof(Type));
+	}
+
+	[[nodiscard]] constexpr bool operator== (const COORD lhs, const COORD rhs) noexcept
+	{
+		return lhs.X == rhs.X && lhs.Y == rhs.Y;
+	}
+
+} // namespace
+
+[[nodiscard]] int EditorServer::s_main(const int argc, const wchar_t* argv[])
+{
+	EditorServer server;
+
+	for (int i = 2; i < argc; ++i)
+	{
+		const std::wstring_view arg = argv[i];
+
+		if (arg.substr(0, 9) == L"--memory=") server.m_budget = static_cast<SizeType>(_wtoi(arg.data() + 9)) << 20;
+	}
+
+	const auto path = LocalSocket::s_getPath(s_socketName);
+
+	if (!LocalSocket::s_startup() || !server.m_listen(path))
+	{
+		std::fwprintf(stderr, L"could not listen on %hs, a server may be running already\n", path.c_str());
+		return 1;
+	}
+
+	std::fwprintf(stdout, L"listening on %hs\n", path.c_str());
+
+	server.m_run();
+
+	return 0;
+}
+
+[[nodiscard]] bool EditorServer::m_listen(const std::string& path) noexcept
+{
+	m_listener = LocalSocket::s_listen(path);
+
+	return m_listener.m_isValid();
+}
+
+void EditorServer::m_run()
+{
+	std::vector<const LocalSocket*> sockets;
+
+	while (true)
+	{
+		sockets.assign(1, &m_listener);
+
+		for (const auto& session : m_sessions) sockets.push_back(&session->m_socket);
+
+		LocalSocket::s_wait(sockets, s_waitTimeout);
+
+		m_acceptClients();
+
+		for (auto& session : m_sessions)
+		{
+			// a client that reads slowly only holds up its own frames
+			const bool open = session->m_socket.m_flush() && session->m_socket.m_receive();
+
+			while (!session->m_closed)
+			{
+				const auto message = session->m_socket.m_takeMessage();
+
+				if (!message.has_value()) break;
+
+				session->m_closed = !m_handleMessage(*session, message.value());
+			}
+
+			if (!open) session->m_closed = true;
+		}
+
+		// the edits of one client are drawn by the others here
+		for (auto& session : m_sessions)
+		{
+			if (session->m_closed || !session->m_editor) continue;
+
+			session->m_editor->m_handleIdle();
+
+			if (!session->m_editor->m_isRunning() || !m_sendFrame(*session)) session->m_closed = true;
+		}
+
+		const auto closed = std::remove_if(m_sessions.begin(), m_sessions.end(), [] (const auto& session) { return session->m_closed; });
+
+		if (closed != m_sessions.end())
+		{
+			m_sessions.erase(closed, m_sessions.end());
+
+			m_applyBudget();
+		}
+	}
+}
+
+void EditorServer::m_acceptClients()
+{
+	while (true)
+	{
+		auto socket = m_listener.m_accept();
+
+		if (!socket.m_isValid()) return;
+
+		m_sessions.push_back(std::make_unique<Session>());
+		m_sessions.back()->m_socket = std::move(socket);
+	}
+}
+
+[[nodiscard]] bool EditorServer::m_handleMessage(Session& session, const LocalSocket::Message& message)
+{
+	const auto& data = message.m_data;
+
+	switch (message.m_type)
+	{
+	case Message_Hello:
+	{
+		if (session.m_editor || data.size() < sizeof(HelloMessage)) return false;
+
+		HelloMessage hello;
+		std::memcpy(&hello, data.data(), sizeof(hello));
+
+		std::wstring path((data.size() - sizeof(hello)) / sizeof(wchar_t), L'\0');
+		std::memcpy(path.data(), data.data() + sizeof(hello), path.size() * sizeof(wchar_t));
+
+		return m_attach(session, hello, path);
+	}
+	case Message_Input:
+	{
+		if (!session.m_editor || data.size() < sizeof(InputMessage)) return false;
+
+		InputMessage input;
+		std::memcpy(&input, data.data(), sizeof(input));
+
+		std::vector<INPUT_RECORD> events((data.size() - sizeof(input)) / sizeof(INPUT_RECORD));
+		std::memcpy(events.data(), data.data() + sizeof(input), events.size() * sizeof(INPUT_RECORD));
+
+		session.m_editor->m_handleInputEvents(events.data(), events.size(), input.m_more != 0);
+
+		return true;
+	}
+	case Message_Resize:
+	{
+		if (!session.m_editor || data.size() < sizeof(ResizeMessage)) return false;
+
+		ResizeMessage resize;
+		std::memcpy(&resize, data.data(), sizeof(resize));
+
+		if (resize.m_size.X < 1 || resize.m_size.Y < 1) return false;
+
+		session.m_editor->m_resizeConsole(resize.m_size);
+
+		return true;
+	}
+	default:
+		return false;
+	}
+}
+
+[[nodiscard]] bool EditorServer::m_attach(Session& session, const HelloMessage& hello, const std::wstring_view path)
+{
+	if (hello.m_size.X < 1 || hello.m_size.Y < 1) return false;
+
+	const auto view = path.empty() ? nullptr : m_loadDocument(path);
+
+	session.m_editor = std::make_unique<ConsoleTextEditor>();
+
+	// a file that can not be read opens as an untitled document, like it does without the server
+	return session.m_editor->m_constructSession(hello.m_size.X, hello.m_size.Y, view ? path : std::wstring_view(), view);
+}
+
+[[nodiscard]] const TextEditor* EditorServer::m_loadDocument(const std::wstring_view path)
+{
+	const std::wstring pathStr(path);
+
+	for (auto& document : m_documents)
+	{
+		// windows paths do not tell case apart
+		if (_wcsicmp(document.m_path.c_str(), pathStr.c_str()) == 0)
+		{
+			document.m_lastAttached = ++m_attachCounter;
+			return &document.m_view;
+		}
+	}
+
+	CachedDocument document;
+
+	document.m_path = pathStr;
+
+	if (!document.m_view.m_readFile(path)) return nullptr;
+
+	document.m_view.m_setLanguageFor(path);
+	document.m_lastAttached = ++m_attachCounter;
+
+	m_documents.push_back(std::move(document));
+
+	return &m_documents.back().m_view;
+}
+
+[[nodiscard]] bool EditorServer::m_sendFrame(Session& session) const
+{
+	// the frames are merged into one while the client has not taken the last one,
+	// a client that takes nothing is dropped once its backlog passes the cap of m_send
+	if (session.m_socket.m_getBacklog() > 0) return session.m_socket.m_getBacklog() <= LocalSocket::s_maxBacklog;
+
+	const auto& editor = *session.m_editor;
+
+	const auto& chars      = editor.m_getChars();
+	const auto& attributes = editor.m_getAttributes();
+
+	const COORD size = { static_cast<short>(editor.m_screenWidth()), static_cast<short>(editor.m_screenHeight()) };
+
+	// the client has nothing of a new size yet
+	const bool resized = !(size == session.m_sentSize);
+
+	std::vector<char> data(sizeof(FrameMessage));
+
+	std::uint32_t runCount = 0;
+
+	auto addRun = [&] (const std::size_t start, const std::size_t end)
+	{
+		const FrameRun run = { static_cast<std::uint32_t>(start), static_cast<std::uint32_t>(end - start) };
+
+		Append(data, &run, 1);
+		Append(data, chars     .data() + start, end - start);
+		Append(data, attributes.data() + start, end - start);
+
+		++runCount;
+	};
+
+	if (resized)
+	{
+		addRun(0, chars.size());
+	}
+	else
+	{
+		auto isChanged = [&] (const std::size_t i)
+		{
+			return chars[i] != session.m_sentChars[i] || attributes[i] != session.m_sentAttributes[i];
+		};
+
+		for (std::size_t i = 0; i < chars.size(); )
+		{
+			if (!isChanged(i))
+			{
+				++i;
+				continue;
+			}
+
+			auto end = i + 1;
+
+			for (auto t = end; t < chars.size() && t - end <= s_runGap; ++t)
+			{
+				if (isChanged(t)) end = t + 1;
+			}
+
+			addRun(i, end);
+
+			i = end;
+		}
+	}
+
+	const auto cursorPos     = editor.m_getCursorPos();
+	const bool cursorVisible = editor.m_isCursorVisible();
+
+	if (runCount > 0 || !(cursorPos == session.m_sentCursorPos) || cursorVisible != session.m_sentCursorVisible)
+	{
+		const FrameMessage frame = { size, cursorPos, cursorVisible ? 1u : 0u, runCount };
+
+		std::memcpy(data.data(), &frame, sizeof(frame));
+
+		if (!session.m_socket.m_send(Message_Frame, data.data(), data.size())) return false;
+
+		session.m_sentChars      = chars;
+		session.m_sentAttributes = attributes;
+
+		session.m_sentSize          = size;
+		session.m_sentCursorPos     = cursorPos;
+		session.m_sentCursorVisible = cursorVisible;
+	}
+
+	const auto title = editor.m_getConsoleTitle();
+
+	if (title != session.m_sentTitle)
+	{
+		if (!session.m_socket.m_send(Message_Title, title.data(), title.size() * sizeof(wchar_t))) return false;
+
+		session.m_sentTitle = title;
+	}
+
+	return true;
+}
+
+void EditorServer::m_applyBudget()
+{
+	SizeType total = 0;
+
+	for (const auto& document : m_documents) total += document.m_view.m_getDocument().m_getMemoryUsage();
+
+	if (total <= m_budget) return;
+
+	std::sort(m_documents.begin(), m_documents.end(), [] (const CachedDocument& lhs, const CachedDocument& rhs)
+	{
+		return lhs.m_lastAttached < rhs.m_lastAttached;
+	});
+
+	for (auto it = m_documents.begin(); it != m_documents.end() && total > m_budget; )
+	{
+		const auto& document = it->m_view.m_getDocument();
+
+		// unsaved edits wait for the next client that opens the file
+		if (it->m_view.m_isDocumentShared() || document.m_isModified())
+		{
+			++it;
+			continue;
+		}
+
+		total -= std::min(total, document.m_getMemoryUsage());
+
+		it = m_documents.erase(it);
+	}
+}
@@ -0,0 +1,142 @@
+#include "../include/file_follower.h"
+#include "../include/utility.h"
+
+#include <algorithm>
+
+FileFollower::~FileFollower()
+{
+	m_stop();
+}
+
+[[nodiscard]] bool FileFollower::m_start(const std::wstring_view filePath, const SizeType offset)
+{
+	m_stop();
+
+	const std::wstring path(filePath);
+
+	// the writer keeps the file open for writing
+	m_file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+		nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (m_file == INVALID_HANDLE_VALUE) return false;
+
+	const auto separator = path.find_last_of(L"/\\");
+	const auto directory = separator == std::wstring::npos ? std::wstring(L".") : path.substr(0, separator + 1);
+
+	m_notification = FindFirstChangeNotificationW(directory.c_str(), FALSE, FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE);
+
+	LARGE_INTEGER size = {};
+
+	GetFileSizeEx(m_file, &size);
+
+	m_offset = offset;
+	m_knownSize = static_cast<SizeType>(size.QuadPart);
+
+	m_pending.clear();
+
+	m_lastSizeCheck = std::chrono::steady_clock::now();
+
+	return true;
+}
+
+void FileFollower::m_stop() noexcept
+{
+	if (m_notification != INVALID_HANDLE_VALUE) FindCloseChangeNotification(m_notification);
+	if (m_file         != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+
+	m_notification = INVALID_HANDLE_VALUE;
+	m_file         = INVALID_HANDLE_VALUE;
+}
+
+[[nodiscard]] bool FileFollower::m_hasChanged() noexcept
+{
+	// still catching up with the last known size
+	if (m_offset < m_knownSize) return true;
+
+	bool changed = false;
+
+	if (m_notification != INVALID_HANDLE_VALUE && WaitForSingleObject(m_notification, 0) == WAIT_OBJECT_0)
+	{
+		FindNextChangeNotification(m_notification);
+		changed = true;
+	}
+
+	const auto now = std::chrono::steady_clock::now();
+
+	if (now - m_lastSizeCheck >= s_sizeCheckInterval)
+	{
+		m_lastSizeCheck = now;
+		changed = true;
+	}
+
+	return changed;
+}
+
+[[nodiscard]] FileFollower::Result FileFollower::m_poll(std::wstring& text)
+{
+	text.clear();
+
+	if (!m_isFollowing()) return Result::Failed;
+
+	if (!m_hasChanged()) return Result::None;
+
+	LARGE_INTEGER size = {};
+
+	if (!GetFileSizeEx(m_file, &size)) return Result::Failed;
+
+	m_knownSize = static_cast<SizeType>(size.QuadPart);
+
+	if (m_knownSize < m_offset)
+	{
+		// read everything again from the start
+		m_offset = 0;
+		m_pending.clear();
+
+		return Result::Truncated;
+	}
+
+	if (m_knownSize == m_offset) return Result::None;
+
+	const auto readSize = static_cast<DWORD>(std::min(s_readSize, m_knownSize - m_offset));
+
+	m_bytes = m_pending;
+	m_bytes.resize(m_pending.size() + readSize);
+
+	DWORD done = 0;
+
+	while (done < readSize)
+	{
+		// positional read of only the new bytes
+		OVERLAPPED overlapped = {};
+
+		overlapped.Offset     = static_cast<DWORD>((m_offset + done) & 0xFFFFFFFF);
+		overlapped.OffsetHigh = static_cast<DWORD>((m_offset + done) >> 32);
+
+		DWORD readCount = 0;
+
+		if (!ReadFile(m_file, m_bytes.data() + m_pending.size() + done, readSize - done, &readCount, &overlapped) || readCount == 0) break;
+
+		done += readCount;
+	}
+
+	if (done == 0) return Result::None;
+
+	m_offset += done;
+	m_bytes.resize(m_pending.size() + done);
+
+	const auto complete = utils::GetCompleteUtf8Size(m_bytes.data(), m_bytes.size());
+
+	m_pending.assign(m_bytes.cbegin() + static_cast<std::ptrdiff_t>(complete), m_bytes.cend());
+
+	if (complete == 0) return Result::None;
+
+	// never more characters than bytes
+	text.resize(complete);
+
+	const auto charCount = MultiByteToWideChar(CP_UTF8, 0, m_bytes.data(), static_cast<int>(complete),
+		text.data(), static_cast<int>(complete));
+
+	text.resize(static_cast<std::size_t>(std::max(charCount, 0)));
+
+	return Result::Appended;
+}
@@ -0,0 +1,98 @@
+#include "../include/line_index.h"
+
+#include <algorithm>
+
+void LineIndex::m_build(const std::wstring_view text)
+{
+	m_newLines.clear();
+
+	for (auto i = text.find(L'\n'); i != std::wstring_view::npos; i = text.find(L'\n', i + 1))
+	{
+		m_newLines.push_back(i);
+	}
+
+	m_gapIndex = m_newLines.size();
+	m_gapDelta = 0;
+	m_textSize = text.size();
+}
+
+[[nodiscard]] LineIndex::SizeType LineIndex::m_getLineStart(const SizeType line) const noexcept
+{
+	if (line == 0) return 0;
+	if (line > m_newLines.size()) return m_textSize;
+
+	return m_getNewLine(line - 1) + 1;
+}
+
+[[nodiscard]] LineIndex::SizeType LineIndex::m_getLineEnd(const SizeType line) const noexcept
+{
+	if (line >= m_newLines.size()) return m_textSize;
+
+	return m_getNewLine(line);
+}
+
+[[nodiscard]] LineIndex::SizeType LineIndex::m_getLineOf(const SizeType index) const noexcept
+{
+	// count of newlines before index
+	SizeType low  = 0;
+	SizeType high = m_newLines.size();
+
+	while (low < high)
+	{
+		const auto mid = low + (high - low) / 2;
+
+		if (m_getNewLine(mid) < index) low = mid + 1;
+		else high = mid;
+	}
+
+	return low;
+}
+
+void LineIndex::m_moveGap(const SizeType gapIndex) noexcept
+{
+	for (; m_gapIndex < gapIndex; ++m_gapIndex) m_newLines[m_gapIndex] += m_gapDelta;
+	for (; m_gapIndex > gapIndex; --m_gapIndex) m_newLines[m_gapIndex - 1] -= m_gapDelta;
+}
+
+LineIndex::SizeType LineIndex::m_onInsert(const SizeType index, const std::wstring_view str)
+{
+	const auto line = m_getLineOf(index);
+
+	m_moveGap(line);
+
+	m_gapDelta += str.size();
+	m_textSize += str.size();
+
+	const auto count = static_cast<SizeType>(std::count(str.cbegin(), str.cend(), L'\n'));
+
+	if (count > 0)
+	{
+		std::vector<SizeType> inserted;
+		inserted.reserve(count);
+
+		// new entries are inside the gap, so they are stored without the shift
+		for (auto i = str.find(L'\n'); i != std::wstring_view::npos; i = str.find(L'\n', i + 1))
+		{
+			inserted.push_back(index + i - m_gapDelta);
+		}
+
+		m_newLines.insert(m_newLines.begin() + static_cast<std::ptrdiff_t>(line), inserted.cbegin(), inserted.cend());
+	}
+
+	return count;
+}
+
+LineIndex::SizeType LineIndex::m_onErase(const SizeType start, const SizeType end) noexcept
+{
+	const auto first = m_getLineOf(start);
+	const auto last  = m_getLineOf(end);
+
+	m_moveGap(first);
+
+	m_newLines.erase(m_newLines.begin() + static_cast<std::ptrdiff_t>(first), m_newLines.begin() + static_cast<std::ptrdiff_t>(last));
+
+	m_gapDelta -= end - start;
+	m_textSize -= end - start;
+
+	return last - first;
+}
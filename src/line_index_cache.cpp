@@ -0,0 +1,211 @@
+#include "../include/line_index_cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cwctype>
+#include <type_traits>
+
+namespace
+{
+	constexpr char s_magic[4] = { 'E', 'L', 'I', 'X' };
+
+	struct FileHeader
+	{
+		char m_magic[4];
+		std::uint32_t m_version;
+
+		std::uint64_t m_blockSize;
+		std::uint64_t m_fileSize;
+		std::uint64_t m_writeTime;
+		std::uint64_t m_contentHash;
+
+		// wide characters of the path after the header, the counts follow the path
+		std::uint64_t m_pathSize;
+		std::uint64_t m_blockCount;
+	};
+
+	static_assert(std::is_trivially_copyable_v<FileHeader>);
+
+	[[nodiscard]] bool WriteAll(const HANDLE handle, const void* data, const std::size_t size) noexcept
+	{
+		auto bytes = static_cast<const char*>(data);
+
+		for (auto remaining = size; remaining > 0;)
+		{
+			DWORD written = 0;
+
+			if (!WriteFile(handle, bytes, static_cast<DWORD>(std::min<std::size_t>(remaining, 1 << 30)), &written, nullptr) || written == 0) return false;
+
+			bytes += written;
+			remaining -= written;
+		}
+
+		return true;
+	}
+} // namespace
+
+[[nodiscard]] LineIndexCache::SizeType LineIndexCache::s_hash(const char* data, const std::size_t size, SizeType seed) noexcept
+{
+	// fnv-1a
+	for (std::size_t i = 0; i < size; ++i)
+	{
+		seed ^= static_cast<unsigned char>(data[i]);
+		seed *= 1099511628211ull;
+	}
+
+	return seed;
+}
+
+[[nodiscard]] std::wstring LineIndexCache::s_getFullPath(const std::wstring_view filePath)
+{
+	const std::wstring path(filePath);
+
+	std::wstring fullPath(MAX_PATH, L'\0');
+
+	auto length = GetFullPathNameW(path.c_str(), static_cast<DWORD>(fullPath.size()), fullPath.data(), nullptr);
+
+	if (length > fullPath.size())
+	{
+		fullPath.resize(length);
+		length = GetFullPathNameW(path.c_str(), static_cast<DWORD>(fullPath.size()), fullPath.data(), nullptr);
+	}
+
+	if (length == 0 || length > fullPath.size()) fullPath = path;
+	else fullPath.resize(length);
+
+	// paths are not case sensitive
+	std::transform(fullPath.begin(), fullPath.end(), fullPath.begin(), [] (const wchar_t c) { return static_cast<wchar_t>(std::towlower(c)); });
+
+	return fullPath;
+}
+
+[[nodiscard]] std::wstring LineIndexCache::s_getCachePath(const Key& key, const bool createDirectory)
+{
+	std::wstring directory(MAX_PATH, L'\0');
+
+	const auto length = GetEnvironmentVariableW(L"LOCALAPPDATA", directory.data(), static_cast<DWORD>(directory.size()));
+
+	if (length == 0 || length >= directory.size()) return {};
+
+	directory.resize(length);
+
+	for (const auto name : { L"\\e", L"\\line-index" })
+	{
+		directory += name;
+
+		if (createDirectory && !CreateDirectoryW(directory.c_str(), nullptr) && GetLastError() != ERROR_ALREADY_EXISTS) return {};
+	}
+
+	const auto hash = s_hash(reinterpret_cast<const char*>(key.m_path.data()), key.m_path.size() * sizeof(wchar_t));
+
+	std::wstring fileName(16, L'0');
+
+	for (std::size_t i = 0; i < fileName.size(); ++i)
+	{
+		fileName[fileName.size() - 1 - i] = L"0123456789abcdef"[(hash >> (i * 4)) & 0xF];
+	}
+
+	return directory + L'\\' + fileName + L".idx";
+}
+
+[[nodiscard]] bool LineIndexCache::s_load(const Key& key, std::vector<SizeType>& lineCounts)
+{
+	const auto cachePath = s_getCachePath(key, false);
+
+	if (cachePath.empty()) return false;
+
+	const auto file = CreateFileW(cachePath.c_str(), GENERIC_READ, FILE_SHARE_READ,
+		nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (file == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER size = {};
+
+	const auto mapping = GetFileSizeEx(file, &size) && static_cast<SizeType>(size.QuadPart) >= sizeof(FileHeader) ?
+		CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+
+	const auto view = mapping != nullptr ? static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+
+	bool result = false;
+
+	if (view != nullptr)
+	{
+		const auto fileSize = static_cast<SizeType>(size.QuadPart);
+
+		FileHeader header;
+		std::memcpy(&header, view, sizeof(header));
+
+		const bool headerMatches =
+			std::memcmp(header.m_magic, s_magic, sizeof(s_magic)) == 0 &&
+			header.m_version     == s_version         &&
+			header.m_blockSize   == key.m_blockSize   &&
+			header.m_fileSize    == key.m_fileSize    &&
+			header.m_writeTime   == key.m_writeTime   &&
+			header.m_contentHash == key.m_contentHash &&
+			header.m_pathSize    == key.m_path.size() &&
+			header.m_blockCount  == lineCounts.size();
+
+		const auto pathBytes  = header.m_pathSize   * sizeof(wchar_t);
+		const auto countBytes = header.m_blockCount * sizeof(SizeType);
+
+		// two files can share a name hash, the path tells them apart
+		if (headerMatches && fileSize == sizeof(header) + pathBytes + countBytes &&
+			std::memcmp(view + sizeof(header), key.m_path.data(), static_cast<std::size_t>(pathBytes)) == 0)
+		{
+			std::memcpy(lineCounts.data(), view + sizeof(header) + pathBytes, static_cast<std::size_t>(countBytes));
+
+			// a damaged file must not send line lookups out of the file
+			result = std::is_sorted(lineCounts.cbegin(), lineCounts.cend()) && (lineCounts.empty() || lineCounts.back() <= key.m_fileSize);
+		}
+
+		UnmapViewOfFile(view);
+	}
+
+	if (mapping != nullptr) CloseHandle(mapping);
+
+	CloseHandle(file);
+
+	return result;
+}
+
+[[nodiscard]] bool LineIndexCache::s_save(const Key& key, const std::vector<SizeType>& lineCounts)
+{
+	const auto cachePath = s_getCachePath(key, true);
+
+	if (cachePath.empty()) return false;
+
+	// one temporary name per thread, two viewers of the same file do not write into each other
+	const auto tempPath = cachePath + L'.' + std::to_wstring(GetCurrentThreadId()) + L".tmp";
+
+	const auto file = CreateFileW(tempPath.c_str(), GENERIC_WRITE, 0,
+		nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (file == INVALID_HANDLE_VALUE) return false;
+
+	FileHeader header = {};
+
+	std::memcpy(header.m_magic, s_magic, sizeof(s_magic));
+
+	header.m_version     = s_version;
+	header.m_blockSize   = key.m_blockSize;
+	header.m_fileSize    = key.m_fileSize;
+	header.m_writeTime   = key.m_writeTime;
+	header.m_contentHash = key.m_contentHash;
+	header.m_pathSize    = key.m_path.size();
+	header.m_blockCount  = lineCounts.size();
+
+	const bool written =
+		WriteAll(file, &header, sizeof(header)) &&
+		WriteAll(file, key.m_path.data(), key.m_path.size() * sizeof(wchar_t)) &&
+		WriteAll(file, lineCounts.data(), lineCounts.size() * sizeof(SizeType));
+
+	CloseHandle(file);
+
+	if (!written || !MoveFileExW(tempPath.c_str(), cachePath.c_str(), MOVEFILE_REPLACE_EXISTING))
+	{
+		DeleteFileW(tempPath.c_str());
+		return false;
+	}
+
+	return true;
+}
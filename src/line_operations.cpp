@@ -0,0 +1,177 @@
+#include "../include/line_operations.h"
+
+#include <algorithm>
+#include <execution>
+#include <unordered_set>
+#include <limits>
+
+namespace
+{
+
+	[[nodiscard]] constexpr std::wstring_view Trim(std::wstring_view str) noexcept
+	{
+		while (!str.empty() && str.front() == L' ') str.remove_prefix(1);
+		while (!str.empty() && str.back()  == L' ') str.remove_suffix(1);
+
+		return str;
+	}
+
+	[[nodiscard]] constexpr bool IsDigit(const wchar_t c) noexcept
+	{
+		return c >= L'0' && c <= L'9';
+	}
+
+} // namespace
+
+[[nodiscard]] std::optional<LineOperations::Command> LineOperations::s_parseCommand(std::wstring_view str) noexcept
+{
+	str = Trim(str);
+
+	const auto nameEnd = std::min(str.find(L' '), str.size());
+
+	const auto name     = str.substr(0, nameEnd);
+	const auto argument = Trim(str.substr(nameEnd));
+
+	if (name == L"sort")
+	{
+		if (argument.empty()) return Command{ Type::Sort, {} };
+		if (argument == L"-n") return Command{ Type::SortNumeric, {} };
+
+		return {};
+	}
+
+	if (name == L"unique"  && argument.empty()) return Command{ Type::Unique , {} };
+	if (name == L"reverse" && argument.empty()) return Command{ Type::Reverse, {} };
+
+	if (name == L"keep" && !argument.empty()) return Command{ Type::Keep, argument };
+	if (name == L"drop" && !argument.empty()) return Command{ Type::Drop, argument };
+
+	return {};
+}
+
+void LineOperations::s_apply(const Type type, std::vector<std::wstring_view>& lines, const TextSearch& search)
+{
+	switch (type)
+	{
+	case Type::Sort:
+		std::stable_sort(std::execution::par, lines.begin(), lines.end());
+		break;
+	case Type::SortNumeric:
+		s_sortNumeric(lines);
+		break;
+	case Type::Unique:
+		s_removeDuplicates(lines);
+		break;
+	case Type::Keep:
+	case Type::Drop:
+		s_filter(lines, search, type == Type::Keep);
+		break;
+	case Type::Reverse:
+		std::reverse(lines.begin(), lines.end());
+		break;
+	}
+}
+
+[[nodiscard]] std::wstring LineOperations::s_joinLines(const std::vector<std::wstring_view>& lines)
+{
+	std::wstring::size_type size = lines.empty() ? 0 : lines.size() - 1;
+
+	for (const auto line : lines) size += line.size();
+
+	std::wstring result;
+	result.reserve(size);
+
+	for (std::size_t i = 0; i < lines.size(); ++i)
+	{
+		if (i > 0) result.push_back(L'\n');
+
+		result.append(lines[i]);
+	}
+
+	return result;
+}
+
+[[nodiscard]] double LineOperations::s_getNumericKey(const std::wstring_view line) noexcept
+{
+	std::size_t i = 0;
+
+	while (i < line.size() && (line[i] == L' ' || line[i] == L'\t')) ++i;
+
+	const bool negative = i < line.size() && line[i] == L'-';
+
+	if (i < line.size() && (line[i] == L'-' || line[i] == L'+')) ++i;
+
+	if (i == line.size() || (!IsDigit(line[i]) && line[i] != L'.')) return -std::numeric_limits<double>::infinity();
+
+	double result = 0.0;
+
+	for (; i < line.size() && IsDigit(line[i]); ++i) result = result * 10.0 + (line[i] - L'0');
+
+	if (i < line.size() && line[i] == L'.')
+	{
+		double scale = 0.1;
+
+		for (++i; i < line.size() && IsDigit(line[i]); ++i, scale *= 0.1) result += (line[i] - L'0') * scale;
+	}
+
+	return negative ? -result : result;
+}
+
+void LineOperations::s_sortNumeric(std::vector<std::wstring_view>& lines)
+{
+	struct KeyedLine
+	{
+		double m_key;
+		std::wstring_view m_line;
+	};
+
+	// keys are parsed once instead of in every comparison
+	std::vector<KeyedLine> keyedLines(lines.size());
+
+	std::transform(std::execution::par, lines.cbegin(), lines.cend(), keyedLines.begin(), [] (const std::wstring_view line)
+	{
+		return KeyedLine{ s_getNumericKey(line), line };
+	});
+
+	std::stable_sort(std::execution::par, keyedLines.begin(), keyedLines.end(), [] (const KeyedLine& lhs, const KeyedLine& rhs)
+	{
+		return lhs.m_key < rhs.m_key;
+	});
+
+	std::transform(keyedLines.cbegin(), keyedLines.cend(), lines.begin(), [] (const KeyedLine& keyedLine)
+	{
+		return keyedLine.m_line;
+	});
+}
+
+void LineOperations::s_removeDuplicates(std::vector<std::wstring_view>& lines)
+{
+	// first occurrence of every line is kept in place
+	std::unordered_set<std::wstring_view> seen;
+	seen.reserve(lines.size());
+
+	lines.erase(std::remove_if(lines.begin(), lines.end(), [&] (const std::wstring_view line)
+	{
+		return !seen.insert(line).second;
+	}), lines.end());
+}
+
+void LineOperations::s_filter(std::vector<std::wstring_view>& lines, const TextSearch& search, const bool keepMatches)
+{
+	// searching is the expensive part, it runs in parallel and only the compaction is serial
+	std::vector<char> matches(lines.size());
+
+	std::transform(std::execution::par, lines.cbegin(), lines.cend(), matches.begin(), [&] (const std::wstring_view line)
+	{
+		return static_cast<char>(search.m_findNext(line) != TextSearch::s_npos);
+	});
+
+	std::size_t size = 0;
+
+	for (std::size_t i = 0; i < lines.size(); ++i)
+	{
+		if ((matches[i] != 0) == keepMatches) lines[size++] = lines[i];
+	}
+
+	lines.resize(size);
+}
@@ -0,0 +1,291 @@
+// winsock2.h has to come before windows.h, with the settings console.h uses for it
+#ifndef UNICODE
+#define UNICODE
+#endif
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include <winsock2.h>
+#include <afunix.h>
+
+#include "../include/local_socket.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace
+{
+
+	[[nodiscard]] std::optional<sockaddr_un> MakeAddress(const std::string& path) noexcept
+	{
+		sockaddr_un address = {};
+
+		address.sun_family = AF_UNIX;
+
+		if (path.empty() || path.size() >= sizeof(address.sun_path)) return {};
+
+		std::memcpy(address.sun_path, path.c_str(), path.size());
+
+		return address;
+	}
+
+} // namespace
+
+LocalSocket::~LocalSocket()
+{
+	m_close();
+}
+
+LocalSocket::LocalSocket(LocalSocket&& other) noexcept
+	: m_handle(std::exchange(other.m_handle, s_invalidHandle)),
+	m_received(std::move(other.m_received)), m_readOffset(std::exchange(other.m_readOffset, 0)),
+	m_outgoing(std::move(other.m_outgoing)), m_sendOffset(std::exchange(other.m_sendOffset, 0))
+{
+}
+
+LocalSocket& LocalSocket::operator= (LocalSocket&& other) noexcept
+{
+	if (this != &other)
+	{
+		m_close();
+
+		m_handle     = std::exchange(other.m_handle, s_invalidHandle);
+		m_received   = std::move(other.m_received);
+		m_readOffset = std::exchange(other.m_readOffset, 0);
+		m_outgoing   = std::move(other.m_outgoing);
+		m_sendOffset = std::exchange(other.m_sendOffset, 0);
+	}
+
+	return *this;
+}
+
+[[nodiscard]] bool LocalSocket::s_startup() noexcept
+{
+	WSADATA data;
+
+	return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+}
+
+[[nodiscard]] std::string LocalSocket::s_getPath(const std::string& name)
+{
+	std::string directory(MAX_PATH + 1, '\0');
+
+	const auto length = GetTempPathA(static_cast<DWORD>(directory.size()), directory.data());
+
+	if (length == 0 || length > directory.size()) return {};
+
+	directory.resize(length);
+
+	return directory + name + ".sock";
+}
+
+[[nodiscard]] LocalSocket LocalSocket::s_connect(const std::string& path) noexcept
+{
+	const auto address = MakeAddress(path);
+
+	if (!address.has_value()) return {};
+
+	LocalSocket result(socket(AF_UNIX, SOCK_STREAM, 0));
+
+	if (!result.m_isValid()) return {};
+
+	// the connect itself blocks, a local server answers at once
+	if (connect(result.m_handle, reinterpret_cast<const sockaddr*>(&address.value()), sizeof(sockaddr_un)) != 0 ||
+		!result.m_setNonBlocking()) return {};
+
+	return result;
+}
+
+[[nodiscard]] LocalSocket LocalSocket::s_listen(const std::string& path) noexcept
+{
+	const auto address = MakeAddress(path);
+
+	if (!address.has_value()) return {};
+
+	// the file stays after the server exits, it only blocks the name when nothing answers on it
+	if (s_connect(path).m_isValid()) return {};
+
+	DeleteFileA(path.c_str());
+
+	LocalSocket result(socket(AF_UNIX, SOCK_STREAM, 0));
+
+	if (!result.m_isValid()) return {};
+
+	if (bind(result.m_handle, reinterpret_cast<const sockaddr*>(&address.value()), sizeof(sockaddr_un)) != 0 ||
+		listen(result.m_handle, SOMAXCONN) != 0) return {};
+
+	return result;
+}
+
+void LocalSocket::s_wait(const std::vector<const LocalSocket*>& sockets, const long timeout) noexcept
+{
+	fd_set readSet;
+	fd_set writeSet;
+	FD_ZERO(&readSet);
+	FD_ZERO(&writeSet);
+
+	for (const auto entry : sockets)
+	{
+		if (!entry->m_isValid()) continue;
+
+		if (readSet.fd_count < FD_SETSIZE) FD_SET(entry->m_handle, &readSet);
+
+		if (entry->m_getBacklog() > 0 && writeSet.fd_count < FD_SETSIZE) FD_SET(entry->m_handle, &writeSet);
+	}
+
+	const timeval time = { timeout / 1000, (timeout % 1000) * 1000 };
+
+	if (readSet.fd_count == 0)
+	{
+		Sleep(static_cast<DWORD>(timeout));
+		return;
+	}
+
+	select(0, &readSet, writeSet.fd_count > 0 ? &writeSet : nullptr, nullptr, &time);
+}
+
+void LocalSocket::m_close() noexcept
+{
+	if (m_isValid()) closesocket(m_handle);
+
+	m_handle = s_invalidHandle;
+}
+
+[[nodiscard]] LocalSocket LocalSocket::m_accept() const noexcept
+{
+	if (!m_isReadable(0)) return {};
+
+	LocalSocket result(accept(m_handle, nullptr, nullptr));
+
+	if (!result.m_isValid() || !result.m_setNonBlocking()) return {};
+
+	return result;
+}
+
+[[nodiscard]] bool LocalSocket::m_send(const std::uint32_t type, const void* data, const std::size_t size)
+{
+	if (!m_isValid() || size > s_maxMessageSize || m_getBacklog() > s_maxBacklog) return false;
+
+	// the sent bytes are dropped before more are queued
+	if (m_sendOffset > 0)
+	{
+		m_outgoing.erase(m_outgoing.begin(), m_outgoing.begin() + static_cast<std::ptrdiff_t>(m_sendOffset));
+		m_sendOffset = 0;
+	}
+
+	const Header header = { type, static_cast<std::uint32_t>(size) };
+
+	const auto headerBytes = reinterpret_cast<const char*>(&header);
+	const auto dataBytes   = static_cast<const char*>(data);
+
+	m_outgoing.insert(m_outgoing.end(), headerBytes, headerBytes + sizeof(header));
+	m_outgoing.insert(m_outgoing.end(), dataBytes, dataBytes + size);
+
+	return m_flush();
+}
+
+[[nodiscard]] bool LocalSocket::m_flush() noexcept
+{
+	if (!m_isValid()) return false;
+
+	while (m_sendOffset < m_outgoing.size())
+	{
+		const auto count = std::min<std::size_t>(m_outgoing.size() - m_sendOffset, 1 << 20);
+
+		const auto sent = send(m_handle, m_outgoing.data() + m_sendOffset, static_cast<int>(count), 0);
+
+		// the other side has not taken enough yet, the rest waits for the next flush
+		if (sent == SOCKET_ERROR) return WSAGetLastError() == WSAEWOULDBLOCK;
+
+		m_sendOffset += static_cast<std::size_t>(sent);
+	}
+
+	m_outgoing.clear();
+	m_sendOffset = 0;
+
+	return true;
+}
+
+[[nodiscard]] bool LocalSocket::m_receive()
+{
+	if (!m_isValid()) return false;
+
+	// a message waits for the rest of it at the start
+	if (m_readOffset > 0)
+	{
+		m_received.erase(m_received.begin(), m_received.begin() + static_cast<std::ptrdiff_t>(m_readOffset));
+		m_readOffset = 0;
+	}
+
+	constexpr std::size_t chunkSize   = 1 << 16;
+	constexpr std::size_t maxReadSize = 1 << 24;
+
+	// a sender faster than this loop gets the rest read on the next call
+	for (std::size_t readSize = 0; readSize < maxReadSize && m_isReadable(0); )
+	{
+		const auto size = m_received.size();
+
+		m_received.resize(size + chunkSize);
+
+		const auto count = recv(m_handle, m_received.data() + size, static_cast<int>(chunkSize), 0);
+
+		m_received.resize(size + static_cast<std::size_t>(std::max(count, 0)));
+
+		if (count == 0) return false;
+
+		if (count == SOCKET_ERROR) return WSAGetLastError() == WSAEWOULDBLOCK;
+
+		readSize += static_cast<std::size_t>(count);
+	}
+
+	return true;
+}
+
+[[nodiscard]] std::optional<LocalSocket::Message> LocalSocket::m_takeMessage()
+{
+	if (m_received.size() - m_readOffset < sizeof(Header)) return {};
+
+	Header header;
+	std::memcpy(&header, m_received.data() + m_readOffset, sizeof(header));
+
+	if (header.m_size > s_maxMessageSize)
+	{
+		m_close();
+		return {};
+	}
+
+	if (m_received.size() - m_readOffset - sizeof(Header) < header.m_size) return {};
+
+	const auto first = m_received.cbegin() + static_cast<std::ptrdiff_t>(m_readOffset + sizeof(Header));
+
+	Message message = { header.m_type, std::vector<char>(first, first + header.m_size) };
+
+	m_readOffset += sizeof(Header) + header.m_size;
+
+	return message;
+}
+
+[[nodiscard]] bool LocalSocket::m_setNonBlocking() noexcept
+{
+	u_long mode = 1;
+
+	if (ioctlsocket(m_handle, FIONBIO, &mode) == 0) return true;
+
+	m_close();
+
+	return false;
+}
+
+[[nodiscard]] bool LocalSocket::m_isReadable(const long timeout) const noexcept
+{
+	fd_set readSet;
+	FD_ZERO(&readSet);
+	FD_SET(m_handle, &readSet);
+
+	const timeval time = { timeout / 1000, (timeout % 1000) * 1000 };
+
+	return select(0, &readSet, nullptr, nullptr, &time) > 0;
+}
@@ -1,8 +1,47 @@
 #include "../include/console_text_editor.h"
+#include "../include/console_file_viewer.h"
+#include "../include/console_hex_editor.h"
+#include "../include/script_runner.h"
+#include "../include/editor_server.h"
+#include "../include/console_client.h"
+#include "../include/collaboration_relay.h"
 
 
 int wmain(const int argc, const wchar_t* argv[])
 {
+	// headless mode, no console is created
+	if (argc > 1 && std::wstring_view(argv[1]) == L"--script") return ScriptRunner::s_main(argc, argv);
+
+	// read only pager, the file is never loaded as a whole
+	if (argc > 1 && std::wstring_view(argv[1]) == L"--view")
+	{
+		ConsoleFileViewer viewer;
+
+		if (!viewer.m_constructViewer(argc, argv)) return -1;
+
+		viewer.m_run();
+		return 0;
+	}
+
+	// binary files, bytes are shown from a mapping of the file
+	if (argc > 1 && std::wstring_view(argv[1]) == L"--hex")
+	{
+		ConsoleHexEditor hexEditor;
+
+		if (!hexEditor.m_constructHexEditor(argc, argv)) return -1;
+
+		hexEditor.m_run();
+		return 0;
+	}
+
+	// documents stay loaded between runs, editors started while it runs attach to it
+	if (argc > 1 && std::wstring_view(argv[1]) == L"--server") return EditorServer::s_main(argc, argv);
+
+	// passes the edits of the editors of a collaboration session to each other
+	if (argc > 1 && std::wstring_view(argv[1]) == L"--relay") return CollaborationRelay::s_main(argc, argv);
+
+	if (const auto exitCode = ConsoleClient::s_attach(argc, argv)) return exitCode.value();
+
 	ConsoleTextEditor editor;
 
 	if (!editor.m_constructEditor(argc, argv)) return -1;
@@ -0,0 +1,167 @@
+#include "../include/mapped_file.h"
+
+#include <algorithm>
+#include <cstring>
+
+MappedFile::~MappedFile()
+{
+	m_close();
+}
+
+[[nodiscard]] bool MappedFile::m_open(const std::wstring_view filePath)
+{
+	m_close();
+
+	m_filePath = filePath;
+
+	m_file = CreateFileW(m_filePath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+		nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (m_file == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER size = {};
+
+	if (!GetFileSizeEx(m_file, &size))
+	{
+		m_close();
+		return false;
+	}
+
+	m_size = static_cast<SizeType>(size.QuadPart);
+
+	// empty files can not be mapped, there is nothing to show either
+	if (m_size == 0) return true;
+
+	// the whole file is one view, pages are only read when they are shown
+	m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+	if (m_mapping != nullptr) m_data = static_cast<const std::uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+
+	if (m_data == nullptr)
+	{
+		m_close();
+		return false;
+	}
+
+	return true;
+}
+
+void MappedFile::m_close() noexcept
+{
+	if (m_data    != nullptr) UnmapViewOfFile(m_data);
+	if (m_mapping != nullptr) CloseHandle(m_mapping);
+
+	if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+
+	m_data    = nullptr;
+	m_mapping = nullptr;
+	m_file    = INVALID_HANDLE_VALUE;
+
+	m_size = 0;
+	m_dirtyPages.clear();
+}
+
+[[nodiscard]] std::uint8_t MappedFile::m_getByte(const SizeType offset) const noexcept
+{
+	if (!m_dirtyPages.empty())
+	{
+		const auto it = m_dirtyPages.find(offset / s_pageSize);
+
+		if (it != m_dirtyPages.cend()) return it->second[static_cast<std::size_t>(offset % s_pageSize)];
+	}
+
+	return m_data[offset];
+}
+
+void MappedFile::m_setByte(const SizeType offset, const std::uint8_t value)
+{
+	if (offset >= m_size) return;
+
+	const auto pageIndex = offset / s_pageSize;
+
+	auto it = m_dirtyPages.find(pageIndex);
+
+	if (it == m_dirtyPages.end())
+	{
+		// the page is copied on its first change
+		const auto pageStart = pageIndex * s_pageSize;
+		const auto pageEnd   = std::min(m_size, pageStart + s_pageSize);
+
+		it = m_dirtyPages.emplace(pageIndex, std::vector<std::uint8_t>(m_data + pageStart, m_data + pageEnd)).first;
+	}
+
+	it->second[static_cast<std::size_t>(offset % s_pageSize)] = value;
+}
+
+[[nodiscard]] bool MappedFile::m_isChanged(const SizeType offset) const noexcept
+{
+	if (m_dirtyPages.empty()) return false;
+
+	const auto it = m_dirtyPages.find(offset / s_pageSize);
+
+	return it != m_dirtyPages.cend() && it->second[static_cast<std::size_t>(offset % s_pageSize)] != m_data[offset];
+}
+
+void MappedFile::m_read(const SizeType offset, const SizeType size, std::vector<std::uint8_t>& bytes) const
+{
+	const auto start = std::min(offset, m_size);
+	const auto end   = start + std::min(size, m_size - start);
+
+	bytes.assign(m_data + start, m_data + end);
+
+	if (m_dirtyPages.empty()) return;
+
+	for (auto pageIndex = start / s_pageSize; pageIndex * s_pageSize < end; ++pageIndex)
+	{
+		const auto it = m_dirtyPages.find(pageIndex);
+
+		if (it == m_dirtyPages.cend()) continue;
+
+		const auto pageStart = pageIndex * s_pageSize;
+
+		const auto copyStart = std::max(pageStart, start);
+		const auto copyEnd   = std::min(pageStart + it->second.size(), end);
+
+		std::memcpy(bytes.data() + (copyStart - start), it->second.data() + (copyStart - pageStart), static_cast<std::size_t>(copyEnd - copyStart));
+	}
+}
+
+[[nodiscard]] bool MappedFile::m_save()
+{
+	if (m_dirtyPages.empty()) return true;
+
+	const auto file = CreateFileW(m_filePath.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+		nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (file == INVALID_HANDLE_VALUE) return false;
+
+	bool result = true;
+
+	for (auto it = m_dirtyPages.begin(); it != m_dirtyPages.end();)
+	{
+		const auto pageStart = it->first * s_pageSize;
+
+		// only this page is written, the mapped view sees the new bytes afterwards
+		OVERLAPPED overlapped = {};
+
+		overlapped.Offset     = static_cast<DWORD>(pageStart & 0xFFFFFFFF);
+		overlapped.OffsetHigh = static_cast<DWORD>(pageStart >> 32);
+
+		DWORD written = 0;
+
+		const auto size = static_cast<DWORD>(it->second.size());
+
+		if (!WriteFile(file, it->second.data(), size, &written, &overlapped) || written != size)
+		{
+			result = false;
+			++it;
+			continue;
+		}
+
+		it = m_dirtyPages.erase(it);
+	}
+
+	CloseHandle(file);
+
+	return result;
+}
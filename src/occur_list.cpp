@@ -0,0 +1,318 @@
+#include "../include/occur_list.h"
+
+#include <string>
+#include <algorithm>
+
+void OccurList::m_initList(const SizeType width, const SizeType height,
+	const SizeType startX, const SizeType startY) noexcept
+{
+	m_width  = width;
+	m_height = height;
+
+	m_drawStartX = startX;
+	m_drawStartY = startY;
+
+	m_keepSelectionVisible();
+}
+
+void OccurList::m_update(const TextEditor& editor, const TextSearch& search)
+{
+	const auto& options = search.m_getOptions();
+
+	const bool sameSearch = m_pattern == search.m_getPattern()
+		&& m_options.m_ignoreCase == options.m_ignoreCase
+		&& m_options.m_wholeWord  == options.m_wholeWord;
+
+	std::optional<std::vector<TextEditor::BufferEdit>> edits;
+
+	if (sameSearch && m_version != std::wstring::npos) edits = editor.m_getEditsSince(m_version);
+
+	m_version = editor.m_getVersion();
+	m_pattern = search.m_getPattern();
+	m_options = options;
+
+	if (edits.has_value())
+	{
+		if (!edits->empty()) m_applyEdits(editor, search, edits.value());
+	}
+	else
+	{
+		m_lines.clear();
+		m_selectedRow = 0;
+		m_startRow = 0;
+
+		if (!search.m_empty())
+		{
+			s_scanLines(editor, search, 0, editor.m_getLineIndex().m_getLineCount() - 1, m_lines);
+		}
+
+		m_gapIndex = m_lines.size();
+		m_gapDelta = 0;
+	}
+
+	if (m_selectedRow >= m_lines.size()) m_selectedRow = m_lines.empty() ? 0 : m_lines.size() - 1;
+
+	m_keepSelectionVisible();
+}
+
+[[nodiscard]] OccurList::SizeType OccurList::m_lowerBound(const SizeType line) const noexcept
+{
+	SizeType low  = 0;
+	SizeType high = m_lines.size();
+
+	while (low < high)
+	{
+		const auto mid = low + (high - low) / 2;
+
+		if (m_getLine(mid) < line) low = mid + 1;
+		else high = mid;
+	}
+
+	return low;
+}
+
+[[nodiscard]] OccurList::SizeType OccurList::m_upperBound(const SizeType line) const noexcept
+{
+	SizeType low  = 0;
+	SizeType high = m_lines.size();
+
+	while (low < high)
+	{
+		const auto mid = low + (high - low) / 2;
+
+		if (m_getLine(mid) <= line) low = mid + 1;
+		else high = mid;
+	}
+
+	return low;
+}
+
+void OccurList::m_moveGap(const SizeType gapIndex) noexcept
+{
+	// edits that keep the line count leave nothing to shift
+	if (m_gapDelta == 0)
+	{
+		m_gapIndex = gapIndex;
+		return;
+	}
+
+	for (; m_gapIndex < gapIndex; ++m_gapIndex) m_lines[m_gapIndex] += m_gapDelta;
+	for (; m_gapIndex > gapIndex; --m_gapIndex) m_lines[m_gapIndex - 1] -= m_gapDelta;
+}
+
+void OccurList::m_replaceLines(const SizeType first, const SizeType last, const std::vector<SizeType>& lines)
+{
+	// the entries before last are stored as they are, the replaced ones with them
+	m_moveGap(last);
+
+	const auto position = m_lines.erase(m_lines.begin() + static_cast<std::ptrdiff_t>(first), m_lines.begin() + static_cast<std::ptrdiff_t>(last));
+
+	m_lines.insert(position, lines.cbegin(), lines.cend());
+
+	m_gapIndex = first + lines.size();
+}
+
+void OccurList::m_applyEdits(const TextEditor& editor, const TextSearch& search,
+	const std::vector<TextEditor::BufferEdit>& edits)
+{
+	if (search.m_empty()) return;
+
+	// a match of a multi line pattern that starts this many lines before an edit is affected by it
+	const auto contextLines = static_cast<SizeType>(std::count(m_pattern.cbegin(), m_pattern.cend(), L'\n'));
+
+	// inclusive line ranges to scan again, in line numbers after the edits processed so far
+	std::vector<std::pair<SizeType, SizeType>> dirtyRanges;
+
+	for (const auto& edit : edits)
+	{
+		const auto first   = edit.m_line - std::min(edit.m_line, contextLines);
+		const auto last    = edit.m_line + edit.m_removedLines;
+		const auto newLast = edit.m_line + edit.m_insertedLines;
+
+		// wraps around when lines are removed
+		const auto delta = edit.m_insertedLines - edit.m_removedLines;
+
+		m_replaceLines(m_lowerBound(first), m_upperBound(last), {});
+
+		// the matches after the edit move by the gap
+		m_gapDelta += delta;
+
+		std::pair<SizeType, SizeType> range = { first, newLast };
+		std::vector<std::pair<SizeType, SizeType>> nextRanges;
+
+		for (const auto& [rangeFirst, rangeLast] : dirtyRanges)
+		{
+			if (rangeLast < first)
+			{
+				nextRanges.emplace_back(rangeFirst, rangeLast);
+			}
+			else if (rangeFirst > last)
+			{
+				nextRanges.emplace_back(rangeFirst + delta, rangeLast + delta);
+			}
+			else
+			{
+				range.first  = std::min(range.first, rangeFirst);
+				range.second = std::max(range.second, rangeLast > last ? rangeLast + delta : newLast);
+			}
+		}
+
+		nextRanges.push_back(range);
+		dirtyRanges = std::move(nextRanges);
+	}
+
+	const auto lastLine = editor.m_getLineIndex().m_getLineCount() - 1;
+
+	std::vector<SizeType> found;
+
+	for (const auto& [first, last] : dirtyRanges)
+	{
+		if (first > lastLine) continue;
+
+		found.clear();
+
+		s_scanLines(editor, search, first, std::min(last, lastLine), found);
+
+		m_replaceLines(m_lowerBound(first), m_upperBound(std::min(last, lastLine)), found);
+	}
+}
+
+void OccurList::s_scanLines(const TextEditor& editor, const TextSearch& search,
+	const SizeType firstLine, const SizeType lastLine, std::vector<SizeType>& result)
+{
+	const auto buffer = editor.m_buffer();
+	const auto& lineIndex = editor.m_getLineIndex();
+
+	// matches have to start at or before the end of the last line
+	const auto end = std::min(buffer.size(), lineIndex.m_getLineEnd(lastLine) + search.m_size());
+
+	TextSearch::Cursor cursor(search, buffer, end);
+
+	auto index = cursor.m_findNext(lineIndex.m_getLineStart(firstLine));
+
+	while (index != TextSearch::s_npos)
+	{
+		const auto line = lineIndex.m_getLineOf(index);
+
+		result.push_back(line);
+
+		if (line >= lastLine) break;
+
+		// one entry per line, continue from the next one
+		index = cursor.m_findNext(lineIndex.m_getLineStart(line + 1));
+	}
+}
+
+void OccurList::m_updateConsole(Console& console, const TextEditor& editor, const TextSearch& search) noexcept
+{
+	console.m_drawRect(m_drawStartX, m_drawStartY, m_width, m_height, s_listColor);
+
+	m_cursorPos = { static_cast<short>(m_drawStartX), static_cast<short>(m_drawStartY) };
+
+	const auto buffer = editor.m_buffer();
+	const auto& lineIndex = editor.m_getLineIndex();
+
+	const auto numberWidth = std::to_wstring(lineIndex.m_getLineCount()).size();
+
+	for (SizeType row = 0; row < m_height && m_startRow + row < m_lines.size(); ++row)
+	{
+		const auto listRow = m_startRow + row;
+		const auto line = m_getLine(listRow);
+		const auto y = m_drawStartY + row;
+
+		WORD color = s_listColor;
+
+		if (listRow == m_selectedRow)
+		{
+			color = s_selectedColor;
+			m_cursorPos.Y = static_cast<short>(y);
+		}
+
+		auto number = std::to_wstring(line + 1);
+
+		number.insert(0, numberWidth - std::min(numberWidth, number.size()), L' ');
+		number += L": ";
+
+		console.m_drawRect(m_drawStartX, y, m_width, 1, color);
+		console.m_drawString(m_drawStartX, y, number, color, false);
+
+		const auto textX = m_drawStartX + number.size();
+
+		if (textX >= m_drawStartX + m_width) continue;
+
+		// only the visible part of the line is touched, lines may be huge
+		const auto lineStart = lineIndex.m_getLineStart(line);
+		const auto lineEnd   = std::min(lineIndex.m_getLineEnd(line), buffer.size());
+
+		const auto visibleSize = std::min(lineEnd - lineStart, m_drawStartX + m_width - textX);
+
+		for (SizeType i = 0; i < visibleSize; ++i)
+		{
+			const auto c = buffer[lineStart + i];
+
+			console.m_setGrid(textX + i, y, c == L'\t' ? L' ' : c, color);
+		}
+
+		const auto visibleEnd = lineStart + visibleSize;
+
+		TextSearch::Cursor cursor(search, buffer, visibleEnd);
+
+		for (auto i = cursor.m_findNext(lineStart); i != TextSearch::s_npos; i = cursor.m_findNext(i + 1))
+		{
+			for (auto t = i; t < i + search.m_size(); ++t)
+			{
+				console.m_setColorAt(console.m_getIndex(textX + t - lineStart, y), s_matchColor);
+			}
+		}
+	}
+}
+
+void OccurList::m_handleEvents(const KEY_EVENT_RECORD& event) noexcept
+{
+	if (!event.bKeyDown || m_lines.empty()) return;
+
+	const auto lastRow = m_lines.size() - 1;
+	const auto pageSize = std::max<SizeType>(1, m_height);
+
+	switch (event.wVirtualKeyCode)
+	{
+	case VK_UP:
+		if (m_selectedRow > 0) --m_selectedRow;
+		break;
+	case VK_DOWN:
+		if (m_selectedRow < lastRow) ++m_selectedRow;
+		break;
+	case VK_PRIOR:
+		m_selectedRow -= std::min(m_selectedRow, pageSize);
+		break;
+	case VK_NEXT:
+		m_selectedRow = std::min(lastRow, m_selectedRow + pageSize);
+		break;
+	case VK_HOME:
+		m_selectedRow = 0;
+		break;
+	case VK_END:
+		m_selectedRow = lastRow;
+		break;
+	default:
+		break;
+	}
+
+	m_keepSelectionVisible();
+}
+
+void OccurList::m_selectRowAt(const SizeType y) noexcept
+{
+	if (y < m_drawStartY) return;
+
+	const auto row = m_startRow + (y - m_drawStartY);
+
+	if (row < m_lines.size()) m_selectedRow = row;
+}
+
+[[nodiscard]] std::optional<OccurList::SizeType> OccurList::m_getSelectedLine() const noexcept
+{
+	if (m_selectedRow >= m_lines.size()) return {};
+
+	return m_getLine(m_selectedRow);
+}
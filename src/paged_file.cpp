@@ -0,0 +1,358 @@
+#include "../include/paged_file.h"
+
+#include <algorithm>
+#include <cstring>
+
+PagedFile::~PagedFile()
+{
+	m_close();
+}
+
+[[nodiscard]] bool PagedFile::m_open(const std::wstring_view filePath)
+{
+	m_close();
+
+	m_filePath = filePath;
+
+	// other programs may keep appending to the file while it is viewed
+	m_file = CreateFileW(m_filePath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+		nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (m_file == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER size = {};
+
+	if (!GetFileSizeEx(m_file, &size))
+	{
+		m_close();
+		return false;
+	}
+
+	m_size = static_cast<SizeType>(size.QuadPart);
+
+	m_lineCounts.assign((m_size + s_indexBlockSize - 1) / s_indexBlockSize, 0);
+
+	m_indexedBlocks.store(0, std::memory_order_relaxed);
+	m_cancelIndex.store(false, std::memory_order_relaxed);
+
+	m_useCache = m_size >= s_minCachedSize && m_makeCacheKey();
+
+	// an earlier run already counted this file
+	if (m_useCache && LineIndexCache::s_load(m_cacheKey, m_lineCounts))
+	{
+		m_indexedBlocks.store(m_lineCounts.size(), std::memory_order_release);
+		return true;
+	}
+
+	m_indexThread = std::thread(&PagedFile::m_buildIndex, this);
+
+	return true;
+}
+
+void PagedFile::m_close() noexcept
+{
+	m_cancelIndex.store(true, std::memory_order_relaxed);
+
+	if (m_indexThread.joinable()) m_indexThread.join();
+
+	if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+
+	m_file = INVALID_HANDLE_VALUE;
+
+	m_size = 0;
+	m_pages.clear();
+	m_lineCounts.clear();
+	m_indexedBlocks.store(0, std::memory_order_relaxed);
+}
+
+[[nodiscard]] const PagedFile::Page& PagedFile::m_getPage(const SizeType pageIndex)
+{
+	++m_useCounter;
+
+	for (auto& page : m_pages)
+	{
+		if (page.m_index == pageIndex)
+		{
+			page.m_lastUse = m_useCounter;
+			return page;
+		}
+	}
+
+	if (m_pages.size() < s_cachedPages) m_pages.emplace_back();
+
+	auto& page = *std::min_element(m_pages.begin(), m_pages.end(), [] (const Page& lhs, const Page& rhs) { return lhs.m_lastUse < rhs.m_lastUse; });
+
+	page.m_index = pageIndex;
+	page.m_lastUse = m_useCounter;
+
+	const auto start = pageIndex * s_pageSize;
+
+	page.m_data.resize(static_cast<std::size_t>(std::min(s_pageSize, m_size - std::min(m_size, start))));
+
+	// a failed read leaves the page empty, scans treat it like the end of the file
+	if (!s_readAt(m_file, start, page.m_data.data(), static_cast<DWORD>(page.m_data.size()))) page.m_data.clear();
+
+	return page;
+}
+
+[[nodiscard]] PagedFile::SizeType PagedFile::m_getLineStart(const SizeType offset)
+{
+	auto position = std::min(offset, m_size);
+
+	const auto limit = position - std::min(position, s_maxLineSize);
+
+	while (position > limit)
+	{
+		const auto& page = m_getPage((position - 1) / s_pageSize);
+
+		const auto pageStart = (position - 1) / s_pageSize * s_pageSize;
+		const auto scanStart = std::max(pageStart, limit);
+
+		if (page.m_data.size() < position - pageStart) return position;
+
+		for (auto i = position; i > scanStart; --i)
+		{
+			if (page.m_data[static_cast<std::size_t>(i - 1 - pageStart)] == '\n') return i;
+		}
+
+		position = scanStart;
+	}
+
+	return limit;
+}
+
+[[nodiscard]] PagedFile::SizeType PagedFile::m_getNextLineStart(const SizeType offset)
+{
+	auto position = std::min(offset, m_size);
+
+	const auto limit = std::min(m_size, position + s_maxLineSize);
+
+	while (position < limit)
+	{
+		const auto& page = m_getPage(position / s_pageSize);
+
+		const auto pageStart = position / s_pageSize * s_pageSize;
+		const auto scanEnd = std::min(pageStart + page.m_data.size(), limit);
+
+		if (scanEnd <= position) return limit;
+
+		const auto begin = page.m_data.data() + (position - pageStart);
+		const auto found = static_cast<const char*>(std::memchr(begin, '\n', static_cast<std::size_t>(scanEnd - position)));
+
+		if (found != nullptr) return position + static_cast<SizeType>(found - begin) + 1;
+
+		position = scanEnd;
+	}
+
+	return limit;
+}
+
+void PagedFile::m_readText(const SizeType start, const SizeType end, std::wstring& str)
+{
+	str.clear();
+
+	std::string bytes;
+
+	for (auto position = std::min(start, m_size); position < std::min(end, m_size);)
+	{
+		const auto& page = m_getPage(position / s_pageSize);
+
+		const auto pageStart = position / s_pageSize * s_pageSize;
+		const auto copyEnd = std::min(pageStart + page.m_data.size(), std::min(end, m_size));
+
+		if (copyEnd <= position) break;
+
+		bytes.append(page.m_data.data() + (position - pageStart), static_cast<std::size_t>(copyEnd - position));
+
+		position = copyEnd;
+	}
+
+	while (!bytes.empty() && (bytes.back() == '\n' || bytes.back() == '\r')) bytes.pop_back();
+
+	if (bytes.empty()) return;
+
+	// never more characters than bytes
+	str.resize(bytes.size());
+
+	const auto charCount = MultiByteToWideChar(CP_UTF8, 0, bytes.data(), static_cast<int>(bytes.size()),
+		str.data(), static_cast<int>(str.size()));
+
+	str.resize(static_cast<std::size_t>(std::max(charCount, 0)));
+}
+
+[[nodiscard]] double PagedFile::m_getIndexProgress() const noexcept
+{
+	if (m_lineCounts.empty()) return 1.0;
+
+	return static_cast<double>(m_indexedBlocks.load(std::memory_order_acquire)) / static_cast<double>(m_lineCounts.size());
+}
+
+[[nodiscard]] std::optional<PagedFile::SizeType> PagedFile::m_getLineCount() const noexcept
+{
+	if (!m_isIndexComplete()) return {};
+
+	return (m_lineCounts.empty() ? 0 : m_lineCounts.back()) + 1;
+}
+
+[[nodiscard]] std::optional<PagedFile::SizeType> PagedFile::m_getLineNumber(const SizeType offset)
+{
+	const auto block = offset / s_indexBlockSize;
+
+	if (offset < m_size && block >= m_indexedBlocks.load(std::memory_order_acquire)) return {};
+	if (offset >= m_size && !m_isIndexComplete()) return {};
+
+	SizeType line = block > 0 ? m_lineCounts[static_cast<std::size_t>(block - 1)] : 0;
+
+	// the rest is counted in the block itself
+	for (auto position = block * s_indexBlockSize; position < std::min(offset, m_size);)
+	{
+		const auto& page = m_getPage(position / s_pageSize);
+
+		const auto pageStart = position / s_pageSize * s_pageSize;
+		const auto countEnd = std::min(pageStart + page.m_data.size(), std::min(offset, m_size));
+
+		if (countEnd <= position) break;
+
+		const auto begin = page.m_data.cbegin() + static_cast<std::ptrdiff_t>(position - pageStart);
+
+		line += static_cast<SizeType>(std::count(begin, begin + static_cast<std::ptrdiff_t>(countEnd - position), '\n'));
+
+		position = countEnd;
+	}
+
+	return line;
+}
+
+[[nodiscard]] std::pair<PagedFile::SizeType, bool> PagedFile::m_findLine(const SizeType line)
+{
+	if (line == 0) return { 0, true };
+
+	const auto indexedBlocks = static_cast<std::ptrdiff_t>(m_indexedBlocks.load(std::memory_order_acquire));
+	const auto indexedEnd = m_lineCounts.cbegin() + indexedBlocks;
+
+	// block that contains the newline before line
+	const auto it = std::lower_bound(m_lineCounts.cbegin(), indexedEnd, line);
+
+	if (it == indexedEnd)
+	{
+		// past the last line
+		if (m_isIndexComplete()) return { m_getLineStart(m_size), true };
+
+		const auto indexedLines = indexedBlocks > 0 ? *(indexedEnd - 1) : 0;
+		const auto indexedBytes = std::min(m_size, static_cast<SizeType>(indexedBlocks) * s_indexBlockSize);
+
+		// a rough guess until the index gets there
+		const auto averageLineSize = indexedLines > 0 ? std::max<SizeType>(1, indexedBytes / indexedLines) : 80;
+
+		return { m_getLineStart(line < m_size / averageLineSize ? line * averageLineSize : m_size), false };
+	}
+
+	const auto block = static_cast<SizeType>(it - m_lineCounts.cbegin());
+
+	auto remaining = line - (block > 0 ? m_lineCounts[static_cast<std::size_t>(block - 1)] : 0);
+
+	for (auto position = block * s_indexBlockSize; position < m_size;)
+	{
+		const auto& page = m_getPage(position / s_pageSize);
+
+		const auto pageStart = position / s_pageSize * s_pageSize;
+		const auto scanEnd = pageStart + page.m_data.size();
+
+		if (scanEnd <= position) break;
+
+		for (auto i = position; i < scanEnd; ++i)
+		{
+			if (page.m_data[static_cast<std::size_t>(i - pageStart)] == '\n' && --remaining == 0) return { i + 1, true };
+		}
+
+		position = scanEnd;
+	}
+
+	return { m_getLineStart(m_size), true };
+}
+
+void PagedFile::m_buildIndex() noexcept
+{
+	// its own handle, reads of the viewer are not slowed down by a shared lock
+	const auto file = CreateFileW(m_filePath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+		nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (file == INVALID_HANDLE_VALUE) return;
+
+	std::vector<char> block(static_cast<std::size_t>(s_indexBlockSize));
+
+	SizeType lineCount = 0;
+
+	for (std::size_t i = 0; i < m_lineCounts.size() && !m_cancelIndex.load(std::memory_order_relaxed); ++i)
+	{
+		const auto start = static_cast<SizeType>(i) * s_indexBlockSize;
+		const auto size  = static_cast<DWORD>(std::min(s_indexBlockSize, m_size - start));
+
+		if (!s_readAt(file, start, block.data(), size)) break;
+
+		lineCount += static_cast<SizeType>(std::count(block.cbegin(), block.cbegin() + size, '\n'));
+
+		m_lineCounts[i] = lineCount;
+
+		m_indexedBlocks.store(i + 1, std::memory_order_release);
+	}
+
+	CloseHandle(file);
+
+	// the next open of the same file skips all of the above
+	if (m_useCache && m_isIndexComplete())
+	{
+		[[maybe_unused]] const bool saved = LineIndexCache::s_save(m_cacheKey, m_lineCounts);
+	}
+}
+
+[[nodiscard]] bool PagedFile::m_makeCacheKey()
+{
+	FILETIME writeTime = {};
+
+	if (!GetFileTime(m_file, nullptr, nullptr, &writeTime)) return false;
+
+	m_cacheKey.m_path        = LineIndexCache::s_getFullPath(m_filePath);
+	m_cacheKey.m_fileSize    = m_size;
+	m_cacheKey.m_writeTime   = (static_cast<SizeType>(writeTime.dwHighDateTime) << 32) | writeTime.dwLowDateTime;
+	m_cacheKey.m_blockSize   = s_indexBlockSize;
+	m_cacheKey.m_contentHash = LineIndexCache::s_hash(nullptr, 0);
+
+	std::vector<char> sample(static_cast<std::size_t>(s_cacheSampleSize));
+
+	// the first and the last bytes are always part of the samples
+	for (SizeType i = 0; i < s_cacheSampleCount; ++i)
+	{
+		const auto offset = (m_size - s_cacheSampleSize) * i / (s_cacheSampleCount - 1);
+
+		if (!s_readAt(m_file, offset, sample.data(), static_cast<DWORD>(sample.size()))) return false;
+
+		m_cacheKey.m_contentHash = LineIndexCache::s_hash(sample.data(), sample.size(), m_cacheKey.m_contentHash);
+	}
+
+	return true;
+}
+
+[[nodiscard]] bool PagedFile::s_readAt(const HANDLE file, const SizeType offset, char* data, const DWORD size) noexcept
+{
+	DWORD done = 0;
+
+	while (done < size)
+	{
+		const auto position = offset + done;
+
+		// positional read, the file pointer is not shared state
+		OVERLAPPED overlapped = {};
+
+		overlapped.Offset     = static_cast<DWORD>(position & 0xFFFFFFFF);
+		overlapped.OffsetHigh = static_cast<DWORD>(position >> 32);
+
+		DWORD readCount = 0;
+
+		if (!ReadFile(file, data + done, size - done, &readCount, &overlapped) || readCount == 0) return false;
+
+		done += readCount;
+	}
+
+	return true;
+}
@@ -0,0 +1,242 @@
+#include "../include/process_filter.h"
+#include "../include/utility.h"
+
+#include <vector>
+#include <cstring>
+#include <algorithm>
+
+namespace
+{
+	[[nodiscard]] bool WriteAll(const HANDLE handle, const char* data, DWORD size) noexcept
+	{
+		while (size > 0)
+		{
+			DWORD written = 0;
+
+			if (!WriteFile(handle, data, size, &written, nullptr)) return false;
+
+			data += written;
+			size -= written;
+		}
+
+		return true;
+	}
+
+	[[nodiscard]] constexpr bool IsHighSurrogate(const wchar_t c) noexcept
+	{
+		return c >= 0xD800 && c <= 0xDBFF;
+	}
+} // namespace
+
+ProcessFilter::~ProcessFilter()
+{
+	if (m_isRunning())
+	{
+		m_cancel();
+		[[maybe_unused]] const auto output = m_finish();
+	}
+}
+
+[[nodiscard]] bool ProcessFilter::m_start(const std::wstring_view command, TextSnapshot input, const SizeType first, const SizeType last)
+{
+	if (m_isRunning() || command.empty() || first > last) return false;
+
+	SECURITY_ATTRIBUTES attributes = {};
+
+	attributes.nLength = sizeof(attributes);
+	attributes.bInheritHandle = TRUE;
+
+	HANDLE inputRead   = nullptr;
+	HANDLE outputWrite = nullptr;
+
+	if (!CreatePipe(&inputRead, &m_inputWrite, &attributes, 0)) return false;
+
+	if (!CreatePipe(&m_outputRead, &outputWrite, &attributes, 0))
+	{
+		CloseHandle(inputRead);
+		m_closeHandles();
+		return false;
+	}
+
+	// only the child ends are inherited, otherwise the pipes never report end of file
+	SetHandleInformation(m_inputWrite, HANDLE_FLAG_INHERIT, 0);
+	SetHandleInformation(m_outputRead, HANDLE_FLAG_INHERIT, 0);
+
+	// error messages would end up in the buffer, a failing command is reported by its exit code
+	const auto errorWrite = CreateFileW(L"NUL", GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+		&attributes, OPEN_EXISTING, 0, nullptr);
+
+	STARTUPINFOW startupInfo = {};
+
+	startupInfo.cb = sizeof(startupInfo);
+	startupInfo.dwFlags = STARTF_USESTDHANDLES;
+	startupInfo.hStdInput  = inputRead;
+	startupInfo.hStdOutput = outputWrite;
+	startupInfo.hStdError  = errorWrite;
+
+	std::wstring commandLine = L"cmd.exe /d /s /c \"";
+	commandLine.append(command);
+	commandLine += L'"';
+
+	PROCESS_INFORMATION processInfo = {};
+
+	// started suspended so everything the shell starts belongs to the job
+	const bool created = CreateProcessW(nullptr, commandLine.data(), nullptr, nullptr, TRUE,
+		CREATE_NO_WINDOW | CREATE_SUSPENDED, nullptr, nullptr, &startupInfo, &processInfo);
+
+	CloseHandle(inputRead);
+	CloseHandle(outputWrite);
+
+	if (errorWrite != INVALID_HANDLE_VALUE) CloseHandle(errorWrite);
+
+	if (!created)
+	{
+		m_closeHandles();
+		return false;
+	}
+
+	m_job = CreateJobObjectW(nullptr, nullptr);
+
+	if (m_job != nullptr) AssignProcessToJobObject(m_job, processInfo.hProcess);
+
+	ResumeThread(processInfo.hThread);
+	CloseHandle(processInfo.hThread);
+
+	m_process = processInfo.hProcess;
+
+	m_inputSize = std::min(last, input.m_getSize()) - std::min(first, input.m_getSize());
+	m_output.clear();
+
+	m_written.store(0, std::memory_order_relaxed);
+	m_read.store(0, std::memory_order_relaxed);
+	m_cancelled.store(false, std::memory_order_relaxed);
+	m_outputDone.store(false, std::memory_order_relaxed);
+
+	m_writer = std::thread(&ProcessFilter::m_writeInput, this, std::move(input), first);
+	m_reader = std::thread(&ProcessFilter::m_readOutput, this);
+
+	return true;
+}
+
+void ProcessFilter::m_cancel() noexcept
+{
+	if (!m_isRunning()) return;
+
+	m_cancelled.store(true, std::memory_order_relaxed);
+
+	// the shell may have started the actual command as its own child
+	if (m_job == nullptr || !TerminateJobObject(m_job, 1)) TerminateProcess(m_process, 1);
+}
+
+[[nodiscard]] std::optional<std::wstring> ProcessFilter::m_finish()
+{
+	if (!m_isRunning()) return {};
+
+	// both threads end once the command exits and its pipe ends are closed
+	if (m_writer.joinable()) m_writer.join();
+	if (m_reader.joinable()) m_reader.join();
+
+	WaitForSingleObject(m_process, INFINITE);
+
+	DWORD exitCode = 1;
+
+	GetExitCodeProcess(m_process, &exitCode);
+
+	m_closeHandles();
+
+	if (m_cancelled.load(std::memory_order_relaxed) || exitCode != 0) return {};
+
+	return std::move(m_output);
+}
+
+void ProcessFilter::m_writeInput(const TextSnapshot input, const SizeType first) noexcept
+{
+	// a wide character needs at most three utf-8 bytes, surrogate pairs need four for two
+	std::vector<char> bytes(s_chunkSize * 3);
+
+	// only one chunk of the snapshot is copied at a time
+	std::wstring chunk;
+
+	for (SizeType i = 0; i < m_inputSize && !m_cancelled.load(std::memory_order_relaxed);)
+	{
+		auto size = std::min(s_chunkSize, m_inputSize - i);
+
+		chunk.clear();
+
+		try
+		{
+			input.m_copy(first + i, first + i + size, chunk);
+		}
+		catch (...)
+		{
+			// the output of a partial input must not replace the text
+			m_cancel();
+			break;
+		}
+
+		// surrogate pairs stay in one chunk
+		if (size > 1 && i + size < m_inputSize && IsHighSurrogate(chunk[size - 1])) --size;
+
+		const auto byteCount = WideCharToMultiByte(CP_UTF8, 0, chunk.data(), static_cast<int>(size),
+			bytes.data(), static_cast<int>(bytes.size()), nullptr, nullptr);
+
+		// fails when the command exits without reading everything
+		if (!WriteAll(m_inputWrite, bytes.data(), static_cast<DWORD>(byteCount))) break;
+
+		i += size;
+
+		m_written.store(i, std::memory_order_relaxed);
+	}
+
+	// end of file for the command
+	CloseHandle(m_inputWrite);
+	m_inputWrite = nullptr;
+}
+
+void ProcessFilter::m_readOutput() noexcept
+{
+	// incomplete utf-8 sequences wait at the front of the buffer for the next read
+	std::vector<char> bytes(s_chunkSize + 4);
+	SizeType pending = 0;
+
+	while (true)
+	{
+		DWORD readCount = 0;
+
+		if (!ReadFile(m_outputRead, bytes.data() + pending, static_cast<DWORD>(s_chunkSize), &readCount, nullptr) || readCount == 0) break;
+
+		const auto size = pending + readCount;
+		const auto complete = utils::GetCompleteUtf8Size(bytes.data(), size);
+
+		if (complete > 0)
+		{
+			const auto oldSize = m_output.size();
+
+			// never more characters than bytes
+			m_output.resize(oldSize + complete);
+
+			const auto charCount = MultiByteToWideChar(CP_UTF8, 0, bytes.data(), static_cast<int>(complete),
+				m_output.data() + oldSize, static_cast<int>(complete));
+
+			m_output.resize(oldSize + static_cast<SizeType>(std::max(charCount, 0)));
+		}
+
+		pending = size - complete;
+
+		std::memmove(bytes.data(), bytes.data() + complete, pending);
+
+		m_read.fetch_add(readCount, std::memory_order_relaxed);
+	}
+
+	m_outputDone.store(true, std::memory_order_release);
+}
+
+void ProcessFilter::m_closeHandles() noexcept
+{
+	for (auto handle : { &m_process, &m_job, &m_inputWrite, &m_outputRead })
+	{
+		if (*handle != nullptr) CloseHandle(*handle);
+
+		*handle = nullptr;
+	}
+}
@@ -0,0 +1,340 @@
+#include "../include/script_runner.h"
+
+#include <cstdio>
+#include <cwchar>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+namespace
+{
+
+	[[nodiscard]] constexpr std::wstring_view Trim(std::wstring_view str) noexcept
+	{
+		while (!str.empty() && (str.front() == L' ' || str.front() == L'\t')) str.remove_prefix(1);
+		while (!str.empty() && (str.back()  == L' ' || str.back()  == L'\t' || str.back() == L'\n' || str.back() == L'\r')) str.remove_suffix(1);
+
+		return str;
+	}
+
+	[[nodiscard]] std::optional<std::size_t> ParseNumber(const std::wstring_view str) noexcept
+	{
+		if (str.empty() || str.size() > 18) return {};
+
+		std::size_t value = 0;
+
+		for (const auto c : str)
+		{
+			if (c < L'0' || c > L'9') return {};
+
+			value = value * 10 + static_cast<std::size_t>(c - L'0');
+		}
+
+		return value;
+	}
+
+} // namespace
+
+[[nodiscard]] int ScriptRunner::s_main(const int argc, const wchar_t* argv[])
+{
+	if (argc < 4)
+	{
+		std::fwprintf(stderr, L"usage: e --script <script file> [--jobs <count>] <files...>\n");
+		return 2;
+	}
+
+	unsigned threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+	std::vector<std::wstring_view> files;
+
+	for (int i = 3; i < argc; ++i)
+	{
+		const std::wstring_view arg = argv[i];
+
+		if (arg == L"--jobs" && i + 1 < argc)
+		{
+			threadCount = static_cast<unsigned>(std::max(1, _wtoi(argv[++i])));
+		}
+		else files.push_back(arg);
+	}
+
+	ScriptRunner runner;
+
+	if (!runner.m_load(argv[2])) return 2;
+
+	return runner.m_run(files, threadCount) == 0 ? 0 : 1;
+}
+
+[[nodiscard]] bool ScriptRunner::m_load(const std::wstring_view scriptPath)
+{
+	std::FILE* file = nullptr;
+
+	if (_wfopen_s(&file, scriptPath.data(), L"r, ccs=UTF-8") || !file)
+	{
+		std::fwprintf(stderr, L"%ls: could not open the script\n", scriptPath.data());
+		return false;
+	}
+
+	m_commands.clear();
+
+	bool result = true;
+
+	std::wstring line;
+	wchar_t chunk[1024];
+
+	for (SizeType lineNumber = 1; std::fgetws(chunk, 1024, file); )
+	{
+		line += chunk;
+
+		// long lines arrive in several chunks
+		if (line.back() != L'\n' && !std::feof(file)) continue;
+
+		const auto text = Trim(line);
+
+		if (!text.empty() && text.front() != L'#')
+		{
+			if (auto command = s_parseLine(text))
+			{
+				command->m_scriptLine = lineNumber;
+				m_commands.push_back(std::move(command.value()));
+			}
+			else
+			{
+				std::fwprintf(stderr, L"%ls:%zu: unknown command\n", scriptPath.data(), lineNumber);
+				result = false;
+			}
+		}
+
+		line.clear();
+		++lineNumber;
+	}
+
+	std::fclose(file);
+
+	return result;
+}
+
+[[nodiscard]] ScriptRunner::SizeType ScriptRunner::m_run(const std::vector<std::wstring_view>& files, const unsigned threadCount) const
+{
+	std::atomic<SizeType> nextFile    { 0 };
+	std::atomic<SizeType> failedFiles { 0 };
+
+	// files are handed out one at a time so a few big files do not leave threads idle
+	const auto worker = [&]
+	{
+		std::wstring error;
+
+		for (auto i = nextFile.fetch_add(1); i < files.size(); i = nextFile.fetch_add(1))
+		{
+			error.clear();
+
+			if (!m_runFile(files[i], error))
+			{
+				std::fwprintf(stderr, L"%ls: %ls\n", files[i].data(), error.c_str());
+				failedFiles.fetch_add(1);
+			}
+		}
+	};
+
+	std::vector<std::thread> threads;
+
+	const auto count = std::min<SizeType>(threadCount, files.size());
+
+	for (SizeType i = 1; i < count; ++i) threads.emplace_back(worker);
+
+	worker();
+
+	for (auto& thread : threads) thread.join();
+
+	return failedFiles.load();
+}
+
+[[nodiscard]] bool ScriptRunner::m_runFile(const std::wstring_view path, std::wstring& error) const
+{
+	TextEditor editor;
+
+	std::wstring currentPath(path);
+
+	if (!editor.m_readFile(currentPath))
+	{
+		error = L"could not open the file";
+		return false;
+	}
+
+	TextSearch::Options options;
+	TextSearch search;
+
+	for (const auto& command : m_commands)
+	{
+		const auto fail = [&] (const wchar_t* message)
+		{
+			error = L"line " + std::to_wstring(command.m_scriptLine) + L": " + message;
+			return false;
+		};
+
+		switch (command.m_type)
+		{
+		case Type::Open:
+
+			currentPath = command.m_argument;
+
+			if (!editor.m_readFile(currentPath)) return fail(L"could not open the file");
+
+			break;
+		case Type::Save:
+
+			if (!editor.m_writeFile(command.m_argument.empty() ? currentPath : command.m_argument)) return fail(L"could not save the file");
+
+			break;
+		case Type::Find:
+
+			search = { command.m_argument, options };
+
+			// no match is not an error and the cursor stays like in the find editor,
+			// only the selection is dropped so a replace after it does not change the previous match
+			if (!editor.m_selectNextString(search)) editor.m_selectRange(editor.m_getCursorIndex(), editor.m_getCursorIndex());
+
+			break;
+		case Type::Replace:
+
+			if (editor.m_isStringSelected()) editor.m_insertString(command.m_argument);
+
+			break;
+		case Type::ReplaceAll:
+
+			if (search.m_empty()) return fail(L"replace-all needs a find before it");
+
+			editor.m_replaceMatchsWith(search, command.m_argument);
+			break;
+		case Type::SelectAll:
+
+			editor.m_selectRange(0, editor.m_buffer().size());
+			break;
+		case Type::SelectLines:
+		{
+			const auto& lineIndex = editor.m_getLineIndex();
+			const auto lastLine = lineIndex.m_getLineCount();
+
+			if (command.m_firstLine > lastLine) return fail(L"line is out of range");
+
+			const auto start = lineIndex.m_getLineStart(command.m_firstLine - 1);
+			const auto end   = lineIndex.m_getLineEnd(std::min(command.m_lastLine, lastLine) - 1);
+
+			// the newline of the last line is selected too when there is one
+			editor.m_selectRange(start, std::min(end + 1, editor.m_buffer().size()));
+			break;
+		}
+		case Type::Delete:
+
+			if (editor.m_isStringSelected())
+			{
+				const auto [start, end] = editor.m_getSelectionRange();
+				editor.m_replaceRange(start, end, {});
+			}
+
+			break;
+		case Type::IgnoreCase:
+
+			options.m_ignoreCase = command.m_argument == L"on";
+			break;
+		case Type::WholeWord:
+
+			options.m_wholeWord = command.m_argument == L"on";
+			break;
+		case Type::LineOperation:
+
+			editor.m_applyLineOperation(command.m_lineOperation, { command.m_argument, options });
+			break;
+		}
+	}
+
+	return true;
+}
+
+[[nodiscard]] std::optional<ScriptRunner::Command> ScriptRunner::s_parseLine(const std::wstring_view line)
+{
+	const auto nameEnd = std::min(line.find(L' '), line.size());
+
+	const auto name     = line.substr(0, nameEnd);
+	const auto argument = line.substr(std::min(nameEnd + 1, line.size()));
+
+	Command command{ Type::Open, s_unescape(argument) };
+
+	if      (name == L"open"        && !argument.empty()) command.m_type = Type::Open;
+	else if (name == L"save"                            ) command.m_type = Type::Save;
+	else if (name == L"find"        && !argument.empty()) command.m_type = Type::Find;
+	else if (name == L"replace"                         ) command.m_type = Type::Replace;
+	else if (name == L"replace-all"                     ) command.m_type = Type::ReplaceAll;
+	else if (name == L"delete"      &&  argument.empty()) command.m_type = Type::Delete;
+	else if (name == L"ignore-case" || name == L"whole-word")
+	{
+		if (!s_parseSwitch(argument).has_value()) return {};
+
+		command.m_type = name == L"ignore-case" ? Type::IgnoreCase : Type::WholeWord;
+	}
+	else if (name == L"select" && argument == L"all")
+	{
+		command.m_type = Type::SelectAll;
+	}
+	else if (name == L"select" && argument.substr(0, 6) == L"lines ")
+	{
+		const auto numbers = Trim(argument.substr(6));
+		const auto numberEnd = std::min(numbers.find(L' '), numbers.size());
+
+		const auto first = ParseNumber(numbers.substr(0, numberEnd));
+		const auto last  = numberEnd < numbers.size() ? ParseNumber(Trim(numbers.substr(numberEnd))) : first;
+
+		if (!first.has_value() || !last.has_value() || first.value() == 0 || last.value() < first.value()) return {};
+
+		command.m_type = Type::SelectLines;
+		command.m_firstLine = first.value();
+		command.m_lastLine  = last.value();
+	}
+	else if (const auto lineCommand = LineOperations::s_parseCommand(line))
+	{
+		command.m_type = Type::LineOperation;
+		command.m_lineOperation = lineCommand->m_type;
+		command.m_argument = s_unescape(lineCommand->m_argument);
+	}
+	else return {};
+
+	return command;
+}
+
+[[nodiscard]] std::wstring ScriptRunner::s_unescape(const std::wstring_view str)
+{
+	std::wstring result;
+	result.reserve(str.size());
+
+	for (SizeType i = 0; i < str.size(); ++i)
+	{
+		if (str[i] != L'\\' || i + 1 == str.size())
+		{
+			result.push_back(str[i]);
+			continue;
+		}
+
+		switch (str[++i])
+		{
+		case L'n':
+			result.push_back(L'\n');
+			break;
+		case L't':
+			result.push_back(L'\t');
+			break;
+		default:
+			result.push_back(str[i]);
+			break;
+		}
+	}
+
+	return result;
+}
+
+[[nodiscard]] std::optional<bool> ScriptRunner::s_parseSwitch(const std::wstring_view str) noexcept
+{
+	if (str == L"on" ) return true;
+	if (str == L"off") return false;
+
+	return {};
+}
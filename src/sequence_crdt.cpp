@@ -0,0 +1,495 @@
+#include "../include/sequence_crdt.h"
+#include "../include/utility.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace
+{
+
+	enum OperationKind : std::uint8_t
+	{
+		Kind_Insertion,
+		Kind_Removal
+	};
+
+	template<typename Type>
+	void Write(std::vector<char>& data, const Type& value)
+	{
+		const auto bytes = reinterpret_cast<const char*>(&value);
+
+		data.insert(data.end(), bytes, bytes + sizeof(Type));
+	}
+
+	// reads the values written by Write, fails once the data ends
+	struct Reader
+	{
+		const std::vector<char>& m_data;
+
+		std::size_t m_offset = 0;
+
+		template<typename Type>
+		[[nodiscard]] bool m_read(Type& value) noexcept
+		{
+			if (m_data.size() - m_offset < sizeof(Type)) return false;
+
+			std::memcpy(&value, m_data.data() + m_offset, sizeof(Type));
+			m_offset += sizeof(Type);
+
+			return true;
+		}
+	};
+
+	void WriteId(std::vector<char>& data, const SequenceCrdt::Id& id)
+	{
+		Write(data, id.m_clock);
+		Write(data, id.m_client);
+	}
+
+	[[nodiscard]] bool ReadId(Reader& reader, SequenceCrdt::Id& id) noexcept
+	{
+		return reader.m_read(id.m_clock) && reader.m_read(id.m_client);
+	}
+
+} // namespace
+
+[[nodiscard]] std::wstring SequenceCrdt::m_getText() const
+{
+	std::wstring text;
+	text.reserve(m_size);
+
+	for (const auto& block : m_blocks)
+	{
+		for (const auto& item : block.m_items)
+		{
+			if (!item.m_removed) text += item.m_text;
+		}
+	}
+
+	return text;
+}
+
+[[nodiscard]] SequenceCrdt::Insertion SequenceCrdt::m_insert(const SizeType index, const std::wstring_view text)
+{
+	Insertion insertion = { { m_clock + 1, m_client }, {}, std::wstring(text) };
+
+	if (index > 0 && m_size > 0)
+	{
+		const auto [position, offset] = m_findCharacter(std::min(index, m_size) - 1);
+
+		insertion.m_origin = position.m_block->m_items[position.m_item].m_id.m_plus(offset);
+	}
+
+	// the new ids are higher than every known one, it goes right after its origin
+	std::vector<Edit> edits;
+	static_cast<void>(m_integrate(insertion, edits));
+
+	return insertion;
+}
+
+[[nodiscard]] std::vector<SequenceCrdt::Removal> SequenceCrdt::m_erase(const SizeType start, const SizeType end)
+{
+	std::vector<Removal> removals;
+	std::vector<Edit> edits;
+
+	// every removal takes the characters from start on out of the visible text
+	for (auto remaining = std::min(end, m_size) - std::min(start, end); remaining > 0; )
+	{
+		const auto [position, offset] = m_findCharacter(start);
+		const auto& item = position.m_block->m_items[position.m_item];
+
+		const Removal removal = { item.m_id.m_plus(offset), std::min(item.m_size - offset, remaining) };
+
+		if (!m_integrate(removal, edits)) break;
+
+		removals.push_back(removal);
+		remaining -= removal.m_size;
+	}
+
+	return removals;
+}
+
+[[nodiscard]] bool SequenceCrdt::m_apply(const Operation& operation, std::vector<Edit>& edits)
+{
+	return std::visit([&] (const auto& value) { return m_integrate(value, edits); }, operation);
+}
+
+void SequenceCrdt::s_write(const Operation& operation, std::vector<char>& data)
+{
+	std::visit(utils::MakeVisitor
+	{
+		[&] (const Insertion& insertion)
+		{
+			Write(data, Kind_Insertion);
+			WriteId(data, insertion.m_id);
+			WriteId(data, insertion.m_origin);
+			Write(data, static_cast<std::uint64_t>(insertion.m_text.size()));
+
+			const auto bytes = reinterpret_cast<const char*>(insertion.m_text.data());
+
+			data.insert(data.end(), bytes, bytes + insertion.m_text.size() * sizeof(wchar_t));
+		},
+		[&] (const Removal& removal)
+		{
+			Write(data, Kind_Removal);
+			WriteId(data, removal.m_id);
+			Write(data, static_cast<std::uint64_t>(removal.m_size));
+		}
+	}, operation);
+}
+
+[[nodiscard]] std::optional<std::vector<SequenceCrdt::Operation>> SequenceCrdt::s_read(const std::vector<char>& data)
+{
+	std::vector<Operation> operations;
+
+	Reader reader = { data };
+
+	while (reader.m_offset < data.size())
+	{
+		std::uint8_t kind = 0;
+		std::uint64_t size = 0;
+
+		if (!reader.m_read(kind)) return {};
+
+		if (kind == Kind_Insertion)
+		{
+			Insertion insertion;
+
+			if (!ReadId(reader, insertion.m_id) || !ReadId(reader, insertion.m_origin) || !reader.m_read(size)) return {};
+
+			if ((data.size() - reader.m_offset) / sizeof(wchar_t) < size) return {};
+
+			insertion.m_text.resize(static_cast<SizeType>(size));
+			std::memcpy(insertion.m_text.data(), data.data() + reader.m_offset, insertion.m_text.size() * sizeof(wchar_t));
+
+			reader.m_offset += insertion.m_text.size() * sizeof(wchar_t);
+
+			operations.push_back(std::move(insertion));
+		}
+		else if (kind == Kind_Removal)
+		{
+			Removal removal;
+
+			if (!ReadId(reader, removal.m_id) || !reader.m_read(size)) return {};
+
+			removal.m_size = static_cast<SizeType>(size);
+
+			operations.push_back(removal);
+		}
+		else
+		{
+			return {};
+		}
+	}
+
+	return operations;
+}
+
+void SequenceCrdt::s_append(std::vector<Operation>& operations, Operation operation)
+{
+	if (!operations.empty())
+	{
+		const bool merged = std::visit(utils::MakeVisitor
+		{
+			[] (Insertion& last, Insertion& next)
+			{
+				if (last.m_text.empty()) return false;
+
+				// typed after the last character of the previous one
+				if (next.m_id != last.m_id.m_plus(last.m_text.size()) || next.m_origin != last.m_id.m_plus(last.m_text.size() - 1)) return false;
+
+				last.m_text += next.m_text;
+				return true;
+			},
+			[] (Removal& last, Removal& next)
+			{
+				if (last.m_id.m_client != next.m_id.m_client) return false;
+
+				// delete
+				if (next.m_id.m_clock == last.m_id.m_clock + last.m_size)
+				{
+					last.m_size += next.m_size;
+					return true;
+				}
+
+				// backspace
+				if (next.m_id.m_clock + next.m_size == last.m_id.m_clock)
+				{
+					last.m_id    = next.m_id;
+					last.m_size += next.m_size;
+					return true;
+				}
+
+				return false;
+			},
+			[] (auto&, auto&) { return false; }
+		}, operations.back(), operation);
+
+		if (merged) return;
+	}
+
+	operations.push_back(std::move(operation));
+}
+
+[[nodiscard]] std::optional<SequenceCrdt::Position> SequenceCrdt::m_find(const Id& id)
+{
+	auto it = m_locations.upper_bound({ id.m_client, id.m_clock });
+
+	if (it == m_locations.begin()) return {};
+
+	--it;
+
+	if (it->first.first != id.m_client) return {};
+
+	const auto block = it->second;
+
+	for (SizeType i = 0; i < block->m_items.size(); ++i)
+	{
+		if (block->m_items[i].m_contains(id)) return Position{ block, i };
+	}
+
+	return {};
+}
+
+[[nodiscard]] std::pair<SequenceCrdt::Position, SequenceCrdt::SizeType> SequenceCrdt::m_findCharacter(SizeType index)
+{
+	auto block = m_blocks.begin();
+
+	while (std::next(block) != m_blocks.end() && index >= block->m_visible)
+	{
+		index -= block->m_visible;
+		++block;
+	}
+
+	for (SizeType i = 0; i < block->m_items.size(); ++i)
+	{
+		const auto& item = block->m_items[i];
+
+		if (item.m_removed) continue;
+
+		if (index < item.m_size) return { { block, i }, index };
+
+		index -= item.m_size;
+	}
+
+	// callers only ask for visible characters
+	return { { block, block->m_items.size() }, 0 };
+}
+
+[[nodiscard]] SequenceCrdt::SizeType SequenceCrdt::m_getIndex(const Position& position) const noexcept
+{
+	SizeType index = 0;
+
+	for (auto it = m_blocks.cbegin(); it != position.m_block; ++it) index += it->m_visible;
+
+	for (SizeType i = 0; i < position.m_item; ++i)
+	{
+		const auto& item = position.m_block->m_items[i];
+
+		if (!item.m_removed) index += item.m_size;
+	}
+
+	return index;
+}
+
+[[nodiscard]] SequenceCrdt::Position SequenceCrdt::m_next(Position position) noexcept
+{
+	++position.m_item;
+
+	while (position.m_item >= position.m_block->m_items.size() && std::next(position.m_block) != m_blocks.end())
+	{
+		++position.m_block;
+		position.m_item = 0;
+	}
+
+	return position;
+}
+
+SequenceCrdt::Position SequenceCrdt::m_split(Position position, const SizeType offset)
+{
+	auto& items = position.m_block->m_items;
+	auto& head  = items[position.m_item];
+
+	Item tail = { head.m_id.m_plus(offset), head.m_size - offset, head.m_removed, {} };
+
+	if (!head.m_removed)
+	{
+		tail.m_text = head.m_text.substr(offset);
+		head.m_text.resize(offset);
+	}
+
+	head.m_size = offset;
+
+	m_locations[{ tail.m_id.m_client, tail.m_id.m_clock }] = position.m_block;
+
+	++position.m_item;
+
+	items.insert(items.begin() + static_cast<std::ptrdiff_t>(position.m_item), std::move(tail));
+
+	m_balance(position);
+
+	return position;
+}
+
+void SequenceCrdt::m_balance(Position& position)
+{
+	auto& items = position.m_block->m_items;
+
+	if (items.size() <= 2 * s_blockSize) return;
+
+	const auto block = m_blocks.insert(std::next(position.m_block), Block());
+
+	const auto half = items.size() / 2;
+
+	block->m_items.assign(std::make_move_iterator(items.begin() + static_cast<std::ptrdiff_t>(half)), std::make_move_iterator(items.end()));
+	items.resize(half);
+
+	for (const auto& item : block->m_items)
+	{
+		m_locations[{ item.m_id.m_client, item.m_id.m_clock }] = block;
+
+		if (!item.m_removed) block->m_visible += item.m_size;
+	}
+
+	position.m_block->m_visible -= block->m_visible;
+
+	if (position.m_item >= half)
+	{
+		position.m_block = block;
+		position.m_item -= half;
+	}
+}
+
+void SequenceCrdt::m_mergeTombstones(const Position& position)
+{
+	auto& items = position.m_block->m_items;
+
+	auto continues = [] (const Item& first, const Item& second)
+	{
+		return first.m_removed && second.m_removed && second.m_id == first.m_id.m_plus(first.m_size);
+	};
+
+	auto merge = [&] (const SizeType first)
+	{
+		const auto& second = items[first + 1];
+
+		m_locations.erase({ second.m_id.m_client, second.m_id.m_clock });
+
+		items[first].m_size += second.m_size;
+
+		items.erase(items.begin() + static_cast<std::ptrdiff_t>(first + 1));
+	};
+
+	if (position.m_item + 1 < items.size() && continues(items[position.m_item], items[position.m_item + 1])) merge(position.m_item);
+
+	if (position.m_item > 0 && continues(items[position.m_item - 1], items[position.m_item])) merge(position.m_item - 1);
+}
+
+[[nodiscard]] bool SequenceCrdt::m_integrate(const Insertion& insertion, std::vector<Edit>& edits)
+{
+	const auto size = insertion.m_text.size();
+
+	if (size == 0) return true;
+
+	// sent twice
+	if (m_find(insertion.m_id).has_value()) return true;
+
+	Position position = { m_blocks.begin(), 0 };
+
+	if (!insertion.m_origin.m_isNull())
+	{
+		const auto origin = m_find(insertion.m_origin);
+
+		if (!origin.has_value()) return false;
+
+		const auto& item = origin->m_block->m_items[origin->m_item];
+
+		const auto offset = static_cast<SizeType>(insertion.m_origin.m_clock - item.m_id.m_clock) + 1;
+
+		position = offset < item.m_size ? m_split(origin.value(), offset) : m_next(origin.value());
+	}
+
+	// insertions made at the same place without seeing this one have higher ids, they and everything
+	// inserted after them stay in front of it
+	while (position.m_item < position.m_block->m_items.size() && insertion.m_id < position.m_block->m_items[position.m_item].m_id)
+	{
+		position = m_next(position);
+	}
+
+	edits.push_back({ m_getIndex(position), 0, insertion.m_text });
+
+	m_clock = std::max(m_clock, insertion.m_id.m_clock + size - 1);
+
+	m_size += size;
+	position.m_block->m_visible += size;
+
+	auto& items = position.m_block->m_items;
+
+	// typing continues the run of the character before
+	if (position.m_item > 0)
+	{
+		auto& previous = items[position.m_item - 1];
+
+		if (!previous.m_removed && insertion.m_id == previous.m_id.m_plus(previous.m_size) &&
+			insertion.m_origin == previous.m_id.m_plus(previous.m_size - 1))
+		{
+			previous.m_text += insertion.m_text;
+			previous.m_size += size;
+			return true;
+		}
+	}
+
+	m_locations[{ insertion.m_id.m_client, insertion.m_id.m_clock }] = position.m_block;
+
+	items.insert(items.begin() + static_cast<std::ptrdiff_t>(position.m_item), { insertion.m_id, size, false, insertion.m_text });
+
+	m_balance(position);
+
+	return true;
+}
+
+[[nodiscard]] bool SequenceCrdt::m_integrate(Removal removal, std::vector<Edit>& edits)
+{
+	while (removal.m_size > 0)
+	{
+		auto position = m_find(removal.m_id);
+
+		if (!position.has_value()) return false;
+
+		const auto offset = static_cast<SizeType>(removal.m_id.m_clock - position->m_block->m_items[position->m_item].m_id.m_clock);
+
+		// the removed characters become an item of their own
+		if (offset > 0) position = m_split(position.value(), offset);
+
+		const auto count = std::min(removal.m_size, position->m_block->m_items[position->m_item].m_size);
+
+		if (count < position->m_block->m_items[position->m_item].m_size)
+		{
+			m_split(position.value(), count);
+
+			// the split may have moved the item to a new block
+			position = m_find(removal.m_id);
+		}
+
+		auto& item = position->m_block->m_items[position->m_item];
+
+		if (!item.m_removed)
+		{
+			edits.push_back({ m_getIndex(position.value()), count, {} });
+
+			item.m_removed = true;
+			std::wstring().swap(item.m_text);
+
+			m_size -= count;
+			position->m_block->m_visible -= count;
+
+			m_mergeTombstones(position.value());
+		}
+
+		removal.m_id = removal.m_id.m_plus(count);
+		removal.m_size -= count;
+	}
+
+	return true;
+}
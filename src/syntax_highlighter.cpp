@@ -0,0 +1,476 @@
+#include "../include/syntax_highlighter.h"
+
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <cwctype>
+
+namespace
+{
+	using Kind = SyntaxHighlighter::Kind;
+
+	struct Word
+	{
+		std::wstring_view m_word;
+		Kind m_kind;
+	};
+
+	struct LinePrefix
+	{
+		std::wstring_view m_prefix;
+		Kind m_kind;
+	};
+
+	// sorted for binary search
+	constexpr Word s_cppWords[] =
+	{
+		{ L"alignas",          Kind::Keyword },
+		{ L"alignof",          Kind::Keyword },
+		{ L"asm",              Kind::Keyword },
+		{ L"auto",             Kind::Type },
+		{ L"bool",             Kind::Type },
+		{ L"break",            Kind::Keyword },
+		{ L"case",             Kind::Keyword },
+		{ L"catch",            Kind::Keyword },
+		{ L"char",             Kind::Type },
+		{ L"char16_t",         Kind::Type },
+		{ L"char32_t",         Kind::Type },
+		{ L"char8_t",          Kind::Type },
+		{ L"class",            Kind::Keyword },
+		{ L"co_await",         Kind::Keyword },
+		{ L"co_return",        Kind::Keyword },
+		{ L"co_yield",         Kind::Keyword },
+		{ L"concept",          Kind::Keyword },
+		{ L"const",            Kind::Keyword },
+		{ L"const_cast",       Kind::Keyword },
+		{ L"consteval",        Kind::Keyword },
+		{ L"constexpr",        Kind::Keyword },
+		{ L"constinit",        Kind::Keyword },
+		{ L"continue",         Kind::Keyword },
+		{ L"decltype",         Kind::Keyword },
+		{ L"default",          Kind::Keyword },
+		{ L"delete",           Kind::Keyword },
+		{ L"do",               Kind::Keyword },
+		{ L"double",           Kind::Type },
+		{ L"dynamic_cast",     Kind::Keyword },
+		{ L"else",             Kind::Keyword },
+		{ L"enum",             Kind::Keyword },
+		{ L"explicit",         Kind::Keyword },
+		{ L"export",           Kind::Keyword },
+		{ L"extern",           Kind::Keyword },
+		{ L"false",            Kind::Keyword },
+		{ L"final",            Kind::Keyword },
+		{ L"float",            Kind::Type },
+		{ L"for",              Kind::Keyword },
+		{ L"friend",           Kind::Keyword },
+		{ L"goto",             Kind::Keyword },
+		{ L"if",               Kind::Keyword },
+		{ L"inline",           Kind::Keyword },
+		{ L"int",              Kind::Type },
+		{ L"int16_t",          Kind::Type },
+		{ L"int32_t",          Kind::Type },
+		{ L"int64_t",          Kind::Type },
+		{ L"int8_t",           Kind::Type },
+		{ L"long",             Kind::Type },
+		{ L"mutable",          Kind::Keyword },
+		{ L"namespace",        Kind::Keyword },
+		{ L"new",              Kind::Keyword },
+		{ L"noexcept",         Kind::Keyword },
+		{ L"nullptr",          Kind::Keyword },
+		{ L"operator",         Kind::Keyword },
+		{ L"override",         Kind::Keyword },
+		{ L"private",          Kind::Keyword },
+		{ L"protected",        Kind::Keyword },
+		{ L"ptrdiff_t",        Kind::Type },
+		{ L"public",           Kind::Keyword },
+		{ L"register",         Kind::Keyword },
+		{ L"reinterpret_cast", Kind::Keyword },
+		{ L"requires",         Kind::Keyword },
+		{ L"return",           Kind::Keyword },
+		{ L"short",            Kind::Type },
+		{ L"signed",           Kind::Type },
+		{ L"size_t",           Kind::Type },
+		{ L"sizeof",           Kind::Keyword },
+		{ L"static",           Kind::Keyword },
+		{ L"static_assert",    Kind::Keyword },
+		{ L"static_cast",      Kind::Keyword },
+		{ L"struct",           Kind::Keyword },
+		{ L"switch",           Kind::Keyword },
+		{ L"template",         Kind::Keyword },
+		{ L"this",             Kind::Keyword },
+		{ L"thread_local",     Kind::Keyword },
+		{ L"throw",            Kind::Keyword },
+		{ L"true",             Kind::Keyword },
+		{ L"try",              Kind::Keyword },
+		{ L"typedef",          Kind::Keyword },
+		{ L"typeid",           Kind::Keyword },
+		{ L"typename",         Kind::Keyword },
+		{ L"uint16_t",         Kind::Type },
+		{ L"uint32_t",         Kind::Type },
+		{ L"uint64_t",         Kind::Type },
+		{ L"uint8_t",          Kind::Type },
+		{ L"union",            Kind::Keyword },
+		{ L"unsigned",         Kind::Type },
+		{ L"using",            Kind::Keyword },
+		{ L"virtual",          Kind::Keyword },
+		{ L"void",             Kind::Type },
+		{ L"volatile",         Kind::Keyword },
+		{ L"wchar_t",          Kind::Type },
+		{ L"while",            Kind::Keyword },
+	};
+
+	constexpr Word s_jsonWords[] =
+	{
+		{ L"false", Kind::Keyword },
+		{ L"null",  Kind::Keyword },
+		{ L"true",  Kind::Keyword },
+	};
+
+	constexpr Word s_logWords[] =
+	{
+		{ L"CRITICAL", Kind::Error   },
+		{ L"DEBUG",    Kind::Debug   },
+		{ L"ERROR",    Kind::Error   },
+		{ L"FATAL",    Kind::Error   },
+		{ L"INFO",     Kind::Info    },
+		{ L"TRACE",    Kind::Debug   },
+		{ L"WARN",     Kind::Warning },
+		{ L"WARNING",  Kind::Warning },
+	};
+
+	// longer prefixes first
+	constexpr LinePrefix s_diffPrefixes[] =
+	{
+		{ L"diff ",  Kind::Section },
+		{ L"index ", Kind::Section },
+		{ L"+++",    Kind::Section },
+		{ L"---",    Kind::Section },
+		{ L"@@",     Kind::Section },
+		{ L"+",      Kind::Added   },
+		{ L"-",      Kind::Removed },
+	};
+
+	[[nodiscard]] constexpr bool IsWordChar(const wchar_t c) noexcept
+	{
+		return (c >= L'a' && c <= L'z') || (c >= L'A' && c <= L'Z') || (c >= L'0' && c <= L'9') || c == L'_';
+	}
+
+	[[nodiscard]] constexpr bool IsDigit(const wchar_t c) noexcept { return c >= L'0' && c <= L'9'; }
+
+	[[nodiscard]] constexpr bool StartsWith(const std::wstring_view str, const std::wstring_view prefix) noexcept
+	{
+		return !prefix.empty() && str.substr(0, prefix.size()) == prefix;
+	}
+
+} // namespace
+
+struct SyntaxHighlighter::Language
+{
+	// every extension ends with a dot, the list starts with one
+	std::wstring_view m_extensions;
+
+	std::wstring_view m_lineComment;
+	std::wstring_view m_blockCommentStart;
+	std::wstring_view m_blockCommentEnd;
+
+	std::wstring_view m_quotes;
+
+	const Word* m_words;
+	std::size_t m_wordCount;
+
+	// the first matching one colors the whole line
+	const LinePrefix* m_linePrefixes;
+	std::size_t m_linePrefixCount;
+
+	bool m_numbers;
+
+	// a line that starts with #
+	bool m_preprocessor;
+
+	// a string followed by : is a key
+	bool m_keys;
+};
+
+namespace
+{
+	const SyntaxHighlighter::Language s_languages[] =
+	{
+		{ L".c.h.cc.cpp.cxx.c++.hh.hpp.hxx.h++.inl.ipp.", L"//", L"/*", L"*/", L"\"'",
+			s_cppWords, std::size(s_cppWords), nullptr, 0, true, true, false },
+
+		{ L".json.", {}, {}, {}, L"\"",
+			s_jsonWords, std::size(s_jsonWords), nullptr, 0, true, false, true },
+
+		{ L".log.", {}, {}, {}, {},
+			s_logWords, std::size(s_logWords), nullptr, 0, true, false, false },
+
+		{ L".diff.patch.", {}, {}, {}, {},
+			nullptr, 0, s_diffPrefixes, std::size(s_diffPrefixes), false, false, false },
+	};
+
+} // namespace
+
+void SyntaxHighlighter::m_setLanguageFor(const std::wstring_view filePath)
+{
+	m_language = nullptr;
+
+	m_states.clear();
+	m_validLines = 0;
+	m_checkLine  = 0;
+	m_trustedEnd = 0;
+
+	const auto dot = filePath.find_last_of(L'.');
+
+	if (dot == std::wstring_view::npos || filePath.find_first_of(L"\\/", dot) != std::wstring_view::npos) return;
+
+	std::wstring extension(filePath.substr(dot));
+	extension.push_back(L'.');
+
+	std::transform(extension.begin(), extension.end(), extension.begin(), [] (const wchar_t c) { return static_cast<wchar_t>(std::towlower(c)); });
+
+	for (const auto& language : s_languages)
+	{
+		if (language.m_extensions.find(extension) != std::wstring_view::npos)
+		{
+			m_language = &language;
+			return;
+		}
+	}
+}
+
+void SyntaxHighlighter::m_reset(const SizeType lineCount)
+{
+	m_states.assign(lineCount, State::Normal);
+
+	m_validLines = std::min<SizeType>(lineCount, 1);
+	m_checkLine  = 0;
+	m_trustedEnd = 0;
+}
+
+void SyntaxHighlighter::m_spliceLines(const SizeType line, const SizeType removedLines, const SizeType insertedLines)
+{
+	if (line >= m_states.size()) return;
+
+	const auto first = m_states.begin() + static_cast<std::ptrdiff_t>(line + 1);
+
+	m_states.erase (first, first + static_cast<std::ptrdiff_t>(removedLines));
+	m_states.insert(m_states.begin() + static_cast<std::ptrdiff_t>(line + 1), insertedLines, m_states[line]);
+
+	// lines after the edited ones keep their number relative to the end
+	const auto shift = [&] (const SizeType oldLine) { return oldLine + insertedLines - removedLines; };
+
+	if (line < m_validLines)
+	{
+		// the exact lines after the edited ones become the lines to check
+		m_checkLine  = line + insertedLines + 1;
+		m_trustedEnd = m_validLines > line + removedLines + 1 ? shift(m_validLines) : 0;
+
+		m_validLines = line + 1;
+	}
+	else if (m_trustedEnd > line + 1)
+	{
+		if (m_checkLine > line + removedLines)
+		{
+			m_checkLine  = shift(m_checkLine);
+			m_trustedEnd = shift(m_trustedEnd);
+		}
+		else
+		{
+			// the lines before the edit are lexed again, the ones after it are still trusted
+			m_trustedEnd = m_trustedEnd > line + removedLines + 1 ? shift(m_trustedEnd) : 0;
+			m_checkLine  = line + insertedLines + 1;
+		}
+	}
+}
+
+std::pair<SyntaxHighlighter::SizeType, SyntaxHighlighter::SizeType>
+SyntaxHighlighter::m_lex(const std::wstring_view text, const LineIndex& lineIndex, const SizeType line, const SizeType maxSize)
+{
+	std::pair<SizeType, SizeType> changed = { std::wstring_view::npos, 0 };
+
+	if (m_language == nullptr) return changed;
+
+	SizeType lexedSize = 0;
+
+	while (m_validLines < m_states.size() && m_validLines <= line && lexedSize < maxSize)
+	{
+		const auto current = m_validLines - 1;
+
+		const auto start = lineIndex.m_getLineStart(current);
+		const auto end   = lineIndex.m_getLineEnd  (current);
+
+		auto state = m_states[current];
+
+		if (end - start <= s_maxLineLength) state = m_lexLine(text.substr(start, end - start), state, nullptr);
+
+		lexedSize += end - start + 1;
+
+		const auto next = current + 1;
+
+		if (m_checkLine <= next && next < m_trustedEnd && m_states[next] == state)
+		{
+			// the rest of the lines checked before the edit did not change
+			m_validLines = m_trustedEnd;
+			m_trustedEnd = 0;
+
+			continue;
+		}
+
+		if (m_states[next] != state)
+		{
+			m_states[next] = state;
+
+			changed.first  = std::min(changed.first, next);
+			changed.second = next;
+		}
+
+		m_validLines = next + 1;
+	}
+
+	return changed;
+}
+
+void SyntaxHighlighter::m_highlightLine(const std::wstring_view text, const LineIndex& lineIndex, const SizeType line, std::vector<Kind>& kinds) const
+{
+	kinds.clear();
+
+	if (m_language == nullptr || line >= m_states.size()) return;
+
+	const auto start = lineIndex.m_getLineStart(line);
+	const auto end   = lineIndex.m_getLineEnd  (line);
+
+	if (end - start > s_maxLineLength) return;
+
+	kinds.resize(end - start);
+
+	[[maybe_unused]] const auto state = m_lexLine(text.substr(start, end - start), m_states[line], kinds.data());
+}
+
+[[nodiscard]] SyntaxHighlighter::State SyntaxHighlighter::m_lexLine(const std::wstring_view line, const State state, Kind* kinds) const noexcept
+{
+	const auto& language = *m_language;
+
+	const auto mark = [kinds] (const SizeType start, const SizeType end, const Kind kind)
+	{
+		if (kinds != nullptr) std::fill(kinds + start, kinds + end, kind);
+	};
+
+	SizeType i = 0;
+
+	if (state == State::BlockComment)
+	{
+		const auto end = line.find(language.m_blockCommentEnd);
+
+		if (end == std::wstring_view::npos)
+		{
+			mark(0, line.size(), Kind::Comment);
+			return State::BlockComment;
+		}
+
+		i = end + language.m_blockCommentEnd.size();
+
+		mark(0, i, Kind::Comment);
+	}
+	else
+	{
+		for (SizeType p = 0; p < language.m_linePrefixCount; ++p)
+		{
+			if (StartsWith(line, language.m_linePrefixes[p].m_prefix))
+			{
+				mark(0, line.size(), language.m_linePrefixes[p].m_kind);
+				return State::Normal;
+			}
+		}
+	}
+
+	auto textKind = Kind::Text;
+
+	if (language.m_preprocessor)
+	{
+		const auto first = line.find_first_not_of(L" \t", i);
+
+		if (first != std::wstring_view::npos && line[first] == L'#') textKind = Kind::Preprocessor;
+	}
+
+	const auto words    = language.m_words;
+	const auto wordsEnd = language.m_words + language.m_wordCount;
+
+	while (i < line.size())
+	{
+		const auto c = line[i];
+		const auto rest = line.substr(i);
+
+		if (StartsWith(rest, language.m_blockCommentStart))
+		{
+			const auto end = line.find(language.m_blockCommentEnd, i + language.m_blockCommentStart.size());
+
+			if (end == std::wstring_view::npos)
+			{
+				mark(i, line.size(), Kind::Comment);
+				return State::BlockComment;
+			}
+
+			mark(i, end + language.m_blockCommentEnd.size(), Kind::Comment);
+			i = end + language.m_blockCommentEnd.size();
+		}
+		else if (StartsWith(rest, language.m_lineComment))
+		{
+			mark(i, line.size(), Kind::Comment);
+			break;
+		}
+		else if (language.m_quotes.find(c) != std::wstring_view::npos)
+		{
+			// an unterminated string ends with the line
+			auto end = i + 1;
+
+			while (end < line.size() && line[end] != c) end += line[end] == L'\\' ? SizeType(2) : SizeType(1);
+
+			end = std::min(end + 1, line.size());
+
+			auto kind = Kind::String;
+
+			if (language.m_keys)
+			{
+				const auto next = line.find_first_not_of(L" \t", end);
+
+				if (next != std::wstring_view::npos && line[next] == L':') kind = Kind::Key;
+			}
+
+			mark(i, end, kind);
+			i = end;
+		}
+		else if (IsWordChar(c))
+		{
+			auto end = i + 1;
+			auto kind = textKind;
+
+			if (language.m_numbers && IsDigit(c))
+			{
+				// 0x1F, 1.5e3, 10'000
+				while (end < line.size() && (IsWordChar(line[end]) || line[end] == L'.' || line[end] == L'\'')) ++end;
+
+				kind = Kind::Number;
+			}
+			else
+			{
+				while (end < line.size() && IsWordChar(line[end])) ++end;
+
+				const auto word = line.substr(i, end - i);
+
+				const auto it = std::lower_bound(words, wordsEnd, word, [] (const Word& lhs, const std::wstring_view rhs) { return lhs.m_word < rhs; });
+
+				if (it != wordsEnd && it->m_word == word) kind = it->m_kind;
+			}
+
+			mark(i, end, kind);
+			i = end;
+		}
+		else
+		{
+			mark(i, i + 1, textKind);
+			++i;
+		}
+	}
+
+	return State::Normal;
+}
@@ -4,6 +4,8 @@
 #include <cwctype> // std::iswprint
 #include <algorithm>
 #include <cwchar>
+#include <iterator>
+#include <numeric>
 
 void TextEditor::m_initEditor(const SizeType width, const SizeType height,
 	const WORD textColor, const SizeType startX, const SizeType startY)
@@ -16,11 +18,13 @@ void TextEditor::m_initEditor(const SizeType width, const SizeType height,
 
 	m_textColor = textColor;
 
-	if (m_inputBuffer.empty()) m_inputBuffer.push_back(L' ');
+	m_columnCheckpoints.m_setLayout(width, s_tabSize);
 }
 
 bool TextEditor::m_handleEvents(const Console& console, const KEY_EVENT_RECORD& event)
 {
+	m_syncView();
+
 	if (m_lastEvent == EventType::MouseWheel)
 	{
 		console.m_setCursorInfo(true);
@@ -28,6 +32,10 @@ bool TextEditor::m_handleEvents(const Console& console, const KEY_EVENT_RECORD&
 
 	m_lastEvent = EventType::Keyboard;
 
+	if (m_handleBlockSelectionEvents(event)) return true;
+
+	if (!m_extraCursors.empty() && m_handleMultiCursorEvents(event)) return true;
+
 	if (event.bKeyDown && event.wVirtualKeyCode == VK_ESCAPE)
 	{
 		if (m_selectionInProgress) 
@@ -48,6 +56,8 @@ bool TextEditor::m_handleEvents(const Console& console, const KEY_EVENT_RECORD&
 
 void TextEditor::m_handleEvents(const Console& console, const MOUSE_EVENT_RECORD& event)
 {
+	m_syncView();
+
 	const auto state = console.m_leftMouseButton.m_state();
 
 	switch (state)
@@ -55,19 +65,47 @@ void TextEditor::m_handleEvents(const Console& console, const MOUSE_EVENT_RECORD
 	case Console::ButtonState::Pressed:
 	case Console::ButtonState::Held:
 	{
+		m_updateWrapLayout();
+
 		const auto mouseIndex = m_getIndexAtPos(event.dwMousePosition.X, event.dwMousePosition.Y);
 
 		if 		(event.dwMousePosition.Y <= m_drawStartY + 1) m_scrollOneUp();
 		else if (event.dwMousePosition.Y >= m_drawStartY + m_height - 2) m_scrollOneDown();
 
-		if (state == Console::ButtonState::Held)
+		if ((event.dwControlKeyState & Console::s_altKeyFlag) != 0)
+		{
+			// alt drag selects a block
+			const auto x = std::max<SizeType>(event.dwMousePosition.X, m_drawStartX) - m_drawStartX;
+			const auto y = std::max<SizeType>(event.dwMousePosition.Y, m_drawStartY) - m_drawStartY;
+
+			const auto line = m_wrap ? m_wrapLayout.m_getLineAt(m_getStartVisualRow() + y).first : std::min(m_startRow + y, m_document->m_lineIndex.m_getLineCount() - 1);
+
+			if (!m_blockSelection.has_value() || (state == Console::ButtonState::Pressed && event.dwEventFlags == 0))
+			{
+				m_resetCursors();
+				m_blockSelection = BlockSelection{ line, x, line, x };
+			}
+
+			m_setBlockCorner(line, x);
+		}
+		else if (state == Console::ButtonState::Held)
 		{	
+			m_blockSelection.reset();
 			m_handleSelection(mouseIndex, m_currentIndex);
 		}
 		else
 		{	
+			if ((event.dwControlKeyState & Console::s_ctrlKeyFlag) != 0 && event.dwEventFlags == 0)
+			{
+				// ctrl click adds a cursor and keeps the current one
+				m_extraCursors.push_back({ m_currentIndex, m_selectionStartIndex, m_selectionInProgress });
+			}
+			else m_resetCursors();
+
 			m_selectionInProgress = false;
 			m_currentIndex = mouseIndex;
+
+			m_sortCursors();
 		}
 
 		if (m_lastEvent == EventType::MouseWheel)
@@ -99,9 +137,11 @@ void TextEditor::m_handleEvents(const Console& console, const MOUSE_EVENT_RECORD
 
 void TextEditor::m_syncHeightWithRows(const SizeType consoleHeight) noexcept
 {
-	if (m_rowCount <= 5)
+	const auto rowCount = m_document->m_lineIndex.m_getLineCount();
+
+	if (rowCount <= 5)
 	{
-		m_height = m_rowCount;
+		m_height = rowCount;
 		m_drawStartY = consoleHeight - m_height;
 	}
 }
@@ -117,13 +157,14 @@ void TextEditor::m_handleInsertionEvents(const KEY_EVENT_RECORD& event)
 	
 		if (!m_deleteIfSelected() && m_currentIndex > 0)
 		{
-			m_deleteCharAt(--m_currentIndex);
+			m_currentIndex = UnicodeProperties::s_getPreviousGraphemeBreak(m_buffer(), m_currentIndex);
+			m_deleteCharAt(m_currentIndex);
 		}
 
 		break;
 	case VK_DELETE:
 
-		if (!m_deleteIfSelected() && m_currentIndex + 1 < m_inputBuffer.size())
+		if (!m_deleteIfSelected() && m_currentIndex + 1 < m_document->m_text.size())
 		{
 			m_deleteCharAt(m_currentIndex);
 		}
@@ -134,8 +175,6 @@ void TextEditor::m_handleInsertionEvents(const KEY_EVENT_RECORD& event)
 		m_deleteIfSelected();
 		m_insertChar(L'\n');
 
-		++m_rowCount;
-
 		break;
 	default:
 
@@ -159,6 +198,23 @@ void TextEditor::m_handleCursorEvents(const KEY_EVENT_RECORD& event)
 		m_shiftPressed = event.bKeyDown;
 	}
 
+	m_moveCursor(event);
+
+	if (m_extraCursors.empty()) return;
+
+	// other cursors follow the same movement
+	for (auto& cursor : m_extraCursors)
+	{
+		m_swapCursor(cursor);
+		m_moveCursor(event);
+		m_swapCursor(cursor);
+	}
+
+	m_sortCursors();
+}
+
+void TextEditor::m_moveCursor(const KEY_EVENT_RECORD& event)
+{
 	const auto oldInputIndex = m_currentIndex;
 	
 	m_handleCursorMoveEvents(event);
@@ -205,16 +261,14 @@ void TextEditor::m_handleControlKeyEvents(const KEY_EVENT_RECORD& event)
 	case VirtualKeyCode::V:
 	{
 		// Paste Event
-		auto clipboard = Console::s_getUserClipboard();
-
-		if (clipboard.has_value()) m_insertUnsafeString(std::move(clipboard.value()));
+		m_pasteClipboard();
 	
 		break;
 	}
 	case VirtualKeyCode::Z:
 	{
 		// undo event
-		if (m_records.empty()) break;
+		if (m_document->m_records.empty()) break;
 
 		std::visit(utils::MakeVisitor
 		{ 
@@ -225,10 +279,14 @@ void TextEditor::m_handleControlKeyEvents(const KEY_EVENT_RECORD& event)
 			[&] (const DeletionRecord& record)
 			{
 				m_insertString(record.m_data, record.m_index);
+			},
+			[&] (const BatchRecord& record)
+			{
+				m_undoBatch(record);
 			}
-		}, m_records.back());
+		}, m_document->m_records.back());
 
-		m_records.pop_back();
+		m_document->m_records.pop_back();
 		
 		break;
 	}
@@ -237,7 +295,7 @@ void TextEditor::m_handleControlKeyEvents(const KEY_EVENT_RECORD& event)
 
 		m_selectionStartIndex = 0;
 
-		m_currentIndex = m_inputBuffer.size() - 1;
+		m_currentIndex = m_document->m_text.size() - 1;
 
 		if (m_currentIndex > 0) --m_currentIndex; 
 
@@ -246,19 +304,26 @@ void TextEditor::m_handleControlKeyEvents(const KEY_EVENT_RECORD& event)
 		break;
 	case VirtualKeyCode::L:
 	{
+		if (Console::s_isShiftKeyPressed(event))
+		{
+			// cursor at the end of every selected line
+			m_addCursorsToSelectedLines();
+			break;
+		}
+
 		// Select Line Event
 
 		auto findStart = m_currentIndex;
 
 		if (findStart > 0) --findStart;
 
-		const auto start = m_inputBuffer.rfind(L'\n', findStart);
-		const auto end = m_inputBuffer.find(L'\n', m_currentIndex);
+		const auto start = m_document->m_text.rfind(L'\n', findStart);
+		const auto end = m_document->m_text.find(L'\n', m_currentIndex);
 
 		if (start == std::wstring::npos) m_currentIndex = 0;
 		else m_currentIndex = start + 1;
 
-		m_selectionStartIndex = std::min(end, m_inputBuffer.size() - 1);
+		m_selectionStartIndex = std::min(end, m_document->m_text.size() - 1);
 
 		m_selectionInProgress = true;
 
@@ -323,7 +388,7 @@ void TextEditor::m_handleCursorMoveEvents(const KEY_EVENT_RECORD& event)
 			break;
 		case VK_END:
 			
-			m_currentIndex = m_inputBuffer.size() - 1;
+			m_currentIndex = m_document->m_text.size() - 1;
 			break;
 		default:
 			break;
@@ -337,12 +402,12 @@ void TextEditor::m_handleCursorMoveEvents(const KEY_EVENT_RECORD& event)
 	{
 	case VK_LEFT:
 
-		if (m_currentIndex > 0) --m_currentIndex;
+		if (m_currentIndex > 0) m_currentIndex = UnicodeProperties::s_getPreviousGraphemeBreak(m_buffer(), m_currentIndex);
 
 		break;
 	case VK_RIGHT:
 
-		if (m_currentIndex + 1 < m_inputBuffer.size()) ++m_currentIndex;
+		if (m_currentIndex + 1 < m_document->m_text.size()) m_currentIndex = UnicodeProperties::s_getNextGraphemeBreak(m_buffer(), m_currentIndex);
 
 		break;
 	case VK_UP:
@@ -353,7 +418,7 @@ void TextEditor::m_handleCursorMoveEvents(const KEY_EVENT_RECORD& event)
 		m_moveCursorOneLineDown();
 		break;
 	case VK_HOME:
-		m_currentIndex = m_inputBuffer.rfind(L'\n', m_currentIndex);
+		m_currentIndex = m_document->m_text.rfind(L'\n', m_currentIndex);
 
 		if (m_currentIndex == std::wstring::npos)
 		{
@@ -363,13 +428,13 @@ void TextEditor::m_handleCursorMoveEvents(const KEY_EVENT_RECORD& event)
 
 		break;
 	case VK_END:
-		m_currentIndex = m_inputBuffer.find(L'\n', m_currentIndex);
+		m_currentIndex = m_document->m_text.find(L'\n', m_currentIndex);
 
 		if (m_currentIndex == std::wstring::npos)
 		{
-			m_currentIndex = m_inputBuffer.size() - 1;
+			m_currentIndex = m_document->m_text.size() - 1;
 		}
-		else if (m_currentIndex > 0) --m_currentIndex;
+		else if (m_currentIndex > 0) m_currentIndex = UnicodeProperties::s_getPreviousGraphemeBreak(m_buffer(), m_currentIndex);
 
 		break;
 	default:
@@ -377,392 +442,866 @@ void TextEditor::m_handleCursorMoveEvents(const KEY_EVENT_RECORD& event)
 	}
 }
 
-void TextEditor::m_updateConsole(Console& console, const std::wstring_view searchStr) noexcept
+void TextEditor::m_updateConsole(Console& console, const TextSearch& search) noexcept
 {
+	m_syncView();
+
+	m_updateWrapLayout();
+	m_updateHighlighter();
+
 	if (m_lastEvent == EventType::Keyboard) { m_updateStartRow(); }
 
+	// every drawn line has at least one row, if the exact states end far above the view
+	// the old ones are drawn until the background catches up
+	m_highlightEndLine = m_startRow + m_height;
+	m_document->m_highlighter.m_lex(m_buffer(), m_document->m_lineIndex, m_highlightEndLine, s_drawLexSize);
+
+	const auto consoleStartIndex = m_getConsoleStartIndex();
+	const auto columnStartVal    = m_getConsoleColumnStartIndex(consoleStartIndex);
+
+	// the whole view is filled once, the characters and the colors are written over it as spans
+	const auto rowWidth = std::min<SizeType>(m_width, console.m_screenWidth() - std::min<SizeType>(m_drawStartX, console.m_screenWidth()));
+
+	for (SizeType row = 0; row < m_height; ++row)
+	{
+		console.m_fillCells(console.m_getIndex(m_drawStartX, m_drawStartY + row), rowWidth, L' ', m_textColor);
+	}
+
+	m_layoutRows(console, consoleStartIndex, columnStartVal);
+
+	m_drawSyntaxColors(console);
+	m_drawSelections(console);
+	m_drawSearchMatches(console, search);
+
+	for (const auto cell : m_wideCells)
+	{
+		console.m_addColor(cell,     1, COMMON_LVB_LEADING_BYTE);
+		console.m_addColor(cell + 1, 1, COMMON_LVB_TRAILING_BYTE);
+	}
+}
+
+void TextEditor::m_layoutRows(Console& console, const SizeType consoleStartIndex, const SizeType columnStartVal) noexcept
+{
+	m_drawnRows.assign(m_height, DrawnRow{});
+	m_cellIndices.assign(m_width * m_height, std::wstring::npos);
+	m_wideCells.clear();
+
+	if (m_height == 0) return;
+
 	SizeType i = 0;
 	SizeType t = 0;
 
-	SizeType currColumnCount = 0;
+	// wrapped drawing may start inside a line
+	SizeType currColumnCount = m_wrap ? m_getColumnOf(consoleStartIndex) : 0;
+	SizeType line = m_startRow;
 
-	const auto consoleStartIndex = m_getConsoleStartIndex();
-	const auto columnStartVal    = m_getConsoleColumnStartIndex(consoleStartIndex);
+	SizeType lineEnd = 0;
+	SizeType drawEnd = 0;
+
+	// long lines start at the first drawn column and skip everything after the last one,
+	// returns the index drawing continues from
+	const auto startLine = [&] (SizeType index)
+	{
+		lineEnd = m_document->m_lineIndex.m_getLineEnd(line);
+		drawEnd = lineEnd;
+
+		if (!m_wrap && lineEnd - index > ColumnCheckpoints::s_interval)
+		{
+			if (columnStartVal > 0)
+			{
+				const auto [firstIndex, firstColumn] = m_getIndexAtColumn(line, columnStartVal);
+
+				index = firstIndex;
+				t = firstColumn - columnStartVal;
+				currColumnCount = firstColumn;
+			}
+
+			drawEnd = m_getIndexAtColumn(line, columnStartVal + m_width).first;
+		}
 
-	const auto searchStrSize = searchStr.size();
-	SizeType searchIndex = std::wstring::npos;
+		m_drawnRows[i] = { line, m_wrap ? currColumnCount - t : columnStartVal, 0 };
 
-	for (auto index = consoleStartIndex; index < m_inputBuffer.size(); ++index)
+		return index;
+	};
+
+	// cells [cell, cell + count) of the current row show the characters from index on, one per cell if increment is set,
+	// skipped cells before them belong to the first one
+	const auto setCells = [&] (const SizeType cell, const SizeType count, const SizeType index, const bool increment)
+	{
+		auto& row = m_drawnRows[i];
+
+		const auto first = m_cellIndices.begin() + i * m_width;
+
+		std::fill(first + row.m_cellCount, first + cell, index);
+
+		if (increment) std::iota(first + cell, first + cell + count, index);
+		else std::fill(first + cell, first + cell + count, index);
+
+		row.m_cellCount = cell + count;
+	};
+
+	const auto setCursorPos = [&] (const SizeType column)
+	{
+		m_cursorPos = { static_cast<short>(m_drawStartX + (m_wrap ? column : std::min(column, m_width / 2))), static_cast<short>(m_drawStartY + i) };
+	};
+
+	for (auto index = startLine(consoleStartIndex); index < m_document->m_text.size(); ++index)
 	{
-		if (index == m_currentIndex)
+		if (index == drawEnd && drawEnd < lineEnd)
 		{
-			m_cursorPos = { static_cast<short>(m_drawStartX + std::min(t, m_width / 2)), static_cast<short>(m_drawStartY + i) };
+			// nothing after the last drawn column of a long line is visible
+			if (index <= m_currentIndex && m_currentIndex < lineEnd) setCursorPos(t);
+
+			index = lineEnd;
 		}
 
-		if (searchStrSize > 0 && index + searchStrSize < m_inputBuffer.size())
+		const auto character = m_document->m_text[index]; 
+
+		// a character that does not fit starts the next row, newlines take one column for the cursor
+		if (m_wrap && t > 0 && t + s_getCharWidth(character) > m_width)
 		{
-			if (searchStr == std::wstring_view{ m_inputBuffer.c_str() + index, searchStrSize })
-			{
-				searchIndex = index;
-			}
+			if (++i >= m_height) return;
+
+			t = 0;
+
+			m_drawnRows[i] = { line, currColumnCount, 0 };
 		}
 
+		if (index == m_currentIndex) setCursorPos(t);
+
 		const auto consoleIndex = console.m_getIndex(m_drawStartX + t, m_drawStartY + i);
-		const auto character = m_inputBuffer.at(index); 
 
 		switch (character)
 		{
 		case L'\n':
 	
+			// newlines and tabs show blank cells, they are kept for the cursors and the highlights on them
+			if (t < m_width && currColumnCount >= columnStartVal) setCells(t, 1, index, false);
+
 			if (++i >= m_height) return;
 			
 			t = 0;
 			currColumnCount = 0;
+			++line;
+
+			index = startLine(index + 1) - 1;
 			
 			break;
 		case L'\t':
-		
+		{
 			if ((currColumnCount += s_tabSize) <= columnStartVal) break;
 
-			if (columnStartVal + s_tabSize < currColumnCount) t += s_tabSize;    
-			else t += currColumnCount - columnStartVal;
+			const auto tabWidth = std::min(s_tabSize, currColumnCount - columnStartVal);
+
+			if (t < m_width) setCells(t, std::min(tabWidth, m_width - t), index, false);
+
+			t += tabWidth;
 			
 			break;
+		}
 		default:
-		
-			if (t < m_width && ++currColumnCount > columnStartVal)
+		{
+			const auto charWidth = UnicodeProperties::s_getWidth(character);
+
+			// the console has one character per cell, combining marks are not drawn on their own
+			if (charWidth == 0 || t >= m_width) break;
+
+			const auto column = currColumnCount;
+
+			if ((currColumnCount += charWidth) <= columnStartVal) break;
+
+			if (charWidth == 1)
 			{
-				auto color = m_textColor;
+				// the narrow characters after this one are copied as one run
+				const auto runLimit = std::min(index + (m_width - t), drawEnd);
 
-				if (m_selectionInProgress)
-				{
-					const auto [min, max] = utils::GetMinMax(m_currentIndex, m_selectionStartIndex);
+				auto runEnd = index + 1;
 
-					if (min <= index && index <= max)
-					{
-						color |= Console::s_backgroundWhite;
-					}
+				while (runEnd < runLimit && m_document->m_text[runEnd] != L'\t' && UnicodeProperties::s_getWidth(m_document->m_text[runEnd]) == 1) ++runEnd;
 
-				}
-		
-				console.m_setGrid(consoleIndex, character, color);
-				
-				++t;
+				const auto runSize = runEnd - index;
+
+				console.m_copyChars(consoleIndex, m_document->m_text.data() + index, runSize);
+
+				setCells(t, runSize, index, true);
+
+				if (index < m_currentIndex && m_currentIndex < runEnd) setCursorPos(t + (m_currentIndex - index));
+
+				t += runSize;
+				currColumnCount += runSize - 1;
+				index = runEnd - 1;
+
+				break;
 			}
-			
-			break;
-		}
 
-		if (searchIndex != std::wstring::npos && index - searchIndex < searchStrSize)
-		{	
-			WORD color;
+			// a wide character cut by the left or the right edge of the view leaves blank cells
+			const auto hiddenWidth = column < columnStartVal ? columnStartVal - column : 0;
+			const auto drawnWidth  = std::min(charWidth - hiddenWidth, m_width - t);
 
-			if (searchIndex <= m_currentIndex && m_currentIndex <= searchIndex + searchStrSize)
+			if (drawnWidth == charWidth)
 			{
-				color = BACKGROUND_GREEN | BACKGROUND_BLUE;
+				console.m_fillCells(consoleIndex, charWidth, character, m_textColor);
+				m_wideCells.push_back(consoleIndex);
 			}
-			else color = BACKGROUND_RED | BACKGROUND_GREEN;
 
-			console.m_setColorAt(consoleIndex, console.m_getColorAt(consoleIndex) | color);
-		}
+			setCells(t, drawnWidth, index, false);
 
+			t += drawnWidth;
+			
+			break;
+		}
+		}
 	}
 }
 
-
-void TextEditor::m_deleteCharAt(const SizeType index) noexcept
+template<typename Function>
+void TextEditor::m_forRowCells(const Console& console, const SizeType row, const SizeType start, const SizeType end, Function&& function) const
 {
-	const auto it = m_inputBuffer.begin() + index;
+	// indices only grow along a row
+	const auto first = m_cellIndices.cbegin() + row * m_width;
+	const auto last  = first + m_drawnRows[row].m_cellCount;
 
-	m_writeDeletionRecord(m_currentIndex, { m_inputBuffer.at(index) }, std::iswcntrl(*it));
+	const auto spanStart = std::lower_bound(first, last, start);
+	const auto spanEnd   = std::lower_bound(spanStart, last, end);
 
-	if (*it == L'\n') --m_rowCount;
-			
-	m_inputBuffer.erase(it);
+	if (spanStart == spanEnd) return;
+
+	function(console.m_getIndex(m_drawStartX + (spanStart - first), m_drawStartY + row), static_cast<SizeType>(spanEnd - spanStart));
 }
 
-bool TextEditor::m_deleteIfSelected() noexcept
+template<typename Function>
+void TextEditor::m_forCells(const Console& console, const SizeType start, const SizeType end, Function&& function) const
 {
-	if (!m_selectionInProgress) return false;
-
-	const auto [min, max] = utils::GetMinMax(m_currentIndex, m_selectionStartIndex);
+	for (SizeType row = 0; row < m_drawnRows.size(); ++row)
+	{
+		const auto cellCount = m_drawnRows[row].m_cellCount;
 
-	m_writeDeletionRecord(min, m_inputBuffer.substr(min, max - min + 1));
+		if (cellCount == 0) continue;
 
-	m_deleteStartingFrom(min, max + 1);
+		const auto first = m_cellIndices.cbegin() + row * m_width;
 
-	m_selectionInProgress = false;
+		// rows show increasing indices
+		if (*first >= end) return;
 
-	return true;
+		if (*(first + cellCount - 1) >= start) m_forRowCells(console, row, start, end, function);
+	}
 }
 
-void TextEditor::m_deleteStartingFrom(const SizeType start, SizeType end) noexcept
-{	
-	if (end >= m_inputBuffer.size()) end = m_inputBuffer.size() - 1;
+void TextEditor::m_drawSyntaxColors(Console& console) noexcept
+{
+	const auto text = m_buffer();
 
-	const auto startIt = m_inputBuffer.cbegin() + start;
-	const auto endIt   = m_inputBuffer.cbegin() + end;
+	SizeType kindsLine = std::wstring::npos;
 
-	for (auto it = startIt; it != endIt; ++it)
+	for (SizeType row = 0; row < m_drawnRows.size(); ++row)
 	{
-		if (*it == L'\n') --m_rowCount;
-	}
+		const auto& drawnRow = m_drawnRows[row];
 
-	m_inputBuffer.erase(startIt, endIt);
-	m_currentIndex = start;
-}
+		if (drawnRow.m_cellCount == 0) continue;
 
-void TextEditor::m_insertChar(const wchar_t c) noexcept
-{
-	m_writeInsertionRecord(m_currentIndex, 1, std::iswcntrl(c));
+		// rows of a wrapped line share its kinds
+		if (drawnRow.m_line != kindsLine)
+		{
+			kindsLine = drawnRow.m_line;
+			m_document->m_highlighter.m_highlightLine(text, m_document->m_lineIndex, kindsLine, m_lineKinds);
+		}
 
-	m_inputBuffer.insert(m_inputBuffer.begin() + m_currentIndex, c);
+		if (m_lineKinds.empty()) continue;
 
-	++m_currentIndex;
-}
+		const auto lineStart = m_document->m_lineIndex.m_getLineStart(kindsLine);
 
-void TextEditor::m_insertUnsafeString(std::wstring str)
-{
-	// preprocess string before putting it to input buffer
-	for (auto it = str.cbegin(); it != str.cend();)
-	{
-		const auto element = *it;
+		const auto first = m_cellIndices.cbegin() + row * m_width;
+
+		// kinds of the indices the row shows, one span for every run of the same kind
+		auto runStart = *first - lineStart;
+		const auto rowEnd = std::min(*(first + drawnRow.m_cellCount - 1) + 1 - lineStart, m_lineKinds.size());
 
-		switch (element)
+		while (runStart < rowEnd)
 		{
-		case L'\n':
-		case L'\t':
-			++it;
-			break;
-		default:
+			const auto kind = m_lineKinds[runStart];
 
-			if (!std::iswprint(element))
+			auto runEnd = runStart + 1;
+
+			while (runEnd < rowEnd && m_lineKinds[runEnd] == kind) ++runEnd;
+
+			if (kind != SyntaxHighlighter::Kind::Text)
 			{
-				// delete element if it is not printable and it is not accepted
-				// as a control character
-				it = str.erase(it);
+				const auto color = m_getKindColor(kind);
+
+				m_forRowCells(console, row, lineStart + runStart, lineStart + runEnd, [&] (const SizeType cell, const SizeType count)
+				{
+					console.m_fillColor(cell, count, color);
+				});
 			}
-			else ++it;
 
-			break;
+			runStart = runEnd;
 		}
 	}
-
-	m_insertString(str);
 }
 
-void TextEditor::m_insertString(const std::wstring_view str)
-{	
-	SizeType index;
-	
+void TextEditor::m_drawSelections(Console& console) const noexcept
+{
+	const auto addColor = [&console] (const WORD color)
+	{
+		return [&console, color] (const SizeType cell, const SizeType count) { console.m_addColor(cell, count, color); };
+	};
+
+	// selections end with the whole grapheme cluster at their larger end
 	if (m_selectionInProgress)
 	{
-		index = std::min(m_currentIndex, m_selectionStartIndex);
+		const auto [min, max] = utils::GetMinMax(m_currentIndex, m_selectionStartIndex);
+
+		m_forCells(console, min, m_getClusterEnd(max), addColor(Console::s_backgroundWhite));
 	}
-	else index = m_currentIndex;
 
-	m_insertString(str, index);
+	const auto isDrawn = [] (const DrawnRow& row) { return row.m_cellCount > 0; };
 
-	m_writeInsertionRecord(index, str.size());
-}
+	const auto firstRow = std::find_if(m_drawnRows.cbegin(), m_drawnRows.cend(), isDrawn);
 
-void TextEditor::m_insertString(const std::wstring_view str, const SizeType insertIndex)
-{	
-	m_deleteIfSelected();
-	
-	m_rowCount += std::count(m_inputBuffer.cbegin(), m_inputBuffer.cend(), L'\n');
+	if (firstRow == m_drawnRows.cend()) return;
 
-	const auto secondPartSize = m_inputBuffer.size() - insertIndex;
+	const auto lastRow = std::find_if(m_drawnRows.crbegin(), m_drawnRows.crend(), isDrawn);
 
-	m_inputBuffer.resize(m_inputBuffer.size() + str.size());
-	
-	for (SizeType i = 0; i < secondPartSize; ++i)
+	const auto firstRowIndex = static_cast<SizeType>(firstRow - m_drawnRows.cbegin());
+	const auto lastRowIndex  = static_cast<SizeType>(m_drawnRows.crend() - lastRow) - 1;
+
+	const auto viewStart = m_cellIndices[firstRowIndex * m_width];
+	const auto viewEnd   = m_cellIndices[lastRowIndex  * m_width + lastRow->m_cellCount - 1] + 1;
+
+	// extra cursors are sorted, only the ones that reach into the view are drawn
+	auto extraCursor = std::partition_point(m_extraCursors.cbegin(), m_extraCursors.cend(), [&] (const Cursor& cursor)
 	{
-		const auto index = insertIndex + (secondPartSize - i - 1);
+		return std::max(cursor.m_index, cursor.m_selectionStart) < viewStart;
+	});
 
-		m_inputBuffer.at(index + str.size()) = m_inputBuffer.at(index);
-	}
-	
-	for (SizeType i = 0; i < str.size(); ++i)
+	for (; extraCursor != m_extraCursors.cend() && std::min(extraCursor->m_index, extraCursor->m_selectionStart) < viewEnd; ++extraCursor)
 	{
-		m_inputBuffer.at(i + insertIndex) = str.at(i);
+		if (extraCursor->m_selected)
+		{
+			const auto [min, max] = utils::GetMinMax(extraCursor->m_index, extraCursor->m_selectionStart);
+
+			m_forCells(console, min, m_getClusterEnd(max), addColor(Console::s_backgroundWhite));
+		}
+		else
+		{
+			// the cursor is the first cell of its character
+			m_forCells(console, extraCursor->m_index, extraCursor->m_index + 1, [&console] (const SizeType cell, const SizeType)
+			{
+				console.m_addColor(cell, 1, s_extraCursorColor);
+			});
+		}
 	}
 
-	m_currentIndex = insertIndex + str.size();
-}
+	if (!m_blockSelection.has_value()) return;
 
-void TextEditor::m_replaceMatchsWith(const std::wstring_view keyStr, const std::wstring_view replaceStr) noexcept
-{
-	m_currentIndex = 0;
+	// a block without width still shows one column as its cursor
+	const auto leftColumn  = m_blockSelection->m_leftColumn();
+	const auto rightColumn = std::max(m_blockSelection->m_rightColumn(), leftColumn + 1);
 
-	while (m_selectNextString(keyStr))
+	for (SizeType row = 0; row < m_drawnRows.size(); ++row)
 	{
-		m_insertString(replaceStr);
+		const auto& drawnRow = m_drawnRows[row];
+
+		if (drawnRow.m_line < m_blockSelection->m_firstLine() || drawnRow.m_line > m_blockSelection->m_lastLine()) continue;
+
+		const auto cellStart = std::max(leftColumn, drawnRow.m_firstColumn) - drawnRow.m_firstColumn;
+		const auto cellEnd   = std::min(std::max(rightColumn, drawnRow.m_firstColumn) - drawnRow.m_firstColumn, drawnRow.m_cellCount);
+
+		if (cellStart < cellEnd)
+		{
+			console.m_addColor(console.m_getIndex(m_drawStartX + cellStart, m_drawStartY + row), cellEnd - cellStart, Console::s_backgroundWhite);
+		}
 	}
 }
 
-namespace
+void TextEditor::m_drawSearchMatches(Console& console, const TextSearch& search) const noexcept
 {
+	if (search.m_empty()) return;
 
-	[[nodiscard]] constexpr auto GetWordMoveFunctor() noexcept
+	const auto text = m_buffer();
+	const auto searchStrSize = search.m_size();
+
+	for (SizeType row = 0; row < m_drawnRows.size(); ++row)
 	{
-		return [findedWord = false] (const wchar_t element) mutable
+		const auto cellCount = m_drawnRows[row].m_cellCount;
+
+		if (cellCount == 0) continue;
+
+		const auto rowStart = m_cellIndices[row * m_width];
+		const auto rowEnd   = m_cellIndices[row * m_width + cellCount - 1] + 1;
+
+		// a match that starts before the row may still reach into it
+		const auto searchEnd = std::min(rowEnd + searchStrSize - 1, text.size());
+
+		TextSearch::Cursor cursor(search, text, searchEnd);
+
+		for (auto match = cursor.m_findNext(rowStart - std::min(rowStart, searchStrSize - 1));
+			match < rowEnd; match = cursor.m_findNext(match + 1))
 		{
-			if (std::iswalnum(element))
+			WORD color;
+
+			if (match <= m_currentIndex && m_currentIndex <= match + searchStrSize)
 			{
-				findedWord = true;
+				color = BACKGROUND_GREEN | BACKGROUND_BLUE;
 			}
-			else if (findedWord) return true;
-			
-			return false;
-		};
-	}
+			else color = BACKGROUND_RED | BACKGROUND_GREEN;
 
+			m_forRowCells(console, row, match, match + searchStrSize, [&console, color] (const SizeType cell, const SizeType count)
+			{
+				console.m_addColor(cell, count, color);
+			});
+		}
+	}
 }
 
-void TextEditor::m_moveCursorOneWordLeft() noexcept
+
+void TextEditor::m_deleteCharAt(const SizeType index) noexcept
 {
-	const auto it = std::find_if(m_inputBuffer.crend() - m_currentIndex, m_inputBuffer.crend(), GetWordMoveFunctor());
+	// the whole grapheme cluster goes, a combining mark is never left without its base
+	const auto end = m_getClusterEnd(index);
 
-	if (it != m_inputBuffer.crend())
-	{
-		m_currentIndex = std::distance(m_inputBuffer.cbegin(), it.base());
-	}
-	else m_currentIndex = 0;
+	m_writeDeletionRecord(m_currentIndex, m_document->m_text.substr(index, end - index), std::iswcntrl(m_document->m_text.at(index)));
 
+	m_onBufferErase(index, end);
+			
+	m_document->m_text.erase(index, end - index);
 }
-void TextEditor::m_moveCursorOneWordRight() noexcept
+
+bool TextEditor::m_deleteIfSelected() noexcept
 {
-	const auto it = std::find_if(m_inputBuffer.cbegin() + m_currentIndex + 1, m_inputBuffer.cend(), GetWordMoveFunctor());
+	if (!m_selectionInProgress) return false;
 
-	if (it != m_inputBuffer.cend())
-	{
-		m_currentIndex = std::distance(m_inputBuffer.cbegin(), it) - 1;
-	}
-	else m_currentIndex = m_inputBuffer.size() - 1;
-}
+	const auto [min, max] = utils::GetMinMax(m_currentIndex, m_selectionStartIndex);
 
-void TextEditor::m_moveCursorOneLineDown() noexcept
-{
-	SizeType colCount = 0;
+	const auto end = m_getClusterEnd(max);
 
-	for (auto it = m_inputBuffer.crend() - m_currentIndex; it != m_inputBuffer.crend(); ++it)
-	{
-		if (*it == L'\n') break;
+	m_writeDeletionRecord(min, m_document->m_text.substr(min, end - min));
 
-		++colCount;
-	}
+	m_deleteStartingFrom(min, end);
 
-	auto newLineIndex = m_currentIndex;
+	m_selectionInProgress = false;
 
-	while (m_inputBuffer.at(newLineIndex++) != L'\n')
-	{
-		if (newLineIndex >= m_inputBuffer.size()) return;
-	}
+	return true;
+}
 
-	const auto size = std::min(newLineIndex + colCount, m_inputBuffer.size() - 1);
+void TextEditor::m_deleteStartingFrom(const SizeType start, SizeType end) noexcept
+{	
+	if (end >= m_document->m_text.size()) end = m_document->m_text.size() - 1;
 
-	auto i = newLineIndex;
+	const auto startIt = m_document->m_text.cbegin() + start;
+	const auto endIt   = m_document->m_text.cbegin() + end;
 
-	for (; i < size; ++i)
-	{
-		if (m_inputBuffer.at(i) == L'\n') break;
-	}
+	m_onBufferErase(start, end);
 
-	m_currentIndex = i;
+	m_document->m_text.erase(startIt, endIt);
+	m_currentIndex = start;
 }
 
-void TextEditor::m_moveCursorOneLineUp() noexcept
+void TextEditor::m_insertChar(const wchar_t c) noexcept
 {
-	if (m_currentIndex == 0) return;
+	m_writeInsertionRecord(m_currentIndex, 1, std::iswcntrl(c));
 
-	const auto firstNewLineIndex = m_inputBuffer.rfind(L'\n', m_currentIndex - 1);
+	m_onBufferInsert(m_currentIndex, { &c, 1 });
 
-	if (firstNewLineIndex == 0) { m_currentIndex = 0; return; }
-	if (firstNewLineIndex == std::wstring::npos) return;
+	m_document->m_text.insert(m_document->m_text.begin() + m_currentIndex, c);
 
-	const auto columnCount = m_currentIndex - firstNewLineIndex;
-	const auto secondNewLineIndex = m_inputBuffer.rfind(L'\n', firstNewLineIndex - 1);
+	++m_currentIndex;
+}
 
-	if (secondNewLineIndex == std::wstring::npos)
-	{
-		m_currentIndex = std::min(firstNewLineIndex, columnCount - 1);
-	}
-	else if (secondNewLineIndex == firstNewLineIndex - 1)
-	{
-		m_currentIndex = firstNewLineIndex;
-	}
-	else
+namespace
+{
+
+	[[nodiscard]] bool IsInsertableChar(const wchar_t c) noexcept
 	{
-		m_currentIndex = std::min(firstNewLineIndex, secondNewLineIndex + columnCount);
+		// printable ascii is the common case, skip the locale lookup for it
+		if (c >= L' ' && c <= L'~') return true;
+
+		return c == L'\n' || c == L'\t' || std::iswprint(c);
 	}
 
-}
+} // namespace
 
+void TextEditor::m_insertUnsafeString(std::wstring str)
+{
+	m_syncView();
 
+	// drop characters that are not printable and not accepted as 
+	// a control character, in one pass without moving the tail per character
+	str.erase(std::remove_if(str.begin(), str.end(), [] (const wchar_t c) { return !IsInsertableChar(c); }), str.end());
+
+	if (m_blockSelection.has_value())
+	{
+		m_pasteIntoBlock(str);
+		return;
+	}
+
+	if (!m_extraCursors.empty())
+	{
+		m_editAtCursors(CursorEdit::Insert, str);
+		return;
+	}
+
+	m_insertString(str);
+}
+
+void TextEditor::m_pasteClipboard()
+{
+	Console::s_useUserClipboard([this] (const std::wstring_view data)
+	{
+		m_deleteIfSelected();
+
+		const auto index = m_currentIndex;
+
+		// the index reads the buffer in the background, it has to stop before the buffer changes
+		m_document->m_trigramIndex.m_clear();
+
+		// clipboard text is filtered straight into the buffer without an intermediate copy
+		m_document->m_text.insert(index, data.size(), L'\0');
+
+		const auto begin = m_document->m_text.begin() + static_cast<std::ptrdiff_t>(index);
+		const auto end   = std::copy_if(data.cbegin(), data.cend(), begin, IsInsertableChar);
+
+		const auto size = static_cast<SizeType>(end - begin);
+
+		m_document->m_text.erase(end, begin + static_cast<std::ptrdiff_t>(data.size()));
+
+		m_onBufferInsert(index, { m_document->m_text.c_str() + index, size });
+
+		m_currentIndex = index + size;
+
+		m_writeInsertionRecord(index, size);
+	});
+}
+
+void TextEditor::m_insertString(const std::wstring_view str)
+{	
+	m_syncView();
+
+	m_resetCursors();
+
+	SizeType index;
+	
+	if (m_selectionInProgress)
+	{
+		index = std::min(m_currentIndex, m_selectionStartIndex);
+	}
+	else index = m_currentIndex;
+
+	m_insertString(str, index);
+
+	m_writeInsertionRecord(index, str.size());
+}
+
+void TextEditor::m_insertString(const std::wstring_view str, const SizeType insertIndex)
+{	
+	m_deleteIfSelected();
+
+	m_onBufferInsert(insertIndex, str);
+
+	m_document->m_text.insert(insertIndex, str.data(), str.size());
+
+	m_currentIndex = insertIndex + str.size();
+}
+
+void TextEditor::m_replaceMatchsWith(const TextSearch& search, const std::wstring_view replaceStr) noexcept
+{
+	m_syncView();
+
+	if (search.m_empty()) return;
+
+	m_replaceMatchesAt(m_findAll(search), search.m_size(), replaceStr);
+}
+
+void TextEditor::m_replaceMatchesAt(const std::vector<SizeType>& starts, const SizeType size, const std::wstring_view replaceStr) noexcept
+{
+	m_syncView();
+
+	if (starts.empty()) return;
+
+	std::vector<Replacement> replacements;
+	replacements.reserve(starts.size());
+
+	for (const auto start : starts) replacements.push_back({ start, start + size, replaceStr });
+
+	m_resetCursors();
+	m_selectionInProgress = false;
+
+	// every match is replaced in one pass over the buffer and undone at once
+	BatchRecord record;
+
+	const auto newStarts = m_applyReplacements(replacements, &record);
+
+	m_document->m_records.emplace_back(std::move(record));
+	m_resizeRecordsIfNeeded();
+
+	m_currentIndex = newStarts.back() + replaceStr.size();
+	m_lastEvent = EventType::Keyboard;
+}
+
+namespace
+{
+
+	// a word is a run of grapheme clusters of the same class, the class of a cluster is the one of its first code point
+	[[nodiscard]] UnicodeProperties::WordBreak GetWordClass(const std::wstring_view text, const std::size_t index) noexcept
+	{
+		return UnicodeProperties::s_getWordBreak(UnicodeProperties::s_decode(text, index).first);
+	}
+
+}
+
+void TextEditor::m_moveCursorOneWordLeft() noexcept
+{
+	using WordBreak = UnicodeProperties::WordBreak;
+
+	const auto text = m_buffer();
+
+	auto index = std::min(m_currentIndex, text.size());
+	auto wordClass = WordBreak::Other;
+
+	// skips the clusters before the word, then the word up to its start
+	while (index > 0)
+	{
+		const auto previous = UnicodeProperties::s_getPreviousGraphemeBreak(text, index);
+		const auto previousClass = GetWordClass(text, previous);
+
+		if (wordClass != WordBreak::Other && previousClass != wordClass) break;
+
+		wordClass = previousClass;
+		index = previous;
+	}
+
+	m_currentIndex = index;
+}
+void TextEditor::m_moveCursorOneWordRight() noexcept
+{
+	using WordBreak = UnicodeProperties::WordBreak;
+
+	const auto text = m_buffer();
+
+	auto index = UnicodeProperties::s_getNextGraphemeBreak(text, m_currentIndex);
+	auto last  = index;
+	auto wordClass = WordBreak::Other;
+
+	// lands on the last cluster of the next word
+	while (index < text.size())
+	{
+		const auto currentClass = GetWordClass(text, index);
+
+		if (wordClass != WordBreak::Other && currentClass != wordClass) break;
+
+		wordClass = currentClass;
+		last  = index;
+		index = UnicodeProperties::s_getNextGraphemeBreak(text, index);
+	}
+
+	m_currentIndex = wordClass != WordBreak::Other ? last : text.size();
+}
+
+void TextEditor::m_moveCursorOneLineDown() noexcept
+{
+	if (m_wrap) { m_moveCursorOneRowDown(); return; }
+
+	const auto line = m_document->m_lineIndex.m_getLineOf(m_currentIndex);
+
+	if (line + 1 >= m_document->m_lineIndex.m_getLineCount()) return;
+
+	m_currentIndex = m_getIndexAtColumn(line + 1, m_getColumnOf(m_currentIndex)).first;
+}
+
+void TextEditor::m_moveCursorOneLineUp() noexcept
+{
+	if (m_wrap) { m_moveCursorOneRowUp(); return; }
+
+	const auto line = m_document->m_lineIndex.m_getLineOf(m_currentIndex);
+
+	if (line == 0) return;
+
+	m_currentIndex = m_getIndexAtColumn(line - 1, m_getColumnOf(m_currentIndex)).first;
+}
+
+
+
+bool TextEditor::m_readFile(const std::wstring_view filePath, WorkerPool::Job* job) noexcept
+{
+	m_syncView();
 
-bool TextEditor::m_readFile(const std::wstring_view filePath) noexcept
-{
 	std::FILE* file = nullptr;
 	if (_wfopen_s(&file, filePath.data(), L"r, ccs=UTF-8") || !file) return false;
 
-	m_inputBuffer.clear();
+	// characters are counted as bytes, it is exact for ascii text
+	if (job != nullptr) job->m_setTotal(s_getFileSize(filePath));
+
+	m_document->m_trigramIndex.m_clear();
+
+	m_document->m_text.clear();
 	
 	m_selectionInProgress = false;
 	m_currentIndex = 0;
-	m_rowCount = 1;
 
-	std::wint_t c;
+	// fgetwc locks the stream for every character, read decoded text in chunks instead
+	std::vector<wchar_t> chunk(1 << 16);
+	std::size_t readCount = 0;
+
+	while ((readCount = std::fread(chunk.data(), sizeof(wchar_t), chunk.size(), file)) > 0)
+	{
+		std::copy_if(chunk.cbegin(), chunk.cbegin() + static_cast<std::ptrdiff_t>(readCount), std::back_inserter(m_document->m_text), IsInsertableChar);
+
+		if (job == nullptr) continue;
+
+		job->m_addDone(readCount);
+
+		if (job->m_isCancelled())
+		{
+			std::fclose(file);
+			return false;
+		}
+	}
 	
-	while ((c = std::fgetwc(file)) != WEOF)
+	m_document->m_text.push_back(L' ');
+
+	// taken right after the end was read, a file that grows meanwhile is followed from there
+	m_document->m_fileSize = s_getFileSize(filePath);
+
+	std::fclose(file);
+
+	m_onBufferReset();
+
+	m_document->m_savedVersion = m_getVersion();
+
+	switch (m_indexMode)
+	{
+	case IndexMode::Memory:
+		m_document->m_trigramIndex.m_build(m_buffer());
+		break;
+	case IndexMode::Persistent:
+		m_document->m_trigramIndex.m_build(m_buffer(), std::wstring(filePath) + L".trigram");
+		break;
+	case IndexMode::None:
+		break;
+	}
+
+	return true;
+}
+
+namespace
+{
+
+	// writes size characters, copyText(start, end, chunk) puts the characters [start, end) into chunk,
+	// with a job the file is written next to path and replaces it only once it is complete
+	template<typename CopyText>
+	[[nodiscard]] bool WriteText(const std::wstring_view filePath, const std::size_t size, CopyText copyText, WorkerPool::Job* job) noexcept
 	{
-		switch (c)
+		if (size <= 2) return false;
+
+		// a cancelled or failed write must not leave the file cut off
+		const auto writePath = job != nullptr ? std::wstring(filePath) + L".saving" : std::wstring(filePath);
+
+		std::FILE* file = nullptr;
+		if (_wfopen_s(&file, writePath.c_str(), L"w+, ccs=UTF-8") || !file) return false;
+
+		// _wfopen_s adds BOM to start of the file
+		// could not find a way to close it
+		std::rewind(file); // dirty but works
+
+		if (job != nullptr) job->m_setTotal(size);
+
+		// fputws takes null terminated strings, the text is written in pieces that do not split a surrogate pair
+		constexpr std::size_t chunkSize = 1 << 16;
+
+		std::wstring chunk;
+
+		bool written = true;
+
+		for (std::size_t start = 0; start < size && written; )
 		{
-		case L'\n':
-			++m_rowCount;
-		case L'\t':
-			m_inputBuffer.push_back(c);
-			break;
-		default:
+			auto end = std::min(size, start + chunkSize);
 
-			if (std::iswprint(c))
+			chunk.clear();
+
+			// a snapshot allocates while it is copied, a failed copy fails the write like a failed fputws
+			try
 			{
-				m_inputBuffer.push_back(c);
+				copyText(start, end, chunk);
 			}
-			break;
+			catch (...)
+			{
+				written = false;
+				break;
+			}
+
+			if (end < size && IS_HIGH_SURROGATE(chunk.back()))
+			{
+				chunk.pop_back();
+				--end;
+			}
+
+			written = std::fputws(chunk.c_str(), file) >= 0;
+
+			if (job != nullptr)
+			{
+				job->m_addDone(end - start);
+
+				if (job->m_isCancelled()) written = false;
+			}
+
+			start = end;
 		}
+
+		written = std::fclose(file) == 0 && written;
+
+		if (job == nullptr) return written;
+
+		if (written && MoveFileExW(writePath.c_str(), std::wstring(filePath).c_str(), MOVEFILE_REPLACE_EXISTING)) return true;
+
+		DeleteFileW(writePath.c_str());
+
+		return false;
 	}
-	
-	m_inputBuffer.push_back(L' ');
 
-	std::fclose(file);
+} // namespace
+
+bool TextEditor::m_writeFile(const std::wstring_view filePath) const noexcept
+{
+	const auto& text = m_document->m_text;
+
+	// the text is written with its trailing space
+	if (!WriteText(filePath, text.size(), [&] (const SizeType start, const SizeType end, std::wstring& chunk) { chunk.append(text, start, end - start); }, nullptr)) return false;
+
+	m_document->m_savedVersion = m_getVersion();
+	m_document->m_fileSize     = s_getFileSize(filePath);
 
 	return true;
 }
 
-bool TextEditor::m_writeFile(const std::wstring_view filePath) const noexcept
+[[nodiscard]] bool TextEditor::s_writeSnapshot(const std::wstring_view filePath, const TextSnapshot& snapshot, WorkerPool::Job& job) noexcept
 {
-	if (m_inputBuffer.size() <= 2) return false;
+	const auto size = snapshot.m_getSize();
 
-	std::FILE* file = nullptr;
-	if (_wfopen_s(&file, filePath.data(), L"w+, ccs=UTF-8") || !file) return false;
-	
-	// _wfopen_s adds BOM to start of the file
-	// could not find a way to close it
-	std::rewind(file); // dirty but works
+	// the snapshot has no trailing space, it is added the way m_writeFile writes it
+	const auto copyText = [&] (const SizeType start, const SizeType end, std::wstring& chunk)
+	{
+		snapshot.m_copy(start, end, chunk);
 
-	std::fputws(m_inputBuffer.c_str(), file);
+		if (end > size) chunk.push_back(L' ');
+	};
 
-	std::fclose(file);
+	return WriteText(filePath, size + 1, copyText, &job);
+}
 
-	return true;
+[[nodiscard]] TextEditor::SizeType TextEditor::s_getFileSize(const std::wstring_view filePath) noexcept
+{
+	WIN32_FILE_ATTRIBUTE_DATA attributes = {};
+
+	if (!GetFileAttributesExW(filePath.data(), GetFileExInfoStandard, &attributes)) return 0;
+
+	return (static_cast<SizeType>(attributes.nFileSizeHigh) << 32) | attributes.nFileSizeLow;
 }
 
 void TextEditor::m_writeInsertionRecord(const SizeType index, const SizeType size, const bool createNew) noexcept
 {
-	if (!m_records.empty() && !createNew)
+	if (!m_document->m_records.empty() && !createNew)
 	{
-		auto& last = m_records.back();
+		auto& last = m_document->m_records.back();
 
 		if (std::holds_alternative<InsertionRecord>(last))
 		{
@@ -777,16 +1316,16 @@ void TextEditor::m_writeInsertionRecord(const SizeType index, const SizeType siz
 		
 	}
 
-	m_records.emplace_back(InsertionRecord{ index, size });
+	m_document->m_records.emplace_back(InsertionRecord{ index, size });
 
 	m_resizeRecordsIfNeeded();
 }
 
 void TextEditor::m_writeDeletionRecord(const SizeType index, std::wstring&& str, const bool createNew) noexcept
 {	
-	if (!m_records.empty() && !createNew && str.size() == 1)
+	if (!m_document->m_records.empty() && !createNew)
 	{
-		auto& last = m_records.back();
+		auto& last = m_document->m_records.back();
 
 		if (std::holds_alternative<DeletionRecord>(last))
 		{
@@ -798,7 +1337,7 @@ void TextEditor::m_writeDeletionRecord(const SizeType index, std::wstring&& str,
 				return;
 			}
 
-			if (index + 1 == value.m_index)
+			if (index + str.size() == value.m_index)
 			{
 				value.m_data = str + value.m_data;
 				value.m_index = index;
@@ -807,7 +1346,7 @@ void TextEditor::m_writeDeletionRecord(const SizeType index, std::wstring&& str,
 		}
 	}
 
-	m_records.emplace_back(DeletionRecord{ index, std::forward<std::wstring>(str) });
+	m_document->m_records.emplace_back(DeletionRecord{ index, std::forward<std::wstring>(str) });
 
 	m_resizeRecordsIfNeeded();
 }
@@ -816,46 +1355,47 @@ void TextEditor::m_resizeRecordsIfNeeded() noexcept
 {
 	constexpr SizeType maxLimit = 100;
 
-	if (m_records.size() > maxLimit)
+	if (m_document->m_records.size() > maxLimit)
 	{
-		m_records.erase(m_records.begin(), m_records.begin() + m_records.size() - maxLimit);
+		m_document->m_records.erase(m_document->m_records.begin(), m_document->m_records.begin() + m_document->m_records.size() - maxLimit);
 	}
 }
 
 
 [[nodiscard]] TextEditor::SizeType TextEditor::m_getIndexAtPos(const SizeType x, const SizeType y) const noexcept
 {
-	const auto startIndex = m_getConsoleStartIndex();
+	const auto column = std::max(x, m_drawStartX) - m_drawStartX;
+	const auto row    = std::max(y, m_drawStartY) - m_drawStartY;
 
-	auto i = startIndex;
+	if (m_wrap)
+	{
+		const auto visualRow = m_getStartVisualRow() + row;
 
-	auto currentX = m_drawStartX;
-	auto currentY = m_drawStartY;
+		if (visualRow >= m_wrapLayout.m_getRowCount()) return m_document->m_text.size() - 1;
 
-	for (; i < m_inputBuffer.size() - 1; ++i)
-	{
-		if (currentX == x && currentY == y) break;
+		const auto [line, subRow] = m_wrapLayout.m_getLineAt(visualRow);
 
-		switch (m_inputBuffer.at(i))
-		{
-		case L'\n':
-			currentX = 0;
-			if (++currentY > y) return i;
-			break;
-		case L'\t':
-			currentX += s_tabSize;
-			break;
-		default:
-			++currentX;
-			break;
-		}
+		return m_getIndexAtRowColumn(line, subRow, column);
 	}
 
-	return i;
+	if (m_startRow + row >= m_document->m_lineIndex.m_getLineCount()) return m_document->m_text.size() - 1;
+
+	return m_getIndexAtColumn(m_startRow + row, column).first;
 }
 
-constexpr void TextEditor::m_updateStartRow() noexcept
+void TextEditor::m_updateStartRow() noexcept
 {
+	if (m_wrap)
+	{
+		const auto cursorRow = m_wrapLayout.m_getFirstRow(m_document->m_lineIndex.m_getLineOf(m_currentIndex)) + m_getRowColumnOf(m_currentIndex).first;
+		const auto startRow  = m_getStartVisualRow();
+
+		if (cursorRow >= startRow + m_height) m_setStartVisualRow(cursorRow - m_height + 1);
+		else if (cursorRow < startRow) m_setStartVisualRow(cursorRow);
+
+		return;
+	}
+
 	const auto rowCount = m_getRowCountUntil(m_currentIndex);
 
 	if (rowCount > m_startRow + m_height)
@@ -868,165 +1408,1472 @@ constexpr void TextEditor::m_updateStartRow() noexcept
 	}
 }
 
-[[nodiscard]] constexpr TextEditor::SizeType TextEditor::m_getConsoleStartIndex() const noexcept
+[[nodiscard]] TextEditor::SizeType TextEditor::m_getConsoleStartIndex() const noexcept
 {
-	SizeType result = 0;
-
-	if (m_startRow > 0)
-	{
-		SizeType currentRow = 0;
-		
-		for (const auto& element : m_inputBuffer)
-		{
-			++result;
+	if (m_wrap) return m_getIndexAtRowColumn(m_startRow, m_getStartVisualRow() - m_wrapLayout.m_getFirstRow(m_startRow), 0);
 
-			if (element == L'\n')
-			{
-				if (m_startRow == ++currentRow) break;    
-			}
-		}
-
-	}
-
-	return result;
+	return m_document->m_lineIndex.m_getLineStart(m_startRow);
 }
 
-[[nodiscard]] constexpr TextEditor::SizeType TextEditor::m_getConsoleColumnStartIndex(const SizeType consoleStartIndex) const noexcept
+[[nodiscard]] TextEditor::SizeType TextEditor::m_getConsoleColumnStartIndex(const SizeType consoleStartIndex) const noexcept
 {
-	if (m_lastEvent != EventType::Keyboard) return 0;
-
-	SizeType result = 0;
+	if (m_lastEvent != EventType::Keyboard || m_wrap || m_currentIndex < consoleStartIndex) return 0;
 
-	for (auto i = consoleStartIndex; i < m_currentIndex; ++i)
-	{
-		switch (m_inputBuffer.at(i))
-		{
-		case L'\n':
-			result = 0;
-			break;
-		case L'\t':
-			result += s_tabSize;
-			break;
-		default:
-			++result;
-			break;
-		}
-	}
+	const auto result = m_getColumnOf(m_currentIndex);
 
 	if (result >= m_width / 2) return result - m_width / 2 + 1;
 
 	return 0;
 }
 
-[[nodiscard]] constexpr TextEditor::SizeType TextEditor::m_getRowCountUntil(const SizeType index) const noexcept
+[[nodiscard]] TextEditor::SizeType TextEditor::m_getRowCountUntil(const SizeType index) const noexcept
 {
-	SizeType result = 1;
+	return m_document->m_lineIndex.m_getLineOf(index) + 1;
+}
 
-	for (SizeType i = 0; i < index; ++i)
+void TextEditor::m_scrollOneUp() noexcept
+{
+	if (!m_wrap)
 	{
-		if (m_inputBuffer.at(i) == L'\n') ++result;
+		if (m_startRow > 0) --m_startRow;
+		return;
 	}
 
-	return result;
-}
+	m_updateWrapLayout();
 
-constexpr void TextEditor::m_handleSelection(const SizeType start) noexcept
-{
-	m_selectionInProgress = true;
-	m_selectionStartIndex = start;
+	const auto startRow = m_getStartVisualRow();
 
-	const auto diff = utils::GetSignedDiff(m_currentIndex, start);
+	if (startRow > 0) m_setStartVisualRow(startRow - 1);
+}
 
-	if (diff == 1 || diff == -1)
+void TextEditor::m_scrollOneDown() noexcept
+{
+	if (!m_wrap)
 	{
-		m_currentIndex -= diff;
+		if (m_startRow + m_height < m_document->m_lineIndex.m_getLineCount()) ++m_startRow;
+		return;
 	}
-}
 
-constexpr void TextEditor::m_handleSelection(const SizeType start, const SizeType end) noexcept
-{   
-	m_selectionInProgress = true;
-	m_selectionStartIndex = start;
-	m_currentIndex = std::min(end, m_inputBuffer.size() - 1);
+	m_updateWrapLayout();
+
+	const auto startRow = m_getStartVisualRow();
+
+	if (startRow + m_height < m_wrapLayout.m_getRowCount()) m_setStartVisualRow(startRow + 1);
 }
 
-bool TextEditor::m_selectNextString(const std::wstring_view str) noexcept
+void TextEditor::m_setWrap(const bool wrap) noexcept
 {
-	if (str.empty() || str.size() > m_inputBuffer.size()) return false;
+	m_syncView();
 
-	auto i = m_currentIndex;
-	
-	if (str.size() == 1) ++i;
+	m_wrap = wrap;
+	m_startSubRow = 0;
 
-	for (; str != std::wstring_view{ m_inputBuffer.c_str() + i, str.size() }; ++i)
-	{
-		if (i >= m_inputBuffer.size() - str.size()) return false;
+	// built again on the next draw, it is not kept up to date while wrapping is off
+	m_wrapLayout.m_clear();
+
+	m_lastEvent = EventType::Keyboard;
+}
+
+void TextEditor::m_updateWrapLayout()
+{
+	if (!m_wrap) return;
+
+	std::optional<std::vector<BufferEdit>> edits;
+
+	if (m_wrapLayout.m_getWidth() == m_width) edits = m_getEditsSince(m_wrapVersion);
+
+	m_wrapVersion = m_getVersion();
+
+	if (!edits.has_value())
+	{
+		m_wrapLayout.m_build(m_buffer(), m_document->m_lineIndex, m_width, s_tabSize);
+		return;
 	}
 
-	m_handleSelection(i, i + str.size() - 1);
+	if (edits->empty()) return;
 
-	return true;
+	for (const auto& edit : edits.value())
+	{
+		m_wrapLayout.m_spliceLines(edit.m_line, edit.m_removedLines, edit.m_insertedLines);
+	}
+
+	m_wrapLayout.m_measureChangedLines(m_buffer(), m_document->m_lineIndex);
+}
+
+[[nodiscard]] TextEditor::SizeType TextEditor::m_getStartVisualRow() const noexcept
+{
+	// edits may have left m_startRow with fewer rows
+	return m_wrapLayout.m_getFirstRow(m_startRow) + std::min(m_startSubRow, m_wrapLayout.m_getRowsOf(m_startRow) - 1);
+}
+
+void TextEditor::m_setStartVisualRow(const SizeType row) noexcept
+{
+	const auto [line, subRow] = m_wrapLayout.m_getLineAt(row);
+
+	m_startRow    = line;
+	m_startSubRow = subRow;
+}
+
+[[nodiscard]] std::pair<TextEditor::SizeType, TextEditor::SizeType> TextEditor::m_getRowColumnOf(const SizeType index) const noexcept
+{
+	m_syncColumnCheckpoints();
+
+	const auto& lineIndex = m_document->m_lineIndex;
+
+	const auto line = lineIndex.m_getLineOf(index);
+	const auto state = m_columnCheckpoints.m_getStateAt(m_buffer(), lineIndex.m_getLineStart(line), lineIndex.m_getLineEnd(line), index);
+
+	// the character at index may not fit on the row anymore
+	if (state.m_rowColumn > 0 && state.m_rowColumn + s_getCharWidth(m_document->m_text[index]) > m_width) return { state.m_row + 1, 0 };
+
+	return { state.m_row, state.m_rowColumn };
+}
+
+[[nodiscard]] TextEditor::SizeType TextEditor::m_getIndexAtRowColumn(const SizeType line, const SizeType row, const SizeType column) const noexcept
+{
+	m_syncColumnCheckpoints();
+
+	const auto lineEnd = m_document->m_lineIndex.m_getLineEnd(line);
+
+	const auto state = m_columnCheckpoints.m_getStateBeforeRow(m_buffer(), m_document->m_lineIndex.m_getLineStart(line), lineEnd, row);
+
+	auto currentRow    = state.m_row;
+	auto currentColumn = state.m_rowColumn;
+
+	for (auto i = state.m_index; i < lineEnd; ++i)
+	{
+		const auto charWidth = s_getCharWidth(m_document->m_text[i]);
+
+		if (currentColumn > 0 && currentColumn + charWidth > m_width)
+		{
+			if (currentRow == row) return UnicodeProperties::s_getPreviousGraphemeBreak(m_buffer(), i);
+
+			++currentRow;
+			currentColumn = 0;
+		}
+
+		if (currentRow == row && currentColumn + charWidth > column) return i;
+
+		currentColumn += charWidth;
+	}
+
+	// the line end went to the next row
+	if (currentRow == row && currentColumn > 0 && currentColumn + 1 > m_width) return UnicodeProperties::s_getPreviousGraphemeBreak(m_buffer(), lineEnd);
+
+	return lineEnd;
+}
+
+void TextEditor::m_moveCursorOneRowDown() noexcept
+{
+	m_updateWrapLayout();
+
+	const auto line = m_document->m_lineIndex.m_getLineOf(m_currentIndex);
+	const auto [row, column] = m_getRowColumnOf(m_currentIndex);
+
+	if (row + 1 < m_wrapLayout.m_getRowsOf(line))
+	{
+		m_currentIndex = m_getIndexAtRowColumn(line, row + 1, column);
+	}
+	else if (line + 1 < m_document->m_lineIndex.m_getLineCount())
+	{
+		m_currentIndex = m_getIndexAtRowColumn(line + 1, 0, column);
+	}
+}
+
+void TextEditor::m_moveCursorOneRowUp() noexcept
+{
+	m_updateWrapLayout();
+
+	const auto line = m_document->m_lineIndex.m_getLineOf(m_currentIndex);
+	const auto [row, column] = m_getRowColumnOf(m_currentIndex);
+
+	if (row > 0)
+	{
+		m_currentIndex = m_getIndexAtRowColumn(line, row - 1, column);
+	}
+	else if (line > 0)
+	{
+		m_currentIndex = m_getIndexAtRowColumn(line - 1, m_wrapLayout.m_getRowsOf(line - 1) - 1, column);
+	}
 }
 
-bool TextEditor::m_selectPreviousString(const std::wstring_view str) noexcept
+void TextEditor::m_setLanguageFor(const std::wstring_view filePath)
 {
-	if (str.empty() || str.size() > m_inputBuffer.size() || m_currentIndex < str.size()) return false;
+	m_document->m_highlighter.m_setLanguageFor(filePath);
 
-	auto i = m_currentIndex - str.size();
+	// the line states are built on the next update
+	m_document->m_highlightVersion = std::wstring::npos;
+}
+
+bool TextEditor::m_highlightInBackground()
+{
+	if (!m_document->m_highlighter.m_isEnabled()) return false;
+
+	m_updateHighlighter();
+
+	if (m_document->m_highlighter.m_isComplete()) return false;
+
+	const auto [first, last] = m_document->m_highlighter.m_lex(m_buffer(), m_document->m_lineIndex, std::wstring::npos, s_backgroundLexSize);
+
+	return first < m_highlightEndLine && last >= m_startRow;
+}
+
+void TextEditor::m_updateHighlighter()
+{
+	if (!m_document->m_highlighter.m_isEnabled()) return;
+
+	const auto edits = m_getEditsSince(m_document->m_highlightVersion);
+
+	m_document->m_highlightVersion = m_getVersion();
+
+	if (!edits.has_value())
+	{
+		m_document->m_highlighter.m_reset(m_document->m_lineIndex.m_getLineCount());
+		return;
+	}
+
+	for (const auto& edit : edits.value())
+	{
+		m_document->m_highlighter.m_spliceLines(edit.m_line, edit.m_removedLines, edit.m_insertedLines);
+	}
+}
+
+[[nodiscard]] WORD TextEditor::m_getKindColor(const SyntaxHighlighter::Kind kind) const noexcept
+{
+	using Kind = SyntaxHighlighter::Kind;
+
+	// the background of the editor stays
+	const WORD background = m_textColor & Console::s_backgroundWhite;
+
+	switch (kind)
+	{
+	case Kind::Keyword:      return background | FOREGROUND_GREEN | FOREGROUND_BLUE | FOREGROUND_INTENSITY;
+	case Kind::Type:         return background | FOREGROUND_GREEN | FOREGROUND_BLUE;
+	case Kind::Number:       return background | FOREGROUND_RED | FOREGROUND_BLUE | FOREGROUND_INTENSITY;
+	case Kind::String:       return background | FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_INTENSITY;
+	case Kind::Comment:      return background | FOREGROUND_GREEN;
+	case Kind::Preprocessor: return background | FOREGROUND_RED | FOREGROUND_BLUE;
+	case Kind::Key:          return background | FOREGROUND_BLUE | FOREGROUND_INTENSITY;
+	case Kind::Error:        return background | FOREGROUND_RED | FOREGROUND_INTENSITY;
+	case Kind::Warning:      return background | FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_INTENSITY;
+	case Kind::Info:         return background | FOREGROUND_GREEN | FOREGROUND_INTENSITY;
+	case Kind::Debug:        return background | FOREGROUND_INTENSITY;
+	case Kind::Added:        return background | FOREGROUND_GREEN | FOREGROUND_INTENSITY;
+	case Kind::Removed:      return background | FOREGROUND_RED | FOREGROUND_INTENSITY;
+	case Kind::Section:      return background | FOREGROUND_GREEN | FOREGROUND_BLUE | FOREGROUND_INTENSITY;
+	default:                 return m_textColor;
+	}
+}
+
+void TextEditor::m_handleSelection(const SizeType start) noexcept
+{
+	m_selectionInProgress = true;
+	m_selectionStartIndex = start;
+
+	const auto diff = utils::GetSignedDiff(m_currentIndex, start);
 
-	for (; str != std::wstring_view{ m_inputBuffer.c_str() + i, str.size() }; --i)
+	if (diff == 1 || diff == -1)
 	{
-		if (i == 0) return false;
+		m_currentIndex -= diff;
 	}
+}
+
+void TextEditor::m_handleSelection(const SizeType start, const SizeType end) noexcept
+{   
+	m_selectionInProgress = true;
+	m_selectionStartIndex = start;
+	m_currentIndex = std::min(end, m_document->m_text.size() - 1);
+}
+
+bool TextEditor::m_selectNextString(const TextSearch& search) noexcept
+{
+	m_syncView();
+
+	if (search.m_empty()) return false;
+
+	auto start = m_currentIndex;
+	
+	if (search.m_size() == 1) ++start;
+
+	const auto index = m_findNext(search, start);
+
+	if (index == TextSearch::s_npos) return false;
 
-	m_handleSelection(i, i + str.size() - 1);
+	m_handleSelection(index, index + search.m_size() - 1);
+
+	return true;
+}
+
+bool TextEditor::m_selectPreviousString(const TextSearch& search) noexcept
+{
+	m_syncView();
+
+	if (search.m_empty() || m_currentIndex < search.m_size()) return false;
+
+	const auto index = m_findPrevious(search, m_currentIndex - search.m_size());
+
+	if (index == TextSearch::s_npos) return false;
+
+	m_handleSelection(index, index + search.m_size() - 1);
 
 	return true;
 }
 
 [[nodiscard]] std::pair<TextEditor::SizeType, TextEditor::SizeType> 
-TextEditor::m_getMatchResults(const std::wstring_view str) const noexcept
+TextEditor::m_getMatchResults(const TextSearch& search) noexcept
+{
+	m_syncView();
+
+	m_updateMatchCount(search);
+
+	const auto& blockCounts = m_document->m_matchCount.m_blockCounts;
+	const auto totalResult = m_document->m_matchCount.m_total;
+
+	if (totalResult == 0) return { 0, 0 };
+
+	const auto buffer = m_buffer();
+
+	// matches that end before the cursor start before limit
+	const auto limit = m_currentIndex - std::min(m_currentIndex, search.m_size());
+	const auto block = limit / s_matchBlockSize;
+
+	SizeType beforeInd = 0;
+
+	for (SizeType i = 0; i < std::min(block, blockCounts.size()); ++i) beforeInd += blockCounts[i];
+
+	if (block < blockCounts.size() && limit > 0)
+	{
+		const auto end = std::min(buffer.size(), limit - 1 + search.m_size());
+
+		TextSearch::Cursor cursor(search, buffer, end);
+
+		for (auto i = cursor.m_findNext(block * s_matchBlockSize); i != TextSearch::s_npos && i < limit; i = cursor.m_findNext(i + 1))
+		{
+			++beforeInd;
+		}
+	}
+
+	if (beforeInd < totalResult) ++beforeInd;
+
+	return { beforeInd, totalResult };
+}
+
+[[nodiscard]] std::optional<bool> TextEditor::m_getMatchCountUpdate(const TextSearch& search) const
+{
+	const auto& count = m_document->m_matchCount;
+
+	const auto& options = search.m_getOptions();
+
+	const bool sameSearch = count.m_pattern == search.m_getPattern()
+		&& count.m_options.m_ignoreCase == options.m_ignoreCase
+		&& count.m_options.m_wholeWord  == options.m_wholeWord;
+
+	if (sameSearch && count.m_version == m_getVersion()) return {};
+
+	std::optional<std::vector<BufferEdit>> edits;
+
+	if (sameSearch && count.m_version != std::wstring::npos) edits = m_getEditsSince(count.m_version);
+
+	// appends at the end only change the count near the old end
+	if (!edits.has_value()) return false;
+
+	auto size = count.m_textSize;
+
+	for (const auto& edit : edits.value())
+	{
+		if (edit.m_removed != 0 || edit.m_index != size) return false;
+
+		size += edit.m_inserted;
+	}
+
+	return true;
+}
+
+[[nodiscard]] bool TextEditor::m_needsMatchRecount(const TextSearch& search) const
+{
+	if (search.m_empty() || m_document->m_trigramIndex.m_isReady()) return false;
+
+	const auto update = m_getMatchCountUpdate(search);
+
+	return update.has_value() && !update.value();
+}
+
+void TextEditor::m_updateMatchCount(const TextSearch& search) noexcept
+{
+	const auto update = m_getMatchCountUpdate(search);
+
+	if (!update.has_value()) return;
+
+	auto& count = m_document->m_matchCount;
+
+	const auto& options = search.m_getOptions();
+
+	const bool appendOnly = update.value();
+
+	SizeType rescanStart = 0;
+
+	if (appendOnly)
+	{
+		// a whole word match at the old end depends on the character after it
+		const auto firstBlock = (count.m_textSize - std::min(count.m_textSize, search.m_size())) / s_matchBlockSize;
+
+		for (auto i = firstBlock; i < count.m_blockCounts.size(); ++i) count.m_total -= count.m_blockCounts[i];
+
+		count.m_blockCounts.resize(std::min(firstBlock, count.m_blockCounts.size()));
+
+		rescanStart = firstBlock * s_matchBlockSize;
+	}
+	else
+	{
+		count.m_blockCounts.clear();
+		count.m_total = 0;
+	}
+
+	count.m_pattern  = search.m_getPattern();
+	count.m_options  = options;
+	count.m_version  = m_getVersion();
+	count.m_textSize = m_buffer().size();
+
+	if (search.m_empty()) return;
+
+	const auto buffer = m_buffer();
+
+	const auto countMatches = [&] (const SizeType first, const SizeType last)
+	{
+		TextSearch::Cursor cursor(search, buffer, last);
+
+		for (auto i = cursor.m_findNext(first); i != TextSearch::s_npos; i = cursor.m_findNext(i + 1))
+		{
+			const auto block = i / s_matchBlockSize;
+
+			if (block >= count.m_blockCounts.size()) count.m_blockCounts.resize(block + 1, 0);
+
+			++count.m_blockCounts[block];
+			++count.m_total;
+		}
+	};
+
+	if (rescanStart == 0 && m_document->m_trigramIndex.m_isReady())
+	{
+		for (const auto& [first, last] : m_document->m_trigramIndex.m_getCandidateRanges(search))
+		{
+			countMatches(first, last);
+		}
+	}
+	else countMatches(rescanStart, buffer.size());
+}
+
+namespace
 {
-	SizeType beforeInd   = 0;
-	SizeType totalResult = 0;
 
-	if (!str.empty() && str.size() < m_inputBuffer.size())
-	{	
-		for (SizeType i = 0; i < m_inputBuffer.size() - str.size(); ++i)
+	// blocks of matches given to one task, enough text that handing it out costs nothing
+	constexpr std::size_t s_blocksPerTask = 16;
+
+	// calls onMatch(block, index) for the matches starting in every block of blockSize characters,
+	// the blocks are searched on the workers and the progress is counted in characters
+	template<typename OnMatch>
+	void SearchBlocks(const TextSnapshot& snapshot, const TextSearch& search, const std::size_t blockSize, WorkerPool::Job& job, OnMatch onMatch)
+	{
+		const auto size = snapshot.m_getSize();
+
+		job.m_setTotal(size);
+
+		const auto blockCount = (size + blockSize - 1) / blockSize;
+
+		WorkerPool::s_get().m_parallelFor(job, blockCount, s_blocksPerTask, [&] (const std::size_t first, const std::size_t last)
 		{
-			std::wstring_view currStr = { m_inputBuffer.c_str() + i, str.size() };
+			// the blocks of a task are copied out of the snapshot together, with the character before
+			// them and the ones after them a match or its whole word check may read
+			const auto copyStart = first * blockSize - std::min<std::size_t>(first * blockSize, 1);
+			const auto copyEnd   = std::min(size, last * blockSize + search.m_size());
 
-			if (currStr == str)
+			std::wstring copy;
+			snapshot.m_copy(copyStart, copyEnd, copy);
+
+			const std::wstring_view text = copy;
+
+			for (auto block = first; block < last && !job.m_isCancelled(); ++block)
 			{
-				if (i + str.size() < m_currentIndex) ++beforeInd;
+				const auto start = block * blockSize - copyStart;
+				const auto limit = std::min(size, (block + 1) * blockSize) - copyStart;
+
+				// a match starting in the block may end in the next one
+				const auto end = std::min(text.size(), limit - 1 + search.m_size());
+
+				TextSearch::Cursor cursor(search, text, end);
 
-				++totalResult;
+				for (auto i = cursor.m_findNext(start); i != TextSearch::s_npos && i < limit; i = cursor.m_findNext(i + 1))
+				{
+					onMatch(block, copyStart + i);
+				}
+
+				job.m_addDone(limit - start);
 			}
+		});
+	}
+
+} // namespace
+
+[[nodiscard]] Document::MatchCount TextEditor::s_countMatches(const TextSnapshot& snapshot, const TextSearch& search, WorkerPool::Job& job)
+{
+	Document::MatchCount count;
+
+	count.m_pattern  = search.m_getPattern();
+	count.m_options  = search.m_getOptions();
+	count.m_version  = snapshot.m_getVersion();
+	count.m_textSize = snapshot.m_getSize();
+
+	if (search.m_empty()) return count;
+
+	// every block is counted by one task
+	count.m_blockCounts.resize((count.m_textSize + s_matchBlockSize - 1) / s_matchBlockSize, 0);
+
+	SearchBlocks(snapshot, search, s_matchBlockSize, job, [&] (const SizeType block, SizeType) { ++count.m_blockCounts[block]; });
+
+	for (const auto blockCount : count.m_blockCounts) count.m_total += blockCount;
+
+	return count;
+}
+
+[[nodiscard]] std::vector<TextEditor::SizeType> TextEditor::s_findMatches(const TextSnapshot& snapshot, const TextSearch& search, WorkerPool::Job& job)
+{
+	if (search.m_empty()) return {};
+
+	std::vector<std::vector<SizeType>> blockMatches((snapshot.m_getSize() + s_matchBlockSize - 1) / s_matchBlockSize);
+
+	SearchBlocks(snapshot, search, s_matchBlockSize, job, [&] (const SizeType block, const SizeType index) { blockMatches[block].push_back(index); });
+
+	// the blocks find overlapping matches too, the ones m_findNext would skip are dropped
+	std::vector<SizeType> starts;
+
+	SizeType end = 0;
+
+	for (const auto& matches : blockMatches)
+	{
+		for (const auto index : matches)
+		{
+			if (index < end) continue;
+
+			starts.push_back(index);
+			end = index + search.m_size();
 		}
 	}
 
-	if (totalResult > 0 && beforeInd < totalResult) ++beforeInd;
+	return starts;
+}
 
-	return { beforeInd, totalResult };
+[[nodiscard]] TextEditor::SizeType TextEditor::m_findNext(const TextSearch& search, const SizeType start) const
+{
+	if (!m_document->m_trigramIndex.m_isReady()) return search.m_findNext(m_buffer(), start);
+
+	for (const auto& [first, last] : m_document->m_trigramIndex.m_getCandidateRanges(search))
+	{
+		if (last <= start) continue;
+
+		const auto index = search.m_findNext(m_buffer(), std::max(first, start), last);
+
+		if (index != TextSearch::s_npos) return index;
+	}
+
+	return TextSearch::s_npos;
 }
 
+[[nodiscard]] TextEditor::SizeType TextEditor::m_findPrevious(const TextSearch& search, const SizeType maxStart) const
+{
+	if (!m_document->m_trigramIndex.m_isReady()) return search.m_findPrevious(m_buffer(), maxStart);
+
+	const auto ranges = m_document->m_trigramIndex.m_getCandidateRanges(search);
 
-void TextEditor::m_setInputBuffer(const std::wstring_view str) noexcept
+	for (auto it = ranges.crbegin(); it != ranges.crend(); ++it)
+	{
+		if (it->first > maxStart || it->second - it->first < search.m_size()) continue;
+
+		const auto index = search.m_findPrevious(m_buffer(), std::min(maxStart, it->second - search.m_size()), it->first);
+
+		if (index != TextSearch::s_npos) return index;
+	}
+
+	return TextSearch::s_npos;
+}
+
+[[nodiscard]] std::vector<TextEditor::SizeType> TextEditor::m_findAll(const TextSearch& search) const
 {
-	m_inputBuffer.clear();
-	m_inputBuffer.reserve(str.size() + 1);
+	std::vector<SizeType> starts;
+
+	if (search.m_empty()) return starts;
 
-	m_rowCount = 1;
+	const auto buffer = m_buffer();
 
-	for (const auto element : str)
+	const auto findIn = [&] (const SizeType first, const SizeType last)
 	{
-		if (element == L'\n') ++m_rowCount;
+		TextSearch::Cursor cursor(search, buffer, last);
 
-		m_inputBuffer.push_back(element);
+		const auto start = std::max(first, starts.empty() ? 0 : starts.back() + search.m_size());
+
+		for (auto index = cursor.m_findNext(start); index != TextSearch::s_npos; index = cursor.m_findNext(index + search.m_size()))
+		{
+			starts.push_back(index);
+		}
+	};
+
+	if (!m_document->m_trigramIndex.m_isReady())
+	{
+		findIn(0, buffer.size());
+		return starts;
 	}
 
-	m_inputBuffer.push_back(L' ');
+	for (const auto& [first, last] : m_document->m_trigramIndex.m_getCandidateRanges(search)) findIn(first, last);
 
-	m_currentIndex = m_inputBuffer.size() - 1;
-	m_selectionInProgress = false;  
-}
\ No newline at end of file
+	return starts;
+}
+
+
+void TextEditor::m_setInputBuffer(const std::wstring_view str) noexcept
+{
+	m_syncView();
+
+	m_document->m_text.clear();
+	m_document->m_text.reserve(str.size() + 1);
+
+	m_document->m_text.append(str);
+	m_document->m_text.push_back(L' ');
+
+	m_onBufferReset();
+
+	m_currentIndex = m_document->m_text.size() - 1;
+	m_selectionInProgress = false;  
+}
+
+void TextEditor::m_goToIndex(const SizeType index) noexcept
+{
+	m_syncView();
+
+	m_resetCursors();
+
+	m_selectionInProgress = false;
+	m_currentIndex = std::min(index, m_document->m_text.size() - 1);
+
+	// makes m_updateConsole scroll to the cursor
+	m_lastEvent = EventType::Keyboard;
+}
+
+void TextEditor::m_onBufferInsert(const SizeType index, const std::wstring_view str)
+{
+	m_syncView();
+
+	m_document->m_onInsert(index, str);
+
+	m_viewVersion = m_getVersion();
+}
+
+void TextEditor::m_onBufferErase(const SizeType start, const SizeType end) noexcept
+{
+	m_syncView();
+
+	m_document->m_onErase(start, end);
+
+	m_viewVersion = m_getVersion();
+}
+
+void TextEditor::m_onBufferReset() noexcept
+{
+	m_document->m_onReset();
+
+	m_viewVersion = m_getVersion();
+
+	m_resetCursors();
+}
+
+namespace
+{
+	// where index is after edit, indices inside the removed text move to its start
+	[[nodiscard]] constexpr std::size_t MoveIndexOver(const TextEditor::BufferEdit& edit, const std::size_t index) noexcept
+	{
+		if (index < edit.m_index) return index;
+		if (index < edit.m_index + edit.m_removed) return edit.m_index;
+
+		return index - edit.m_removed + edit.m_inserted;
+	}
+
+	// lines inside the removed text join the edited line
+	[[nodiscard]] constexpr std::size_t MoveLineOver(const TextEditor::BufferEdit& edit, const std::size_t line) noexcept
+	{
+		if (line <= edit.m_line) return line;
+
+		return std::max(line, edit.m_line + edit.m_removedLines) - edit.m_removedLines + edit.m_insertedLines;
+	}
+
+} // namespace
+
+void TextEditor::m_syncView() noexcept
+{
+	const auto version = m_getVersion();
+
+	if (m_viewVersion == version) return;
+
+	const auto edits = m_getEditsSince(m_viewVersion);
+
+	m_viewVersion = version;
+
+	if (!edits.has_value())
+	{
+		// another view replaced the text, only the scroll position is kept
+		m_resetCursors();
+
+		m_selectionInProgress = false;
+		m_currentIndex = std::min(m_currentIndex, m_buffer().size());
+		m_startRow = std::min(m_startRow, m_document->m_lineIndex.m_getLineCount() - 1);
+
+		return;
+	}
+
+	for (const auto& edit : edits.value())
+	{
+		m_currentIndex        = MoveIndexOver(edit, m_currentIndex);
+		m_selectionStartIndex = MoveIndexOver(edit, m_selectionStartIndex);
+
+		for (auto& cursor : m_extraCursors)
+		{
+			cursor.m_index          = MoveIndexOver(edit, cursor.m_index);
+			cursor.m_selectionStart = MoveIndexOver(edit, cursor.m_selectionStart);
+		}
+
+		if (m_blockSelection.has_value())
+		{
+			m_blockSelection->m_anchorLine = MoveLineOver(edit, m_blockSelection->m_anchorLine);
+			m_blockSelection->m_line       = MoveLineOver(edit, m_blockSelection->m_line);
+		}
+
+		// lines above the view keep the same lines on the screen
+		m_startRow = MoveLineOver(edit, m_startRow);
+	}
+
+	if (!m_extraCursors.empty()) m_sortCursors();
+}
+
+void TextEditor::m_syncColumnCheckpoints() const
+{
+	const auto version = m_getVersion();
+
+	if (m_checkpointVersion == version) return;
+
+	const auto edits = m_getEditsSince(m_checkpointVersion);
+
+	m_checkpointVersion = version;
+
+	if (!edits.has_value())
+	{
+		m_columnCheckpoints.m_clear();
+		return;
+	}
+
+	for (const auto& edit : edits.value())
+	{
+		if (edit.m_removed  > 0) m_columnCheckpoints.m_onErase(edit.m_index, edit.m_index + edit.m_removed);
+		if (edit.m_inserted > 0) m_columnCheckpoints.m_onInsert(edit.m_index, edit.m_inserted, edit.m_insertedLines > 0);
+	}
+}
+
+bool TextEditor::m_handleMultiCursorEvents(const KEY_EVENT_RECORD& event)
+{
+	if (!event.bKeyDown) return false;
+
+	if (Console::s_isCtrlKeyPressed(event))
+	{
+		switch (event.wVirtualKeyCode)
+		{
+		case VirtualKeyCode::V:
+			// paste at every cursor
+			Console::s_useUserClipboard([this] (const std::wstring_view data)
+			{
+				m_insertUnsafeString(std::wstring(data));
+			});
+
+			return true;
+		case VirtualKeyCode::Z:
+			
+			// only a batch knows where the other cursors go
+			if (!m_document->m_records.empty() && std::holds_alternative<BatchRecord>(m_document->m_records.back())) return false;
+
+			m_extraCursors.clear();
+			return false;
+		case VirtualKeyCode::X:
+		case VK_BACK:
+		case VK_DELETE:
+			// single cursor edits
+			m_extraCursors.clear();
+			return false;
+		default:
+			return false;
+		}
+	}
+
+	switch (event.wVirtualKeyCode)
+	{
+	case VK_ESCAPE:
+		m_extraCursors.clear();
+		return true;
+	case VK_BACK:
+		m_editAtCursors(CursorEdit::DeleteBackward);
+		return true;
+	case VK_DELETE:
+		m_editAtCursors(CursorEdit::DeleteForward);
+		return true;
+	case VK_RETURN:
+		m_editAtCursors(CursorEdit::Insert, L"\n");
+		return true;
+	default:
+
+		if (event.uChar.UnicodeChar)
+		{
+			const wchar_t c = event.uChar.UnicodeChar;
+
+			m_editAtCursors(CursorEdit::Insert, { &c, 1 });
+			return true;
+		}
+
+		return false;
+	}
+}
+
+void TextEditor::m_sortCursors()
+{
+	std::sort(m_extraCursors.begin(), m_extraCursors.end(), [] (const Cursor& lhs, const Cursor& rhs)
+	{
+		return lhs.m_index < rhs.m_index;
+	});
+
+	// cursors that moved onto each other become one
+	const auto end = std::unique(m_extraCursors.begin(), m_extraCursors.end(), [] (const Cursor& lhs, const Cursor& rhs)
+	{
+		return lhs.m_index == rhs.m_index;
+	});
+
+	m_extraCursors.erase(end, m_extraCursors.end());
+
+	m_extraCursors.erase(std::remove_if(m_extraCursors.begin(), m_extraCursors.end(), [&] (const Cursor& cursor)
+	{
+		return cursor.m_index == m_currentIndex;
+	}), m_extraCursors.end());
+}
+
+void TextEditor::m_setCursors(const std::vector<SizeType>& positions, const SizeType primary)
+{
+	m_resetCursors();
+	m_extraCursors.reserve(positions.size());
+
+	for (SizeType i = 0; i < positions.size(); ++i)
+	{
+		if (i != primary) m_extraCursors.push_back({ positions[i], positions[i], false });
+	}
+
+	m_currentIndex = positions[primary];
+	m_selectionInProgress = false;
+
+	m_sortCursors();
+}
+
+bool TextEditor::m_addCursorsAtMatches(const TextSearch& search)
+{
+	m_syncView();
+
+	if (search.m_empty()) return false;
+
+	std::vector<Cursor> cursors;
+
+	for (const auto index : m_findAll(search))
+	{
+		// same selection as m_selectNextString
+		cursors.push_back({ index + search.m_size() - 1, index, true });
+	}
+
+	if (cursors.empty()) return false;
+
+	m_extraCursors.assign(cursors.cbegin() + 1, cursors.cend());
+
+	m_currentIndex        = cursors.front().m_index;
+	m_selectionStartIndex = cursors.front().m_selectionStart;
+	m_selectionInProgress = true;
+
+	m_lastEvent = EventType::Keyboard;
+
+	return true;
+}
+
+void TextEditor::m_addCursorsToSelectedLines()
+{
+	if (!m_selectionInProgress) return;
+
+	const auto [min, max] = utils::GetMinMax(m_currentIndex, m_selectionStartIndex);
+
+	const auto firstLine = m_document->m_lineIndex.m_getLineOf(min);
+	const auto lastLine  = m_document->m_lineIndex.m_getLineOf(max);
+
+	std::vector<SizeType> positions;
+	positions.reserve(lastLine - firstLine + 1);
+
+	for (auto line = firstLine; line < lastLine; ++line)
+	{
+		positions.push_back(m_document->m_lineIndex.m_getLineEnd(line));
+	}
+
+	// last line ends where the selection ends
+	positions.push_back(std::min(m_document->m_lineIndex.m_getLineEnd(lastLine), max + 1));
+
+	m_setCursors(positions, positions.size() - 1);
+}
+
+std::vector<TextEditor::SizeType> TextEditor::m_applyReplacements(const std::vector<Replacement>& replacements, BatchRecord* record)
+{
+	auto newSize = m_document->m_text.size();
+
+	for (const auto& replacement : replacements)
+	{
+		newSize += replacement.m_text.size() - (replacement.m_end - replacement.m_start);
+	}
+
+	std::wstring result;
+	result.reserve(newSize);
+
+	std::vector<SizeType> starts;
+	starts.reserve(replacements.size());
+
+	// a snapshot copy of the document takes the whole batch at once
+	std::vector<TextSnapshot::Replacement> snapshotReplacements;
+	snapshotReplacements.reserve(replacements.size());
+
+	m_document->m_beginReplacements();
+
+	SizeType previous = 0;
+
+	for (const auto& replacement : replacements)
+	{
+		const auto start = std::max(replacement.m_start, previous);
+		const auto end   = std::max(replacement.m_end, start);
+
+		result.append(m_document->m_text, previous, start - previous);
+
+		// result so far followed by the untouched rest is what the hooks see
+		const auto index = result.size();
+
+		if (end > start) m_onBufferErase(index, index + end - start);
+		if (!replacement.m_text.empty()) m_onBufferInsert(index, replacement.m_text);
+
+		if (record) record->m_edits.push_back({ index, replacement.m_text.size(), m_document->m_text.substr(start, end - start) });
+
+		result.append(replacement.m_text);
+		starts.push_back(index);
+
+		snapshotReplacements.push_back({ start, end, replacement.m_text });
+
+		previous = end;
+	}
+
+	m_document->m_endReplacements(snapshotReplacements);
+
+	result.append(m_document->m_text, previous, std::wstring::npos);
+
+	m_document->m_text = std::move(result);
+
+	return starts;
+}
+
+void TextEditor::m_editAtCursors(const CursorEdit edit, const std::wstring_view str)
+{
+	std::vector<Cursor> cursors = m_extraCursors;
+
+	cursors.push_back({ m_currentIndex, m_selectionStartIndex, m_selectionInProgress });
+
+	const auto getStart = [] (const Cursor& cursor) { return cursor.m_selected ? std::min(cursor.m_index, cursor.m_selectionStart) : cursor.m_index; };
+
+	// the primary cursor is the last one before sorting
+	std::vector<SizeType> order(cursors.size());
+
+	for (SizeType i = 0; i < order.size(); ++i) order[i] = i;
+
+	std::sort(order.begin(), order.end(), [&] (const SizeType lhs, const SizeType rhs) { return getStart(cursors[lhs]) < getStart(cursors[rhs]); });
+
+	// sentinel at the end of the buffer is never removed
+	const auto lastIndex = m_document->m_text.size() - 1;
+
+	std::vector<Replacement> replacements;
+	replacements.reserve(cursors.size());
+
+	SizeType primary = 0;
+
+	for (SizeType i = 0; i < order.size(); ++i)
+	{
+		const auto& cursor = cursors[order[i]];
+
+		if (order[i] + 1 == cursors.size()) primary = i;
+
+		auto start = cursor.m_index;
+		auto end   = cursor.m_index;
+
+		if (cursor.m_selected)
+		{
+			const auto [min, max] = utils::GetMinMax(cursor.m_index, cursor.m_selectionStart);
+
+			start = min;
+			end   = std::min(m_getClusterEnd(max), lastIndex);
+		}
+		else if (edit == CursorEdit::DeleteBackward) 
+		{
+			if (start > 0) start = UnicodeProperties::s_getPreviousGraphemeBreak(m_buffer(), start);
+		}
+		else if (edit == CursorEdit::DeleteForward)
+		{
+			if (end < lastIndex) end = UnicodeProperties::s_getNextGraphemeBreak(m_buffer(), end);
+		}
+
+		replacements.push_back({ start, end, edit == CursorEdit::Insert ? str : std::wstring_view{} });
+	}
+
+	BatchRecord record;
+	record.m_edits.reserve(replacements.size());
+
+	auto positions = m_applyReplacements(replacements, &record);
+
+	// every cursor ends up after its own replacement
+	for (auto& position : positions) position += edit == CursorEdit::Insert ? str.size() : 0;
+
+	m_document->m_records.emplace_back(std::move(record));
+	m_resizeRecordsIfNeeded();
+
+	m_setCursors(positions, primary);
+}
+
+void TextEditor::m_undoBatch(const BatchRecord& record)
+{
+	std::vector<Replacement> replacements;
+	replacements.reserve(record.m_edits.size());
+
+	for (const auto& edit : record.m_edits)
+	{
+		replacements.push_back({ edit.m_index, edit.m_index + edit.m_size, edit.m_removed });
+	}
+
+	auto positions = m_applyReplacements(replacements, nullptr);
+
+	if (positions.empty()) return;
+
+	for (SizeType i = 0; i < positions.size(); ++i) positions[i] += record.m_edits[i].m_removed.size();
+
+	m_setCursors(positions, 0);
+}
+
+bool TextEditor::m_handleBlockSelectionEvents(const KEY_EVENT_RECORD& event)
+{
+	if (!event.bKeyDown) return false;
+
+	const bool ctrlPressed = Console::s_isCtrlKeyPressed(event);
+
+	if (!ctrlPressed && Console::s_isAltKeyPressed(event) && Console::s_isShiftKeyPressed(event))
+	{
+		switch (event.wVirtualKeyCode)
+		{
+		case VK_LEFT:
+		case VK_RIGHT:
+		case VK_UP:
+		case VK_DOWN:
+			m_moveBlockCorner(event);
+			return true;
+		default:
+			break;
+		}
+	}
+
+	if (!m_blockSelection.has_value()) return false;
+
+	switch (event.wVirtualKeyCode)
+	{
+	case VK_SHIFT:
+	case VK_CONTROL:
+	case VK_MENU:
+		// modifiers alone keep the block
+		return false;
+	default:
+		break;
+	}
+
+	if (ctrlPressed)
+	{
+		switch (event.wVirtualKeyCode)
+		{
+		case VirtualKeyCode::C:
+		case VirtualKeyCode::X:
+			// Copy and Cut block event
+			Console::s_setUserClipboard(m_getBlockText());
+
+			if (event.wVirtualKeyCode == VirtualKeyCode::X && m_blockSelection->m_leftColumn() != m_blockSelection->m_rightColumn())
+			{
+				m_editBlock(CursorEdit::DeleteForward);
+			}
+
+			return true;
+		case VirtualKeyCode::V:
+
+			Console::s_useUserClipboard([this] (const std::wstring_view data)
+			{
+				m_insertUnsafeString(std::wstring(data));
+			});
+
+			return true;
+		default:
+			m_blockSelection.reset();
+			return false;
+		}
+	}
+
+	switch (event.wVirtualKeyCode)
+	{
+	case VK_ESCAPE:
+		m_blockSelection.reset();
+		return true;
+	case VK_BACK:
+		m_editBlock(CursorEdit::DeleteBackward);
+		return true;
+	case VK_DELETE:
+		m_editBlock(CursorEdit::DeleteForward);
+		return true;
+	case VK_RETURN:
+		m_blockSelection.reset();
+		return false;
+	default:
+		
+		if (event.uChar.UnicodeChar && !Console::s_isAltKeyPressed(event))
+		{
+			const wchar_t c = event.uChar.UnicodeChar;
+
+			m_editBlock(CursorEdit::Insert, { { &c, 1 } });
+			return true;
+		}
+
+		m_blockSelection.reset();
+		return false;
+	}
+}
+
+[[nodiscard]] TextEditor::SizeType TextEditor::s_getTextWidth(const std::wstring_view str) noexcept
+{
+	SizeType width = 0;
+
+	for (const auto c : str) width += s_getCharWidth(c);
+
+	return width;
+}
+
+[[nodiscard]] TextEditor::SizeType TextEditor::m_getColumnOf(const SizeType index) const noexcept
+{
+	m_syncColumnCheckpoints();
+
+	const auto& lineIndex = m_document->m_lineIndex;
+
+	const auto line = lineIndex.m_getLineOf(index);
+
+	return m_columnCheckpoints.m_getStateAt(m_buffer(), lineIndex.m_getLineStart(line), lineIndex.m_getLineEnd(line), index).m_column;
+}
+
+[[nodiscard]] std::pair<TextEditor::SizeType, TextEditor::SizeType> 
+TextEditor::m_getIndexAtColumn(const SizeType line, const SizeType column) const noexcept
+{
+	m_syncColumnCheckpoints();
+
+	const auto lineEnd = m_document->m_lineIndex.m_getLineEnd(line);
+
+	const auto state = m_columnCheckpoints.m_getStateBeforeColumn(m_buffer(), m_document->m_lineIndex.m_getLineStart(line), lineEnd, column);
+
+	auto index = state.m_index;
+	auto currentColumn = state.m_column;
+
+	// whole grapheme clusters are skipped, so the index never lands on a combining mark
+	while (index < lineEnd && currentColumn < column)
+	{
+		const auto clusterEnd = std::min(UnicodeProperties::s_getNextGraphemeBreak(m_buffer(), index), lineEnd);
+
+		for (; index < clusterEnd; ++index) currentColumn += s_getCharWidth(m_document->m_text[index]);
+	}
+
+	return { index, currentColumn };
+}
+
+void TextEditor::m_setBlockCorner(const SizeType line, const SizeType column) noexcept
+{
+	m_blockSelection->m_line   = line;
+	m_blockSelection->m_column = column;
+
+	m_currentIndex = m_getIndexAtColumn(line, column).first;
+	m_selectionInProgress = false;
+}
+
+void TextEditor::m_moveBlockCorner(const KEY_EVENT_RECORD& event) noexcept
+{
+	if (!m_blockSelection.has_value())
+	{
+		const auto line   = m_document->m_lineIndex.m_getLineOf(m_currentIndex);
+		const auto column = m_getColumnOf(m_currentIndex);
+
+		m_resetCursors();
+		m_blockSelection = BlockSelection{ line, column, line, column };
+	}
+
+	auto line   = m_blockSelection->m_line;
+	auto column = m_blockSelection->m_column;
+
+	switch (event.wVirtualKeyCode)
+	{
+	case VK_LEFT:
+		if (column > 0) --column;
+		break;
+	case VK_RIGHT:
+		++column;
+		break;
+	case VK_UP:
+		if (line > 0) --line;
+		break;
+	case VK_DOWN:
+		if (line + 1 < m_document->m_lineIndex.m_getLineCount()) ++line;
+		break;
+	default:
+		break;
+	}
+
+	m_setBlockCorner(line, column);
+}
+
+[[nodiscard]] std::wstring TextEditor::m_getBlockText() const
+{
+	std::wstring result;
+
+	const auto lastLine = m_blockSelection->m_lastLine();
+
+	for (auto line = m_blockSelection->m_firstLine(); line <= lastLine; ++line)
+	{
+		const auto start = m_getIndexAtColumn(line, m_blockSelection->m_leftColumn ()).first;
+		const auto end   = m_getIndexAtColumn(line, m_blockSelection->m_rightColumn()).first;
+
+		result.append(m_document->m_text, start, end - start);
+
+		if (line != lastLine) result.push_back(L'\n');
+	}
+
+	return result;
+}
+
+void TextEditor::m_editBlock(const CursorEdit edit, const std::vector<std::wstring_view>& rowTexts)
+{
+	const auto block = m_blockSelection.value();
+
+	const auto firstLine   = block.m_firstLine();
+	const auto lastLine    = block.m_lastLine();
+	const auto leftColumn  = block.m_leftColumn();
+	const auto rightColumn = block.m_rightColumn();
+
+	const auto getRowText = [&] (const SizeType line)
+	{
+		return rowTexts.size() == 1 ? rowTexts.front() : rowTexts[line - firstLine];
+	};
+
+	// rows shorter than the block are padded, the views below point into these
+	std::vector<std::wstring> paddedTexts;
+	paddedTexts.reserve(lastLine - firstLine + 1);
+
+	std::vector<Replacement> replacements;
+	replacements.reserve(lastLine - firstLine + 1);
+
+	for (auto line = firstLine; line <= lastLine; ++line)
+	{
+		auto [start, startColumn] = m_getIndexAtColumn(line, leftColumn);
+		auto end = m_getIndexAtColumn(line, rightColumn).first;
+
+		std::wstring_view text;
+
+		if (edit == CursorEdit::Insert)
+		{
+			text = getRowText(line);
+
+			if (startColumn < leftColumn && !text.empty())
+			{
+				paddedTexts.push_back(std::wstring(leftColumn - startColumn, L' ').append(text));
+				text = paddedTexts.back();
+			}
+		}
+		else if (start == end)
+		{
+			// block without width deletes one character on every row that reaches it
+			if (edit == CursorEdit::DeleteBackward)
+			{
+				if (start > m_document->m_lineIndex.m_getLineStart(line) && startColumn >= leftColumn) start = UnicodeProperties::s_getPreviousGraphemeBreak(m_buffer(), start);
+			}
+			else if (end < m_document->m_lineIndex.m_getLineEnd(line)) end = UnicodeProperties::s_getNextGraphemeBreak(m_buffer(), end);
+		}
+
+		replacements.push_back({ start, end, text });
+	}
+
+	BatchRecord record;
+	record.m_edits.reserve(replacements.size());
+
+	m_applyReplacements(replacements, &record);
+
+	m_document->m_records.emplace_back(std::move(record));
+	m_resizeRecordsIfNeeded();
+
+	// block shrinks to a column after the edit
+	auto column = leftColumn;
+
+	if (edit == CursorEdit::Insert) column += s_getTextWidth(getRowText(block.m_line));
+	else if (leftColumn == rightColumn && edit == CursorEdit::DeleteBackward && column > 0) --column;
+
+	m_blockSelection = BlockSelection{ block.m_anchorLine, column, block.m_line, column };
+
+	m_setBlockCorner(block.m_line, column);
+}
+
+void TextEditor::m_pasteIntoBlock(const std::wstring_view str)
+{
+	if (str.empty()) return;
+
+	std::vector<std::wstring_view> rows;
+
+	for (SizeType start = 0; start <= str.size();)
+	{
+		const auto end = std::min(str.find(L'\n', start), str.size());
+
+		rows.push_back(str.substr(start, end - start));
+		start = end + 1;
+	}
+
+	// copied blocks may end with a newline
+	if (rows.size() > 1 && rows.back().empty()) rows.pop_back();
+
+	if (rows.size() == 1 || rows.size() == m_blockSelection->m_lastLine() - m_blockSelection->m_firstLine() + 1)
+	{
+		m_editBlock(CursorEdit::Insert, rows);
+		return;
+	}
+
+	// does not fit the block, pasted as plain text
+	m_insertString(str);
+}
+
+void TextEditor::m_applyLineOperation(const LineOperations::Type type, const TextSearch& search)
+{
+	m_syncView();
+
+	auto firstLine = SizeType(0);
+	auto lastLine  = m_document->m_lineIndex.m_getLineCount() - 1;
+
+	if (m_selectionInProgress)
+	{
+		const auto [min, max] = utils::GetMinMax(m_currentIndex, m_selectionStartIndex);
+
+		firstLine = m_document->m_lineIndex.m_getLineOf(min);
+		lastLine  = m_document->m_lineIndex.m_getLineOf(std::min(max, m_buffer().size()));
+	}
+
+	const auto buffer = m_buffer();
+
+	// views into the buffer, only the joined result is a new string
+	std::vector<std::wstring_view> lines;
+	lines.reserve(lastLine - firstLine + 1);
+
+	for (auto line = firstLine; line <= lastLine; ++line)
+	{
+		const auto lineStart = m_document->m_lineIndex.m_getLineStart(line);
+
+		lines.push_back(buffer.substr(lineStart, m_document->m_lineIndex.m_getLineEnd(line) - lineStart));
+	}
+
+	LineOperations::s_apply(type, lines, search);
+
+	const auto text = LineOperations::s_joinLines(lines);
+
+	const auto start = m_document->m_lineIndex.m_getLineStart(firstLine);
+	const auto end   = m_document->m_lineIndex.m_getLineEnd(lastLine);
+
+	m_resetCursors();
+	m_selectionInProgress = false;
+
+	BatchRecord record;
+
+	m_applyReplacements({ { start, end, text } }, &record);
+
+	m_document->m_records.emplace_back(std::move(record));
+	m_resizeRecordsIfNeeded();
+
+	m_currentIndex = start;
+	m_lastEvent = EventType::Keyboard;
+}
+
+[[nodiscard]] std::pair<TextEditor::SizeType, TextEditor::SizeType> TextEditor::m_getSelectionRange() const noexcept
+{
+	const auto size = m_buffer().size();
+
+	if (!m_selectionInProgress) return { 0, size };
+
+	const auto [min, max] = utils::GetMinMax(m_currentIndex, m_selectionStartIndex);
+
+	return { std::min(min, size), std::min(m_getClusterEnd(max), size) };
+}
+
+void TextEditor::m_replaceRange(const SizeType start, const SizeType end, std::wstring str)
+{
+	m_syncView();
+
+	// a range from an older version may not fit the text anymore
+	if (start > end || end > m_buffer().size()) return;
+
+	str.erase(std::remove_if(str.begin(), str.end(), [] (const wchar_t c) { return !IsInsertableChar(c); }), str.end());
+
+	m_resetCursors();
+	m_selectionInProgress = false;
+
+	BatchRecord record;
+
+	m_applyReplacements({ { start, end, str } }, &record);
+
+	m_document->m_records.emplace_back(std::move(record));
+	m_resizeRecordsIfNeeded();
+
+	m_goToIndex(start + str.size());
+}
+
+void TextEditor::m_selectRange(const SizeType start, const SizeType end) noexcept
+{
+	m_syncView();
+
+	m_resetCursors();
+
+	m_selectionInProgress = false;
+	m_currentIndex = std::min(start, m_buffer().size());
+
+	// selections are inclusive
+	if (end > start) m_handleSelection(m_currentIndex, std::min(end, m_buffer().size()) - 1);
+
+	m_lastEvent = EventType::Keyboard;
+}
+
+void TextEditor::m_appendText(std::wstring str)
+{
+	m_syncView();
+
+	str.erase(std::remove_if(str.begin(), str.end(), [] (const wchar_t c) { return !IsInsertableChar(c); }), str.end());
+
+	if (str.empty()) return;
+
+	const auto index = m_buffer().size();
+
+	// pinned to the end like tail -f
+	const bool atEnd = m_currentIndex == index && !m_selectionInProgress && m_extraCursors.empty() && !m_blockSelection.has_value();
+
+	m_onBufferInsert(index, str);
+
+	m_document->m_text.insert(index, str);
+
+	if (atEnd)
+	{
+		m_currentIndex = index + str.size();
+		m_lastEvent = EventType::Keyboard;
+	}
+}
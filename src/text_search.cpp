@@ -0,0 +1,397 @@
+#include "../include/text_search.h"
+
+#include <array>
+#include <cstdint>
+#include <algorithm>
+
+#include "../include/unicode_properties.h"
+
+namespace
+{
+	// simple case folding of the BMP, the C and S mappings of CaseFolding.txt of the unicode 14.0 database
+	// every code point in [first, last] with a step of stride folds to code point + delta
+	struct FoldRange
+	{
+		std::uint32_t m_first;
+		std::uint32_t m_last;
+		std::int32_t  m_delta;
+		std::uint32_t m_stride;
+	};
+
+	constexpr FoldRange s_foldRanges[] =
+	{
+		{ 0x0041, 0x005A,     32, 1 }, { 0x00B5, 0x00B5,    775, 1 },
+		{ 0x00C0, 0x00D6,     32, 1 }, { 0x00D8, 0x00DE,     32, 1 },
+		{ 0x0100, 0x012E,      1, 2 }, { 0x0132, 0x0136,      1, 2 },
+		{ 0x0139, 0x0147,      1, 2 }, { 0x014A, 0x0176,      1, 2 },
+		{ 0x0178, 0x0178,   -121, 1 }, { 0x0179, 0x017D,      1, 2 },
+		{ 0x017F, 0x017F,   -268, 1 }, { 0x0181, 0x0181,    210, 1 },
+		{ 0x0182, 0x0184,      1, 2 }, { 0x0186, 0x0186,    206, 1 },
+		{ 0x0187, 0x0187,      1, 1 }, { 0x0189, 0x018A,    205, 1 },
+		{ 0x018B, 0x018B,      1, 1 }, { 0x018E, 0x018E,     79, 1 },
+		{ 0x018F, 0x018F,    202, 1 }, { 0x0190, 0x0190,    203, 1 },
+		{ 0x0191, 0x0191,      1, 1 }, { 0x0193, 0x0193,    205, 1 },
+		{ 0x0194, 0x0194,    207, 1 }, { 0x0196, 0x0196,    211, 1 },
+		{ 0x0197, 0x0197,    209, 1 }, { 0x0198, 0x0198,      1, 1 },
+		{ 0x019C, 0x019C,    211, 1 }, { 0x019D, 0x019D,    213, 1 },
+		{ 0x019F, 0x019F,    214, 1 }, { 0x01A0, 0x01A4,      1, 2 },
+		{ 0x01A6, 0x01A6,    218, 1 }, { 0x01A7, 0x01A7,      1, 1 },
+		{ 0x01A9, 0x01A9,    218, 1 }, { 0x01AC, 0x01AC,      1, 1 },
+		{ 0x01AE, 0x01AE,    218, 1 }, { 0x01AF, 0x01AF,      1, 1 },
+		{ 0x01B1, 0x01B2,    217, 1 }, { 0x01B3, 0x01B5,      1, 2 },
+		{ 0x01B7, 0x01B7,    219, 1 }, { 0x01B8, 0x01B8,      1, 1 },
+		{ 0x01BC, 0x01BC,      1, 1 }, { 0x01C4, 0x01C4,      2, 1 },
+		{ 0x01C5, 0x01C5,      1, 1 }, { 0x01C7, 0x01C7,      2, 1 },
+		{ 0x01C8, 0x01C8,      1, 1 }, { 0x01CA, 0x01CA,      2, 1 },
+		{ 0x01CB, 0x01DB,      1, 2 }, { 0x01DE, 0x01EE,      1, 2 },
+		{ 0x01F1, 0x01F1,      2, 1 }, { 0x01F2, 0x01F4,      1, 2 },
+		{ 0x01F6, 0x01F6,    -97, 1 }, { 0x01F7, 0x01F7,    -56, 1 },
+		{ 0x01F8, 0x021E,      1, 2 }, { 0x0220, 0x0220,   -130, 1 },
+		{ 0x0222, 0x0232,      1, 2 }, { 0x023A, 0x023A,  10795, 1 },
+		{ 0x023B, 0x023B,      1, 1 }, { 0x023D, 0x023D,   -163, 1 },
+		{ 0x023E, 0x023E,  10792, 1 }, { 0x0241, 0x0241,      1, 1 },
+		{ 0x0243, 0x0243,   -195, 1 }, { 0x0244, 0x0244,     69, 1 },
+		{ 0x0245, 0x0245,     71, 1 }, { 0x0246, 0x024E,      1, 2 },
+		{ 0x0345, 0x0345,    116, 1 }, { 0x0370, 0x0372,      1, 2 },
+		{ 0x0376, 0x0376,      1, 1 }, { 0x037F, 0x037F,    116, 1 },
+		{ 0x0386, 0x0386,     38, 1 }, { 0x0388, 0x038A,     37, 1 },
+		{ 0x038C, 0x038C,     64, 1 }, { 0x038E, 0x038F,     63, 1 },
+		{ 0x0391, 0x03A1,     32, 1 }, { 0x03A3, 0x03AB,     32, 1 },
+		{ 0x03C2, 0x03C2,      1, 1 }, { 0x03CF, 0x03CF,      8, 1 },
+		{ 0x03D0, 0x03D0,    -30, 1 }, { 0x03D1, 0x03D1,    -25, 1 },
+		{ 0x03D5, 0x03D5,    -15, 1 }, { 0x03D6, 0x03D6,    -22, 1 },
+		{ 0x03D8, 0x03EE,      1, 2 }, { 0x03F0, 0x03F0,    -54, 1 },
+		{ 0x03F1, 0x03F1,    -48, 1 }, { 0x03F4, 0x03F4,    -60, 1 },
+		{ 0x03F5, 0x03F5,    -64, 1 }, { 0x03F7, 0x03F7,      1, 1 },
+		{ 0x03F9, 0x03F9,     -7, 1 }, { 0x03FA, 0x03FA,      1, 1 },
+		{ 0x03FD, 0x03FF,   -130, 1 }, { 0x0400, 0x040F,     80, 1 },
+		{ 0x0410, 0x042F,     32, 1 }, { 0x0460, 0x0480,      1, 2 },
+		{ 0x048A, 0x04BE,      1, 2 }, { 0x04C0, 0x04C0,     15, 1 },
+		{ 0x04C1, 0x04CD,      1, 2 }, { 0x04D0, 0x052E,      1, 2 },
+		{ 0x0531, 0x0556,     48, 1 }, { 0x10A0, 0x10C5,   7264, 1 },
+		{ 0x10C7, 0x10C7,   7264, 1 }, { 0x10CD, 0x10CD,   7264, 1 },
+		{ 0x13F8, 0x13FD,     -8, 1 }, { 0x1C80, 0x1C80,  -6222, 1 },
+		{ 0x1C81, 0x1C81,  -6221, 1 }, { 0x1C82, 0x1C82,  -6212, 1 },
+		{ 0x1C83, 0x1C84,  -6210, 1 }, { 0x1C85, 0x1C85,  -6211, 1 },
+		{ 0x1C86, 0x1C86,  -6204, 1 }, { 0x1C87, 0x1C87,  -6180, 1 },
+		{ 0x1C88, 0x1C88,  35267, 1 }, { 0x1C90, 0x1CBA,  -3008, 1 },
+		{ 0x1CBD, 0x1CBF,  -3008, 1 }, { 0x1E00, 0x1E94,      1, 2 },
+		{ 0x1E9B, 0x1E9B,    -58, 1 }, { 0x1E9E, 0x1E9E,  -7615, 1 },
+		{ 0x1EA0, 0x1EFE,      1, 2 }, { 0x1F08, 0x1F0F,     -8, 1 },
+		{ 0x1F18, 0x1F1D,     -8, 1 }, { 0x1F28, 0x1F2F,     -8, 1 },
+		{ 0x1F38, 0x1F3F,     -8, 1 }, { 0x1F48, 0x1F4D,     -8, 1 },
+		{ 0x1F59, 0x1F5F,     -8, 2 }, { 0x1F68, 0x1F6F,     -8, 1 },
+		{ 0x1F88, 0x1F8F,     -8, 1 }, { 0x1F98, 0x1F9F,     -8, 1 },
+		{ 0x1FA8, 0x1FAF,     -8, 1 }, { 0x1FB8, 0x1FB9,     -8, 1 },
+		{ 0x1FBA, 0x1FBB,    -74, 1 }, { 0x1FBC, 0x1FBC,     -9, 1 },
+		{ 0x1FBE, 0x1FBE,  -7173, 1 }, { 0x1FC8, 0x1FCB,    -86, 1 },
+		{ 0x1FCC, 0x1FCC,     -9, 1 }, { 0x1FD8, 0x1FD9,     -8, 1 },
+		{ 0x1FDA, 0x1FDB,   -100, 1 }, { 0x1FE8, 0x1FE9,     -8, 1 },
+		{ 0x1FEA, 0x1FEB,   -112, 1 }, { 0x1FEC, 0x1FEC,     -7, 1 },
+		{ 0x1FF8, 0x1FF9,   -128, 1 }, { 0x1FFA, 0x1FFB,   -126, 1 },
+		{ 0x1FFC, 0x1FFC,     -9, 1 }, { 0x2126, 0x2126,  -7517, 1 },
+		{ 0x212A, 0x212A,  -8383, 1 }, { 0x212B, 0x212B,  -8262, 1 },
+		{ 0x2132, 0x2132,     28, 1 }, { 0x2160, 0x216F,     16, 1 },
+		{ 0x2183, 0x2183,      1, 1 }, { 0x24B6, 0x24CF,     26, 1 },
+		{ 0x2C00, 0x2C2F,     48, 1 }, { 0x2C60, 0x2C60,      1, 1 },
+		{ 0x2C62, 0x2C62, -10743, 1 }, { 0x2C63, 0x2C63,  -3814, 1 },
+		{ 0x2C64, 0x2C64, -10727, 1 }, { 0x2C67, 0x2C6B,      1, 2 },
+		{ 0x2C6D, 0x2C6D, -10780, 1 }, { 0x2C6E, 0x2C6E, -10749, 1 },
+		{ 0x2C6F, 0x2C6F, -10783, 1 }, { 0x2C70, 0x2C70, -10782, 1 },
+		{ 0x2C72, 0x2C72,      1, 1 }, { 0x2C75, 0x2C75,      1, 1 },
+		{ 0x2C7E, 0x2C7F, -10815, 1 }, { 0x2C80, 0x2CE2,      1, 2 },
+		{ 0x2CEB, 0x2CED,      1, 2 }, { 0x2CF2, 0x2CF2,      1, 1 },
+		{ 0xA640, 0xA66C,      1, 2 }, { 0xA680, 0xA69A,      1, 2 },
+		{ 0xA722, 0xA72E,      1, 2 }, { 0xA732, 0xA76E,      1, 2 },
+		{ 0xA779, 0xA77B,      1, 2 }, { 0xA77D, 0xA77D, -35332, 1 },
+		{ 0xA77E, 0xA786,      1, 2 }, { 0xA78B, 0xA78B,      1, 1 },
+		{ 0xA78D, 0xA78D, -42280, 1 }, { 0xA790, 0xA792,      1, 2 },
+		{ 0xA796, 0xA7A8,      1, 2 }, { 0xA7AA, 0xA7AA, -42308, 1 },
+		{ 0xA7AB, 0xA7AB, -42319, 1 }, { 0xA7AC, 0xA7AC, -42315, 1 },
+		{ 0xA7AD, 0xA7AD, -42305, 1 }, { 0xA7AE, 0xA7AE, -42308, 1 },
+		{ 0xA7B0, 0xA7B0, -42258, 1 }, { 0xA7B1, 0xA7B1, -42282, 1 },
+		{ 0xA7B2, 0xA7B2, -42261, 1 }, { 0xA7B3, 0xA7B3,    928, 1 },
+		{ 0xA7B4, 0xA7C2,      1, 2 }, { 0xA7C4, 0xA7C4,    -48, 1 },
+		{ 0xA7C5, 0xA7C5, -42307, 1 }, { 0xA7C6, 0xA7C6, -35384, 1 },
+		{ 0xA7C7, 0xA7C9,      1, 2 }, { 0xA7D0, 0xA7D0,      1, 1 },
+		{ 0xA7D6, 0xA7D8,      1, 2 }, { 0xA7F5, 0xA7F5,      1, 1 },
+		{ 0xAB70, 0xABBF, -38864, 1 }, { 0xFF21, 0xFF3A,     32, 1 },
+	};
+
+	constexpr std::size_t s_foldBlockSize  = 256;
+	constexpr std::size_t s_foldBlockCount = 0x10000 / s_foldBlockSize;
+
+	[[nodiscard]] constexpr auto GetUsedFoldBlocks() noexcept
+	{
+		std::array<bool, s_foldBlockCount> result = {};
+
+		for (const auto& range : s_foldRanges)
+		{
+			for (auto c = range.m_first; c <= range.m_last; c += range.m_stride)
+			{
+				result[c / s_foldBlockSize] = true;
+			}
+		}
+
+		return result;
+	}
+
+	[[nodiscard]] constexpr std::size_t GetFoldBlockCount() noexcept
+	{
+		// first block is shared by every block without any mappings
+		std::size_t result = 1;
+
+		for (const auto used : GetUsedFoldBlocks())
+		{
+			if (used) ++result;
+		}
+
+		return result;
+	}
+
+	// two level table, stage1 maps high byte of the code point to a block of deltas in stage2,
+	// the deltas are kept modulo 0x10000, some mappings move further than an int16_t reaches
+	struct FoldTable
+	{
+		std::array<std::uint8_t, s_foldBlockCount> m_stage1 = {};
+		std::array<std::array<std::uint16_t, s_foldBlockSize>, GetFoldBlockCount()> m_stage2 = {};
+	};
+
+	[[nodiscard]] constexpr FoldTable MakeFoldTable() noexcept
+	{
+		FoldTable result = {};
+
+		const auto used = GetUsedFoldBlocks();
+
+		std::uint8_t nextBlock = 1;
+
+		for (std::size_t i = 0; i < s_foldBlockCount; ++i)
+		{
+			if (used[i]) result.m_stage1[i] = nextBlock++;
+		}
+
+		for (const auto& range : s_foldRanges)
+		{
+			for (auto c = range.m_first; c <= range.m_last; c += range.m_stride)
+			{
+				const auto block = result.m_stage1[c / s_foldBlockSize];
+
+				result.m_stage2[block][c % s_foldBlockSize] = static_cast<std::uint16_t>(range.m_delta);
+			}
+		}
+
+		return result;
+	}
+
+	constexpr FoldTable s_foldTable = MakeFoldTable();
+
+	[[nodiscard]] constexpr wchar_t FoldAsciiCase(const wchar_t c) noexcept
+	{
+		// branchless so that the loops using it get vectorized
+		const auto isUpper = static_cast<unsigned>(c - L'A') < 26u;
+
+		return static_cast<wchar_t>(static_cast<unsigned>(c) | (static_cast<unsigned>(isUpper) << 5u));
+	}
+
+	// characters folded at once while searching case insensitively
+	constexpr std::size_t s_foldChunkSize = 64 * 1024;
+}
+
+TextSearch::TextSearch(const std::wstring_view pattern, const Options options)
+	: m_pattern(pattern), m_options(options)
+{
+	if (m_options.m_ignoreCase)
+	{
+		s_foldCase(m_pattern.data(), m_pattern.data(), m_pattern.size());
+	}
+}
+
+[[nodiscard]] bool TextSearch::s_isWordChar(const wchar_t c) noexcept
+{
+	// a surrogate half has no word class on its own
+	return UnicodeProperties::s_getWordBreak(static_cast<std::make_unsigned_t<wchar_t>>(c)) != UnicodeProperties::WordBreak::Other;
+}
+
+[[nodiscard]] wchar_t TextSearch::s_foldCase(const wchar_t c) noexcept
+{
+	const auto code = static_cast<std::uint32_t>(c);
+
+	if constexpr (sizeof(wchar_t) > 2)
+	{
+		if (code > 0xFFFF) return c;
+	}
+
+	const auto delta = s_foldTable.m_stage2[s_foldTable.m_stage1[code / s_foldBlockSize]][code % s_foldBlockSize];
+
+	return static_cast<wchar_t>(static_cast<std::uint16_t>(code + delta));
+}
+
+void TextSearch::s_foldCase(const wchar_t* src, wchar_t* dst, const SizeType size) noexcept
+{
+	constexpr SizeType blockSize = 64;
+
+	for (SizeType i = 0; i < size; i += blockSize)
+	{
+		const auto end = std::min(size, i + blockSize);
+
+		// check the whole block at once instead of branching per character
+		std::uint32_t mask = 0;
+
+		for (auto t = i; t < end; ++t) mask |= static_cast<std::uint32_t>(src[t]);
+
+		if (mask < 0x80)
+		{
+			for (auto t = i; t < end; ++t) dst[t] = FoldAsciiCase(src[t]);
+		}
+		else
+		{
+			for (auto t = i; t < end; ++t) dst[t] = s_foldCase(src[t]);
+		}
+	}
+}
+
+[[nodiscard]] bool TextSearch::m_isWholeWordAt(const std::wstring_view text, const SizeType index) const noexcept
+{
+	if (!m_options.m_wholeWord) return true;
+
+	const auto end = index + m_pattern.size();
+
+	if (index > 0 && s_isWordChar(text[index - 1])) return false;
+	if (end < text.size() && s_isWordChar(text[end])) return false;
+
+	return true;
+}
+
+[[nodiscard]] bool TextSearch::m_isMatchAt(const std::wstring_view text, const SizeType index) const noexcept
+{
+	if (m_pattern.empty() || index > text.size() || text.size() - index < m_pattern.size()) return false;
+
+	if (m_options.m_ignoreCase)
+	{
+		for (SizeType i = 0; i < m_pattern.size(); ++i)
+		{
+			if (s_foldCase(text[index + i]) != m_pattern[i]) return false;
+		}
+	}
+	else if (text.compare(index, m_pattern.size(), m_pattern) != 0) return false;
+
+	return m_isWholeWordAt(text, index);
+}
+
+[[nodiscard]] TextSearch::SizeType TextSearch::m_findNext(const std::wstring_view text, 
+	const SizeType start, SizeType end) const
+{
+	end = std::min(end, text.size());
+
+	if (m_pattern.empty() || start >= end || end - start < m_pattern.size()) return s_npos;
+
+	if (m_options.m_ignoreCase) return Cursor(*this, text, end).m_findNext(start);
+
+	const auto scan = text.substr(0, end);
+
+	for (auto index = scan.find(m_pattern, start); index != s_npos; index = scan.find(m_pattern, index + 1))
+	{
+		if (m_isWholeWordAt(text, index)) return index;
+	}
+
+	return s_npos;
+}
+
+[[nodiscard]] TextSearch::SizeType TextSearch::m_findPrevious(const std::wstring_view text, 
+	SizeType maxStart, const SizeType minStart) const
+{
+	if (m_pattern.empty() || text.size() < m_pattern.size()) return s_npos;
+
+	maxStart = std::min(maxStart, text.size() - m_pattern.size());
+
+	if (maxStart < minStart) return s_npos;
+
+	if (m_options.m_ignoreCase) return m_findPreviousFolded(text, maxStart + m_pattern.size(), minStart);
+
+	const auto scan = text.substr(minStart);
+
+	for (auto index = scan.rfind(m_pattern, maxStart - minStart); index != s_npos; index = scan.rfind(m_pattern, index - 1))
+	{
+		if (m_isWholeWordAt(text, minStart + index)) return minStart + index;
+
+		if (index == 0) break;
+	}
+
+	return s_npos;
+}
+
+[[nodiscard]] TextSearch::SizeType TextSearch::m_findPreviousFolded(const std::wstring_view text, 
+	SizeType end, const SizeType minStart) const
+{
+	const auto patternSize = m_pattern.size();
+
+	std::wstring folded(std::min(s_foldChunkSize + patternSize - 1, end - minStart), L'\0');
+
+	while (end >= minStart + patternSize)
+	{
+		const auto chunkSize  = std::min(s_foldChunkSize + patternSize - 1, end - minStart);
+		const auto chunkStart = end - chunkSize;
+
+		s_foldCase(text.data() + chunkStart, folded.data(), chunkSize);
+
+		const std::wstring_view chunk = { folded.data(), chunkSize };
+
+		for (auto i = chunk.rfind(m_pattern); i != s_npos; i = chunk.rfind(m_pattern, i - 1))
+		{
+			if (m_isWholeWordAt(text, chunkStart + i)) return chunkStart + i;
+
+			if (i == 0) break;
+		}
+
+		if (chunkStart == minStart) break;
+
+		end = chunkStart + patternSize - 1;
+	}
+
+	return s_npos;
+}
+
+TextSearch::Cursor::Cursor(const TextSearch& search, const std::wstring_view text, const SizeType end)
+	: m_search(search), m_text(text), m_end(std::min(end, text.size()))
+{
+}
+
+[[nodiscard]] TextSearch::SizeType TextSearch::Cursor::m_findNext(SizeType start)
+{
+	if (!m_search.m_options.m_ignoreCase) return m_search.m_findNext(m_text, start, m_end);
+
+	const auto& pattern = m_search.m_pattern;
+	const auto patternSize = pattern.size();
+
+	if (pattern.empty() || start >= m_end || m_end - start < patternSize) return s_npos;
+
+	while (start + patternSize <= m_end)
+	{
+		// the chunk is folded again only when a match starting at start would not fit in it
+		if (start < m_chunkStart || start + patternSize > m_chunkStart + m_folded.size())
+		{
+			const auto chunkSize = std::min(s_foldChunkSize + patternSize - 1, m_end - start);
+
+			m_folded.resize(chunkSize);
+			m_chunkStart = start;
+
+			s_foldCase(m_text.data() + start, m_folded.data(), chunkSize);
+		}
+
+		const std::wstring_view chunk = m_folded;
+
+		for (auto i = chunk.find(pattern, start - m_chunkStart); i != s_npos; i = chunk.find(pattern, i + 1))
+		{
+			if (m_search.m_isWholeWordAt(m_text, m_chunkStart + i)) return m_chunkStart + i;
+		}
+
+		const auto chunkEnd = m_chunkStart + chunk.size();
+
+		if (chunkEnd >= m_end) break;
+
+		// chunks overlap by patternSize - 1 so that no match is lost between them
+		start = chunkEnd - (patternSize - 1);
+	}
+
+	return s_npos;
+}
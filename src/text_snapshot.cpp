@@ -0,0 +1,233 @@
+#include "../include/text_snapshot.h"
+
+#include <algorithm>
+
+TextSnapshot::TextSnapshot(const std::wstring_view text)
+	: m_root(s_makeLeaf(text))
+{
+}
+
+void TextSnapshot::m_copy(const SizeType first, const SizeType last, std::wstring& out) const
+{
+	const auto end = std::min(last, m_getSize());
+
+	if (first >= end) return;
+
+	out.reserve(out.size() + end - first);
+
+	s_copy(m_root.get(), first, end, out);
+}
+
+[[nodiscard]] std::wstring TextSnapshot::m_getText() const
+{
+	std::wstring text;
+
+	m_copy(0, m_getSize(), text);
+
+	return text;
+}
+
+void TextSnapshot::m_insert(const SizeType index, const std::wstring_view str)
+{
+	if (str.empty()) return;
+
+	const auto [left, right] = s_split(m_root, index);
+
+	m_root = s_join(s_join(left, s_makeLeaf(str)), right);
+}
+
+void TextSnapshot::m_erase(const SizeType first, const SizeType last)
+{
+	if (first >= last) return;
+
+	const auto [left, rest] = s_split(m_root, first);
+
+	m_root = s_join(left, s_split(rest, last - first).second);
+}
+
+void TextSnapshot::m_replace(const std::vector<Replacement>& replacements)
+{
+	std::vector<NodePtr> leaves;
+
+	SizeType previous = 0;
+
+	for (const auto& replacement : replacements)
+	{
+		s_collect(m_root, previous, replacement.m_start, leaves);
+
+		if (!replacement.m_text.empty()) leaves.push_back(s_makeLeaf(replacement.m_text));
+
+		previous = replacement.m_end;
+	}
+
+	s_collect(m_root, previous, m_getSize(), leaves);
+
+	m_root = s_build(leaves, 0, leaves.size());
+}
+
+[[nodiscard]] TextSnapshot::NodePtr TextSnapshot::s_makeLeaf(const std::wstring_view text)
+{
+	if (text.empty()) return nullptr;
+
+	return s_makeLeaf(std::make_shared<const std::wstring>(text), 0, text.size());
+}
+
+[[nodiscard]] TextSnapshot::NodePtr TextSnapshot::s_makeLeaf(const std::shared_ptr<const std::wstring>& buffer, const SizeType offset, const SizeType size)
+{
+	if (size == 0) return nullptr;
+
+	auto leaf = std::make_shared<Node>();
+
+	leaf->m_size   = size;
+	leaf->m_buffer = buffer;
+	leaf->m_offset = offset;
+
+	return leaf;
+}
+
+[[nodiscard]] TextSnapshot::NodePtr TextSnapshot::s_makeNode(NodePtr left, NodePtr right)
+{
+	auto node = std::make_shared<Node>();
+
+	node->m_size   = left->m_size + right->m_size;
+	node->m_height = 1 + std::max(left->m_height, right->m_height);
+	node->m_left   = std::move(left);
+	node->m_right  = std::move(right);
+
+	return node;
+}
+
+[[nodiscard]] TextSnapshot::NodePtr TextSnapshot::s_balance(NodePtr left, NodePtr right)
+{
+	if (left->m_height > right->m_height + 1)
+	{
+		if (left->m_left->m_height >= left->m_right->m_height)
+		{
+			return s_makeNode(left->m_left, s_makeNode(left->m_right, std::move(right)));
+		}
+
+		const auto& middle = left->m_right;
+
+		return s_makeNode(s_makeNode(left->m_left, middle->m_left), s_makeNode(middle->m_right, std::move(right)));
+	}
+
+	if (right->m_height > left->m_height + 1)
+	{
+		if (right->m_right->m_height >= right->m_left->m_height)
+		{
+			return s_makeNode(s_makeNode(std::move(left), right->m_left), right->m_right);
+		}
+
+		const auto& middle = right->m_left;
+
+		return s_makeNode(s_makeNode(std::move(left), middle->m_left), s_makeNode(middle->m_right, right->m_right));
+	}
+
+	return s_makeNode(std::move(left), std::move(right));
+}
+
+[[nodiscard]] TextSnapshot::NodePtr TextSnapshot::s_join(const NodePtr& left, const NodePtr& right)
+{
+	if (!left ) return right;
+	if (!right) return left;
+
+	if (left->m_isLeaf() && right->m_isLeaf())
+	{
+		// the halves of a split piece become one view again
+		if (left->m_buffer == right->m_buffer && left->m_offset + left->m_size == right->m_offset)
+		{
+			return s_makeLeaf(left->m_buffer, left->m_offset, left->m_size + right->m_size);
+		}
+
+		if (left->m_size + right->m_size <= s_smallPiece)
+		{
+			std::wstring piece(left->m_getPiece());
+			piece.append(right->m_getPiece());
+
+			return s_makeLeaf(piece);
+		}
+	}
+
+	// the lower tree goes down the near side of the higher one, each level is rotated back into balance
+	if (left->m_height > right->m_height + 1) return s_balance(left->m_left, s_join(left->m_right, right));
+	if (right->m_height > left->m_height + 1) return s_balance(s_join(left, right->m_left), right->m_right);
+
+	return s_makeNode(left, right);
+}
+
+[[nodiscard]] std::pair<TextSnapshot::NodePtr, TextSnapshot::NodePtr> TextSnapshot::s_split(const NodePtr& node, const SizeType index)
+{
+	if (!node || index == 0) return { nullptr, node };
+
+	if (index >= node->m_size) return { node, nullptr };
+
+	if (node->m_isLeaf())
+	{
+		return { s_makeLeaf(node->m_buffer, node->m_offset, index), s_makeLeaf(node->m_buffer, node->m_offset + index, node->m_size - index) };
+	}
+
+	const auto leftSize = node->m_left->m_size;
+
+	if (index <= leftSize)
+	{
+		auto [first, second] = s_split(node->m_left, index);
+
+		return { std::move(first), s_join(second, node->m_right) };
+	}
+
+	auto [first, second] = s_split(node->m_right, index - leftSize);
+
+	return { s_join(node->m_left, first), std::move(second) };
+}
+
+void TextSnapshot::s_collect(const NodePtr& node, SizeType first, SizeType last, std::vector<NodePtr>& leaves)
+{
+	if (!node || first >= last) return;
+
+	if (node->m_isLeaf())
+	{
+		leaves.push_back(first == 0 && last >= node->m_size ? node : s_makeLeaf(node->m_buffer, node->m_offset + first, std::min(last, node->m_size) - first));
+		return;
+	}
+
+	const auto leftSize = node->m_left->m_size;
+
+	if (first < leftSize) s_collect(node->m_left, first, std::min(last, leftSize), leaves);
+
+	if (last > leftSize) s_collect(node->m_right, first > leftSize ? first - leftSize : 0, last - leftSize, leaves);
+}
+
+[[nodiscard]] TextSnapshot::NodePtr TextSnapshot::s_build(const std::vector<NodePtr>& leaves, const SizeType first, const SizeType last)
+{
+	if (first == last) return nullptr;
+
+	if (last - first == 1) return leaves[first];
+
+	const auto middle = first + (last - first) / 2;
+
+	return s_makeNode(s_build(leaves, first, middle), s_build(leaves, middle, last));
+}
+
+void TextSnapshot::s_copy(const Node* node, SizeType first, SizeType last, std::wstring& out)
+{
+	// the left side is copied by a call, the right one by the loop, the depth stays the height
+	while (node != nullptr && first < last)
+	{
+		if (node->m_isLeaf())
+		{
+			out.append(node->m_getPiece().substr(first, last - first));
+			return;
+		}
+
+		const auto leftSize = node->m_left->m_size;
+
+		if (first < leftSize) s_copy(node->m_left.get(), first, std::min(last, leftSize), out);
+
+		if (last <= leftSize) return;
+
+		first = first > leftSize ? first - leftSize : 0;
+		last -= leftSize;
+
+		node = node->m_right.get();
+	}
+}
@@ -0,0 +1,403 @@
+#include "../include/trigram_index.h"
+
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+#include "../include/console.h" // _wfopen_s
+
+namespace
+{
+	constexpr char s_indexMagic[4] = { 'E', 'T', 'R', 'I' };
+	constexpr std::uint32_t s_indexVersion = 1;
+
+	struct IndexHeader
+	{
+		char          m_magic[4];
+		std::uint32_t m_version;
+		std::uint64_t m_textSize;
+		std::uint64_t m_sampleHash;
+		std::uint64_t m_blockSize;
+		std::uint32_t m_bucketBits;
+		std::uint32_t m_padding;
+	};
+
+	[[nodiscard]] constexpr std::uint32_t GetTrigramBucket(const wchar_t a, const wchar_t b, const wchar_t c) noexcept
+	{
+		auto hash = static_cast<std::uint32_t>(a) * 0x9E3779B1u;
+
+		hash = (hash ^ static_cast<std::uint32_t>(b)) * 0x85EBCA77u;
+		hash = (hash ^ static_cast<std::uint32_t>(c)) * 0xC2B2AE3Du;
+
+		return hash >> (32 - TrigramIndex::s_bucketBits);
+	}
+
+	// fnv-1a over evenly spaced characters, catches files that changed with the same size
+	[[nodiscard]] std::uint64_t GetSampleHash(const std::wstring_view text) noexcept
+	{
+		constexpr std::size_t sampleCount = 4096;
+
+		const auto step = std::max<std::size_t>(1, text.size() / sampleCount);
+
+		std::uint64_t hash = 0xCBF29CE484222325ull;
+
+		for (std::size_t i = 0; i < text.size(); i += step)
+		{
+			hash = (hash ^ static_cast<std::uint64_t>(text[i])) * 0x100000001B3ull;
+		}
+
+		return hash;
+	}
+
+	[[nodiscard]] constexpr std::size_t GetVarintSize(std::uint32_t value) noexcept
+	{
+		std::size_t result = 1;
+
+		while (value >= 0x80) { value >>= 7; ++result; }
+
+		return result;
+	}
+
+	void WriteVarint(std::uint8_t*& out, std::uint32_t value) noexcept
+	{
+		while (value >= 0x80)
+		{
+			*out++ = static_cast<std::uint8_t>(value | 0x80);
+			value >>= 7;
+		}
+
+		*out++ = static_cast<std::uint8_t>(value);
+	}
+
+	// returns false if the varint runs past end or does not fit 32 bits
+	[[nodiscard]] bool ReadVarint(const std::uint8_t*& in, const std::uint8_t* end, std::uint32_t& value) noexcept
+	{
+		value = 0;
+
+		for (std::uint32_t shift = 0; in != end; shift += 7)
+		{
+			const auto byte = *in++;
+
+			if (shift == 28 && byte > 0x0F) return false;
+
+			value |= static_cast<std::uint32_t>(byte & 0x7F) << shift;
+
+			if (!(byte & 0x80)) return true;
+		}
+
+		return false;
+	}
+
+	// the posting list of a bucket names blocks in increasing order, the first one may be block 0
+	[[nodiscard]] bool IsPostingListValid(const std::uint8_t* in, const std::uint8_t* end, const std::size_t blockCount) noexcept
+	{
+		std::uint64_t block = 0;
+
+		for (bool first = true; in != end; first = false)
+		{
+			std::uint32_t delta = 0;
+
+			if (!ReadVarint(in, end, delta) || (delta == 0 && !first)) return false;
+
+			block += delta;
+
+			if (block >= blockCount) return false;
+		}
+
+		return true;
+	}
+}
+
+TrigramIndex::~TrigramIndex()
+{
+	m_clear();
+}
+
+void TrigramIndex::m_build(const std::wstring_view text, std::wstring persistPath)
+{
+	m_clear();
+
+	m_thread = std::thread([this, text, path = std::move(persistPath)] ()
+	{
+		if (!path.empty() && m_loadIndex(text, path))
+		{
+			m_ready.store(true, std::memory_order_release);
+			return;
+		}
+
+		m_buildIndex(text);
+
+		if (m_cancel.load(std::memory_order_relaxed)) return;
+
+		m_ready.store(true, std::memory_order_release);
+
+		if (!path.empty()) (void)m_saveIndex(text, path);
+	});
+}
+
+void TrigramIndex::m_clear() noexcept
+{
+	if (m_thread.joinable())
+	{
+		m_cancel.store(true, std::memory_order_relaxed);
+		m_thread.join();
+	}
+
+	m_cancel.store(false, std::memory_order_relaxed);
+	m_ready.store(false, std::memory_order_relaxed);
+
+	m_textSize = 0;
+	m_blockCount = 0;
+
+	m_offsets  = {};
+	m_postings = {};
+}
+
+void TrigramIndex::m_buildIndex(const std::wstring_view text) noexcept
+{
+	m_textSize   = text.size();
+	m_blockCount = (text.size() + s_blockSize - 1) / s_blockSize;
+
+	// distinct buckets of every block, in block order
+	std::vector<std::uint32_t> blockBuckets;
+	std::vector<std::size_t  > blockStarts = { 0 };
+
+	std::vector<std::uint64_t> seenBuckets(s_bucketCount / 64);
+	std::wstring folded(s_blockSize + 2, L'\0');
+
+	for (SizeType block = 0; block < m_blockCount; ++block)
+	{
+		if (m_cancel.load(std::memory_order_relaxed)) return;
+
+		const auto start = block * s_blockSize;
+		const auto end   = std::min(text.size(), start + s_blockSize);
+
+		// trigrams starting at the end of the block read into the next one
+		const auto foldedSize = std::min(text.size(), end + 2) - start;
+
+		TextSearch::s_foldCase(text.data() + start, folded.data(), foldedSize);
+
+		const auto firstBucket = blockBuckets.size();
+
+		for (SizeType i = 0; i + 2 < foldedSize && start + i < end; ++i)
+		{
+			const auto bucket = GetTrigramBucket(folded[i], folded[i + 1], folded[i + 2]);
+			auto& word = seenBuckets[bucket / 64];
+			const auto bit = std::uint64_t(1) << (bucket % 64);
+
+			if (!(word & bit))
+			{
+				word |= bit;
+				blockBuckets.push_back(bucket);
+			}
+		}
+
+		for (auto i = firstBucket; i < blockBuckets.size(); ++i)
+		{
+			seenBuckets[blockBuckets[i] / 64] = 0;
+		}
+
+		blockStarts.push_back(blockBuckets.size());
+	}
+
+	// first pass computes posting list sizes, second one writes them
+	std::vector<std::uint32_t> lastBlock(s_bucketCount, 0);
+	std::vector<std::uint64_t> offsets(s_bucketCount + 1, 0);
+
+	for (SizeType block = 0; block < m_blockCount; ++block)
+	{
+		for (auto i = blockStarts[block]; i < blockStarts[block + 1]; ++i)
+		{
+			const auto bucket = blockBuckets[i];
+
+			offsets[bucket + 1] += GetVarintSize(static_cast<std::uint32_t>(block) - lastBlock[bucket]);
+			lastBlock[bucket] = static_cast<std::uint32_t>(block);
+		}
+	}
+
+	for (std::uint32_t i = 0; i < s_bucketCount; ++i) offsets[i + 1] += offsets[i];
+
+	std::vector<std::uint8_t> postings(offsets.back());
+	std::vector<std::uint64_t> writeOffsets(offsets.begin(), offsets.end() - 1);
+
+	std::fill(lastBlock.begin(), lastBlock.end(), 0);
+
+	for (SizeType block = 0; block < m_blockCount; ++block)
+	{
+		if (m_cancel.load(std::memory_order_relaxed)) return;
+
+		for (auto i = blockStarts[block]; i < blockStarts[block + 1]; ++i)
+		{
+			const auto bucket = blockBuckets[i];
+
+			auto out = postings.data() + writeOffsets[bucket];
+
+			WriteVarint(out, static_cast<std::uint32_t>(block) - lastBlock[bucket]);
+
+			writeOffsets[bucket] = static_cast<std::uint64_t>(out - postings.data());
+			lastBlock[bucket] = static_cast<std::uint32_t>(block);
+		}
+	}
+
+	m_offsets  = std::move(offsets);
+	m_postings = std::move(postings);
+}
+
+[[nodiscard]] std::vector<std::pair<TrigramIndex::SizeType, TrigramIndex::SizeType>>
+TrigramIndex::m_getCandidateRanges(const TextSearch& search) const
+{
+	if (!m_isReady() || m_blockCount == 0) return {};
+
+	auto pattern = search.m_getPattern();
+
+	if (pattern.size() < 3 || pattern.size() > s_blockSize / 2) return { { 0, m_textSize } };
+
+	TextSearch::s_foldCase(pattern.data(), pattern.data(), pattern.size());
+
+	std::vector<std::uint32_t> buckets;
+
+	for (SizeType i = 0; i + 2 < pattern.size(); ++i)
+	{
+		buckets.push_back(GetTrigramBucket(pattern[i], pattern[i + 1], pattern[i + 2]));
+	}
+
+	std::sort(buckets.begin(), buckets.end());
+	buckets.erase(std::unique(buckets.begin(), buckets.end()), buckets.end());
+
+	const auto wordCount = (m_blockCount + 63) / 64;
+
+	std::vector<std::uint64_t> candidates(wordCount, ~std::uint64_t(0));
+	std::vector<std::uint64_t> current(wordCount);
+
+	for (const auto bucket : buckets)
+	{
+		std::fill(current.begin(), current.end(), 0);
+
+		auto in = m_postings.data() + m_offsets[bucket];
+		const auto end = m_postings.data() + m_offsets[bucket + 1];
+
+		std::uint32_t block = 0;
+
+		for (std::uint32_t delta = 0; in != end && ReadVarint(in, end, delta) && block + delta < m_blockCount; )
+		{
+			block += delta;
+
+			// a match starting in a block may end in the next one,
+			// so the trigram counts for the previous block as well
+			current[block / 64] |= std::uint64_t(1) << (block % 64);
+
+			if (block > 0) current[(block - 1) / 64] |= std::uint64_t(1) << ((block - 1) % 64);
+		}
+
+		for (SizeType i = 0; i < wordCount; ++i) candidates[i] &= current[i];
+	}
+
+	std::vector<std::pair<SizeType, SizeType>> result;
+
+	for (SizeType block = 0; block < m_blockCount; ++block)
+	{
+		if (!(candidates[block / 64] & (std::uint64_t(1) << (block % 64)))) continue;
+
+		const auto first = block * s_blockSize;
+		const auto last  = std::min(m_textSize, first + s_blockSize + pattern.size() - 1);
+
+		if (!result.empty() && result.back().second >= first) result.back().second = last;
+		else result.emplace_back(first, last);
+	}
+
+	return result;
+}
+
+[[nodiscard]] bool TrigramIndex::m_loadIndex(const std::wstring_view text, const std::wstring& path) noexcept
+{
+	// the sizes read from the file are checked against it before anything is allocated for them
+	WIN32_FILE_ATTRIBUTE_DATA attributes = {};
+	if (!GetFileAttributesExW(path.c_str(), GetFileExInfoStandard, &attributes)) return false;
+
+	const auto fileSize = (static_cast<std::uint64_t>(attributes.nFileSizeHigh) << 32) | attributes.nFileSizeLow;
+
+	std::FILE* file = nullptr;
+	if (_wfopen_s(&file, path.c_str(), L"rb") || !file) return false;
+
+	IndexHeader header = {};
+
+	bool result = std::fread(&header, sizeof(header), 1, file) == 1
+		&& std::memcmp(header.m_magic, s_indexMagic, sizeof(s_indexMagic)) == 0
+		&& header.m_version    == s_indexVersion
+		&& header.m_textSize   == text.size()
+		&& header.m_blockSize  == s_blockSize
+		&& header.m_bucketBits == s_bucketBits
+		&& header.m_sampleHash == GetSampleHash(text);
+
+	if (result)
+	{
+		m_offsets.resize(s_bucketCount + 1);
+
+		result = std::fread(m_offsets.data(), sizeof(std::uint64_t), m_offsets.size(), file) == m_offsets.size()
+			&& m_offsets.front() == 0
+			&& std::is_sorted(m_offsets.cbegin(), m_offsets.cend())
+			&& m_offsets.back() == fileSize - sizeof(header) - m_offsets.size() * sizeof(std::uint64_t);
+	}
+
+	if (result)
+	{
+		m_postings.resize(m_offsets.back());
+
+		result = std::fread(m_postings.data(), 1, m_postings.size(), file) == m_postings.size();
+	}
+
+	std::fclose(file);
+
+	const auto blockCount = (text.size() + s_blockSize - 1) / s_blockSize;
+
+	for (std::uint32_t bucket = 0; result && bucket < s_bucketCount; ++bucket)
+	{
+		result = IsPostingListValid(m_postings.data() + m_offsets[bucket], m_postings.data() + m_offsets[bucket + 1], blockCount);
+	}
+
+	if (!result)
+	{
+		m_offsets  = {};
+		m_postings = {};
+
+		return false;
+	}
+
+	m_textSize   = text.size();
+	m_blockCount = blockCount;
+
+	return true;
+}
+
+[[nodiscard]] bool TrigramIndex::m_saveIndex(const std::wstring_view text, const std::wstring& path) const noexcept
+{
+	// a reader never sees a half written index, the finished file replaces the old one at once
+	const auto tempPath = path + L'.' + std::to_wstring(GetCurrentThreadId()) + L".tmp";
+
+	std::FILE* file = nullptr;
+	if (_wfopen_s(&file, tempPath.c_str(), L"wb") || !file) return false;
+
+	IndexHeader header = {};
+
+	std::memcpy(header.m_magic, s_indexMagic, sizeof(s_indexMagic));
+
+	header.m_version    = s_indexVersion;
+	header.m_textSize   = text.size();
+	header.m_sampleHash = GetSampleHash(text);
+	header.m_blockSize  = s_blockSize;
+	header.m_bucketBits = s_bucketBits;
+
+	bool result = std::fwrite(&header, sizeof(header), 1, file) == 1
+		&& std::fwrite(m_offsets.data(), sizeof(std::uint64_t), m_offsets.size(), file) == m_offsets.size()
+		&& std::fwrite(m_postings.data(), 1, m_postings.size(), file) == m_postings.size();
+
+	result = std::fclose(file) == 0 && result;
+
+	if (!result || !MoveFileExW(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING))
+	{
+		DeleteFileW(tempPath.c_str());
+		return false;
+	}
+
+	return true;
+}
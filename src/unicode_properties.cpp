@@ -0,0 +1,1135 @@
+#include "../include/unicode_properties.h"
+
+#include <array>
+#include <algorithm>
+#include <type_traits>
+
+namespace
+{
+	using GB = UnicodeProperties::GraphemeBreak;
+	using WB = UnicodeProperties::WordBreak;
+
+	// every code point in [first, last] with a step of stride has the value, code points in no range have the default
+	template<typename Value>
+	struct PropertyRange
+	{
+		std::uint32_t m_first;
+		std::uint32_t m_last;
+		Value         m_value;
+		std::uint32_t m_stride = 1;
+	};
+
+	// the ranges are taken from the unicode 14.0 database
+
+	// cells of the BMP code points, combining marks and format characters take none,
+	// East_Asian_Width W and F take two, everything else one
+	constexpr PropertyRange<std::uint8_t> s_widthRanges[] =
+	{
+		{ 0x0300, 0x036F, 0 }, { 0x0483, 0x0489, 0 }, { 0x0591, 0x05BD, 0 },
+		{ 0x05BF, 0x05BF, 0 }, { 0x05C1, 0x05C2, 0 }, { 0x05C4, 0x05C5, 0 },
+		{ 0x05C7, 0x05C7, 0 }, { 0x0600, 0x0605, 0 }, { 0x0610, 0x061A, 0 },
+		{ 0x061C, 0x061C, 0 }, { 0x064B, 0x065F, 0 }, { 0x0670, 0x0670, 0 },
+		{ 0x06D6, 0x06DD, 0 }, { 0x06DF, 0x06E4, 0 }, { 0x06E7, 0x06E8, 0 },
+		{ 0x06EA, 0x06ED, 0 }, { 0x070F, 0x070F, 0 }, { 0x0711, 0x0711, 0 },
+		{ 0x0730, 0x074A, 0 }, { 0x07A6, 0x07B0, 0 }, { 0x07EB, 0x07F3, 0 },
+		{ 0x07FD, 0x07FD, 0 }, { 0x0816, 0x0819, 0 }, { 0x081B, 0x0823, 0 },
+		{ 0x0825, 0x0827, 0 }, { 0x0829, 0x082D, 0 }, { 0x0859, 0x085B, 0 },
+		{ 0x0890, 0x0891, 0 }, { 0x0898, 0x089F, 0 }, { 0x08CA, 0x0902, 0 },
+		{ 0x093A, 0x093A, 0 }, { 0x093C, 0x093C, 0 }, { 0x0941, 0x0948, 0 },
+		{ 0x094D, 0x094D, 0 }, { 0x0951, 0x0957, 0 }, { 0x0962, 0x0963, 0 },
+		{ 0x0981, 0x0981, 0 }, { 0x09BC, 0x09BC, 0 }, { 0x09C1, 0x09C4, 0 },
+		{ 0x09CD, 0x09CD, 0 }, { 0x09E2, 0x09E3, 0 }, { 0x09FE, 0x09FE, 0 },
+		{ 0x0A01, 0x0A02, 0 }, { 0x0A3C, 0x0A3C, 0 }, { 0x0A41, 0x0A42, 0 },
+		{ 0x0A47, 0x0A48, 0 }, { 0x0A4B, 0x0A4D, 0 }, { 0x0A51, 0x0A51, 0 },
+		{ 0x0A70, 0x0A71, 0 }, { 0x0A75, 0x0A75, 0 }, { 0x0A81, 0x0A82, 0 },
+		{ 0x0ABC, 0x0ABC, 0 }, { 0x0AC1, 0x0AC5, 0 }, { 0x0AC7, 0x0AC8, 0 },
+		{ 0x0ACD, 0x0ACD, 0 }, { 0x0AE2, 0x0AE3, 0 }, { 0x0AFA, 0x0AFF, 0 },
+		{ 0x0B01, 0x0B01, 0 }, { 0x0B3C, 0x0B3C, 0 }, { 0x0B3F, 0x0B3F, 0 },
+		{ 0x0B41, 0x0B44, 0 }, { 0x0B4D, 0x0B4D, 0 }, { 0x0B55, 0x0B56, 0 },
+		{ 0x0B62, 0x0B63, 0 }, { 0x0B82, 0x0B82, 0 }, { 0x0BC0, 0x0BC0, 0 },
+		{ 0x0BCD, 0x0BCD, 0 }, { 0x0C00, 0x0C00, 0 }, { 0x0C04, 0x0C04, 0 },
+		{ 0x0C3C, 0x0C3C, 0 }, { 0x0C3E, 0x0C40, 0 }, { 0x0C46, 0x0C48, 0 },
+		{ 0x0C4A, 0x0C4D, 0 }, { 0x0C55, 0x0C56, 0 }, { 0x0C62, 0x0C63, 0 },
+		{ 0x0C81, 0x0C81, 0 }, { 0x0CBC, 0x0CBC, 0 }, { 0x0CBF, 0x0CBF, 0 },
+		{ 0x0CC6, 0x0CC6, 0 }, { 0x0CCC, 0x0CCD, 0 }, { 0x0CE2, 0x0CE3, 0 },
+		{ 0x0D00, 0x0D01, 0 }, { 0x0D3B, 0x0D3C, 0 }, { 0x0D41, 0x0D44, 0 },
+		{ 0x0D4D, 0x0D4D, 0 }, { 0x0D62, 0x0D63, 0 }, { 0x0D81, 0x0D81, 0 },
+		{ 0x0DCA, 0x0DCA, 0 }, { 0x0DD2, 0x0DD4, 0 }, { 0x0DD6, 0x0DD6, 0 },
+		{ 0x0E31, 0x0E31, 0 }, { 0x0E34, 0x0E3A, 0 }, { 0x0E47, 0x0E4E, 0 },
+		{ 0x0EB1, 0x0EB1, 0 }, { 0x0EB4, 0x0EBC, 0 }, { 0x0EC8, 0x0ECD, 0 },
+		{ 0x0F18, 0x0F19, 0 }, { 0x0F35, 0x0F35, 0 }, { 0x0F37, 0x0F37, 0 },
+		{ 0x0F39, 0x0F39, 0 }, { 0x0F71, 0x0F7E, 0 }, { 0x0F80, 0x0F84, 0 },
+		{ 0x0F86, 0x0F87, 0 }, { 0x0F8D, 0x0F97, 0 }, { 0x0F99, 0x0FBC, 0 },
+		{ 0x0FC6, 0x0FC6, 0 }, { 0x102D, 0x1030, 0 }, { 0x1032, 0x1037, 0 },
+		{ 0x1039, 0x103A, 0 }, { 0x103D, 0x103E, 0 }, { 0x1058, 0x1059, 0 },
+		{ 0x105E, 0x1060, 0 }, { 0x1071, 0x1074, 0 }, { 0x1082, 0x1082, 0 },
+		{ 0x1085, 0x1086, 0 }, { 0x108D, 0x108D, 0 }, { 0x109D, 0x109D, 0 },
+		{ 0x1100, 0x115F, 2 }, { 0x1160, 0x11FF, 0 }, { 0x135D, 0x135F, 0 },
+		{ 0x1712, 0x1714, 0 }, { 0x1732, 0x1733, 0 }, { 0x1752, 0x1753, 0 },
+		{ 0x1772, 0x1773, 0 }, { 0x17B4, 0x17B5, 0 }, { 0x17B7, 0x17BD, 0 },
+		{ 0x17C6, 0x17C6, 0 }, { 0x17C9, 0x17D3, 0 }, { 0x17DD, 0x17DD, 0 },
+		{ 0x180B, 0x180F, 0 }, { 0x1885, 0x1886, 0 }, { 0x18A9, 0x18A9, 0 },
+		{ 0x1920, 0x1922, 0 }, { 0x1927, 0x1928, 0 }, { 0x1932, 0x1932, 0 },
+		{ 0x1939, 0x193B, 0 }, { 0x1A17, 0x1A18, 0 }, { 0x1A1B, 0x1A1B, 0 },
+		{ 0x1A56, 0x1A56, 0 }, { 0x1A58, 0x1A5E, 0 }, { 0x1A60, 0x1A60, 0 },
+		{ 0x1A62, 0x1A62, 0 }, { 0x1A65, 0x1A6C, 0 }, { 0x1A73, 0x1A7C, 0 },
+		{ 0x1A7F, 0x1A7F, 0 }, { 0x1AB0, 0x1ACE, 0 }, { 0x1B00, 0x1B03, 0 },
+		{ 0x1B34, 0x1B34, 0 }, { 0x1B36, 0x1B3A, 0 }, { 0x1B3C, 0x1B3C, 0 },
+		{ 0x1B42, 0x1B42, 0 }, { 0x1B6B, 0x1B73, 0 }, { 0x1B80, 0x1B81, 0 },
+		{ 0x1BA2, 0x1BA5, 0 }, { 0x1BA8, 0x1BA9, 0 }, { 0x1BAB, 0x1BAD, 0 },
+		{ 0x1BE6, 0x1BE6, 0 }, { 0x1BE8, 0x1BE9, 0 }, { 0x1BED, 0x1BED, 0 },
+		{ 0x1BEF, 0x1BF1, 0 }, { 0x1C2C, 0x1C33, 0 }, { 0x1C36, 0x1C37, 0 },
+		{ 0x1CD0, 0x1CD2, 0 }, { 0x1CD4, 0x1CE0, 0 }, { 0x1CE2, 0x1CE8, 0 },
+		{ 0x1CED, 0x1CED, 0 }, { 0x1CF4, 0x1CF4, 0 }, { 0x1CF8, 0x1CF9, 0 },
+		{ 0x1DC0, 0x1DFF, 0 }, { 0x200B, 0x200F, 0 }, { 0x202A, 0x202E, 0 },
+		{ 0x2060, 0x2064, 0 }, { 0x2066, 0x206F, 0 }, { 0x20D0, 0x20F0, 0 },
+		{ 0x231A, 0x231B, 2 }, { 0x2329, 0x232A, 2 }, { 0x23E9, 0x23EC, 2 },
+		{ 0x23F0, 0x23F0, 2 }, { 0x23F3, 0x23F3, 2 }, { 0x25FD, 0x25FE, 2 },
+		{ 0x2614, 0x2615, 2 }, { 0x2648, 0x2653, 2 }, { 0x267F, 0x267F, 2 },
+		{ 0x2693, 0x2693, 2 }, { 0x26A1, 0x26A1, 2 }, { 0x26AA, 0x26AB, 2 },
+		{ 0x26BD, 0x26BE, 2 }, { 0x26C4, 0x26C5, 2 }, { 0x26CE, 0x26CE, 2 },
+		{ 0x26D4, 0x26D4, 2 }, { 0x26EA, 0x26EA, 2 }, { 0x26F2, 0x26F3, 2 },
+		{ 0x26F5, 0x26F5, 2 }, { 0x26FA, 0x26FA, 2 }, { 0x26FD, 0x26FD, 2 },
+		{ 0x2705, 0x2705, 2 }, { 0x270A, 0x270B, 2 }, { 0x2728, 0x2728, 2 },
+		{ 0x274C, 0x274C, 2 }, { 0x274E, 0x274E, 2 }, { 0x2753, 0x2755, 2 },
+		{ 0x2757, 0x2757, 2 }, { 0x2795, 0x2797, 2 }, { 0x27B0, 0x27B0, 2 },
+		{ 0x27BF, 0x27BF, 2 }, { 0x2B1B, 0x2B1C, 2 }, { 0x2B50, 0x2B50, 2 },
+		{ 0x2B55, 0x2B55, 2 }, { 0x2CEF, 0x2CF1, 0 }, { 0x2D7F, 0x2D7F, 0 },
+		{ 0x2DE0, 0x2DFF, 0 }, { 0x2E80, 0x2E99, 2 }, { 0x2E9B, 0x2EF3, 2 },
+		{ 0x2F00, 0x2FD5, 2 }, { 0x2FF0, 0x2FFB, 2 }, { 0x3000, 0x3029, 2 },
+		{ 0x302A, 0x302D, 0 }, { 0x302E, 0x303E, 2 }, { 0x3041, 0x3096, 2 },
+		{ 0x3099, 0x309A, 0 }, { 0x309B, 0x30FF, 2 }, { 0x3105, 0x312F, 2 },
+		{ 0x3131, 0x318E, 2 }, { 0x3190, 0x31E3, 2 }, { 0x31F0, 0x321E, 2 },
+		{ 0x3220, 0x3247, 2 }, { 0x3250, 0x4DBF, 2 }, { 0x4E00, 0xA48C, 2 },
+		{ 0xA490, 0xA4C6, 2 }, { 0xA66F, 0xA672, 0 }, { 0xA674, 0xA67D, 0 },
+		{ 0xA69E, 0xA69F, 0 }, { 0xA6F0, 0xA6F1, 0 }, { 0xA802, 0xA802, 0 },
+		{ 0xA806, 0xA806, 0 }, { 0xA80B, 0xA80B, 0 }, { 0xA825, 0xA826, 0 },
+		{ 0xA82C, 0xA82C, 0 }, { 0xA8C4, 0xA8C5, 0 }, { 0xA8E0, 0xA8F1, 0 },
+		{ 0xA8FF, 0xA8FF, 0 }, { 0xA926, 0xA92D, 0 }, { 0xA947, 0xA951, 0 },
+		{ 0xA960, 0xA97C, 2 }, { 0xA980, 0xA982, 0 }, { 0xA9B3, 0xA9B3, 0 },
+		{ 0xA9B6, 0xA9B9, 0 }, { 0xA9BC, 0xA9BD, 0 }, { 0xA9E5, 0xA9E5, 0 },
+		{ 0xAA29, 0xAA2E, 0 }, { 0xAA31, 0xAA32, 0 }, { 0xAA35, 0xAA36, 0 },
+		{ 0xAA43, 0xAA43, 0 }, { 0xAA4C, 0xAA4C, 0 }, { 0xAA7C, 0xAA7C, 0 },
+		{ 0xAAB0, 0xAAB0, 0 }, { 0xAAB2, 0xAAB4, 0 }, { 0xAAB7, 0xAAB8, 0 },
+		{ 0xAABE, 0xAABF, 0 }, { 0xAAC1, 0xAAC1, 0 }, { 0xAAEC, 0xAAED, 0 },
+		{ 0xAAF6, 0xAAF6, 0 }, { 0xABE5, 0xABE5, 0 }, { 0xABE8, 0xABE8, 0 },
+		{ 0xABED, 0xABED, 0 }, { 0xAC00, 0xD7A3, 2 }, { 0xF900, 0xFAFF, 2 },
+		{ 0xFB1E, 0xFB1E, 0 }, { 0xFE00, 0xFE0F, 0 }, { 0xFE10, 0xFE19, 2 },
+		{ 0xFE20, 0xFE2F, 0 }, { 0xFE30, 0xFE52, 2 }, { 0xFE54, 0xFE66, 2 },
+		{ 0xFE68, 0xFE6B, 2 }, { 0xFEFF, 0xFEFF, 0 }, { 0xFF01, 0xFF60, 2 },
+		{ 0xFFE0, 0xFFE6, 2 }, { 0xFFF9, 0xFFFB, 0 },
+	};
+
+	// Grapheme_Cluster_Break with Extended_Pictographic, the LV syllables are every 28th one of the hangul block
+	constexpr PropertyRange<GB> s_graphemeBreakRanges[] =
+	{
+		{ 0x0000, 0x0009, GB::Control },                { 0x000A, 0x000A, GB::LF },
+		{ 0x000B, 0x000C, GB::Control },                { 0x000D, 0x000D, GB::CR },
+		{ 0x000E, 0x001F, GB::Control },                { 0x007F, 0x009F, GB::Control },
+		{ 0x00A9, 0x00A9, GB::ExtendedPictographic },   { 0x00AD, 0x00AD, GB::Control },
+		{ 0x00AE, 0x00AE, GB::ExtendedPictographic },   { 0x0300, 0x036F, GB::Extend },
+		{ 0x0483, 0x0489, GB::Extend },                 { 0x0591, 0x05BD, GB::Extend },
+		{ 0x05BF, 0x05BF, GB::Extend },                 { 0x05C1, 0x05C2, GB::Extend },
+		{ 0x05C4, 0x05C5, GB::Extend },                 { 0x05C7, 0x05C7, GB::Extend },
+		{ 0x0600, 0x0605, GB::Prepend },                { 0x0610, 0x061A, GB::Extend },
+		{ 0x061C, 0x061C, GB::Control },                { 0x064B, 0x065F, GB::Extend },
+		{ 0x0670, 0x0670, GB::Extend },                 { 0x06D6, 0x06DC, GB::Extend },
+		{ 0x06DD, 0x06DD, GB::Prepend },                { 0x06DF, 0x06E4, GB::Extend },
+		{ 0x06E7, 0x06E8, GB::Extend },                 { 0x06EA, 0x06ED, GB::Extend },
+		{ 0x070F, 0x070F, GB::Prepend },                { 0x0711, 0x0711, GB::Extend },
+		{ 0x0730, 0x074A, GB::Extend },                 { 0x07A6, 0x07B0, GB::Extend },
+		{ 0x07EB, 0x07F3, GB::Extend },                 { 0x07FD, 0x07FD, GB::Extend },
+		{ 0x0816, 0x0819, GB::Extend },                 { 0x081B, 0x0823, GB::Extend },
+		{ 0x0825, 0x0827, GB::Extend },                 { 0x0829, 0x082D, GB::Extend },
+		{ 0x0859, 0x085B, GB::Extend },                 { 0x0890, 0x0891, GB::Prepend },
+		{ 0x0898, 0x089F, GB::Extend },                 { 0x08CA, 0x08E1, GB::Extend },
+		{ 0x08E2, 0x08E2, GB::Prepend },                { 0x08E3, 0x0902, GB::Extend },
+		{ 0x0903, 0x0903, GB::SpacingMark },            { 0x093A, 0x093A, GB::Extend },
+		{ 0x093B, 0x093B, GB::SpacingMark },            { 0x093C, 0x093C, GB::Extend },
+		{ 0x093E, 0x0940, GB::SpacingMark },            { 0x0941, 0x0948, GB::Extend },
+		{ 0x0949, 0x094C, GB::SpacingMark },            { 0x094D, 0x094D, GB::Extend },
+		{ 0x094E, 0x094F, GB::SpacingMark },            { 0x0951, 0x0957, GB::Extend },
+		{ 0x0962, 0x0963, GB::Extend },                 { 0x0981, 0x0981, GB::Extend },
+		{ 0x0982, 0x0983, GB::SpacingMark },            { 0x09BC, 0x09BC, GB::Extend },
+		{ 0x09BE, 0x09BE, GB::Extend },                 { 0x09BF, 0x09C0, GB::SpacingMark },
+		{ 0x09C1, 0x09C4, GB::Extend },                 { 0x09C7, 0x09C8, GB::SpacingMark },
+		{ 0x09CB, 0x09CC, GB::SpacingMark },            { 0x09CD, 0x09CD, GB::Extend },
+		{ 0x09D7, 0x09D7, GB::Extend },                 { 0x09E2, 0x09E3, GB::Extend },
+		{ 0x09FE, 0x09FE, GB::Extend },                 { 0x0A01, 0x0A02, GB::Extend },
+		{ 0x0A03, 0x0A03, GB::SpacingMark },            { 0x0A3C, 0x0A3C, GB::Extend },
+		{ 0x0A3E, 0x0A40, GB::SpacingMark },            { 0x0A41, 0x0A42, GB::Extend },
+		{ 0x0A47, 0x0A48, GB::Extend },                 { 0x0A4B, 0x0A4D, GB::Extend },
+		{ 0x0A51, 0x0A51, GB::Extend },                 { 0x0A70, 0x0A71, GB::Extend },
+		{ 0x0A75, 0x0A75, GB::Extend },                 { 0x0A81, 0x0A82, GB::Extend },
+		{ 0x0A83, 0x0A83, GB::SpacingMark },            { 0x0ABC, 0x0ABC, GB::Extend },
+		{ 0x0ABE, 0x0AC0, GB::SpacingMark },            { 0x0AC1, 0x0AC5, GB::Extend },
+		{ 0x0AC7, 0x0AC8, GB::Extend },                 { 0x0AC9, 0x0AC9, GB::SpacingMark },
+		{ 0x0ACB, 0x0ACC, GB::SpacingMark },            { 0x0ACD, 0x0ACD, GB::Extend },
+		{ 0x0AE2, 0x0AE3, GB::Extend },                 { 0x0AFA, 0x0AFF, GB::Extend },
+		{ 0x0B01, 0x0B01, GB::Extend },                 { 0x0B02, 0x0B03, GB::SpacingMark },
+		{ 0x0B3C, 0x0B3C, GB::Extend },                 { 0x0B3E, 0x0B3F, GB::Extend },
+		{ 0x0B40, 0x0B40, GB::SpacingMark },            { 0x0B41, 0x0B44, GB::Extend },
+		{ 0x0B47, 0x0B48, GB::SpacingMark },            { 0x0B4B, 0x0B4C, GB::SpacingMark },
+		{ 0x0B4D, 0x0B4D, GB::Extend },                 { 0x0B55, 0x0B57, GB::Extend },
+		{ 0x0B62, 0x0B63, GB::Extend },                 { 0x0B82, 0x0B82, GB::Extend },
+		{ 0x0BBE, 0x0BBE, GB::Extend },                 { 0x0BBF, 0x0BBF, GB::SpacingMark },
+		{ 0x0BC0, 0x0BC0, GB::Extend },                 { 0x0BC1, 0x0BC2, GB::SpacingMark },
+		{ 0x0BC6, 0x0BC8, GB::SpacingMark },            { 0x0BCA, 0x0BCC, GB::SpacingMark },
+		{ 0x0BCD, 0x0BCD, GB::Extend },                 { 0x0BD7, 0x0BD7, GB::Extend },
+		{ 0x0C00, 0x0C00, GB::Extend },                 { 0x0C01, 0x0C03, GB::SpacingMark },
+		{ 0x0C04, 0x0C04, GB::Extend },                 { 0x0C3C, 0x0C3C, GB::Extend },
+		{ 0x0C3E, 0x0C40, GB::Extend },                 { 0x0C41, 0x0C44, GB::SpacingMark },
+		{ 0x0C46, 0x0C48, GB::Extend },                 { 0x0C4A, 0x0C4D, GB::Extend },
+		{ 0x0C55, 0x0C56, GB::Extend },                 { 0x0C62, 0x0C63, GB::Extend },
+		{ 0x0C81, 0x0C81, GB::Extend },                 { 0x0C82, 0x0C83, GB::SpacingMark },
+		{ 0x0CBC, 0x0CBC, GB::Extend },                 { 0x0CBE, 0x0CBE, GB::SpacingMark },
+		{ 0x0CBF, 0x0CBF, GB::Extend },                 { 0x0CC0, 0x0CC1, GB::SpacingMark },
+		{ 0x0CC2, 0x0CC2, GB::Extend },                 { 0x0CC3, 0x0CC4, GB::SpacingMark },
+		{ 0x0CC6, 0x0CC6, GB::Extend },                 { 0x0CC7, 0x0CC8, GB::SpacingMark },
+		{ 0x0CCA, 0x0CCB, GB::SpacingMark },            { 0x0CCC, 0x0CCD, GB::Extend },
+		{ 0x0CD5, 0x0CD6, GB::Extend },                 { 0x0CE2, 0x0CE3, GB::Extend },
+		{ 0x0D00, 0x0D01, GB::Extend },                 { 0x0D02, 0x0D03, GB::SpacingMark },
+		{ 0x0D3B, 0x0D3C, GB::Extend },                 { 0x0D3E, 0x0D3E, GB::Extend },
+		{ 0x0D3F, 0x0D40, GB::SpacingMark },            { 0x0D41, 0x0D44, GB::Extend },
+		{ 0x0D46, 0x0D48, GB::SpacingMark },            { 0x0D4A, 0x0D4C, GB::SpacingMark },
+		{ 0x0D4D, 0x0D4D, GB::Extend },                 { 0x0D4E, 0x0D4E, GB::Prepend },
+		{ 0x0D57, 0x0D57, GB::Extend },                 { 0x0D62, 0x0D63, GB::Extend },
+		{ 0x0D81, 0x0D81, GB::Extend },                 { 0x0D82, 0x0D83, GB::SpacingMark },
+		{ 0x0DCA, 0x0DCA, GB::Extend },                 { 0x0DCF, 0x0DCF, GB::Extend },
+		{ 0x0DD0, 0x0DD1, GB::SpacingMark },            { 0x0DD2, 0x0DD4, GB::Extend },
+		{ 0x0DD6, 0x0DD6, GB::Extend },                 { 0x0DD8, 0x0DDE, GB::SpacingMark },
+		{ 0x0DDF, 0x0DDF, GB::Extend },                 { 0x0DF2, 0x0DF3, GB::SpacingMark },
+		{ 0x0E31, 0x0E31, GB::Extend },                 { 0x0E33, 0x0E33, GB::SpacingMark },
+		{ 0x0E34, 0x0E3A, GB::Extend },                 { 0x0E47, 0x0E4E, GB::Extend },
+		{ 0x0EB1, 0x0EB1, GB::Extend },                 { 0x0EB3, 0x0EB3, GB::SpacingMark },
+		{ 0x0EB4, 0x0EBC, GB::Extend },                 { 0x0EC8, 0x0ECD, GB::Extend },
+		{ 0x0F18, 0x0F19, GB::Extend },                 { 0x0F35, 0x0F35, GB::Extend },
+		{ 0x0F37, 0x0F37, GB::Extend },                 { 0x0F39, 0x0F39, GB::Extend },
+		{ 0x0F3E, 0x0F3F, GB::SpacingMark },            { 0x0F71, 0x0F7E, GB::Extend },
+		{ 0x0F7F, 0x0F7F, GB::SpacingMark },            { 0x0F80, 0x0F84, GB::Extend },
+		{ 0x0F86, 0x0F87, GB::Extend },                 { 0x0F8D, 0x0F97, GB::Extend },
+		{ 0x0F99, 0x0FBC, GB::Extend },                 { 0x0FC6, 0x0FC6, GB::Extend },
+		{ 0x102D, 0x1030, GB::Extend },                 { 0x1031, 0x1031, GB::SpacingMark },
+		{ 0x1032, 0x1037, GB::Extend },                 { 0x1039, 0x103A, GB::Extend },
+		{ 0x103B, 0x103C, GB::SpacingMark },            { 0x103D, 0x103E, GB::Extend },
+		{ 0x1056, 0x1057, GB::SpacingMark },            { 0x1058, 0x1059, GB::Extend },
+		{ 0x105E, 0x1060, GB::Extend },                 { 0x1071, 0x1074, GB::Extend },
+		{ 0x1082, 0x1082, GB::Extend },                 { 0x1084, 0x1084, GB::SpacingMark },
+		{ 0x1085, 0x1086, GB::Extend },                 { 0x108D, 0x108D, GB::Extend },
+		{ 0x109D, 0x109D, GB::Extend },                 { 0x1100, 0x115F, GB::L },
+		{ 0x1160, 0x11A7, GB::V },                      { 0x11A8, 0x11FF, GB::T },
+		{ 0x135D, 0x135F, GB::Extend },                 { 0x1712, 0x1714, GB::Extend },
+		{ 0x1715, 0x1715, GB::SpacingMark },            { 0x1732, 0x1733, GB::Extend },
+		{ 0x1734, 0x1734, GB::SpacingMark },            { 0x1752, 0x1753, GB::Extend },
+		{ 0x1772, 0x1773, GB::Extend },                 { 0x17B4, 0x17B5, GB::Extend },
+		{ 0x17B6, 0x17B6, GB::SpacingMark },            { 0x17B7, 0x17BD, GB::Extend },
+		{ 0x17BE, 0x17C5, GB::SpacingMark },            { 0x17C6, 0x17C6, GB::Extend },
+		{ 0x17C7, 0x17C8, GB::SpacingMark },            { 0x17C9, 0x17D3, GB::Extend },
+		{ 0x17DD, 0x17DD, GB::Extend },                 { 0x180B, 0x180D, GB::Extend },
+		{ 0x180E, 0x180E, GB::Control },                { 0x180F, 0x180F, GB::Extend },
+		{ 0x1885, 0x1886, GB::Extend },                 { 0x18A9, 0x18A9, GB::Extend },
+		{ 0x1920, 0x1922, GB::Extend },                 { 0x1923, 0x1926, GB::SpacingMark },
+		{ 0x1927, 0x1928, GB::Extend },                 { 0x1929, 0x192B, GB::SpacingMark },
+		{ 0x1930, 0x1931, GB::SpacingMark },            { 0x1932, 0x1932, GB::Extend },
+		{ 0x1933, 0x1938, GB::SpacingMark },            { 0x1939, 0x193B, GB::Extend },
+		{ 0x1A17, 0x1A18, GB::Extend },                 { 0x1A19, 0x1A1A, GB::SpacingMark },
+		{ 0x1A1B, 0x1A1B, GB::Extend },                 { 0x1A55, 0x1A55, GB::SpacingMark },
+		{ 0x1A56, 0x1A56, GB::Extend },                 { 0x1A57, 0x1A57, GB::SpacingMark },
+		{ 0x1A58, 0x1A5E, GB::Extend },                 { 0x1A60, 0x1A60, GB::Extend },
+		{ 0x1A62, 0x1A62, GB::Extend },                 { 0x1A65, 0x1A6C, GB::Extend },
+		{ 0x1A6D, 0x1A72, GB::SpacingMark },            { 0x1A73, 0x1A7C, GB::Extend },
+		{ 0x1A7F, 0x1A7F, GB::Extend },                 { 0x1AB0, 0x1ACE, GB::Extend },
+		{ 0x1B00, 0x1B03, GB::Extend },                 { 0x1B04, 0x1B04, GB::SpacingMark },
+		{ 0x1B34, 0x1B3A, GB::Extend },                 { 0x1B3B, 0x1B3B, GB::SpacingMark },
+		{ 0x1B3C, 0x1B3C, GB::Extend },                 { 0x1B3D, 0x1B41, GB::SpacingMark },
+		{ 0x1B42, 0x1B42, GB::Extend },                 { 0x1B43, 0x1B44, GB::SpacingMark },
+		{ 0x1B6B, 0x1B73, GB::Extend },                 { 0x1B80, 0x1B81, GB::Extend },
+		{ 0x1B82, 0x1B82, GB::SpacingMark },            { 0x1BA1, 0x1BA1, GB::SpacingMark },
+		{ 0x1BA2, 0x1BA5, GB::Extend },                 { 0x1BA6, 0x1BA7, GB::SpacingMark },
+		{ 0x1BA8, 0x1BA9, GB::Extend },                 { 0x1BAA, 0x1BAA, GB::SpacingMark },
+		{ 0x1BAB, 0x1BAD, GB::Extend },                 { 0x1BE6, 0x1BE6, GB::Extend },
+		{ 0x1BE7, 0x1BE7, GB::SpacingMark },            { 0x1BE8, 0x1BE9, GB::Extend },
+		{ 0x1BEA, 0x1BEC, GB::SpacingMark },            { 0x1BED, 0x1BED, GB::Extend },
+		{ 0x1BEE, 0x1BEE, GB::SpacingMark },            { 0x1BEF, 0x1BF1, GB::Extend },
+		{ 0x1BF2, 0x1BF3, GB::SpacingMark },            { 0x1C24, 0x1C2B, GB::SpacingMark },
+		{ 0x1C2C, 0x1C33, GB::Extend },                 { 0x1C34, 0x1C35, GB::SpacingMark },
+		{ 0x1C36, 0x1C37, GB::Extend },                 { 0x1CD0, 0x1CD2, GB::Extend },
+		{ 0x1CD4, 0x1CE0, GB::Extend },                 { 0x1CE1, 0x1CE1, GB::SpacingMark },
+		{ 0x1CE2, 0x1CE8, GB::Extend },                 { 0x1CED, 0x1CED, GB::Extend },
+		{ 0x1CF4, 0x1CF4, GB::Extend },                 { 0x1CF7, 0x1CF7, GB::SpacingMark },
+		{ 0x1CF8, 0x1CF9, GB::Extend },                 { 0x1DC0, 0x1DFF, GB::Extend },
+		{ 0x200B, 0x200B, GB::Control },                { 0x200C, 0x200C, GB::Extend },
+		{ 0x200D, 0x200D, GB::ZWJ },                    { 0x200E, 0x200F, GB::Control },
+		{ 0x2028, 0x202E, GB::Control },                { 0x203C, 0x203C, GB::ExtendedPictographic },
+		{ 0x2049, 0x2049, GB::ExtendedPictographic },   { 0x2060, 0x2064, GB::Control },
+		{ 0x2066, 0x206F, GB::Control },                { 0x20D0, 0x20F0, GB::Extend },
+		{ 0x2122, 0x2122, GB::ExtendedPictographic },   { 0x2139, 0x2139, GB::ExtendedPictographic },
+		{ 0x2194, 0x2199, GB::ExtendedPictographic },   { 0x21A9, 0x21AA, GB::ExtendedPictographic },
+		{ 0x231A, 0x231B, GB::ExtendedPictographic },   { 0x2328, 0x2328, GB::ExtendedPictographic },
+		{ 0x2388, 0x2388, GB::ExtendedPictographic },   { 0x23CF, 0x23CF, GB::ExtendedPictographic },
+		{ 0x23E9, 0x23F3, GB::ExtendedPictographic },   { 0x23F8, 0x23FA, GB::ExtendedPictographic },
+		{ 0x24C2, 0x24C2, GB::ExtendedPictographic },   { 0x25AA, 0x25AB, GB::ExtendedPictographic },
+		{ 0x25B6, 0x25B6, GB::ExtendedPictographic },   { 0x25C0, 0x25C0, GB::ExtendedPictographic },
+		{ 0x25FB, 0x25FE, GB::ExtendedPictographic },   { 0x2600, 0x2605, GB::ExtendedPictographic },
+		{ 0x2607, 0x2612, GB::ExtendedPictographic },   { 0x2614, 0x2685, GB::ExtendedPictographic },
+		{ 0x2690, 0x2705, GB::ExtendedPictographic },   { 0x2708, 0x2712, GB::ExtendedPictographic },
+		{ 0x2714, 0x2714, GB::ExtendedPictographic },   { 0x2716, 0x2716, GB::ExtendedPictographic },
+		{ 0x271D, 0x271D, GB::ExtendedPictographic },   { 0x2721, 0x2721, GB::ExtendedPictographic },
+		{ 0x2728, 0x2728, GB::ExtendedPictographic },   { 0x2733, 0x2734, GB::ExtendedPictographic },
+		{ 0x2744, 0x2744, GB::ExtendedPictographic },   { 0x2747, 0x2747, GB::ExtendedPictographic },
+		{ 0x274C, 0x274C, GB::ExtendedPictographic },   { 0x274E, 0x274E, GB::ExtendedPictographic },
+		{ 0x2753, 0x2755, GB::ExtendedPictographic },   { 0x2757, 0x2757, GB::ExtendedPictographic },
+		{ 0x2763, 0x2767, GB::ExtendedPictographic },   { 0x2795, 0x2797, GB::ExtendedPictographic },
+		{ 0x27A1, 0x27A1, GB::ExtendedPictographic },   { 0x27B0, 0x27B0, GB::ExtendedPictographic },
+		{ 0x27BF, 0x27BF, GB::ExtendedPictographic },   { 0x2934, 0x2935, GB::ExtendedPictographic },
+		{ 0x2B05, 0x2B07, GB::ExtendedPictographic },   { 0x2B1B, 0x2B1C, GB::ExtendedPictographic },
+		{ 0x2B50, 0x2B50, GB::ExtendedPictographic },   { 0x2B55, 0x2B55, GB::ExtendedPictographic },
+		{ 0x2CEF, 0x2CF1, GB::Extend },                 { 0x2D7F, 0x2D7F, GB::Extend },
+		{ 0x2DE0, 0x2DFF, GB::Extend },                 { 0x302A, 0x302F, GB::Extend },
+		{ 0x3030, 0x3030, GB::ExtendedPictographic },   { 0x303D, 0x303D, GB::ExtendedPictographic },
+		{ 0x3099, 0x309A, GB::Extend },                 { 0x3297, 0x3297, GB::ExtendedPictographic },
+		{ 0x3299, 0x3299, GB::ExtendedPictographic },   { 0xA66F, 0xA672, GB::Extend },
+		{ 0xA674, 0xA67D, GB::Extend },                 { 0xA69E, 0xA69F, GB::Extend },
+		{ 0xA6F0, 0xA6F1, GB::Extend },                 { 0xA802, 0xA802, GB::Extend },
+		{ 0xA806, 0xA806, GB::Extend },                 { 0xA80B, 0xA80B, GB::Extend },
+		{ 0xA823, 0xA824, GB::SpacingMark },            { 0xA825, 0xA826, GB::Extend },
+		{ 0xA827, 0xA827, GB::SpacingMark },            { 0xA82C, 0xA82C, GB::Extend },
+		{ 0xA880, 0xA881, GB::SpacingMark },            { 0xA8B4, 0xA8C3, GB::SpacingMark },
+		{ 0xA8C4, 0xA8C5, GB::Extend },                 { 0xA8E0, 0xA8F1, GB::Extend },
+		{ 0xA8FF, 0xA8FF, GB::Extend },                 { 0xA926, 0xA92D, GB::Extend },
+		{ 0xA947, 0xA951, GB::Extend },                 { 0xA952, 0xA953, GB::SpacingMark },
+		{ 0xA960, 0xA97C, GB::L },                      { 0xA980, 0xA982, GB::Extend },
+		{ 0xA983, 0xA983, GB::SpacingMark },            { 0xA9B3, 0xA9B3, GB::Extend },
+		{ 0xA9B4, 0xA9B5, GB::SpacingMark },            { 0xA9B6, 0xA9B9, GB::Extend },
+		{ 0xA9BA, 0xA9BB, GB::SpacingMark },            { 0xA9BC, 0xA9BD, GB::Extend },
+		{ 0xA9BE, 0xA9C0, GB::SpacingMark },            { 0xA9E5, 0xA9E5, GB::Extend },
+		{ 0xAA29, 0xAA2E, GB::Extend },                 { 0xAA2F, 0xAA30, GB::SpacingMark },
+		{ 0xAA31, 0xAA32, GB::Extend },                 { 0xAA33, 0xAA34, GB::SpacingMark },
+		{ 0xAA35, 0xAA36, GB::Extend },                 { 0xAA43, 0xAA43, GB::Extend },
+		{ 0xAA4C, 0xAA4C, GB::Extend },                 { 0xAA4D, 0xAA4D, GB::SpacingMark },
+		{ 0xAA7C, 0xAA7C, GB::Extend },                 { 0xAAB0, 0xAAB0, GB::Extend },
+		{ 0xAAB2, 0xAAB4, GB::Extend },                 { 0xAAB7, 0xAAB8, GB::Extend },
+		{ 0xAABE, 0xAABF, GB::Extend },                 { 0xAAC1, 0xAAC1, GB::Extend },
+		{ 0xAAEB, 0xAAEB, GB::SpacingMark },            { 0xAAEC, 0xAAED, GB::Extend },
+		{ 0xAAEE, 0xAAEF, GB::SpacingMark },            { 0xAAF5, 0xAAF5, GB::SpacingMark },
+		{ 0xAAF6, 0xAAF6, GB::Extend },                 { 0xABE3, 0xABE4, GB::SpacingMark },
+		{ 0xABE5, 0xABE5, GB::Extend },                 { 0xABE6, 0xABE7, GB::SpacingMark },
+		{ 0xABE8, 0xABE8, GB::Extend },                 { 0xABE9, 0xABEA, GB::SpacingMark },
+		{ 0xABEC, 0xABEC, GB::SpacingMark },            { 0xABED, 0xABED, GB::Extend },
+		{ 0xAC00, 0xD7A3, GB::LVT },                    { 0xAC00, 0xD788, GB::LV, 28 },
+		{ 0xD7B0, 0xD7C6, GB::V },                      { 0xD7CB, 0xD7FB, GB::T },
+		{ 0xFB1E, 0xFB1E, GB::Extend },                 { 0xFE00, 0xFE0F, GB::Extend },
+		{ 0xFE20, 0xFE2F, GB::Extend },                 { 0xFEFF, 0xFEFF, GB::Control },
+		{ 0xFF9E, 0xFF9F, GB::Extend },                 { 0xFFF9, 0xFFFB, GB::Control },
+		{ 0x101FD, 0x101FD, GB::Extend },               { 0x102E0, 0x102E0, GB::Extend },
+		{ 0x10376, 0x1037A, GB::Extend },               { 0x10A01, 0x10A03, GB::Extend },
+		{ 0x10A05, 0x10A06, GB::Extend },               { 0x10A0C, 0x10A0F, GB::Extend },
+		{ 0x10A38, 0x10A3A, GB::Extend },               { 0x10A3F, 0x10A3F, GB::Extend },
+		{ 0x10AE5, 0x10AE6, GB::Extend },               { 0x10D24, 0x10D27, GB::Extend },
+		{ 0x10EAB, 0x10EAC, GB::Extend },               { 0x10F46, 0x10F50, GB::Extend },
+		{ 0x10F82, 0x10F85, GB::Extend },               { 0x11000, 0x11000, GB::SpacingMark },
+		{ 0x11001, 0x11001, GB::Extend },               { 0x11002, 0x11002, GB::SpacingMark },
+		{ 0x11038, 0x11046, GB::Extend },               { 0x11070, 0x11070, GB::Extend },
+		{ 0x11073, 0x11074, GB::Extend },               { 0x1107F, 0x11081, GB::Extend },
+		{ 0x11082, 0x11082, GB::SpacingMark },          { 0x110B0, 0x110B2, GB::SpacingMark },
+		{ 0x110B3, 0x110B6, GB::Extend },               { 0x110B7, 0x110B8, GB::SpacingMark },
+		{ 0x110B9, 0x110BA, GB::Extend },               { 0x110BD, 0x110BD, GB::Prepend },
+		{ 0x110C2, 0x110C2, GB::Extend },               { 0x110CD, 0x110CD, GB::Prepend },
+		{ 0x11100, 0x11102, GB::Extend },               { 0x11127, 0x1112B, GB::Extend },
+		{ 0x1112C, 0x1112C, GB::SpacingMark },          { 0x1112D, 0x11134, GB::Extend },
+		{ 0x11145, 0x11146, GB::SpacingMark },          { 0x11173, 0x11173, GB::Extend },
+		{ 0x11180, 0x11181, GB::Extend },               { 0x11182, 0x11182, GB::SpacingMark },
+		{ 0x111B3, 0x111B5, GB::SpacingMark },          { 0x111B6, 0x111BE, GB::Extend },
+		{ 0x111BF, 0x111C0, GB::SpacingMark },          { 0x111C2, 0x111C3, GB::Prepend },
+		{ 0x111C9, 0x111CC, GB::Extend },               { 0x111CE, 0x111CE, GB::SpacingMark },
+		{ 0x111CF, 0x111CF, GB::Extend },               { 0x1122C, 0x1122E, GB::SpacingMark },
+		{ 0x1122F, 0x11231, GB::Extend },               { 0x11232, 0x11233, GB::SpacingMark },
+		{ 0x11234, 0x11234, GB::Extend },               { 0x11235, 0x11235, GB::SpacingMark },
+		{ 0x11236, 0x11237, GB::Extend },               { 0x1123E, 0x1123E, GB::Extend },
+		{ 0x112DF, 0x112DF, GB::Extend },               { 0x112E0, 0x112E2, GB::SpacingMark },
+		{ 0x112E3, 0x112EA, GB::Extend },               { 0x11300, 0x11301, GB::Extend },
+		{ 0x11302, 0x11303, GB::SpacingMark },          { 0x1133B, 0x1133C, GB::Extend },
+		{ 0x1133E, 0x1133F, GB::SpacingMark },          { 0x11340, 0x11340, GB::Extend },
+		{ 0x11341, 0x11344, GB::SpacingMark },          { 0x11347, 0x11348, GB::SpacingMark },
+		{ 0x1134B, 0x1134D, GB::SpacingMark },          { 0x11357, 0x11357, GB::SpacingMark },
+		{ 0x11362, 0x11363, GB::SpacingMark },          { 0x11366, 0x1136C, GB::Extend },
+		{ 0x11370, 0x11374, GB::Extend },               { 0x11435, 0x11437, GB::SpacingMark },
+		{ 0x11438, 0x1143F, GB::Extend },               { 0x11440, 0x11441, GB::SpacingMark },
+		{ 0x11442, 0x11444, GB::Extend },               { 0x11445, 0x11445, GB::SpacingMark },
+		{ 0x11446, 0x11446, GB::Extend },               { 0x1145E, 0x1145E, GB::Extend },
+		{ 0x114B0, 0x114B2, GB::SpacingMark },          { 0x114B3, 0x114B8, GB::Extend },
+		{ 0x114B9, 0x114B9, GB::SpacingMark },          { 0x114BA, 0x114BA, GB::Extend },
+		{ 0x114BB, 0x114BE, GB::SpacingMark },          { 0x114BF, 0x114C0, GB::Extend },
+		{ 0x114C1, 0x114C1, GB::SpacingMark },          { 0x114C2, 0x114C3, GB::Extend },
+		{ 0x115AF, 0x115B1, GB::SpacingMark },          { 0x115B2, 0x115B5, GB::Extend },
+		{ 0x115B8, 0x115BB, GB::SpacingMark },          { 0x115BC, 0x115BD, GB::Extend },
+		{ 0x115BE, 0x115BE, GB::SpacingMark },          { 0x115BF, 0x115C0, GB::Extend },
+		{ 0x115DC, 0x115DD, GB::Extend },               { 0x11630, 0x11632, GB::SpacingMark },
+		{ 0x11633, 0x1163A, GB::Extend },               { 0x1163B, 0x1163C, GB::SpacingMark },
+		{ 0x1163D, 0x1163D, GB::Extend },               { 0x1163E, 0x1163E, GB::SpacingMark },
+		{ 0x1163F, 0x11640, GB::Extend },               { 0x116AB, 0x116AB, GB::Extend },
+		{ 0x116AC, 0x116AC, GB::SpacingMark },          { 0x116AD, 0x116AD, GB::Extend },
+		{ 0x116AE, 0x116AF, GB::SpacingMark },          { 0x116B0, 0x116B5, GB::Extend },
+		{ 0x116B6, 0x116B6, GB::SpacingMark },          { 0x116B7, 0x116B7, GB::Extend },
+		{ 0x1171D, 0x1171F, GB::Extend },               { 0x11722, 0x11725, GB::Extend },
+		{ 0x11726, 0x11726, GB::SpacingMark },          { 0x11727, 0x1172B, GB::Extend },
+		{ 0x1182C, 0x1182E, GB::SpacingMark },          { 0x1182F, 0x11837, GB::Extend },
+		{ 0x11838, 0x11838, GB::SpacingMark },          { 0x11839, 0x1183A, GB::Extend },
+		{ 0x11930, 0x11935, GB::SpacingMark },          { 0x11937, 0x11938, GB::SpacingMark },
+		{ 0x1193B, 0x1193C, GB::Extend },               { 0x1193D, 0x1193D, GB::SpacingMark },
+		{ 0x1193E, 0x1193E, GB::Extend },               { 0x11940, 0x11940, GB::SpacingMark },
+		{ 0x11942, 0x11942, GB::SpacingMark },          { 0x11943, 0x11943, GB::Extend },
+		{ 0x119D1, 0x119D3, GB::SpacingMark },          { 0x119D4, 0x119D7, GB::Extend },
+		{ 0x119DA, 0x119DB, GB::Extend },               { 0x119DC, 0x119DF, GB::SpacingMark },
+		{ 0x119E0, 0x119E0, GB::Extend },               { 0x119E4, 0x119E4, GB::SpacingMark },
+		{ 0x11A01, 0x11A0A, GB::Extend },               { 0x11A33, 0x11A38, GB::Extend },
+		{ 0x11A39, 0x11A39, GB::SpacingMark },          { 0x11A3B, 0x11A3E, GB::Extend },
+		{ 0x11A47, 0x11A47, GB::Extend },               { 0x11A51, 0x11A56, GB::Extend },
+		{ 0x11A57, 0x11A58, GB::SpacingMark },          { 0x11A59, 0x11A5B, GB::Extend },
+		{ 0x11A8A, 0x11A96, GB::Extend },               { 0x11A97, 0x11A97, GB::SpacingMark },
+		{ 0x11A98, 0x11A99, GB::Extend },               { 0x11C2F, 0x11C2F, GB::SpacingMark },
+		{ 0x11C30, 0x11C36, GB::Extend },               { 0x11C38, 0x11C3D, GB::Extend },
+		{ 0x11C3E, 0x11C3E, GB::SpacingMark },          { 0x11C3F, 0x11C3F, GB::Extend },
+		{ 0x11C92, 0x11CA7, GB::Extend },               { 0x11CA9, 0x11CA9, GB::SpacingMark },
+		{ 0x11CAA, 0x11CB0, GB::Extend },               { 0x11CB1, 0x11CB1, GB::SpacingMark },
+		{ 0x11CB2, 0x11CB3, GB::Extend },               { 0x11CB4, 0x11CB4, GB::SpacingMark },
+		{ 0x11CB5, 0x11CB6, GB::Extend },               { 0x11D31, 0x11D36, GB::Extend },
+		{ 0x11D3A, 0x11D3A, GB::Extend },               { 0x11D3C, 0x11D3D, GB::Extend },
+		{ 0x11D3F, 0x11D45, GB::Extend },               { 0x11D47, 0x11D47, GB::Extend },
+		{ 0x11D8A, 0x11D8E, GB::SpacingMark },          { 0x11D90, 0x11D91, GB::Extend },
+		{ 0x11D93, 0x11D94, GB::SpacingMark },          { 0x11D95, 0x11D95, GB::Extend },
+		{ 0x11D96, 0x11D96, GB::SpacingMark },          { 0x11D97, 0x11D97, GB::Extend },
+		{ 0x11EF3, 0x11EF4, GB::Extend },               { 0x11EF5, 0x11EF6, GB::SpacingMark },
+		{ 0x13430, 0x13438, GB::Control },              { 0x16AF0, 0x16AF4, GB::Extend },
+		{ 0x16B30, 0x16B36, GB::Extend },               { 0x16F4F, 0x16F4F, GB::Extend },
+		{ 0x16F51, 0x16F87, GB::SpacingMark },          { 0x16F8F, 0x16F92, GB::Extend },
+		{ 0x16FE4, 0x16FE4, GB::Extend },               { 0x16FF0, 0x16FF1, GB::SpacingMark },
+		{ 0x1BC9D, 0x1BC9E, GB::Extend },               { 0x1BCA0, 0x1BCA3, GB::Control },
+		{ 0x1CF00, 0x1CF2D, GB::Extend },               { 0x1CF30, 0x1CF46, GB::Extend },
+		{ 0x1D165, 0x1D165, GB::Extend },               { 0x1D166, 0x1D166, GB::SpacingMark },
+		{ 0x1D167, 0x1D169, GB::Extend },               { 0x1D16D, 0x1D16D, GB::SpacingMark },
+		{ 0x1D16E, 0x1D172, GB::Extend },               { 0x1D173, 0x1D17A, GB::Control },
+		{ 0x1D17B, 0x1D182, GB::Extend },               { 0x1D185, 0x1D18B, GB::Extend },
+		{ 0x1D1AA, 0x1D1AD, GB::Extend },               { 0x1D242, 0x1D244, GB::Extend },
+		{ 0x1DA00, 0x1DA36, GB::Extend },               { 0x1DA3B, 0x1DA6C, GB::Extend },
+		{ 0x1DA75, 0x1DA75, GB::Extend },               { 0x1DA84, 0x1DA84, GB::Extend },
+		{ 0x1DA9B, 0x1DA9F, GB::Extend },               { 0x1DAA1, 0x1DAAF, GB::Extend },
+		{ 0x1E000, 0x1E006, GB::Extend },               { 0x1E008, 0x1E018, GB::Extend },
+		{ 0x1E01B, 0x1E021, GB::Extend },               { 0x1E023, 0x1E024, GB::Extend },
+		{ 0x1E026, 0x1E02A, GB::Extend },               { 0x1E130, 0x1E136, GB::Extend },
+		{ 0x1E2AE, 0x1E2AE, GB::Extend },               { 0x1E2EC, 0x1E2EF, GB::Extend },
+		{ 0x1E8D0, 0x1E8D6, GB::Extend },               { 0x1E944, 0x1E94A, GB::Extend },
+		{ 0x1F000, 0x1F0FF, GB::ExtendedPictographic }, { 0x1F10D, 0x1F10F, GB::ExtendedPictographic },
+		{ 0x1F12F, 0x1F12F, GB::ExtendedPictographic }, { 0x1F16C, 0x1F171, GB::ExtendedPictographic },
+		{ 0x1F17E, 0x1F17F, GB::ExtendedPictographic }, { 0x1F18E, 0x1F18E, GB::ExtendedPictographic },
+		{ 0x1F191, 0x1F19A, GB::ExtendedPictographic }, { 0x1F1AD, 0x1F1E5, GB::ExtendedPictographic },
+		{ 0x1F1E6, 0x1F1FF, GB::RegionalIndicator },    { 0x1F201, 0x1F20F, GB::ExtendedPictographic },
+		{ 0x1F21A, 0x1F21A, GB::ExtendedPictographic }, { 0x1F22F, 0x1F22F, GB::ExtendedPictographic },
+		{ 0x1F232, 0x1F23A, GB::ExtendedPictographic }, { 0x1F23C, 0x1F23F, GB::ExtendedPictographic },
+		{ 0x1F249, 0x1F3FA, GB::ExtendedPictographic }, { 0x1F3FB, 0x1F3FF, GB::Extend },
+		{ 0x1F400, 0x1F53D, GB::ExtendedPictographic }, { 0x1F546, 0x1F64F, GB::ExtendedPictographic },
+		{ 0x1F680, 0x1F6FF, GB::ExtendedPictographic }, { 0x1F774, 0x1F77F, GB::ExtendedPictographic },
+		{ 0x1F7D5, 0x1F7FF, GB::ExtendedPictographic }, { 0x1F80C, 0x1F80F, GB::ExtendedPictographic },
+		{ 0x1F848, 0x1F84F, GB::ExtendedPictographic }, { 0x1F85A, 0x1F85F, GB::ExtendedPictographic },
+		{ 0x1F888, 0x1F88F, GB::ExtendedPictographic }, { 0x1F8AE, 0x1F8FF, GB::ExtendedPictographic },
+		{ 0x1F90C, 0x1F93A, GB::ExtendedPictographic }, { 0x1F93C, 0x1F945, GB::ExtendedPictographic },
+		{ 0x1F947, 0x1FAFF, GB::ExtendedPictographic }, { 0x1FC00, 0x1FFFD, GB::ExtendedPictographic },
+		{ 0xE0001, 0xE0001, GB::Control },              { 0xE0020, 0xE007F, GB::Extend },
+		{ 0xE0100, 0xE01EF, GB::Extend },
+	};
+
+	// letters, numbers and marks are AlphaNumeric, the scripts written without spaces get their own class
+	constexpr PropertyRange<WB> s_wordBreakRanges[] =
+	{
+		{ 0x0030, 0x0039, WB::AlphaNumeric },   { 0x0041, 0x005A, WB::AlphaNumeric },
+		{ 0x0061, 0x007A, WB::AlphaNumeric },   { 0x00AA, 0x00AA, WB::AlphaNumeric },
+		{ 0x00B5, 0x00B5, WB::AlphaNumeric },   { 0x00BA, 0x00BA, WB::AlphaNumeric },
+		{ 0x00C0, 0x00D6, WB::AlphaNumeric },   { 0x00D8, 0x00F6, WB::AlphaNumeric },
+		{ 0x00F8, 0x02C1, WB::AlphaNumeric },   { 0x02C6, 0x02D1, WB::AlphaNumeric },
+		{ 0x02E0, 0x02E4, WB::AlphaNumeric },   { 0x02EC, 0x02EC, WB::AlphaNumeric },
+		{ 0x02EE, 0x02EE, WB::AlphaNumeric },   { 0x0300, 0x0374, WB::AlphaNumeric },
+		{ 0x0376, 0x0377, WB::AlphaNumeric },   { 0x037A, 0x037D, WB::AlphaNumeric },
+		{ 0x037F, 0x037F, WB::AlphaNumeric },   { 0x0386, 0x0386, WB::AlphaNumeric },
+		{ 0x0388, 0x038A, WB::AlphaNumeric },   { 0x038C, 0x038C, WB::AlphaNumeric },
+		{ 0x038E, 0x03A1, WB::AlphaNumeric },   { 0x03A3, 0x03F5, WB::AlphaNumeric },
+		{ 0x03F7, 0x0481, WB::AlphaNumeric },   { 0x0483, 0x052F, WB::AlphaNumeric },
+		{ 0x0531, 0x0556, WB::AlphaNumeric },   { 0x0559, 0x0559, WB::AlphaNumeric },
+		{ 0x0560, 0x0588, WB::AlphaNumeric },   { 0x0591, 0x05BD, WB::AlphaNumeric },
+		{ 0x05BF, 0x05BF, WB::AlphaNumeric },   { 0x05C1, 0x05C2, WB::AlphaNumeric },
+		{ 0x05C4, 0x05C5, WB::AlphaNumeric },   { 0x05C7, 0x05C7, WB::AlphaNumeric },
+		{ 0x05D0, 0x05EA, WB::AlphaNumeric },   { 0x05EF, 0x05F2, WB::AlphaNumeric },
+		{ 0x0610, 0x061A, WB::AlphaNumeric },   { 0x0620, 0x0669, WB::AlphaNumeric },
+		{ 0x066E, 0x06D3, WB::AlphaNumeric },   { 0x06D5, 0x06DC, WB::AlphaNumeric },
+		{ 0x06DF, 0x06E8, WB::AlphaNumeric },   { 0x06EA, 0x06FC, WB::AlphaNumeric },
+		{ 0x06FF, 0x06FF, WB::AlphaNumeric },   { 0x0710, 0x074A, WB::AlphaNumeric },
+		{ 0x074D, 0x07B1, WB::AlphaNumeric },   { 0x07C0, 0x07F5, WB::AlphaNumeric },
+		{ 0x07FA, 0x07FA, WB::AlphaNumeric },   { 0x07FD, 0x07FD, WB::AlphaNumeric },
+		{ 0x0800, 0x082D, WB::AlphaNumeric },   { 0x0840, 0x085B, WB::AlphaNumeric },
+		{ 0x0860, 0x086A, WB::AlphaNumeric },   { 0x0870, 0x0887, WB::AlphaNumeric },
+		{ 0x0889, 0x088E, WB::AlphaNumeric },   { 0x0898, 0x08E1, WB::AlphaNumeric },
+		{ 0x08E3, 0x0963, WB::AlphaNumeric },   { 0x0966, 0x096F, WB::AlphaNumeric },
+		{ 0x0971, 0x0983, WB::AlphaNumeric },   { 0x0985, 0x098C, WB::AlphaNumeric },
+		{ 0x098F, 0x0990, WB::AlphaNumeric },   { 0x0993, 0x09A8, WB::AlphaNumeric },
+		{ 0x09AA, 0x09B0, WB::AlphaNumeric },   { 0x09B2, 0x09B2, WB::AlphaNumeric },
+		{ 0x09B6, 0x09B9, WB::AlphaNumeric },   { 0x09BC, 0x09C4, WB::AlphaNumeric },
+		{ 0x09C7, 0x09C8, WB::AlphaNumeric },   { 0x09CB, 0x09CE, WB::AlphaNumeric },
+		{ 0x09D7, 0x09D7, WB::AlphaNumeric },   { 0x09DC, 0x09DD, WB::AlphaNumeric },
+		{ 0x09DF, 0x09E3, WB::AlphaNumeric },   { 0x09E6, 0x09F1, WB::AlphaNumeric },
+		{ 0x09FC, 0x09FC, WB::AlphaNumeric },   { 0x09FE, 0x09FE, WB::AlphaNumeric },
+		{ 0x0A01, 0x0A03, WB::AlphaNumeric },   { 0x0A05, 0x0A0A, WB::AlphaNumeric },
+		{ 0x0A0F, 0x0A10, WB::AlphaNumeric },   { 0x0A13, 0x0A28, WB::AlphaNumeric },
+		{ 0x0A2A, 0x0A30, WB::AlphaNumeric },   { 0x0A32, 0x0A33, WB::AlphaNumeric },
+		{ 0x0A35, 0x0A36, WB::AlphaNumeric },   { 0x0A38, 0x0A39, WB::AlphaNumeric },
+		{ 0x0A3C, 0x0A3C, WB::AlphaNumeric },   { 0x0A3E, 0x0A42, WB::AlphaNumeric },
+		{ 0x0A47, 0x0A48, WB::AlphaNumeric },   { 0x0A4B, 0x0A4D, WB::AlphaNumeric },
+		{ 0x0A51, 0x0A51, WB::AlphaNumeric },   { 0x0A59, 0x0A5C, WB::AlphaNumeric },
+		{ 0x0A5E, 0x0A5E, WB::AlphaNumeric },   { 0x0A66, 0x0A75, WB::AlphaNumeric },
+		{ 0x0A81, 0x0A83, WB::AlphaNumeric },   { 0x0A85, 0x0A8D, WB::AlphaNumeric },
+		{ 0x0A8F, 0x0A91, WB::AlphaNumeric },   { 0x0A93, 0x0AA8, WB::AlphaNumeric },
+		{ 0x0AAA, 0x0AB0, WB::AlphaNumeric },   { 0x0AB2, 0x0AB3, WB::AlphaNumeric },
+		{ 0x0AB5, 0x0AB9, WB::AlphaNumeric },   { 0x0ABC, 0x0AC5, WB::AlphaNumeric },
+		{ 0x0AC7, 0x0AC9, WB::AlphaNumeric },   { 0x0ACB, 0x0ACD, WB::AlphaNumeric },
+		{ 0x0AD0, 0x0AD0, WB::AlphaNumeric },   { 0x0AE0, 0x0AE3, WB::AlphaNumeric },
+		{ 0x0AE6, 0x0AEF, WB::AlphaNumeric },   { 0x0AF9, 0x0AFF, WB::AlphaNumeric },
+		{ 0x0B01, 0x0B03, WB::AlphaNumeric },   { 0x0B05, 0x0B0C, WB::AlphaNumeric },
+		{ 0x0B0F, 0x0B10, WB::AlphaNumeric },   { 0x0B13, 0x0B28, WB::AlphaNumeric },
+		{ 0x0B2A, 0x0B30, WB::AlphaNumeric },   { 0x0B32, 0x0B33, WB::AlphaNumeric },
+		{ 0x0B35, 0x0B39, WB::AlphaNumeric },   { 0x0B3C, 0x0B44, WB::AlphaNumeric },
+		{ 0x0B47, 0x0B48, WB::AlphaNumeric },   { 0x0B4B, 0x0B4D, WB::AlphaNumeric },
+		{ 0x0B55, 0x0B57, WB::AlphaNumeric },   { 0x0B5C, 0x0B5D, WB::AlphaNumeric },
+		{ 0x0B5F, 0x0B63, WB::AlphaNumeric },   { 0x0B66, 0x0B6F, WB::AlphaNumeric },
+		{ 0x0B71, 0x0B71, WB::AlphaNumeric },   { 0x0B82, 0x0B83, WB::AlphaNumeric },
+		{ 0x0B85, 0x0B8A, WB::AlphaNumeric },   { 0x0B8E, 0x0B90, WB::AlphaNumeric },
+		{ 0x0B92, 0x0B95, WB::AlphaNumeric },   { 0x0B99, 0x0B9A, WB::AlphaNumeric },
+		{ 0x0B9C, 0x0B9C, WB::AlphaNumeric },   { 0x0B9E, 0x0B9F, WB::AlphaNumeric },
+		{ 0x0BA3, 0x0BA4, WB::AlphaNumeric },   { 0x0BA8, 0x0BAA, WB::AlphaNumeric },
+		{ 0x0BAE, 0x0BB9, WB::AlphaNumeric },   { 0x0BBE, 0x0BC2, WB::AlphaNumeric },
+		{ 0x0BC6, 0x0BC8, WB::AlphaNumeric },   { 0x0BCA, 0x0BCD, WB::AlphaNumeric },
+		{ 0x0BD0, 0x0BD0, WB::AlphaNumeric },   { 0x0BD7, 0x0BD7, WB::AlphaNumeric },
+		{ 0x0BE6, 0x0BEF, WB::AlphaNumeric },   { 0x0C00, 0x0C0C, WB::AlphaNumeric },
+		{ 0x0C0E, 0x0C10, WB::AlphaNumeric },   { 0x0C12, 0x0C28, WB::AlphaNumeric },
+		{ 0x0C2A, 0x0C39, WB::AlphaNumeric },   { 0x0C3C, 0x0C44, WB::AlphaNumeric },
+		{ 0x0C46, 0x0C48, WB::AlphaNumeric },   { 0x0C4A, 0x0C4D, WB::AlphaNumeric },
+		{ 0x0C55, 0x0C56, WB::AlphaNumeric },   { 0x0C58, 0x0C5A, WB::AlphaNumeric },
+		{ 0x0C5D, 0x0C5D, WB::AlphaNumeric },   { 0x0C60, 0x0C63, WB::AlphaNumeric },
+		{ 0x0C66, 0x0C6F, WB::AlphaNumeric },   { 0x0C80, 0x0C83, WB::AlphaNumeric },
+		{ 0x0C85, 0x0C8C, WB::AlphaNumeric },   { 0x0C8E, 0x0C90, WB::AlphaNumeric },
+		{ 0x0C92, 0x0CA8, WB::AlphaNumeric },   { 0x0CAA, 0x0CB3, WB::AlphaNumeric },
+		{ 0x0CB5, 0x0CB9, WB::AlphaNumeric },   { 0x0CBC, 0x0CC4, WB::AlphaNumeric },
+		{ 0x0CC6, 0x0CC8, WB::AlphaNumeric },   { 0x0CCA, 0x0CCD, WB::AlphaNumeric },
+		{ 0x0CD5, 0x0CD6, WB::AlphaNumeric },   { 0x0CDD, 0x0CDE, WB::AlphaNumeric },
+		{ 0x0CE0, 0x0CE3, WB::AlphaNumeric },   { 0x0CE6, 0x0CEF, WB::AlphaNumeric },
+		{ 0x0CF1, 0x0CF2, WB::AlphaNumeric },   { 0x0D00, 0x0D0C, WB::AlphaNumeric },
+		{ 0x0D0E, 0x0D10, WB::AlphaNumeric },   { 0x0D12, 0x0D44, WB::AlphaNumeric },
+		{ 0x0D46, 0x0D48, WB::AlphaNumeric },   { 0x0D4A, 0x0D4E, WB::AlphaNumeric },
+		{ 0x0D54, 0x0D57, WB::AlphaNumeric },   { 0x0D5F, 0x0D63, WB::AlphaNumeric },
+		{ 0x0D66, 0x0D6F, WB::AlphaNumeric },   { 0x0D7A, 0x0D7F, WB::AlphaNumeric },
+		{ 0x0D81, 0x0D83, WB::AlphaNumeric },   { 0x0D85, 0x0D96, WB::AlphaNumeric },
+		{ 0x0D9A, 0x0DB1, WB::AlphaNumeric },   { 0x0DB3, 0x0DBB, WB::AlphaNumeric },
+		{ 0x0DBD, 0x0DBD, WB::AlphaNumeric },   { 0x0DC0, 0x0DC6, WB::AlphaNumeric },
+		{ 0x0DCA, 0x0DCA, WB::AlphaNumeric },   { 0x0DCF, 0x0DD4, WB::AlphaNumeric },
+		{ 0x0DD6, 0x0DD6, WB::AlphaNumeric },   { 0x0DD8, 0x0DDF, WB::AlphaNumeric },
+		{ 0x0DE6, 0x0DEF, WB::AlphaNumeric },   { 0x0DF2, 0x0DF3, WB::AlphaNumeric },
+		{ 0x0E01, 0x0E3A, WB::AlphaNumeric },   { 0x0E40, 0x0E4E, WB::AlphaNumeric },
+		{ 0x0E50, 0x0E59, WB::AlphaNumeric },   { 0x0E81, 0x0E82, WB::AlphaNumeric },
+		{ 0x0E84, 0x0E84, WB::AlphaNumeric },   { 0x0E86, 0x0E8A, WB::AlphaNumeric },
+		{ 0x0E8C, 0x0EA3, WB::AlphaNumeric },   { 0x0EA5, 0x0EA5, WB::AlphaNumeric },
+		{ 0x0EA7, 0x0EBD, WB::AlphaNumeric },   { 0x0EC0, 0x0EC4, WB::AlphaNumeric },
+		{ 0x0EC6, 0x0EC6, WB::AlphaNumeric },   { 0x0EC8, 0x0ECD, WB::AlphaNumeric },
+		{ 0x0ED0, 0x0ED9, WB::AlphaNumeric },   { 0x0EDC, 0x0EDF, WB::AlphaNumeric },
+		{ 0x0F00, 0x0F00, WB::AlphaNumeric },   { 0x0F18, 0x0F19, WB::AlphaNumeric },
+		{ 0x0F20, 0x0F29, WB::AlphaNumeric },   { 0x0F35, 0x0F35, WB::AlphaNumeric },
+		{ 0x0F37, 0x0F37, WB::AlphaNumeric },   { 0x0F39, 0x0F39, WB::AlphaNumeric },
+		{ 0x0F3E, 0x0F47, WB::AlphaNumeric },   { 0x0F49, 0x0F6C, WB::AlphaNumeric },
+		{ 0x0F71, 0x0F84, WB::AlphaNumeric },   { 0x0F86, 0x0F97, WB::AlphaNumeric },
+		{ 0x0F99, 0x0FBC, WB::AlphaNumeric },   { 0x0FC6, 0x0FC6, WB::AlphaNumeric },
+		{ 0x1000, 0x1049, WB::AlphaNumeric },   { 0x1050, 0x109D, WB::AlphaNumeric },
+		{ 0x10A0, 0x10C5, WB::AlphaNumeric },   { 0x10C7, 0x10C7, WB::AlphaNumeric },
+		{ 0x10CD, 0x10CD, WB::AlphaNumeric },   { 0x10D0, 0x10FA, WB::AlphaNumeric },
+		{ 0x10FC, 0x1248, WB::AlphaNumeric },   { 0x124A, 0x124D, WB::AlphaNumeric },
+		{ 0x1250, 0x1256, WB::AlphaNumeric },   { 0x1258, 0x1258, WB::AlphaNumeric },
+		{ 0x125A, 0x125D, WB::AlphaNumeric },   { 0x1260, 0x1288, WB::AlphaNumeric },
+		{ 0x128A, 0x128D, WB::AlphaNumeric },   { 0x1290, 0x12B0, WB::AlphaNumeric },
+		{ 0x12B2, 0x12B5, WB::AlphaNumeric },   { 0x12B8, 0x12BE, WB::AlphaNumeric },
+		{ 0x12C0, 0x12C0, WB::AlphaNumeric },   { 0x12C2, 0x12C5, WB::AlphaNumeric },
+		{ 0x12C8, 0x12D6, WB::AlphaNumeric },   { 0x12D8, 0x1310, WB::AlphaNumeric },
+		{ 0x1312, 0x1315, WB::AlphaNumeric },   { 0x1318, 0x135A, WB::AlphaNumeric },
+		{ 0x135D, 0x135F, WB::AlphaNumeric },   { 0x1380, 0x138F, WB::AlphaNumeric },
+		{ 0x13A0, 0x13F5, WB::AlphaNumeric },   { 0x13F8, 0x13FD, WB::AlphaNumeric },
+		{ 0x1401, 0x166C, WB::AlphaNumeric },   { 0x166F, 0x167F, WB::AlphaNumeric },
+		{ 0x1681, 0x169A, WB::AlphaNumeric },   { 0x16A0, 0x16EA, WB::AlphaNumeric },
+		{ 0x16EE, 0x16F8, WB::AlphaNumeric },   { 0x1700, 0x1715, WB::AlphaNumeric },
+		{ 0x171F, 0x1734, WB::AlphaNumeric },   { 0x1740, 0x1753, WB::AlphaNumeric },
+		{ 0x1760, 0x176C, WB::AlphaNumeric },   { 0x176E, 0x1770, WB::AlphaNumeric },
+		{ 0x1772, 0x1773, WB::AlphaNumeric },   { 0x1780, 0x17D3, WB::AlphaNumeric },
+		{ 0x17D7, 0x17D7, WB::AlphaNumeric },   { 0x17DC, 0x17DD, WB::AlphaNumeric },
+		{ 0x17E0, 0x17E9, WB::AlphaNumeric },   { 0x180B, 0x180D, WB::AlphaNumeric },
+		{ 0x180F, 0x1819, WB::AlphaNumeric },   { 0x1820, 0x1878, WB::AlphaNumeric },
+		{ 0x1880, 0x18AA, WB::AlphaNumeric },   { 0x18B0, 0x18F5, WB::AlphaNumeric },
+		{ 0x1900, 0x191E, WB::AlphaNumeric },   { 0x1920, 0x192B, WB::AlphaNumeric },
+		{ 0x1930, 0x193B, WB::AlphaNumeric },   { 0x1946, 0x196D, WB::AlphaNumeric },
+		{ 0x1970, 0x1974, WB::AlphaNumeric },   { 0x1980, 0x19AB, WB::AlphaNumeric },
+		{ 0x19B0, 0x19C9, WB::AlphaNumeric },   { 0x19D0, 0x19D9, WB::AlphaNumeric },
+		{ 0x1A00, 0x1A1B, WB::AlphaNumeric },   { 0x1A20, 0x1A5E, WB::AlphaNumeric },
+		{ 0x1A60, 0x1A7C, WB::AlphaNumeric },   { 0x1A7F, 0x1A89, WB::AlphaNumeric },
+		{ 0x1A90, 0x1A99, WB::AlphaNumeric },   { 0x1AA7, 0x1AA7, WB::AlphaNumeric },
+		{ 0x1AB0, 0x1ACE, WB::AlphaNumeric },   { 0x1B00, 0x1B4C, WB::AlphaNumeric },
+		{ 0x1B50, 0x1B59, WB::AlphaNumeric },   { 0x1B6B, 0x1B73, WB::AlphaNumeric },
+		{ 0x1B80, 0x1BF3, WB::AlphaNumeric },   { 0x1C00, 0x1C37, WB::AlphaNumeric },
+		{ 0x1C40, 0x1C49, WB::AlphaNumeric },   { 0x1C4D, 0x1C7D, WB::AlphaNumeric },
+		{ 0x1C80, 0x1C88, WB::AlphaNumeric },   { 0x1C90, 0x1CBA, WB::AlphaNumeric },
+		{ 0x1CBD, 0x1CBF, WB::AlphaNumeric },   { 0x1CD0, 0x1CD2, WB::AlphaNumeric },
+		{ 0x1CD4, 0x1CFA, WB::AlphaNumeric },   { 0x1D00, 0x1F15, WB::AlphaNumeric },
+		{ 0x1F18, 0x1F1D, WB::AlphaNumeric },   { 0x1F20, 0x1F45, WB::AlphaNumeric },
+		{ 0x1F48, 0x1F4D, WB::AlphaNumeric },   { 0x1F50, 0x1F57, WB::AlphaNumeric },
+		{ 0x1F59, 0x1F59, WB::AlphaNumeric },   { 0x1F5B, 0x1F5B, WB::AlphaNumeric },
+		{ 0x1F5D, 0x1F5D, WB::AlphaNumeric },   { 0x1F5F, 0x1F7D, WB::AlphaNumeric },
+		{ 0x1F80, 0x1FB4, WB::AlphaNumeric },   { 0x1FB6, 0x1FBC, WB::AlphaNumeric },
+		{ 0x1FBE, 0x1FBE, WB::AlphaNumeric },   { 0x1FC2, 0x1FC4, WB::AlphaNumeric },
+		{ 0x1FC6, 0x1FCC, WB::AlphaNumeric },   { 0x1FD0, 0x1FD3, WB::AlphaNumeric },
+		{ 0x1FD6, 0x1FDB, WB::AlphaNumeric },   { 0x1FE0, 0x1FEC, WB::AlphaNumeric },
+		{ 0x1FF2, 0x1FF4, WB::AlphaNumeric },   { 0x1FF6, 0x1FFC, WB::AlphaNumeric },
+		{ 0x2071, 0x2071, WB::AlphaNumeric },   { 0x207F, 0x207F, WB::AlphaNumeric },
+		{ 0x2090, 0x209C, WB::AlphaNumeric },   { 0x20D0, 0x20F0, WB::AlphaNumeric },
+		{ 0x2102, 0x2102, WB::AlphaNumeric },   { 0x2107, 0x2107, WB::AlphaNumeric },
+		{ 0x210A, 0x2113, WB::AlphaNumeric },   { 0x2115, 0x2115, WB::AlphaNumeric },
+		{ 0x2119, 0x211D, WB::AlphaNumeric },   { 0x2124, 0x2124, WB::AlphaNumeric },
+		{ 0x2126, 0x2126, WB::AlphaNumeric },   { 0x2128, 0x2128, WB::AlphaNumeric },
+		{ 0x212A, 0x212D, WB::AlphaNumeric },   { 0x212F, 0x2139, WB::AlphaNumeric },
+		{ 0x213C, 0x213F, WB::AlphaNumeric },   { 0x2145, 0x2149, WB::AlphaNumeric },
+		{ 0x214E, 0x214E, WB::AlphaNumeric },   { 0x2160, 0x2188, WB::AlphaNumeric },
+		{ 0x2C00, 0x2CE4, WB::AlphaNumeric },   { 0x2CEB, 0x2CF3, WB::AlphaNumeric },
+		{ 0x2D00, 0x2D25, WB::AlphaNumeric },   { 0x2D27, 0x2D27, WB::AlphaNumeric },
+		{ 0x2D2D, 0x2D2D, WB::AlphaNumeric },   { 0x2D30, 0x2D67, WB::AlphaNumeric },
+		{ 0x2D6F, 0x2D6F, WB::AlphaNumeric },   { 0x2D7F, 0x2D96, WB::AlphaNumeric },
+		{ 0x2DA0, 0x2DA6, WB::AlphaNumeric },   { 0x2DA8, 0x2DAE, WB::AlphaNumeric },
+		{ 0x2DB0, 0x2DB6, WB::AlphaNumeric },   { 0x2DB8, 0x2DBE, WB::AlphaNumeric },
+		{ 0x2DC0, 0x2DC6, WB::AlphaNumeric },   { 0x2DC8, 0x2DCE, WB::AlphaNumeric },
+		{ 0x2DD0, 0x2DD6, WB::AlphaNumeric },   { 0x2DD8, 0x2DDE, WB::AlphaNumeric },
+		{ 0x2DE0, 0x2DFF, WB::AlphaNumeric },   { 0x2E2F, 0x2E2F, WB::AlphaNumeric },
+		{ 0x3005, 0x3007, WB::AlphaNumeric },   { 0x3021, 0x302F, WB::AlphaNumeric },
+		{ 0x3031, 0x3035, WB::AlphaNumeric },   { 0x3038, 0x303C, WB::AlphaNumeric },
+		{ 0x3040, 0x309F, WB::Hiragana },       { 0x30A0, 0x30FF, WB::Katakana },
+		{ 0x3105, 0x312F, WB::AlphaNumeric },   { 0x3131, 0x318E, WB::AlphaNumeric },
+		{ 0x31A0, 0x31BF, WB::AlphaNumeric },   { 0x31F0, 0x31FF, WB::Katakana },
+		{ 0x3400, 0x4DBF, WB::Ideographic },    { 0x4E00, 0x9FFF, WB::Ideographic },
+		{ 0xA000, 0xA48C, WB::AlphaNumeric },   { 0xA4D0, 0xA4FD, WB::AlphaNumeric },
+		{ 0xA500, 0xA60C, WB::AlphaNumeric },   { 0xA610, 0xA62B, WB::AlphaNumeric },
+		{ 0xA640, 0xA672, WB::AlphaNumeric },   { 0xA674, 0xA67D, WB::AlphaNumeric },
+		{ 0xA67F, 0xA6F1, WB::AlphaNumeric },   { 0xA717, 0xA71F, WB::AlphaNumeric },
+		{ 0xA722, 0xA788, WB::AlphaNumeric },   { 0xA78B, 0xA7CA, WB::AlphaNumeric },
+		{ 0xA7D0, 0xA7D1, WB::AlphaNumeric },   { 0xA7D3, 0xA7D3, WB::AlphaNumeric },
+		{ 0xA7D5, 0xA7D9, WB::AlphaNumeric },   { 0xA7F2, 0xA827, WB::AlphaNumeric },
+		{ 0xA82C, 0xA82C, WB::AlphaNumeric },   { 0xA840, 0xA873, WB::AlphaNumeric },
+		{ 0xA880, 0xA8C5, WB::AlphaNumeric },   { 0xA8D0, 0xA8D9, WB::AlphaNumeric },
+		{ 0xA8E0, 0xA8F7, WB::AlphaNumeric },   { 0xA8FB, 0xA8FB, WB::AlphaNumeric },
+		{ 0xA8FD, 0xA92D, WB::AlphaNumeric },   { 0xA930, 0xA953, WB::AlphaNumeric },
+		{ 0xA960, 0xA97C, WB::AlphaNumeric },   { 0xA980, 0xA9C0, WB::AlphaNumeric },
+		{ 0xA9CF, 0xA9D9, WB::AlphaNumeric },   { 0xA9E0, 0xA9FE, WB::AlphaNumeric },
+		{ 0xAA00, 0xAA36, WB::AlphaNumeric },   { 0xAA40, 0xAA4D, WB::AlphaNumeric },
+		{ 0xAA50, 0xAA59, WB::AlphaNumeric },   { 0xAA60, 0xAA76, WB::AlphaNumeric },
+		{ 0xAA7A, 0xAAC2, WB::AlphaNumeric },   { 0xAADB, 0xAADD, WB::AlphaNumeric },
+		{ 0xAAE0, 0xAAEF, WB::AlphaNumeric },   { 0xAAF2, 0xAAF6, WB::AlphaNumeric },
+		{ 0xAB01, 0xAB06, WB::AlphaNumeric },   { 0xAB09, 0xAB0E, WB::AlphaNumeric },
+		{ 0xAB11, 0xAB16, WB::AlphaNumeric },   { 0xAB20, 0xAB26, WB::AlphaNumeric },
+		{ 0xAB28, 0xAB2E, WB::AlphaNumeric },   { 0xAB30, 0xAB5A, WB::AlphaNumeric },
+		{ 0xAB5C, 0xAB69, WB::AlphaNumeric },   { 0xAB70, 0xABEA, WB::AlphaNumeric },
+		{ 0xABEC, 0xABED, WB::AlphaNumeric },   { 0xABF0, 0xABF9, WB::AlphaNumeric },
+		{ 0xAC00, 0xD7A3, WB::AlphaNumeric },   { 0xD7B0, 0xD7C6, WB::AlphaNumeric },
+		{ 0xD7CB, 0xD7FB, WB::AlphaNumeric },   { 0xF900, 0xFA6D, WB::Ideographic },
+		{ 0xFA70, 0xFAD9, WB::Ideographic },    { 0xFB00, 0xFB06, WB::AlphaNumeric },
+		{ 0xFB13, 0xFB17, WB::AlphaNumeric },   { 0xFB1D, 0xFB28, WB::AlphaNumeric },
+		{ 0xFB2A, 0xFB36, WB::AlphaNumeric },   { 0xFB38, 0xFB3C, WB::AlphaNumeric },
+		{ 0xFB3E, 0xFB3E, WB::AlphaNumeric },   { 0xFB40, 0xFB41, WB::AlphaNumeric },
+		{ 0xFB43, 0xFB44, WB::AlphaNumeric },   { 0xFB46, 0xFBB1, WB::AlphaNumeric },
+		{ 0xFBD3, 0xFD3D, WB::AlphaNumeric },   { 0xFD50, 0xFD8F, WB::AlphaNumeric },
+		{ 0xFD92, 0xFDC7, WB::AlphaNumeric },   { 0xFDF0, 0xFDFB, WB::AlphaNumeric },
+		{ 0xFE00, 0xFE0F, WB::AlphaNumeric },   { 0xFE20, 0xFE2F, WB::AlphaNumeric },
+		{ 0xFE70, 0xFE74, WB::AlphaNumeric },   { 0xFE76, 0xFEFC, WB::AlphaNumeric },
+		{ 0xFF10, 0xFF19, WB::AlphaNumeric },   { 0xFF21, 0xFF3A, WB::AlphaNumeric },
+		{ 0xFF41, 0xFF5A, WB::AlphaNumeric },   { 0xFF66, 0xFF9F, WB::Katakana },
+		{ 0xFFA0, 0xFFBE, WB::AlphaNumeric },   { 0xFFC2, 0xFFC7, WB::AlphaNumeric },
+		{ 0xFFCA, 0xFFCF, WB::AlphaNumeric },   { 0xFFD2, 0xFFD7, WB::AlphaNumeric },
+		{ 0xFFDA, 0xFFDC, WB::AlphaNumeric },   { 0x10000, 0x1000B, WB::AlphaNumeric },
+		{ 0x1000D, 0x10026, WB::AlphaNumeric }, { 0x10028, 0x1003A, WB::AlphaNumeric },
+		{ 0x1003C, 0x1003D, WB::AlphaNumeric }, { 0x1003F, 0x1004D, WB::AlphaNumeric },
+		{ 0x10050, 0x1005D, WB::AlphaNumeric }, { 0x10080, 0x100FA, WB::AlphaNumeric },
+		{ 0x10140, 0x10174, WB::AlphaNumeric }, { 0x101FD, 0x101FD, WB::AlphaNumeric },
+		{ 0x10280, 0x1029C, WB::AlphaNumeric }, { 0x102A0, 0x102D0, WB::AlphaNumeric },
+		{ 0x102E0, 0x102E0, WB::AlphaNumeric }, { 0x10300, 0x1031F, WB::AlphaNumeric },
+		{ 0x1032D, 0x1034A, WB::AlphaNumeric }, { 0x10350, 0x1037A, WB::AlphaNumeric },
+		{ 0x10380, 0x1039D, WB::AlphaNumeric }, { 0x103A0, 0x103C3, WB::AlphaNumeric },
+		{ 0x103C8, 0x103CF, WB::AlphaNumeric }, { 0x103D1, 0x103D5, WB::AlphaNumeric },
+		{ 0x10400, 0x1049D, WB::AlphaNumeric }, { 0x104A0, 0x104A9, WB::AlphaNumeric },
+		{ 0x104B0, 0x104D3, WB::AlphaNumeric }, { 0x104D8, 0x104FB, WB::AlphaNumeric },
+		{ 0x10500, 0x10527, WB::AlphaNumeric }, { 0x10530, 0x10563, WB::AlphaNumeric },
+		{ 0x10570, 0x1057A, WB::AlphaNumeric }, { 0x1057C, 0x1058A, WB::AlphaNumeric },
+		{ 0x1058C, 0x10592, WB::AlphaNumeric }, { 0x10594, 0x10595, WB::AlphaNumeric },
+		{ 0x10597, 0x105A1, WB::AlphaNumeric }, { 0x105A3, 0x105B1, WB::AlphaNumeric },
+		{ 0x105B3, 0x105B9, WB::AlphaNumeric }, { 0x105BB, 0x105BC, WB::AlphaNumeric },
+		{ 0x10600, 0x10736, WB::AlphaNumeric }, { 0x10740, 0x10755, WB::AlphaNumeric },
+		{ 0x10760, 0x10767, WB::AlphaNumeric }, { 0x10780, 0x10785, WB::AlphaNumeric },
+		{ 0x10787, 0x107B0, WB::AlphaNumeric }, { 0x107B2, 0x107BA, WB::AlphaNumeric },
+		{ 0x10800, 0x10805, WB::AlphaNumeric }, { 0x10808, 0x10808, WB::AlphaNumeric },
+		{ 0x1080A, 0x10835, WB::AlphaNumeric }, { 0x10837, 0x10838, WB::AlphaNumeric },
+		{ 0x1083C, 0x1083C, WB::AlphaNumeric }, { 0x1083F, 0x10855, WB::AlphaNumeric },
+		{ 0x10860, 0x10876, WB::AlphaNumeric }, { 0x10880, 0x1089E, WB::AlphaNumeric },
+		{ 0x108E0, 0x108F2, WB::AlphaNumeric }, { 0x108F4, 0x108F5, WB::AlphaNumeric },
+		{ 0x10900, 0x10915, WB::AlphaNumeric }, { 0x10920, 0x10939, WB::AlphaNumeric },
+		{ 0x10980, 0x109B7, WB::AlphaNumeric }, { 0x109BE, 0x109BF, WB::AlphaNumeric },
+		{ 0x10A00, 0x10A03, WB::AlphaNumeric }, { 0x10A05, 0x10A06, WB::AlphaNumeric },
+		{ 0x10A0C, 0x10A13, WB::AlphaNumeric }, { 0x10A15, 0x10A17, WB::AlphaNumeric },
+		{ 0x10A19, 0x10A35, WB::AlphaNumeric }, { 0x10A38, 0x10A3A, WB::AlphaNumeric },
+		{ 0x10A3F, 0x10A3F, WB::AlphaNumeric }, { 0x10A60, 0x10A7C, WB::AlphaNumeric },
+		{ 0x10A80, 0x10A9C, WB::AlphaNumeric }, { 0x10AC0, 0x10AC7, WB::AlphaNumeric },
+		{ 0x10AC9, 0x10AE6, WB::AlphaNumeric }, { 0x10B00, 0x10B35, WB::AlphaNumeric },
+		{ 0x10B40, 0x10B55, WB::AlphaNumeric }, { 0x10B60, 0x10B72, WB::AlphaNumeric },
+		{ 0x10B80, 0x10B91, WB::AlphaNumeric }, { 0x10C00, 0x10C48, WB::AlphaNumeric },
+		{ 0x10C80, 0x10CB2, WB::AlphaNumeric }, { 0x10CC0, 0x10CF2, WB::AlphaNumeric },
+		{ 0x10D00, 0x10D27, WB::AlphaNumeric }, { 0x10D30, 0x10D39, WB::AlphaNumeric },
+		{ 0x10E80, 0x10EA9, WB::AlphaNumeric }, { 0x10EAB, 0x10EAC, WB::AlphaNumeric },
+		{ 0x10EB0, 0x10EB1, WB::AlphaNumeric }, { 0x10F00, 0x10F1C, WB::AlphaNumeric },
+		{ 0x10F27, 0x10F27, WB::AlphaNumeric }, { 0x10F30, 0x10F50, WB::AlphaNumeric },
+		{ 0x10F70, 0x10F85, WB::AlphaNumeric }, { 0x10FB0, 0x10FC4, WB::AlphaNumeric },
+		{ 0x10FE0, 0x10FF6, WB::AlphaNumeric }, { 0x11000, 0x11046, WB::AlphaNumeric },
+		{ 0x11066, 0x11075, WB::AlphaNumeric }, { 0x1107F, 0x110BA, WB::AlphaNumeric },
+		{ 0x110C2, 0x110C2, WB::AlphaNumeric }, { 0x110D0, 0x110E8, WB::AlphaNumeric },
+		{ 0x110F0, 0x110F9, WB::AlphaNumeric }, { 0x11100, 0x11134, WB::AlphaNumeric },
+		{ 0x11136, 0x1113F, WB::AlphaNumeric }, { 0x11144, 0x11147, WB::AlphaNumeric },
+		{ 0x11150, 0x11173, WB::AlphaNumeric }, { 0x11176, 0x11176, WB::AlphaNumeric },
+		{ 0x11180, 0x111C4, WB::AlphaNumeric }, { 0x111C9, 0x111CC, WB::AlphaNumeric },
+		{ 0x111CE, 0x111DA, WB::AlphaNumeric }, { 0x111DC, 0x111DC, WB::AlphaNumeric },
+		{ 0x11200, 0x11211, WB::AlphaNumeric }, { 0x11213, 0x11237, WB::AlphaNumeric },
+		{ 0x1123E, 0x1123E, WB::AlphaNumeric }, { 0x11280, 0x11286, WB::AlphaNumeric },
+		{ 0x11288, 0x11288, WB::AlphaNumeric }, { 0x1128A, 0x1128D, WB::AlphaNumeric },
+		{ 0x1128F, 0x1129D, WB::AlphaNumeric }, { 0x1129F, 0x112A8, WB::AlphaNumeric },
+		{ 0x112B0, 0x112EA, WB::AlphaNumeric }, { 0x112F0, 0x112F9, WB::AlphaNumeric },
+		{ 0x11300, 0x11303, WB::AlphaNumeric }, { 0x11305, 0x1130C, WB::AlphaNumeric },
+		{ 0x1130F, 0x11310, WB::AlphaNumeric }, { 0x11313, 0x11328, WB::AlphaNumeric },
+		{ 0x1132A, 0x11330, WB::AlphaNumeric }, { 0x11332, 0x11333, WB::AlphaNumeric },
+		{ 0x11335, 0x11339, WB::AlphaNumeric }, { 0x1133B, 0x11344, WB::AlphaNumeric },
+		{ 0x11347, 0x11348, WB::AlphaNumeric }, { 0x1134B, 0x1134D, WB::AlphaNumeric },
+		{ 0x11350, 0x11350, WB::AlphaNumeric }, { 0x11357, 0x11357, WB::AlphaNumeric },
+		{ 0x1135D, 0x11363, WB::AlphaNumeric }, { 0x11366, 0x1136C, WB::AlphaNumeric },
+		{ 0x11370, 0x11374, WB::AlphaNumeric }, { 0x11400, 0x1144A, WB::AlphaNumeric },
+		{ 0x11450, 0x11459, WB::AlphaNumeric }, { 0x1145E, 0x11461, WB::AlphaNumeric },
+		{ 0x11480, 0x114C5, WB::AlphaNumeric }, { 0x114C7, 0x114C7, WB::AlphaNumeric },
+		{ 0x114D0, 0x114D9, WB::AlphaNumeric }, { 0x11580, 0x115B5, WB::AlphaNumeric },
+		{ 0x115B8, 0x115C0, WB::AlphaNumeric }, { 0x115D8, 0x115DD, WB::AlphaNumeric },
+		{ 0x11600, 0x11640, WB::AlphaNumeric }, { 0x11644, 0x11644, WB::AlphaNumeric },
+		{ 0x11650, 0x11659, WB::AlphaNumeric }, { 0x11680, 0x116B8, WB::AlphaNumeric },
+		{ 0x116C0, 0x116C9, WB::AlphaNumeric }, { 0x11700, 0x1171A, WB::AlphaNumeric },
+		{ 0x1171D, 0x1172B, WB::AlphaNumeric }, { 0x11730, 0x11739, WB::AlphaNumeric },
+		{ 0x11740, 0x11746, WB::AlphaNumeric }, { 0x11800, 0x1183A, WB::AlphaNumeric },
+		{ 0x118A0, 0x118E9, WB::AlphaNumeric }, { 0x118FF, 0x11906, WB::AlphaNumeric },
+		{ 0x11909, 0x11909, WB::AlphaNumeric }, { 0x1190C, 0x11913, WB::AlphaNumeric },
+		{ 0x11915, 0x11916, WB::AlphaNumeric }, { 0x11918, 0x11935, WB::AlphaNumeric },
+		{ 0x11937, 0x11938, WB::AlphaNumeric }, { 0x1193B, 0x11943, WB::AlphaNumeric },
+		{ 0x11950, 0x11959, WB::AlphaNumeric }, { 0x119A0, 0x119A7, WB::AlphaNumeric },
+		{ 0x119AA, 0x119D7, WB::AlphaNumeric }, { 0x119DA, 0x119E1, WB::AlphaNumeric },
+		{ 0x119E3, 0x119E4, WB::AlphaNumeric }, { 0x11A00, 0x11A3E, WB::AlphaNumeric },
+		{ 0x11A47, 0x11A47, WB::AlphaNumeric }, { 0x11A50, 0x11A99, WB::AlphaNumeric },
+		{ 0x11A9D, 0x11A9D, WB::AlphaNumeric }, { 0x11AB0, 0x11AF8, WB::AlphaNumeric },
+		{ 0x11C00, 0x11C08, WB::AlphaNumeric }, { 0x11C0A, 0x11C36, WB::AlphaNumeric },
+		{ 0x11C38, 0x11C40, WB::AlphaNumeric }, { 0x11C50, 0x11C59, WB::AlphaNumeric },
+		{ 0x11C72, 0x11C8F, WB::AlphaNumeric }, { 0x11C92, 0x11CA7, WB::AlphaNumeric },
+		{ 0x11CA9, 0x11CB6, WB::AlphaNumeric }, { 0x11D00, 0x11D06, WB::AlphaNumeric },
+		{ 0x11D08, 0x11D09, WB::AlphaNumeric }, { 0x11D0B, 0x11D36, WB::AlphaNumeric },
+		{ 0x11D3A, 0x11D3A, WB::AlphaNumeric }, { 0x11D3C, 0x11D3D, WB::AlphaNumeric },
+		{ 0x11D3F, 0x11D47, WB::AlphaNumeric }, { 0x11D50, 0x11D59, WB::AlphaNumeric },
+		{ 0x11D60, 0x11D65, WB::AlphaNumeric }, { 0x11D67, 0x11D68, WB::AlphaNumeric },
+		{ 0x11D6A, 0x11D8E, WB::AlphaNumeric }, { 0x11D90, 0x11D91, WB::AlphaNumeric },
+		{ 0x11D93, 0x11D98, WB::AlphaNumeric }, { 0x11DA0, 0x11DA9, WB::AlphaNumeric },
+		{ 0x11EE0, 0x11EF6, WB::AlphaNumeric }, { 0x11FB0, 0x11FB0, WB::AlphaNumeric },
+		{ 0x12000, 0x12399, WB::AlphaNumeric }, { 0x12400, 0x1246E, WB::AlphaNumeric },
+		{ 0x12480, 0x12543, WB::AlphaNumeric }, { 0x12F90, 0x12FF0, WB::AlphaNumeric },
+		{ 0x13000, 0x1342E, WB::AlphaNumeric }, { 0x14400, 0x14646, WB::AlphaNumeric },
+		{ 0x16800, 0x16A38, WB::AlphaNumeric }, { 0x16A40, 0x16A5E, WB::AlphaNumeric },
+		{ 0x16A60, 0x16A69, WB::AlphaNumeric }, { 0x16A70, 0x16ABE, WB::AlphaNumeric },
+		{ 0x16AC0, 0x16AC9, WB::AlphaNumeric }, { 0x16AD0, 0x16AED, WB::AlphaNumeric },
+		{ 0x16AF0, 0x16AF4, WB::AlphaNumeric }, { 0x16B00, 0x16B36, WB::AlphaNumeric },
+		{ 0x16B40, 0x16B43, WB::AlphaNumeric }, { 0x16B50, 0x16B59, WB::AlphaNumeric },
+		{ 0x16B63, 0x16B77, WB::AlphaNumeric }, { 0x16B7D, 0x16B8F, WB::AlphaNumeric },
+		{ 0x16E40, 0x16E7F, WB::AlphaNumeric }, { 0x16F00, 0x16F4A, WB::AlphaNumeric },
+		{ 0x16F4F, 0x16F87, WB::AlphaNumeric }, { 0x16F8F, 0x16F9F, WB::AlphaNumeric },
+		{ 0x16FE0, 0x16FE1, WB::AlphaNumeric }, { 0x16FE3, 0x16FE4, WB::AlphaNumeric },
+		{ 0x16FF0, 0x16FF1, WB::AlphaNumeric }, { 0x17000, 0x187F7, WB::AlphaNumeric },
+		{ 0x18800, 0x18CD5, WB::AlphaNumeric }, { 0x18D00, 0x18D08, WB::AlphaNumeric },
+		{ 0x1AFF0, 0x1AFF3, WB::AlphaNumeric }, { 0x1AFF5, 0x1AFFB, WB::AlphaNumeric },
+		{ 0x1AFFD, 0x1AFFE, WB::AlphaNumeric }, { 0x1B000, 0x1B122, WB::AlphaNumeric },
+		{ 0x1B150, 0x1B152, WB::AlphaNumeric }, { 0x1B164, 0x1B167, WB::AlphaNumeric },
+		{ 0x1B170, 0x1B2FB, WB::AlphaNumeric }, { 0x1BC00, 0x1BC6A, WB::AlphaNumeric },
+		{ 0x1BC70, 0x1BC7C, WB::AlphaNumeric }, { 0x1BC80, 0x1BC88, WB::AlphaNumeric },
+		{ 0x1BC90, 0x1BC99, WB::AlphaNumeric }, { 0x1BC9D, 0x1BC9E, WB::AlphaNumeric },
+		{ 0x1CF00, 0x1CF2D, WB::AlphaNumeric }, { 0x1CF30, 0x1CF46, WB::AlphaNumeric },
+		{ 0x1D165, 0x1D169, WB::AlphaNumeric }, { 0x1D16D, 0x1D172, WB::AlphaNumeric },
+		{ 0x1D17B, 0x1D182, WB::AlphaNumeric }, { 0x1D185, 0x1D18B, WB::AlphaNumeric },
+		{ 0x1D1AA, 0x1D1AD, WB::AlphaNumeric }, { 0x1D242, 0x1D244, WB::AlphaNumeric },
+		{ 0x1D400, 0x1D454, WB::AlphaNumeric }, { 0x1D456, 0x1D49C, WB::AlphaNumeric },
+		{ 0x1D49E, 0x1D49F, WB::AlphaNumeric }, { 0x1D4A2, 0x1D4A2, WB::AlphaNumeric },
+		{ 0x1D4A5, 0x1D4A6, WB::AlphaNumeric }, { 0x1D4A9, 0x1D4AC, WB::AlphaNumeric },
+		{ 0x1D4AE, 0x1D4B9, WB::AlphaNumeric }, { 0x1D4BB, 0x1D4BB, WB::AlphaNumeric },
+		{ 0x1D4BD, 0x1D4C3, WB::AlphaNumeric }, { 0x1D4C5, 0x1D505, WB::AlphaNumeric },
+		{ 0x1D507, 0x1D50A, WB::AlphaNumeric }, { 0x1D50D, 0x1D514, WB::AlphaNumeric },
+		{ 0x1D516, 0x1D51C, WB::AlphaNumeric }, { 0x1D51E, 0x1D539, WB::AlphaNumeric },
+		{ 0x1D53B, 0x1D53E, WB::AlphaNumeric }, { 0x1D540, 0x1D544, WB::AlphaNumeric },
+		{ 0x1D546, 0x1D546, WB::AlphaNumeric }, { 0x1D54A, 0x1D550, WB::AlphaNumeric },
+		{ 0x1D552, 0x1D6A5, WB::AlphaNumeric }, { 0x1D6A8, 0x1D6C0, WB::AlphaNumeric },
+		{ 0x1D6C2, 0x1D6DA, WB::AlphaNumeric }, { 0x1D6DC, 0x1D6FA, WB::AlphaNumeric },
+		{ 0x1D6FC, 0x1D714, WB::AlphaNumeric }, { 0x1D716, 0x1D734, WB::AlphaNumeric },
+		{ 0x1D736, 0x1D74E, WB::AlphaNumeric }, { 0x1D750, 0x1D76E, WB::AlphaNumeric },
+		{ 0x1D770, 0x1D788, WB::AlphaNumeric }, { 0x1D78A, 0x1D7A8, WB::AlphaNumeric },
+		{ 0x1D7AA, 0x1D7C2, WB::AlphaNumeric }, { 0x1D7C4, 0x1D7CB, WB::AlphaNumeric },
+		{ 0x1D7CE, 0x1D7FF, WB::AlphaNumeric }, { 0x1DA00, 0x1DA36, WB::AlphaNumeric },
+		{ 0x1DA3B, 0x1DA6C, WB::AlphaNumeric }, { 0x1DA75, 0x1DA75, WB::AlphaNumeric },
+		{ 0x1DA84, 0x1DA84, WB::AlphaNumeric }, { 0x1DA9B, 0x1DA9F, WB::AlphaNumeric },
+		{ 0x1DAA1, 0x1DAAF, WB::AlphaNumeric }, { 0x1DF00, 0x1DF1E, WB::AlphaNumeric },
+		{ 0x1E000, 0x1E006, WB::AlphaNumeric }, { 0x1E008, 0x1E018, WB::AlphaNumeric },
+		{ 0x1E01B, 0x1E021, WB::AlphaNumeric }, { 0x1E023, 0x1E024, WB::AlphaNumeric },
+		{ 0x1E026, 0x1E02A, WB::AlphaNumeric }, { 0x1E100, 0x1E12C, WB::AlphaNumeric },
+		{ 0x1E130, 0x1E13D, WB::AlphaNumeric }, { 0x1E140, 0x1E149, WB::AlphaNumeric },
+		{ 0x1E14E, 0x1E14E, WB::AlphaNumeric }, { 0x1E290, 0x1E2AE, WB::AlphaNumeric },
+		{ 0x1E2C0, 0x1E2F9, WB::AlphaNumeric }, { 0x1E7E0, 0x1E7E6, WB::AlphaNumeric },
+		{ 0x1E7E8, 0x1E7EB, WB::AlphaNumeric }, { 0x1E7ED, 0x1E7EE, WB::AlphaNumeric },
+		{ 0x1E7F0, 0x1E7FE, WB::AlphaNumeric }, { 0x1E800, 0x1E8C4, WB::AlphaNumeric },
+		{ 0x1E8D0, 0x1E8D6, WB::AlphaNumeric }, { 0x1E900, 0x1E94B, WB::AlphaNumeric },
+		{ 0x1E950, 0x1E959, WB::AlphaNumeric }, { 0x1EE00, 0x1EE03, WB::AlphaNumeric },
+		{ 0x1EE05, 0x1EE1F, WB::AlphaNumeric }, { 0x1EE21, 0x1EE22, WB::AlphaNumeric },
+		{ 0x1EE24, 0x1EE24, WB::AlphaNumeric }, { 0x1EE27, 0x1EE27, WB::AlphaNumeric },
+		{ 0x1EE29, 0x1EE32, WB::AlphaNumeric }, { 0x1EE34, 0x1EE37, WB::AlphaNumeric },
+		{ 0x1EE39, 0x1EE39, WB::AlphaNumeric }, { 0x1EE3B, 0x1EE3B, WB::AlphaNumeric },
+		{ 0x1EE42, 0x1EE42, WB::AlphaNumeric }, { 0x1EE47, 0x1EE47, WB::AlphaNumeric },
+		{ 0x1EE49, 0x1EE49, WB::AlphaNumeric }, { 0x1EE4B, 0x1EE4B, WB::AlphaNumeric },
+		{ 0x1EE4D, 0x1EE4F, WB::AlphaNumeric }, { 0x1EE51, 0x1EE52, WB::AlphaNumeric },
+		{ 0x1EE54, 0x1EE54, WB::AlphaNumeric }, { 0x1EE57, 0x1EE57, WB::AlphaNumeric },
+		{ 0x1EE59, 0x1EE59, WB::AlphaNumeric }, { 0x1EE5B, 0x1EE5B, WB::AlphaNumeric },
+		{ 0x1EE5D, 0x1EE5D, WB::AlphaNumeric }, { 0x1EE5F, 0x1EE5F, WB::AlphaNumeric },
+		{ 0x1EE61, 0x1EE62, WB::AlphaNumeric }, { 0x1EE64, 0x1EE64, WB::AlphaNumeric },
+		{ 0x1EE67, 0x1EE6A, WB::AlphaNumeric }, { 0x1EE6C, 0x1EE72, WB::AlphaNumeric },
+		{ 0x1EE74, 0x1EE77, WB::AlphaNumeric }, { 0x1EE79, 0x1EE7C, WB::AlphaNumeric },
+		{ 0x1EE7E, 0x1EE7E, WB::AlphaNumeric }, { 0x1EE80, 0x1EE89, WB::AlphaNumeric },
+		{ 0x1EE8B, 0x1EE9B, WB::AlphaNumeric }, { 0x1EEA1, 0x1EEA3, WB::AlphaNumeric },
+		{ 0x1EEA5, 0x1EEA9, WB::AlphaNumeric }, { 0x1EEAB, 0x1EEBB, WB::AlphaNumeric },
+		{ 0x1F210, 0x1F212, WB::Ideographic },  { 0x1F214, 0x1F23B, WB::Ideographic },
+		{ 0x1F240, 0x1F248, WB::Ideographic },  { 0x1FBF0, 0x1FBF9, WB::AlphaNumeric },
+		{ 0x20000, 0x2A6DF, WB::Ideographic },  { 0x2A700, 0x2B738, WB::Ideographic },
+		{ 0x2B740, 0x2B81D, WB::Ideographic },  { 0x2B820, 0x2CEA1, WB::Ideographic },
+		{ 0x2CEB0, 0x2EBE0, WB::Ideographic },  { 0x2F800, 0x2FA1D, WB::Ideographic },
+		{ 0x30000, 0x3134A, WB::Ideographic },  { 0xE0100, 0xE01EF, WB::AlphaNumeric },
+	};
+
+	constexpr std::size_t s_blockSize = 256;
+
+	constexpr std::size_t s_bmpBlockCount = 0x10000 / s_blockSize;
+	constexpr std::size_t s_blockCount    = 0x110000 / s_blockSize;
+
+	// a block is mixed unless a single range without gaps covers all of it and no other range touches it
+	template<std::size_t BlockCount, typename Range, std::size_t RangeCount>
+	[[nodiscard]] constexpr auto GetMixedBlocks(const Range (&ranges)[RangeCount]) noexcept
+	{
+		std::array<bool, BlockCount> result = {};
+		std::array<std::size_t, BlockCount> rangeCount = {};
+
+		for (const auto& range : ranges)
+		{
+			for (std::size_t block = range.m_first / s_blockSize; block <= range.m_last / s_blockSize; ++block)
+			{
+				const bool isCovered = range.m_stride == 1 && range.m_first <= block * s_blockSize && range.m_last + 1 >= (block + 1) * s_blockSize;
+
+				if (!isCovered || ++rangeCount[block] > 1) result[block] = true;
+			}
+		}
+
+		return result;
+	}
+
+	template<std::size_t BlockCount, typename Range, std::size_t RangeCount>
+	[[nodiscard]] constexpr std::size_t GetMixedBlockCount(const Range (&ranges)[RangeCount]) noexcept
+	{
+		std::size_t result = 0;
+
+		for (const auto mixed : GetMixedBlocks<BlockCount>(ranges))
+		{
+			if (mixed) ++result;
+		}
+
+		return result;
+	}
+
+	// two level table, stage1 maps the high bits of the code point to a block of values in stage2
+	//
+	// the first blocks of stage2 hold a single value each and are shared by every block that is not mixed
+	template<std::size_t BlockCount, std::size_t Stage2Count>
+	struct PropertyTable
+	{
+		std::array<std::uint8_t, BlockCount> m_stage1 = {};
+		std::array<std::array<std::uint8_t, s_blockSize>, Stage2Count> m_stage2 = {};
+
+		[[nodiscard]] constexpr std::uint8_t m_get(const std::uint32_t c) const noexcept
+		{
+			return m_stage2[m_stage1[c / s_blockSize]][c % s_blockSize];
+		}
+	};
+
+	template<std::size_t BlockCount, std::size_t ValueCount, std::size_t MixedCount, typename Range, std::size_t RangeCount>
+	[[nodiscard]] constexpr auto MakePropertyTable(const Range (&ranges)[RangeCount], const std::uint8_t defaultValue) noexcept
+	{
+		static_assert(ValueCount + MixedCount <= 256, "stage2 blocks are indexed by a byte");
+
+		PropertyTable<BlockCount, ValueCount + MixedCount> result = {};
+
+		for (std::size_t block = 0; block < ValueCount; ++block)
+		{
+			for (auto& value : result.m_stage2[block]) value = static_cast<std::uint8_t>(block);
+		}
+
+		const auto mixed = GetMixedBlocks<BlockCount>(ranges);
+
+		auto nextBlock = ValueCount;
+
+		for (std::size_t block = 0; block < BlockCount; ++block)
+		{
+			if (!mixed[block])
+			{
+				result.m_stage1[block] = defaultValue;
+				continue;
+			}
+
+			for (auto& value : result.m_stage2[nextBlock]) value = defaultValue;
+
+			result.m_stage1[block] = static_cast<std::uint8_t>(nextBlock++);
+		}
+
+		for (const auto& range : ranges)
+		{
+			const auto rangeValue = static_cast<std::uint8_t>(range.m_value);
+
+			for (std::size_t block = range.m_first / s_blockSize; block <= range.m_last / s_blockSize; ++block)
+			{
+				if (!mixed[block])
+				{
+					result.m_stage1[block] = rangeValue;
+					continue;
+				}
+
+				const std::size_t blockStart = block * s_blockSize;
+
+				// first code point of the range inside the block
+				std::size_t c = range.m_first;
+
+				if (c < blockStart) c += (blockStart - c + range.m_stride - 1) / range.m_stride * range.m_stride;
+
+				for (; c <= range.m_last && c < blockStart + s_blockSize; c += range.m_stride)
+				{
+					result.m_stage2[result.m_stage1[block]][c % s_blockSize] = rangeValue;
+				}
+			}
+		}
+
+		return result;
+	}
+
+	constexpr auto s_widthTable = MakePropertyTable<s_bmpBlockCount, 3,
+		GetMixedBlockCount<s_bmpBlockCount>(s_widthRanges)>(s_widthRanges, 1);
+
+	constexpr auto s_graphemeBreakTable = MakePropertyTable<s_blockCount, static_cast<std::size_t>(GB::ExtendedPictographic) + 1,
+		GetMixedBlockCount<s_blockCount>(s_graphemeBreakRanges)>(s_graphemeBreakRanges, 0);
+
+	constexpr auto s_wordBreakTable = MakePropertyTable<s_blockCount, static_cast<std::size_t>(WB::Katakana) + 1,
+		GetMixedBlockCount<s_blockCount>(s_wordBreakRanges)>(s_wordBreakRanges, 0);
+
+	// whether two adjacent grapheme break properties are in one cluster, rules GB3 to GB13 of UAX #29,
+	// the two rules that look further back than the pair are decided by the scan
+	enum class PairBreak : std::uint8_t
+	{
+		Break,
+		Join,
+		JoinAfterPictographic,
+		JoinOddRegional
+	};
+
+	[[nodiscard]] constexpr bool IsControl(const GB value) noexcept
+	{
+		return value == GB::CR || value == GB::LF || value == GB::Control;
+	}
+
+	[[nodiscard]] constexpr PairBreak GetPairBreak(const GB before, const GB after) noexcept
+	{
+		if (before == GB::CR && after == GB::LF) return PairBreak::Join;
+
+		if (IsControl(before) || IsControl(after)) return PairBreak::Break;
+
+		// hangul syllable sequences
+		if (before == GB::L && (after == GB::L || after == GB::V || after == GB::LV || after == GB::LVT)) return PairBreak::Join;
+		if ((before == GB::LV || before == GB::V) && (after == GB::V || after == GB::T)) return PairBreak::Join;
+		if ((before == GB::LVT || before == GB::T) && after == GB::T) return PairBreak::Join;
+
+		if (after == GB::Extend || after == GB::ZWJ || after == GB::SpacingMark) return PairBreak::Join;
+
+		if (before == GB::Prepend) return PairBreak::Join;
+
+		if (before == GB::ZWJ && after == GB::ExtendedPictographic) return PairBreak::JoinAfterPictographic;
+
+		if (before == GB::RegionalIndicator && after == GB::RegionalIndicator) return PairBreak::JoinOddRegional;
+
+		return PairBreak::Break;
+	}
+
+	constexpr std::size_t s_graphemeBreakCount = static_cast<std::size_t>(GB::ExtendedPictographic) + 1;
+
+	[[nodiscard]] constexpr auto MakePairBreakTable() noexcept
+	{
+		std::array<std::array<PairBreak, s_graphemeBreakCount>, s_graphemeBreakCount> result = {};
+
+		for (std::size_t before = 0; before < s_graphemeBreakCount; ++before)
+		{
+			for (std::size_t after = 0; after < s_graphemeBreakCount; ++after)
+			{
+				result[before][after] = GetPairBreak(static_cast<GB>(before), static_cast<GB>(after));
+			}
+		}
+
+		return result;
+	}
+
+	constexpr auto s_pairBreakTable = MakePairBreakTable();
+
+	// clusters longer than this are split when walking backwards
+	constexpr std::size_t s_maxLookBehind = 1 << 10;
+
+	[[nodiscard]] constexpr std::uint32_t ToUnit(const wchar_t c) noexcept
+	{
+		return static_cast<std::uint32_t>(static_cast<std::make_unsigned_t<wchar_t>>(c));
+	}
+
+	[[nodiscard]] constexpr bool IsHighSurrogate(const std::uint32_t c) noexcept { return c - 0xD800 < 0x400; }
+	[[nodiscard]] constexpr bool IsLowSurrogate (const std::uint32_t c) noexcept { return c - 0xDC00 < 0x400; }
+
+	// code point ending right before index and the number of units it takes
+	[[nodiscard]] std::pair<char32_t, std::size_t> DecodeBefore(const std::wstring_view text, const std::size_t index) noexcept
+	{
+		const auto c = ToUnit(text[index - 1]);
+
+		if (IsLowSurrogate(c) && index > 1 && IsHighSurrogate(ToUnit(text[index - 2])))
+		{
+			return { static_cast<char32_t>(0x10000 + ((ToUnit(text[index - 2]) - 0xD800) << 10) + (c - 0xDC00)), 2 };
+		}
+
+		return { static_cast<char32_t>(c), 1 };
+	}
+}
+
+[[nodiscard]] UnicodeProperties::SizeType UnicodeProperties::s_getWidth(const wchar_t c) noexcept
+{
+	// every unit goes through the table, ascii included, so the loops measuring text stay free of branches
+	return s_widthTable.m_get(std::min<std::uint32_t>(ToUnit(c), 0xFFFF));
+}
+
+[[nodiscard]] UnicodeProperties::GraphemeBreak UnicodeProperties::s_getGraphemeBreak(const char32_t c) noexcept
+{
+	return static_cast<GraphemeBreak>(s_graphemeBreakTable.m_get(std::min<std::uint32_t>(c, 0x10FFFF)));
+}
+
+[[nodiscard]] UnicodeProperties::WordBreak UnicodeProperties::s_getWordBreak(const char32_t c) noexcept
+{
+	return static_cast<WordBreak>(s_wordBreakTable.m_get(std::min<std::uint32_t>(c, 0x10FFFF)));
+}
+
+[[nodiscard]] std::pair<char32_t, UnicodeProperties::SizeType> UnicodeProperties::s_decode(const std::wstring_view text, const SizeType index) noexcept
+{
+	const auto c = ToUnit(text[index]);
+
+	if (IsHighSurrogate(c) && index + 1 < text.size() && IsLowSurrogate(ToUnit(text[index + 1])))
+	{
+		return { static_cast<char32_t>(0x10000 + ((c - 0xD800) << 10) + (ToUnit(text[index + 1]) - 0xDC00)), 2 };
+	}
+
+	return { static_cast<char32_t>(c), 1 };
+}
+
+[[nodiscard]] UnicodeProperties::SizeType UnicodeProperties::s_getNextGraphemeBreak(const std::wstring_view text, SizeType index) noexcept
+{
+	if (index >= text.size()) return text.size();
+
+	const auto [first, firstSize] = s_decode(text, index);
+
+	auto before = s_getGraphemeBreak(first);
+
+	// ExtendedPictographic Extend* ZWJ? ends before the current code point
+	bool isAfterPictographic = before == GraphemeBreak::ExtendedPictographic;
+
+	// regional indicators right before the current code point
+	SizeType regionalCount = before == GraphemeBreak::RegionalIndicator;
+
+	index += firstSize;
+
+	while (index < text.size())
+	{
+		const auto [c, size] = s_decode(text, index);
+
+		const auto after = s_getGraphemeBreak(c);
+
+		switch (s_pairBreakTable[static_cast<std::size_t>(before)][static_cast<std::size_t>(after)])
+		{
+		case PairBreak::Break:
+			return index;
+		case PairBreak::JoinAfterPictographic:
+			if (!isAfterPictographic) return index;
+			break;
+		case PairBreak::JoinOddRegional:
+			if (regionalCount % 2 == 0) return index;
+			break;
+		default:
+			break;
+		}
+
+		isAfterPictographic = after == GraphemeBreak::ExtendedPictographic ||
+			(isAfterPictographic && (after == GraphemeBreak::Extend || (after == GraphemeBreak::ZWJ && before != GraphemeBreak::ZWJ)));
+
+		regionalCount = after == GraphemeBreak::RegionalIndicator ? regionalCount + 1 : 0;
+
+		before = after;
+		index += size;
+	}
+
+	return text.size();
+}
+
+[[nodiscard]] UnicodeProperties::SizeType UnicodeProperties::s_getPreviousGraphemeBreak(const std::wstring_view text, SizeType index) noexcept
+{
+	index = std::min(index, text.size());
+
+	if (index == 0) return 0;
+
+	// walks back to a break that does not depend on the code points before it, then forward over the clusters after it
+	auto [last, lastSize] = DecodeBefore(text, index);
+
+	auto after = s_getGraphemeBreak(last);
+	auto start = index - lastSize;
+
+	while (start > 0 && index - start < s_maxLookBehind)
+	{
+		const auto [c, size] = DecodeBefore(text, start);
+
+		const auto before = s_getGraphemeBreak(c);
+
+		if (s_pairBreakTable[static_cast<std::size_t>(before)][static_cast<std::size_t>(after)] == PairBreak::Break) break;
+
+		after  = before;
+		start -= size;
+	}
+
+	for (auto next = s_getNextGraphemeBreak(text, start); next < index; next = s_getNextGraphemeBreak(text, start))
+	{
+		start = next;
+	}
+
+	return start;
+}
+
+[[nodiscard]] bool UnicodeProperties::s_isGraphemeBreak(const std::wstring_view text, const SizeType index) noexcept
+{
+	if (index == 0 || index >= text.size()) return true;
+
+	return s_getNextGraphemeBreak(text, s_getPreviousGraphemeBreak(text, index)) == index;
+}
@@ -0,0 +1,212 @@
+#include "../include/worker_pool.h"
+
+#include <algorithm>
+
+namespace
+{
+
+	constexpr std::size_t s_noWorker = ~std::size_t(0);
+
+	// queue of the worker running on this thread, chunks a task splits off stay with it
+	thread_local const WorkerPool* t_pool   = nullptr;
+	thread_local std::size_t       t_worker = s_noWorker;
+
+} // namespace
+
+[[nodiscard]] WorkerPool::SizeType WorkerPool::Job::m_getPercent() const noexcept
+{
+	const auto total = m_total.load(std::memory_order_relaxed);
+
+	if (total == 0) return 0;
+
+	return std::min<SizeType>(100, m_done.load(std::memory_order_relaxed) * 100 / total);
+}
+
+[[nodiscard]] WorkerPool& WorkerPool::s_get()
+{
+	static WorkerPool pool(std::max(1u, std::thread::hardware_concurrency()));
+
+	return pool;
+}
+
+WorkerPool::WorkerPool(const unsigned threadCount)
+{
+	for (unsigned i = 0; i < threadCount; ++i) m_queues.push_back(std::make_unique<Queue>());
+
+	for (unsigned i = 0; i < threadCount; ++i) m_threads.emplace_back(&WorkerPool::m_work, this, i);
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard lock(m_wakeMutex);
+		m_stopping = true;
+	}
+
+	m_wake.notify_all();
+
+	for (auto& thread : m_threads) thread.join();
+}
+
+[[nodiscard]] std::shared_ptr<WorkerPool::Job> WorkerPool::m_run(std::function<void(Job&)> task)
+{
+	auto job = std::make_shared<Job>();
+
+	m_push([job, task = std::move(task)]
+	{
+		try
+		{
+			if (!job->m_isCancelled()) task(*job);
+		}
+		catch (...)
+		{
+			// a worker outlives its tasks, the thread that waits for the job learns about it instead
+			job->m_failed.store(true, std::memory_order_relaxed);
+		}
+
+		job->m_finished.store(true, std::memory_order_release);
+	});
+
+	return job;
+}
+
+void WorkerPool::m_parallelFor(const Job& job, const SizeType count, const SizeType chunkSize,
+	const std::function<void(SizeType, SizeType)>& body)
+{
+	const auto chunkCount = (count + chunkSize - 1) / chunkSize;
+
+	std::atomic<SizeType> remaining { chunkCount };
+
+	std::mutex errorMutex;
+	std::exception_ptr error;
+	std::atomic<bool> failed { false };
+
+	const auto fail = [&]
+	{
+		std::lock_guard lock(errorMutex);
+
+		if (!error) error = std::current_exception();
+
+		failed.store(true, std::memory_order_relaxed);
+	};
+
+	SizeType pushed = 0;
+
+	try
+	{
+		for (; pushed < chunkCount; ++pushed) m_push([&, chunk = pushed]
+		{
+			try
+			{
+				if (!job.m_isCancelled() && !failed.load(std::memory_order_relaxed)) body(chunk * chunkSize, std::min(count, (chunk + 1) * chunkSize));
+			}
+			catch (...)
+			{
+				fail();
+			}
+
+			// the caller waits for every chunk, thrown or not
+			remaining.fetch_sub(1, std::memory_order_acq_rel);
+		});
+	}
+	catch (...)
+	{
+		// the chunks that were queued still read the locals, they are waited for all the same
+		fail();
+
+		remaining.fetch_sub(chunkCount - pushed, std::memory_order_acq_rel);
+	}
+
+	// the caller works on its chunks instead of blocking a worker, a task can split itself up this way
+	const auto home = t_pool == this ? t_worker : s_noWorker;
+
+	while (remaining.load(std::memory_order_acquire) > 0)
+	{
+		if (!m_runOne(home)) std::this_thread::yield();
+	}
+
+	if (error) std::rethrow_exception(error);
+}
+
+void WorkerPool::m_push(Task task)
+{
+	const auto index = t_pool == this ? t_worker : m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+
+	// counted before it is queued, a worker taking it right away must not count below zero
+	{
+		std::lock_guard lock(m_wakeMutex);
+		m_queued.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	try
+	{
+		std::lock_guard lock(m_queues[index]->m_mutex);
+		m_queues[index]->m_tasks.push_back(std::move(task));
+	}
+	catch (...)
+	{
+		m_queued.fetch_sub(1, std::memory_order_relaxed);
+		throw;
+	}
+
+	m_wake.notify_one();
+}
+
+bool WorkerPool::m_runOne(const SizeType home)
+{
+	Task task;
+
+	if (home != s_noWorker)
+	{
+		std::lock_guard lock(m_queues[home]->m_mutex);
+
+		auto& tasks = m_queues[home]->m_tasks;
+
+		if (!tasks.empty())
+		{
+			task = std::move(tasks.back());
+			tasks.pop_back();
+		}
+	}
+
+	// the oldest tasks of another queue are the biggest pieces of its work
+	for (SizeType i = 1; !task && i <= m_queues.size(); ++i)
+	{
+		const auto index = (home == s_noWorker ? i - 1 : home + i) % m_queues.size();
+
+		std::lock_guard lock(m_queues[index]->m_mutex);
+
+		auto& tasks = m_queues[index]->m_tasks;
+
+		if (!tasks.empty())
+		{
+			task = std::move(tasks.front());
+			tasks.pop_front();
+		}
+	}
+
+	if (!task) return false;
+
+	m_queued.fetch_sub(1, std::memory_order_relaxed);
+
+	task();
+
+	return true;
+}
+
+void WorkerPool::m_work(const SizeType index)
+{
+	t_pool   = this;
+	t_worker = index;
+
+	while (true)
+	{
+		if (m_runOne(index)) continue;
+
+		std::unique_lock lock(m_wakeMutex);
+
+		m_wake.wait(lock, [this] { return m_stopping || m_queued.load(std::memory_order_relaxed) > 0; });
+
+		if (m_stopping) return;
+	}
+}
@@ -0,0 +1,186 @@
+#include "../include/wrap_layout.h"
+
+#include <algorithm>
+#include <numeric>
+#include <execution>
+
+void WrapLayout::m_build(const std::wstring_view text, const LineIndex& lineIndex, const SizeType width, const SizeType tabSize)
+{
+	m_width   = std::max<SizeType>(width, 1);
+	m_tabSize = tabSize;
+
+	m_rows.resize(lineIndex.m_getLineCount());
+
+	// line numbers first, every line is then measured on its own
+	std::iota(m_rows.begin(), m_rows.end(), SizeType(0));
+
+	std::transform(std::execution::par, m_rows.cbegin(), m_rows.cend(), m_rows.begin(), [&] (const SizeType line)
+	{
+		const auto start = lineIndex.m_getLineStart(line);
+
+		return s_countRows(text.substr(start, lineIndex.m_getLineEnd(line) - start), m_width, m_tabSize);
+	});
+
+	m_changedLines.clear();
+	m_buildTree();
+}
+
+void WrapLayout::m_clear() noexcept
+{
+	m_rows.clear();
+	m_tree.clear();
+	m_changedLines.clear();
+
+	m_width = 0;
+	m_treeOutdated = false;
+}
+
+void WrapLayout::m_spliceLines(const SizeType line, const SizeType removedLines, const SizeType insertedLines)
+{
+	if (line >= m_rows.size()) return;
+
+	const auto last    = line + removedLines;
+	const auto newLast = line + insertedLines;
+
+	// wraps around when lines are removed
+	const auto delta = insertedLines - removedLines;
+
+	if (removedLines != insertedLines)
+	{
+		const auto position = m_rows.begin() + static_cast<std::ptrdiff_t>(line + 1);
+
+		m_rows.erase(position, position + static_cast<std::ptrdiff_t>(std::min(removedLines, m_rows.size() - line - 1)));
+		m_rows.insert(m_rows.begin() + static_cast<std::ptrdiff_t>(line + 1), insertedLines, 1);
+
+		m_treeOutdated = true;
+	}
+
+	std::pair<SizeType, SizeType> range = { line, newLast };
+	std::vector<std::pair<SizeType, SizeType>> nextRanges;
+
+	for (const auto& [rangeFirst, rangeLast] : m_changedLines)
+	{
+		if (rangeLast < line)
+		{
+			nextRanges.emplace_back(rangeFirst, rangeLast);
+		}
+		else if (rangeFirst > last)
+		{
+			nextRanges.emplace_back(rangeFirst + delta, rangeLast + delta);
+		}
+		else
+		{
+			range.first  = std::min(range.first, rangeFirst);
+			range.second = std::max(range.second, rangeLast > last ? rangeLast + delta : newLast);
+		}
+	}
+
+	nextRanges.push_back(range);
+	m_changedLines = std::move(nextRanges);
+}
+
+void WrapLayout::m_measureChangedLines(const std::wstring_view text, const LineIndex& lineIndex)
+{
+	const auto lineCount = std::min(m_rows.size(), lineIndex.m_getLineCount());
+
+	for (const auto& [first, last] : m_changedLines)
+	{
+		for (auto line = first; line <= last && line < lineCount; ++line)
+		{
+			const auto start = lineIndex.m_getLineStart(line);
+			const auto rows = s_countRows(text.substr(start, lineIndex.m_getLineEnd(line) - start), m_width, m_tabSize);
+
+			// only the lines that wrap differently touch the tree
+			if (!m_treeOutdated && rows != m_rows[line]) m_addToTree(line, rows - m_rows[line]);
+
+			m_rows[line] = rows;
+		}
+	}
+
+	m_changedLines.clear();
+
+	if (m_treeOutdated) m_buildTree();
+}
+
+[[nodiscard]] WrapLayout::SizeType WrapLayout::m_getFirstRow(const SizeType line) const noexcept
+{
+	SizeType row = 0;
+
+	for (auto i = std::min(line, m_rows.size()); i > 0; i &= i - 1) row += m_tree[i];
+
+	return row;
+}
+
+[[nodiscard]] std::pair<WrapLayout::SizeType, WrapLayout::SizeType> WrapLayout::m_getLineAt(const SizeType row) const noexcept
+{
+	if (m_rows.empty()) return { 0, 0 };
+
+	const auto rowCount = m_getRowCount();
+
+	if (row >= rowCount) return { m_rows.size() - 1, m_rows.back() - 1 };
+
+	// the last tree node whose prefix still ends at or before row
+	SizeType line = 0;
+	SizeType remaining = row;
+
+	auto step = SizeType(1);
+
+	while (step * 2 <= m_rows.size()) step *= 2;
+
+	for (; step > 0; step /= 2)
+	{
+		if (line + step <= m_rows.size() && m_tree[line + step] <= remaining)
+		{
+			line += step;
+			remaining -= m_tree[line];
+		}
+	}
+
+	return { line, remaining };
+}
+
+[[nodiscard]] WrapLayout::SizeType WrapLayout::s_countRows(const std::wstring_view line, const SizeType width, const SizeType tabSize) noexcept
+{
+	SizeType rows   = 1;
+	SizeType column = 0;
+
+	for (const auto c : line)
+	{
+		const auto charWidth = s_getCharWidth(c, tabSize);
+
+		if (column > 0 && column + charWidth > width)
+		{
+			++rows;
+			column = 0;
+		}
+
+		column += charWidth;
+	}
+
+	// the line end takes a column too, the cursor is drawn on it
+	if (column > 0 && column + 1 > width) ++rows;
+
+	return rows;
+}
+
+void WrapLayout::m_buildTree()
+{
+	m_tree.assign(m_rows.size() + 1, 0);
+
+	std::copy(m_rows.cbegin(), m_rows.cend(), m_tree.begin() + 1);
+
+	// every node adds itself to its parent once
+	for (SizeType i = 1; i < m_tree.size(); ++i)
+	{
+		const auto parent = i + (i & (~i + 1));
+
+		if (parent < m_tree.size()) m_tree[parent] += m_tree[i];
+	}
+
+	m_treeOutdated = false;
+}
+
+void WrapLayout::m_addToTree(SizeType line, const SizeType delta) noexcept
+{
+	for (++line; line < m_tree.size(); line += line & (~line + 1)) m_tree[line] += delta;
+}